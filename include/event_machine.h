@@ -197,15 +197,23 @@ extern "C" {
  * @example hello.c
  * @example api_hooks.c
  * @example dispatcher_callback.c
+ * @example dispatch_prio.c
+ * @example dispatch_defer.c
+ * @example core_util.c
+ * @example coro_yield.c
  * @example error.c
+ * @example event_headroom.c
+ * @example event_imm.c
  * @example event_group.c
  * @example event_group_abort.c
  * @example event_group_assign_end.c
  * @example event_group_chaining.c
  * @example fractal.c
  * @example ordered.c
+ * @example pool_wmark.c
  * @example queue_types_ag.c
  * @example queue_types_local.c
+ * @example queue_stats.c
  * @example queue_group.c
  * add-ons:
  * @example timer_hello.c
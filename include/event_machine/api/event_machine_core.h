@@ -74,6 +74,48 @@ em_core_id(void);
 int
 em_core_count(void);
 
+/**
+ * EM-core utilization
+ *
+ * Always collected by the dispatcher: a core is 'busy' from the dispatch round
+ * that gets events (from the scheduler or local queues) until a round that
+ * gets none, and 'idle' from there on. Time spent outside em_dispatch() counts
+ * towards the state of the latest dispatch round.
+ * The average dispatch burst size is 'events / rounds'.
+ *
+ * The counters are cumulative since em_init(), sample twice and use the
+ * difference to get the utilization over an interval.
+ */
+typedef struct {
+	/** Time (ns) the core has been busy */
+	uint64_t busy_ns;
+	/** Time (ns) the core has been idle */
+	uint64_t idle_ns;
+	/** Dispatch rounds that got events from the scheduler */
+	uint64_t rounds;
+	/** Dispatch rounds that got no events from the scheduler */
+	uint64_t empty_rounds;
+	/** Events received from the scheduler */
+	uint64_t events;
+} em_core_util_t;
+
+/**
+ * @brief Retrieve the utilization counters of an EM-core
+ *
+ * Can be called from any thread, the counters are read without locking.
+ *
+ * @param         core  EM-core id, 0 ... em_core_count() - 1
+ * @param[out]    util  Pointer to the utilization counters to fill
+ *
+ * @return EM_OK if successful
+ */
+em_status_t em_core_util(int core, em_core_util_t *util /*out*/);
+
+/**
+ * @brief Print the utilization of all EM-cores
+ */
+void em_core_util_print(void);
+
 /**
  * @}
  */
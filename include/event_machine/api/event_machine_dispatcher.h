@@ -243,6 +243,31 @@ typedef struct {
 	 */
 	bool sched_pause;
 
+	/**
+	 * Per queue priority event budgets, indexed by em_queue_prio_t.
+	 * Dispatch ends after the round in which the number of events
+	 * dispatched from queues of priority 'prio' reaches prio_budget[prio].
+	 * Bounds the work per priority in one call of em_dispatch_duration()
+	 * etc., in addition to the selected duration.
+	 *
+	 * 0: no budget for the priority (default)
+	 */
+	uint64_t prio_budget[EM_QUEUE_PRIO_NUM];
+
+	/**
+	 * Dispatch ends when only events of priority lower than 'stop_prio'
+	 * remain, i.e. after a dispatch round that got events from a queue of
+	 * priority < 'stop_prio' or no events at all. The scheduler serves the
+	 * higher priorities first, so such a round means there was no event of
+	 * priority >= 'stop_prio' available. The events of the lower priority
+	 * round have already been dispatched when the dispatch returns.
+	 * A round that only dispatched local queue events or deferred calls
+	 * (em_defer()) does not end dispatch.
+	 *
+	 * EM_QUEUE_PRIO_UNDEF: not used (default)
+	 */
+	em_queue_prio_t stop_prio;
+
 	/**
 	 * Internal check - don't touch!
 	 *
@@ -276,9 +301,18 @@ typedef struct {
 	uint64_t ns;
 
 	/**
-	 * The number of events that were dispatched.
+	 * The number of events that were dispatched, including the events
+	 * from local queues and the deferred calls (em_defer()).
 	 */
 	uint64_t events;
+
+	/**
+	 * The number of events that were dispatched per queue priority,
+	 * indexed by em_queue_prio_t. Events from local queues are counted by
+	 * the priority of the local queue, deferred calls by the priority
+	 * given to em_defer_prio().
+	 */
+	uint64_t prio_events[EM_QUEUE_PRIO_NUM];
 } em_dispatch_results_t;
 
 /**
@@ -644,6 +678,63 @@ em_dispatch_register_exit_cb(em_dispatch_exit_func_t func);
 em_status_t
 em_dispatch_unregister_exit_cb(em_dispatch_exit_func_t func);
 
+/**
+ * Deferred function, see em_defer()
+ */
+typedef void (*em_defer_func_t)(void *arg);
+
+/**
+ * @brief Call a function on this EM-core after the current event
+ *
+ * Queues the call 'fn(arg)' into a fixed-size core-local ring, no event is
+ * allocated. The dispatcher runs the pending calls when it next checks the
+ * local queues: after the EO receive function returns, before any local
+ * queue events, or in the next dispatch round. Calls of a higher priority run
+ * first, calls of the same priority in the order they were deferred.
+ *
+ * The dispatcher only runs the calls pending when it starts running them:
+ * calls deferred meanwhile, also by a deferred function, run the next time.
+ * A deferred function can thus defer itself again without stalling dispatch.
+ *
+ * The call runs in the dispatcher, outside of the EO receive function but
+ * within the scheduling context of the event being dispatched unless already
+ * ended. Can be called from an EO receive function or a deferred function on
+ * an EM-core, not from threads that do not dispatch.
+ *
+ * Calls still pending when the core calls em_term_core() are run there, before
+ * the core-local resources are released, so that resources owned by 'arg' are
+ * not leaked. Calls deferred by those are run too, for a bounded number of
+ * passes; calls still pending after that are dropped and em_term_core() reports
+ * an error.
+ *
+ * @param fn    Function to call
+ * @param arg   Argument passed to 'fn'
+ * @param prio  Priority: EM_QUEUE_PRIO_LOWEST ... EM_QUEUE_PRIO_HIGHEST
+ *
+ * @return EM_OK if successful
+ * @retval EM_ERR_TOO_LARGE if EM_DEFER_RING_SIZE calls of the priority are
+ *         already pending on this core
+ *
+ * @see em_defer()
+ */
+em_status_t
+em_defer_prio(em_defer_func_t fn, void *arg, em_queue_prio_t prio);
+
+/**
+ * @brief Call a function on this EM-core after the current event
+ *
+ * Same as em_defer_prio() with priority EM_QUEUE_PRIO_NORMAL.
+ *
+ * @param fn    Function to call
+ * @param arg   Argument passed to 'fn'
+ *
+ * @return EM_OK if successful
+ *
+ * @see em_defer_prio()
+ */
+em_status_t
+em_defer(em_defer_func_t fn, void *arg);
+
 /**
  * @}
  */
@@ -959,6 +959,59 @@ em_eo_queue_get_first(unsigned int *num, em_eo_t eo);
 em_queue_t
 em_eo_queue_get_next(void);
 
+/**
+ * em_yield_until() timeout: wait for the event without a timeout
+ */
+#define EM_YIELD_FOREVER  UINT64_MAX
+
+/**
+ * @brief Run the receive function of an EO as a coroutine
+ *
+ * The receive function of a coroutine EO runs on its own stack taken from a
+ * core-local pool (EM_CORO_MAX_PER_CORE coroutines of EM_CORO_STACK_SIZE
+ * bytes) and may call em_yield_until() to wait for an event without blocking
+ * the EM-core. Only EOs created with em_eo_create() are supported.
+ *
+ * Must be called before queues are added to the EO and before the EO is
+ * started.
+ *
+ * @param eo  EO handle
+ *
+ * @return EM_OK if successful
+ */
+em_status_t
+em_eo_coro_enable(em_eo_t eo);
+
+/**
+ * @brief Park the coroutine until an event arrives or the timeout expires
+ *
+ * Called from the receive function of a coroutine EO. Returns at once if an
+ * event is available in 'queue', otherwise ends the current atomic or ordered
+ * scheduling context (as em_atomic_processing_end() or
+ * em_ordered_processing_end()), parks the coroutine and returns to the
+ * dispatcher. The dispatcher continues with other events, also from the same
+ * EO queue, and resumes the coroutine on the same EM-core when an event has
+ * arrived into 'queue' or 'timeout_ns' has passed. The timeout is checked
+ * every dispatch round, a scheduler wait (dispatch.sched_wait_ns or
+ * em_dispatch_opt_t::wait_ns) is cut short at the nearest timeout of the
+ * parked coroutines on the core.
+ *
+ * The dispatch of the original event is complete from the dispatcher's point
+ * of view when the coroutine parks: the dispatch exit callbacks are called and
+ * the event group count is decremented. The resumed coroutine runs without a
+ * scheduling context and without an event group.
+ *
+ * @param queue       Unscheduled queue to wait on, the reply queue of a
+ *                    request, or EM_QUEUE_UNDEF to only wait for the timeout
+ * @param timeout_ns  Max time (ns) to wait, EM_YIELD_FOREVER for no timeout
+ *                    or 0 to only check 'queue'
+ *
+ * @return The event dequeued from 'queue' or EM_EVENT_UNDEF on timeout, error
+ *         or if the EO's queue was disabled or deleted meanwhile
+ */
+em_event_t
+em_yield_until(em_queue_t queue, uint64_t timeout_ns);
+
 /**
  * @}
  */
@@ -312,6 +312,70 @@ void *em_event_pointer(em_event_t event);
  */
 uint32_t em_event_get_size(em_event_t event);
 
+/**
+ * @brief Get the headroom of a packet event
+ *
+ * The headroom is the space in front of the event payload that can be taken
+ * into use with em_event_push_head() without copying, e.g. for encapsulation.
+ * Packet pools reserve a minimum headroom, see the config file option
+ * 'pool.pkt_headroom' and em_pool_cfg_t::pkt.headroom.
+ *
+ * @param event  Packet event
+ *
+ * @return The headroom in bytes, 0 for other than packet events
+ */
+uint32_t em_event_headroom(em_event_t event);
+
+/**
+ * @brief Move the start of the packet event payload into the headroom
+ *
+ * Extends the payload by 'len' bytes at the head without copying, the
+ * payload size (em_event_get_size()) grows by 'len' and em_event_pointer()
+ * returns the new payload start. The event handle does not change.
+ *
+ * @param event  Packet event
+ * @param len    Bytes to extend, must be <= em_event_headroom()
+ *
+ * @return Pointer to the new start of the payload or NULL on error
+ */
+void *em_event_push_head(em_event_t event, uint32_t len);
+
+/**
+ * @brief Move the start of the packet event payload into the payload
+ *
+ * The counterpart of em_event_push_head(): removes 'len' bytes from the head
+ * of the payload, e.g. for decapsulation. The removed bytes become headroom.
+ *
+ * @param event  Packet event
+ * @param len    Bytes to remove, must be < em_event_get_size()
+ *
+ * @return Pointer to the new start of the payload or NULL on error
+ */
+void *em_event_pull_head(em_event_t event, uint32_t len);
+
+/**
+ * @brief Extend the packet event payload at the head, beyond the headroom
+ *
+ * Like em_event_push_head() as long as the headroom suffices. Otherwise new
+ * segment(s) are prepended from the pool of the packet, the existing payload
+ * is not copied (unless the ODP implementation needs to, e.g. for a pool that
+ * does not support segmentation). The EM event header and user area stay
+ * with the event.
+ *
+ * The event handle may change when segments are prepended, the new handle is
+ * stored into '*event' and the old handle must not be used anymore.
+ * After a segment prepend, em_event_pointer() and em_event_get_size() cover
+ * only the first segment, i.e. at least the 'len' new bytes. Use the ODP
+ * packet APIs to access the rest of the payload.
+ *
+ * @param[in,out] event  Packet event, updated if the handle changes
+ * @param         len    Bytes to extend the payload with
+ *
+ * @return Pointer to the new start of the payload or NULL on error,
+ *         '*event' is unchanged on error
+ */
+void *em_event_extend_head(em_event_t *event /*in/out*/, uint32_t len);
+
 /**
  * @brief Returns the EM event-pool the event was allocated from.
  *
@@ -337,6 +401,8 @@ em_pool_t em_event_get_pool(em_event_t event);
  *
  * @note Vector events must always have their major type set to
  *       EM_EVENT_TYPE_VECTOR or EM will not recognize them as vectors.
+ * @note The major types EM_EVENT_TYPE_TIMER_IND and EM_EVENT_TYPE_IMMEDIATE
+ *       are reserved for EM and are rejected with EM_ERR_BAD_ARG.
  *
  * @param event         Event handle
  * @param newtype	New type for the event
@@ -1072,6 +1138,44 @@ typedef struct {
 em_status_t em_event_vector_info(em_event_t vector_event,
 				 em_event_vector_info_t *vector_info /*out*/);
 
+/**
+ * @brief Send an immediate event to a local queue
+ *
+ * An immediate event carries a payload of up to EM_EVENT_IMM_DATA_MAX
+ * (47 bits) in the event handle itself: no event is allocated and there is no
+ * event header. The EO receive function of the local queue is called with
+ * event type EM_EVENT_TYPE_IMMEDIATE, read the payload with
+ * em_event_imm_data(). Immediate and normal events sent to the same local
+ * queue are received in the order they were sent.
+ *
+ * The immediate event is only valid during the receive call and must not be
+ * freed, sent or passed to any other event API. It does not belong to an
+ * event group, is not passed to the dispatch enter/exit callbacks and is not
+ * counted in the queue statistics.
+ *
+ * @note Only queues of type EM_QUEUE_TYPE_LOCAL are supported, of EOs with a
+ *       single-event receive function. Other queue types are rejected with
+ *       EM_ERR_NOT_SUPPORTED. Not allowed from an EO start function.
+ *
+ * @param data   Payload, 0 ... EM_EVENT_IMM_DATA_MAX
+ * @param queue  Local queue
+ *
+ * @return EM_OK if successful
+ * @retval EM_ERR_TOO_LARGE if 'data' is larger than EM_EVENT_IMM_DATA_MAX
+ *
+ * @see em_event_imm_data()
+ */
+em_status_t em_send_imm(uint64_t data, em_queue_t queue);
+
+/**
+ * @brief Read the payload of an immediate event
+ *
+ * @param event  Event of type EM_EVENT_TYPE_IMMEDIATE, see em_send_imm()
+ *
+ * @return The payload given to em_send_imm(), 0 on error
+ */
+uint64_t em_event_imm_data(em_event_t event);
+
 /**
  * @}
  */
@@ -490,6 +490,79 @@ int em_queue_get_index(em_queue_t queue);
  */
 int em_queue_get_num_prio(int *num_runtime);
 
+/**
+ * Number of buckets in the queue sojourn time histogram,
+ * see em_queue_stats_t::sojourn_hist[]
+ */
+#define EM_QUEUE_STATS_HIST_BUCKETS  24
+
+/**
+ * Queue statistics
+ *
+ * Collected when the config file option 'queue.statistics' is enabled.
+ * EM stores the enqueue time into each event sent with em_send...() and
+ * measures the sojourn time, i.e. the time the event waited in the queue, when
+ * the event is dispatched or dequeued. Events enqueued bypassing em_send...(),
+ * e.g. packets from pktin event queues or em_odp_pkt_enqueue() and timeout
+ * indications from the timer, carry no enqueue time and are only counted in
+ * 'dequeued_ext'.
+ *
+ * The counters are updated by all cores without locking, the values read
+ * while sending or receiving are thus approximate.
+ */
+typedef struct {
+	/** Events sent into the queue */
+	uint64_t enqueued;
+	/** Events sent into the queue and since dispatched or dequeued */
+	uint64_t dequeued;
+	/** Events dispatched or dequeued that were not sent via em_send...() */
+	uint64_t dequeued_ext;
+	/** Estimated queue depth: 'enqueued - dequeued' */
+	uint64_t depth;
+	/** Average sojourn time (ns) */
+	uint64_t sojourn_avg_ns;
+	/** Max sojourn time (ns) */
+	uint64_t sojourn_max_ns;
+	/**
+	 * Sojourn time histogram, the number of events per time range:
+	 * [0]: < 1024 ns,
+	 * [i]: 2^(9+i) ... 2^(10+i)-1 ns, i = 1 ... EM_QUEUE_STATS_HIST_BUCKETS-2
+	 * [EM_QUEUE_STATS_HIST_BUCKETS-1]: >= 2^(8+EM_QUEUE_STATS_HIST_BUCKETS) ns
+	 */
+	uint64_t sojourn_hist[EM_QUEUE_STATS_HIST_BUCKETS];
+} em_queue_stats_t;
+
+/**
+ * @brief Retrieve statistics about an EM queue
+ *
+ * @param         queue  EM queue handle
+ * @param[out]    stats  Pointer to queue statistics to fill
+ *
+ * @return EM_OK if successful
+ * @retval EM_ERR_NOT_IMPLEMENTED if the queue statistics are not enabled in
+ *         the EM config file (option 'queue.statistics')
+ */
+em_status_t em_queue_stats(em_queue_t queue, em_queue_stats_t *stats /*out*/);
+
+/**
+ * @brief Reset the statistics of an EM queue to zero
+ *
+ * Events sent before the reset are counted in 'dequeued' when received, the
+ * estimated depth is 0 until new events have been sent.
+ *
+ * @param queue  EM queue handle
+ *
+ * @return EM_OK if successful
+ */
+em_status_t em_queue_stats_reset(em_queue_t queue);
+
+/**
+ * @brief Print the statistics of an EM queue
+ *
+ * @param queue  EM queue handle
+ */
+void em_queue_stats_print(em_queue_t queue);
+
 /**
  * @}
  */
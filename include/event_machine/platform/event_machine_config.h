@@ -200,6 +200,24 @@ extern "C" {
 #define EM_IDLE_HOOKS_ENABLE  0
 #endif
 
+/**
+ * @def EM_TRACE_ENABLE
+ * Compile in the EM event trace points
+ *
+ * EM records dispatch enter/exit, send, alloc, free, timeout and empty
+ * schedule round events into per core trace rings when tracing has been
+ * switched on, see config/em-odp.conf option 'trace.enable' and the EM CLI
+ * command 'em_trace'. A disabled trace point costs one load and a branch,
+ * set to 0 to remove the trace points completely.
+ *
+ * @note em-odp: the 'EM_TRACE_ENABLE' value can be overridden by a
+ *               command-line option to the 'configure' script, e.g.:
+ *               $build> ../configure ... --disable-trace
+ */
+#ifndef EM_TRACE_ENABLE
+#define EM_TRACE_ENABLE  1
+#endif
+
 /**
  * @def EM_SCHED_WAIT_ENABLE
  * Enable the EM dispatcher/scheduler to start waiting for events if none are
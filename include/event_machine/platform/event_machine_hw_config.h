@@ -260,6 +260,34 @@ extern "C" {
  */
 #define EM_OUTPUT_QUEUE_IMMEDIATE 0
 
+/**
+ * @def EM_OUTPUT_ORDER_LOCK_BUF
+ * Max number of events per core buffered for output queues during an ordered
+ * context with an ordered lock, see EM_QUEUE_FLAG_ORDER_LOCK
+ */
+#define EM_OUTPUT_ORDER_LOCK_BUF  128
+
+/**
+ * @def EM_CORO_MAX_PER_CORE
+ * Max number of coroutines per EM-core running or parked in the receive
+ * function of a coroutine EO, see em_eo_coro_enable()
+ */
+#define EM_CORO_MAX_PER_CORE  16
+
+/**
+ * @def EM_CORO_STACK_SIZE
+ * Stack size (bytes) of a coroutine, allocated when first used. Rounded up to
+ * whole pages, an inaccessible guard page below the stack catches overflows.
+ */
+#define EM_CORO_STACK_SIZE  (64 * 1024)
+
+/**
+ * @def EM_DEFER_RING_SIZE
+ * Max number of pending deferred calls per queue priority per EM-core,
+ * see em_defer(). Must be a power of two.
+ */
+#define EM_DEFER_RING_SIZE  64
+
 #ifdef __cplusplus
 }
 #endif
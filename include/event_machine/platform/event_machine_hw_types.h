@@ -71,7 +71,8 @@ typedef enum em_event_type_major_e {
 	EM_EVENT_TYPE_TIMER      = 3 << 24, /**< Timer event */
 	EM_EVENT_TYPE_CRYPTO     = 4 << 24, /**< Crypto event */
 	EM_EVENT_TYPE_VECTOR     = 5 << 24, /**< Event contains a (packet) vector */
-	EM_EVENT_TYPE_TIMER_IND  = 6 << 24  /**< Read-only no payload timeout notification */
+	EM_EVENT_TYPE_TIMER_IND  = 6 << 24, /**< Read-only no payload timeout notification */
+	EM_EVENT_TYPE_IMMEDIATE  = 7 << 24  /**< No buffer, payload in the handle (em_send_imm()) */
 } em_event_type_major_e;
 
 /**
@@ -82,6 +83,14 @@ typedef enum em_event_type_sw_minor_e {
 	EM_EVENT_TYPE_SW_DEFAULT = 0
 } em_event_type_sw_minor_e;
 
+/**
+ * Max payload of an immediate event (EM_EVENT_TYPE_IMMEDIATE): 47 bits,
+ * carried in the event handle.
+ *
+ * @see em_send_imm()
+ */
+#define EM_EVENT_IMM_DATA_MAX  UINT64_C(0x7fffffffffff)
+
 /**
  * Queue types
  */
@@ -211,6 +220,40 @@ typedef enum em_queue_prio_e {
  **/
 #define EM_QUEUE_FLAG_DEQ_NOT_MTSAFE  8
 
+/**
+ * @def EM_QUEUE_FLAG_ORDER_LOCK
+ *
+ * em_queue_flag_t value (system specific). Only combine flags with bitwise OR.
+ *
+ * Only for queues of type EM_QUEUE_TYPE_PARALLEL_ORDERED: the ODP queue is
+ * created with an ordered lock. Events sent to output queues from the ordered
+ * context of the queue are buffered core-locally instead of being reordered
+ * through an ODP queue. At the end of the ordered context, or on
+ * em_ordered_processing_end(), the buffered events are passed to the output
+ * functions (em_output_func_t) while holding the ordered lock, i.e. in the
+ * order of the source queue. At most EM_OUTPUT_ORDER_LOCK_BUF events can be
+ * buffered per ordered context, sends beyond that fail.
+ * Queue creation will fail if set and not supported.
+ */
+#define EM_QUEUE_FLAG_ORDER_LOCK  16
+
+/**
+ * @def EM_QUEUE_FLAG_INLINE
+ *
+ * em_queue_flag_t value (system specific). Only combine flags with bitwise OR.
+ *
+ * Only for queues of type EM_QUEUE_TYPE_PARALLEL: events sent to the queue
+ * from an EO receive function are, when possible, dispatched on the sending
+ * core right after the receive function returns instead of going through the
+ * scheduler, like events sent to a queue of type EM_QUEUE_TYPE_LOCAL. This is
+ * done when the core belongs to the queue group of the queue and the sender
+ * is not in an ordered context, otherwise the events are scheduled normally.
+ * The destination receive function runs within the scheduling context of the
+ * sender. Events that do not fit in the core-local queues are scheduled.
+ * Queue creation will fail if set for other queue types.
+ */
+#define EM_QUEUE_FLAG_INLINE  32
+
 /**
  * EM core mask.
  * Each bit represents one core, core 0 is the lsb (1 << em_core_id())
@@ -459,6 +502,11 @@ typedef struct {
  * EM error scope: terminate an Event Machine core
  */
 #define EM_ESCOPE_TERM_CORE                  (EM_ESCOPE_INTERNAL_MASK | 0x0005)
+/**
+ * @def EM_ESCOPE_CORE_UTIL
+ * EM error scope: read the utilization counters of an EM core
+ */
+#define EM_ESCOPE_CORE_UTIL                  (EM_ESCOPE_INTERNAL_MASK | 0x0006)
 
 /**
  * @def EM_ESCOPE_POOL_CFG_INIT
@@ -535,6 +583,16 @@ typedef struct {
  * EM error scope: event pool number of subpools
  */
 #define EM_ESCOPE_POOL_NUM_SUBPOOLS           (EM_ESCOPE_INTERNAL_MASK | 0x010F)
+/**
+ * @def EM_ESCOPE_POOL_WMARK_SET
+ * EM error scope: set event pool occupancy watermarks
+ */
+#define EM_ESCOPE_POOL_WMARK_SET              (EM_ESCOPE_INTERNAL_MASK | 0x0110)
+/**
+ * @def EM_ESCOPE_POOL_WMARK_CLEAR
+ * EM error scope: clear event pool occupancy watermarks
+ */
+#define EM_ESCOPE_POOL_WMARK_CLEAR            (EM_ESCOPE_INTERNAL_MASK | 0x0111)
 /**
  * @def EM_ESCOPE_HOOKS_REGISTER_ALLOC
  * EM error scope: register API callback hook for em_alloc()
@@ -607,6 +665,52 @@ typedef struct {
  * EM error scope: send event(s) to another device
  */
 #define EM_ESCOPE_EVENT_SEND_DEVICE_MULTI    (EM_ESCOPE_INTERNAL_MASK | 0x0302)
+/**
+ * @def EM_ESCOPE_EVENT_HEADROOM
+ * EM error scope: get the headroom of a packet event
+ */
+#define EM_ESCOPE_EVENT_HEADROOM             (EM_ESCOPE_INTERNAL_MASK | 0x0303)
+/**
+ * @def EM_ESCOPE_EVENT_PUSH_HEAD
+ * EM error scope: move the packet event payload start into the headroom
+ */
+#define EM_ESCOPE_EVENT_PUSH_HEAD            (EM_ESCOPE_INTERNAL_MASK | 0x0304)
+/**
+ * @def EM_ESCOPE_EVENT_PULL_HEAD
+ * EM error scope: move the packet event payload start into the payload
+ */
+#define EM_ESCOPE_EVENT_PULL_HEAD            (EM_ESCOPE_INTERNAL_MASK | 0x0305)
+/**
+ * @def EM_ESCOPE_EVENT_EXTEND_HEAD
+ * EM error scope: extend the packet event payload at the head
+ */
+#define EM_ESCOPE_EVENT_EXTEND_HEAD          (EM_ESCOPE_INTERNAL_MASK | 0x0306)
+
+/**
+ * @def EM_ESCOPE_EO_CORO_ENABLE
+ * EM error scope: run the EO receive function as a coroutine
+ */
+#define EM_ESCOPE_EO_CORO_ENABLE             (EM_ESCOPE_INTERNAL_MASK | 0x0401)
+/**
+ * @def EM_ESCOPE_YIELD_UNTIL
+ * EM error scope: park a coroutine EO until an event arrives or a timeout
+ */
+#define EM_ESCOPE_YIELD_UNTIL                (EM_ESCOPE_INTERNAL_MASK | 0x0402)
+/**
+ * @def EM_ESCOPE_DEFER
+ * EM error scope: defer a function call on this core
+ */
+#define EM_ESCOPE_DEFER                      (EM_ESCOPE_INTERNAL_MASK | 0x0403)
+/**
+ * @def EM_ESCOPE_SEND_IMM
+ * EM error scope: send an immediate event to a local queue
+ */
+#define EM_ESCOPE_SEND_IMM                   (EM_ESCOPE_INTERNAL_MASK | 0x0404)
+/**
+ * @def EM_ESCOPE_EVENT_IMM_DATA
+ * EM error scope: read the payload of an immediate event
+ */
+#define EM_ESCOPE_EVENT_IMM_DATA             (EM_ESCOPE_INTERNAL_MASK | 0x0405)
 
 /**
  * @def EM_ESCOPE_EVENT_GROUP_UPDATE
@@ -620,6 +724,8 @@ typedef struct {
 #define EM_ESCOPE_QUEUE_DISABLE              (EM_ESCOPE_INTERNAL_MASK | 0x0603)
 #define EM_ESCOPE_QUEUE_DISABLE_ALL          (EM_ESCOPE_INTERNAL_MASK | 0x0604)
 #define EM_ESCOPE_QUEUE_STATE_CHANGE         (EM_ESCOPE_INTERNAL_MASK | 0x0605)
+#define EM_ESCOPE_QUEUE_STATS                (EM_ESCOPE_INTERNAL_MASK | 0x0606)
+#define EM_ESCOPE_QUEUE_STATS_RESET          (EM_ESCOPE_INTERNAL_MASK | 0x0607)
 
 /* EM internal escopes: Queue Groups */
 #define EM_ESCOPE_QUEUE_GROUP_INIT           (EM_ESCOPE_INTERNAL_MASK | 0x0701)
@@ -277,6 +277,28 @@ odp_schedule_group_t em_odp_qgrp2odp(em_queue_group_t queue_group);
 int em_odp_pkt_enqueue(const odp_packet_t pkt_tbl[/*num*/], int num,
 		       em_queue_t queue);
 
+/**
+ * Enqueue external packets into EM, each packet with its own destination
+ *
+ * Like em_odp_pkt_enqueue() but 'queue_tbl[i]' is the destination of
+ * 'pkt_tbl[i]'. The packets that need their EM event headers initialized
+ * before the enqueue are initialized in one pass, after which each run of
+ * consecutive packets with the same destination queue is enqueued with one
+ * multi-enqueue. Group the packets by destination for the best performance.
+ * Packets that could not be enqueued are freed.
+ *
+ * @param pkt_tbl    Array of external ODP-packets to enqueue into EM as events.
+ *                   The 'pkt_tbl[]' array must contain 'num' valid ODP packet
+ *                   handles.
+ * @param queue_tbl  Array of destination EM queues, 'queue_tbl[i]' for
+ *                   'pkt_tbl[i]'.
+ * @param num        The number of entries in 'pkt_tbl[]' and 'queue_tbl[]'.
+ *
+ * @return The number of ODP packets successfully send/enqueued as EM-events
+ */
+int em_odp_pkt_enqueue_multi(const odp_packet_t pkt_tbl[/*num*/],
+			     const em_queue_t queue_tbl[/*num*/], int num);
+
 /**
  * @brief Get the odp timer_pool from EM timer handle
  *
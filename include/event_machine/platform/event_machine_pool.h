@@ -866,6 +866,86 @@ int em_pool_subpool_stats_selected(em_pool_t pool, const int subpools[], int num
 void em_pool_subpool_stats_selected_print(em_pool_t pool, const int subpools[],
 					  int num_subpools, const em_pool_stats_opt_t *opt);
 
+/**
+ * Pool watermark crossed, see em_pool_wmark_func_t
+ */
+typedef enum {
+	/** The number of free events dropped below 'em_pool_wmark_param_t::low' */
+	EM_POOL_WMARK_LOW = 1,
+	/** The number of free events recovered to 'em_pool_wmark_param_t::high' */
+	EM_POOL_WMARK_HIGH = 2
+} em_pool_wmark_t;
+
+/**
+ * Pool watermark callback function
+ *
+ * Called on the EM-core whose em_alloc/free...() or dispatch of a received
+ * packet sampled the crossing, i.e. on the fast path: keep it short, e.g. set
+ * a load shedding flag or send a pre-allocated notification event.
+ *
+ * @param pool       EM pool handle
+ * @param wmark      Watermark crossed
+ * @param num_free   Number of free events in the pool (estimate)
+ * @param arg        User argument, see em_pool_wmark_param_t::arg
+ */
+typedef void (*em_pool_wmark_func_t)(em_pool_t pool, em_pool_wmark_t wmark,
+				     uint32_t num_free, void *arg);
+
+/**
+ * Pool watermark parameters, see em_pool_wmark_set()
+ */
+typedef struct {
+	/** Call 'func' with EM_POOL_WMARK_LOW when free events < 'low' */
+	uint32_t low;
+	/**
+	 * Call 'func' with EM_POOL_WMARK_HIGH when free events >= 'high' after
+	 * EM_POOL_WMARK_LOW, 'high' >= 'low'. The gap avoids repeated
+	 * notifications when the occupancy oscillates around 'low'.
+	 */
+	uint32_t high;
+	/** Watermark callback function */
+	em_pool_wmark_func_t func;
+	/** User argument passed to 'func' */
+	void *arg;
+} em_pool_wmark_param_t;
+
+/**
+ * @brief Set occupancy watermarks for an EM pool
+ *
+ * Get notified via a callback when the number of free events in the pool drops
+ * below a threshold, e.g. to start shedding load before em_alloc() fails, and
+ * again when the pool has recovered.
+ *
+ * The number of free events is read from the ODP pool statistics, the pool
+ * must have the 'available' statistics enabled, preferably also
+ * 'cache_available' to count the events in the core-local pool caches as
+ * free. Both are disabled by default: enable them with 'pool.statistics' in
+ * the EM config file for all pools, or for this pool with
+ * 'em_pool_cfg_t::stats_opt' given to em_pool_create().
+ *
+ * The statistics are sampled on the fast path, once per 64 operations on the
+ * pool on a core: em_alloc...(), em_event_clone...(), em_free...() and packets
+ * received by pktin into the pool. Events allocated or freed outside of EM,
+ * e.g. packets transmitted and freed by ODP pktio, are included in the
+ * sampled value.
+ *
+ * @param pool   EM pool handle
+ * @param param  Watermark parameters
+ *
+ * @return EM_OK if successful
+ * @retval EM_ERR_NOT_SUPPORTED if the pool has no 'available' statistics
+ */
+em_status_t em_pool_wmark_set(em_pool_t pool, const em_pool_wmark_param_t *param);
+
+/**
+ * @brief Clear the occupancy watermarks of an EM pool
+ *
+ * @param pool   EM pool handle
+ *
+ * @return EM_OK if successful
+ */
+em_status_t em_pool_wmark_clear(em_pool_t pool);
+
 /**
  * @}
  */
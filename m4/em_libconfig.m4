@@ -3,7 +3,7 @@
 ##########################################################################
 m4_define([_em_config_version_generation], [0])
 m4_define([_em_config_version_major], [0])
-m4_define([_em_config_version_minor], [19])
+m4_define([_em_config_version_minor], [22])
 
 m4_define([_em_config_version],
 	  [_em_config_version_generation._em_config_version_major._em_config_version_minor])
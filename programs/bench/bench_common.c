@@ -10,6 +10,7 @@
 
 #include "bench_common.h"
 #include <signal.h>
+#include <string.h>
 
 /* Break worker loop if set to 1 */
 odp_atomic_u32_t exit_thread;
@@ -61,110 +62,651 @@ static void run_indef(const bench_info_t *bench)
 	}
 }
 
+int init_bench_results(run_bench_arg_t *args)
+{
+	const int num_workers = args->opt.num_workers;
+	const size_t result_size = sizeof(bench_result_t) * (num_workers + 1) * args->num_bench;
+	const size_t hist_size = sizeof(bench_hist_t) * (num_workers + 1);
+	void *addr;
+
+	args->result_shm = odp_shm_reserve("shm_bench_results", result_size + hist_size,
+					   ODP_CACHE_LINE_SIZE, 0);
+	if (args->result_shm == ODP_SHM_INVALID) {
+		ODPH_ERR("Result shared mem reserve failed\n");
+		return -1;
+	}
+
+	addr = odp_shm_addr(args->result_shm);
+	if (addr == NULL) {
+		ODPH_ERR("Result shared mem alloc failed\n");
+		return -1;
+	}
+	memset(addr, 0, result_size + hist_size);
+
+	args->core_result = addr;
+	args->aggr_result = &args->core_result[num_workers * args->num_bench];
+	args->hist = (bench_hist_t *)((uint8_t *)addr + result_size);
+
+	odp_barrier_init(&args->barrier, num_workers);
+	odp_atomic_init_u32(&args->worker_count, 0);
+	odp_atomic_init_u32(&args->stop, 0);
+	odp_atomic_init_u32(&args->workers_done, 0);
+	odp_atomic_init_u32(&args->release, 0);
+
+	return 0;
+}
+
+int term_bench_results(run_bench_arg_t *args)
+{
+	if (args->result_shm == ODP_SHM_INVALID)
+		return 0;
+
+	if (odp_shm_free(args->result_shm)) {
+		ODPH_ERR("Result shared mem free failed\n");
+		return -1;
+	}
+
+	args->result_shm = ODP_SHM_INVALID;
+	args->core_result = NULL;
+	args->aggr_result = NULL;
+	args->hist = NULL;
+
+	return 0;
+}
+
+/* Index of the calling worker: 0 ... num_workers - 1 */
+static __thread int worker_idx;
+
+int bench_worker_idx(void)
+{
+	return worker_idx;
+}
+
+/*
+ * Synchronize all workers before a test case so that they run it at the same
+ * time. Returns non-zero if the workers should stop. The stop decision is
+ * taken by worker 0 between two barriers so that all workers see the same one.
+ */
+static int sync_workers(run_bench_arg_t *args)
+{
+	if (args->opt.num_workers < 2)
+		return odp_atomic_load_u32(&exit_thread);
+
+	odp_barrier_wait(&args->barrier);
+	if (worker_idx == 0)
+		odp_atomic_store_u32(&args->stop, odp_atomic_load_u32(&exit_thread));
+	odp_barrier_wait(&args->barrier);
+
+	return odp_atomic_load_u32(&args->stop);
+}
+
+/* Wait until all workers are done with the tests and dispatch in dispatch_until_released() */
+void wait_workers(run_bench_arg_t *args)
+{
+	while (odp_atomic_load_u32(&args->workers_done) < (uint32_t)args->opt.num_workers)
+		odp_time_wait_ns(ODP_TIME_MSEC_IN_NS);
+}
+
+void release_workers(run_bench_arg_t *args)
+{
+	odp_atomic_store_u32(&args->release, 1);
+}
+
+/*
+ * Dispatch the events left in the queues and then keep serving EM until the
+ * control core calls release_workers(). EM sync-APIs called by the control
+ * core, e.g. em_eo_stop_sync(), wait for all EM cores to respond.
+ */
+static void dispatch_until_released(run_bench_arg_t *args)
+{
+	em_dispatch_duration_t duration;
+	em_dispatch_opt_t opt;
+
+	em_dispatch_opt_init(&opt);
+	/* Also dispatch the events pre-scheduled to this core */
+	opt.sched_pause = true;
+
+	memset(&duration, 0, sizeof(duration));
+	duration.select = EM_DISPATCH_DURATION_NO_EVENTS_ROUNDS;
+	duration.no_events.rounds = DRAIN_ROUNDS;
+	(void)em_dispatch_duration(&duration, &opt, NULL);
+
+	odp_atomic_inc_u32(&args->workers_done);
+
+	while (!odp_atomic_load_u32(&args->release))
+		(void)em_dispatch_rounds(DRAIN_ROUNDS, &opt, NULL);
+}
+
+static inline int hist_idx(uint64_t val)
+{
+	int msb, idx;
+
+	if (val < HIST_SUB)
+		return (int)val;
+
+	msb = 63 - __builtin_clzll(val);
+	if (msb > HIST_MAX_BITS)
+		return HIST_BUCKETS - 1;
+
+	idx = (msb - HIST_SUB_BITS + 1) * HIST_SUB +
+	      (int)((val >> (msb - HIST_SUB_BITS)) & (HIST_SUB - 1));
+
+	return idx < HIST_BUCKETS ? idx : HIST_BUCKETS - 1;
+}
+
+/* Middle value of a histogram bucket */
+static uint64_t hist_value(int idx)
+{
+	int shift;
+
+	if (idx < HIST_SUB)
+		return idx;
+
+	shift = idx / HIST_SUB - 1;
+
+	return ((uint64_t)(HIST_SUB + idx % HIST_SUB) << shift) + ((1ULL << shift) >> 1);
+}
+
+static inline void hist_add(bench_hist_t *hist, uint64_t val)
+{
+	hist->bucket[hist_idx(val)]++;
+	hist->count++;
+	if (val < hist->min)
+		hist->min = val;
+	if (val > hist->max)
+		hist->max = val;
+}
+
+static void hist_reset(bench_hist_t *hist)
+{
+	memset(hist, 0, sizeof(*hist));
+	hist->min = UINT64_MAX;
+}
+
+static void hist_merge(bench_hist_t *dst, const bench_hist_t *src)
+{
+	for (int i = 0; i < HIST_BUCKETS; i++)
+		dst->bucket[i] += src->bucket[i];
+
+	dst->count += src->count;
+	if (src->min < dst->min)
+		dst->min = src->min;
+	if (src->max > dst->max)
+		dst->max = src->max;
+}
+
+/* Nearest-rank percentile, accurate to the bucket width */
+static double hist_percentile(const bench_hist_t *hist, uint32_t pct)
+{
+	uint64_t rank = (hist->count * pct + 99) / 100;
+	uint64_t sum = 0;
+
+	if (rank == 0)
+		rank = 1;
+
+	for (int i = 0; i < HIST_BUCKETS; i++) {
+		sum += hist->bucket[i];
+		if (sum >= rank) {
+			uint64_t val = hist_value(i);
+
+			/* Bucket middle value may be outside of the samples */
+			if (val < hist->min)
+				val = hist->min;
+			if (val > hist->max)
+				val = hist->max;
+			return (double)val;
+		}
+	}
+
+	return (double)hist->max;
+}
+
+/* Per-call latency sampling state of the calling worker */
+typedef struct {
+	/* Histogram of the running test case */
+	bench_hist_t *hist;
+
+	/* Timestamp before the sampled call */
+	uint64_t start;
+
+	/* Cost of the sampling itself, subtracted from the samples */
+	uint64_t overhead;
+
+	/* Timestamps in nsec vs CPU cycles */
+	int meas_time;
+
+} sample_loc_t;
+
+__thread int bench_sampling;
+
+static __thread sample_loc_t sample_loc;
+
+static inline uint64_t sample_timestamp(void)
+{
+	if (sample_loc.meas_time)
+		return odp_time_local_strict_ns();
+
+	return odp_cpu_cycles();
+}
+
+/*
+ * Sampling path of BENCH_LOOP(): record the call before 'i' and timestamp
+ * the start of call 'i'. The histogram update is outside of the timed part.
+ */
+int bench_loop_sample(int i, int num)
+{
+	if (i > 0) {
+		const uint64_t end = sample_timestamp();
+		const uint64_t start = sample_loc.start;
+		uint64_t diff;
+
+		diff = sample_loc.meas_time ? end - start : odp_cpu_cycles_diff(end, start);
+		hist_add(sample_loc.hist, diff > sample_loc.overhead ?
+			 diff - sample_loc.overhead : 0);
+	}
+
+	if (i < num) {
+		sample_loc.start = sample_timestamp();
+		return 1;
+	}
+
+	return 0;
+}
+
+/* Number of empty loop iterations timed for the sampling overhead */
+#define CALIBRATION_CALLS 1000
+
+/*
+ * Calibrate the sampling overhead, i.e. the minimum sample of an empty
+ * BENCH_LOOP(), with the histogram 'hist' as scratch space
+ */
+static void sample_calibrate(bench_hist_t *hist, int meas_time)
+{
+	int i;
+
+	hist_reset(hist);
+	sample_loc.hist = hist;
+	sample_loc.overhead = 0;
+	sample_loc.meas_time = meas_time;
+
+	bench_sampling = 1;
+	for (i = 0; BENCH_LOOP(i, CALIBRATION_CALLS); i++)
+		;
+	bench_sampling = 0;
+
+	sample_loc.overhead = hist->min;
+}
+
+static void bench_name(const bench_info_t *bench, char *name/*out*/, size_t len)
+{
+	if (bench->desc != NULL)
+		snprintf(name, len, "%s", bench->desc);
+	else
+		snprintf(name, len, "em_%s", bench->name);
+}
+
+/* Number of API function calls per round */
+static uint32_t bench_repeat(const bench_info_t *bench)
+{
+	return bench->repeat_count ? bench->repeat_count : REPEAT_COUNT;
+}
+
+/* Per-call latency percentiles of a histogram into a result */
+static void hist_result(const bench_hist_t *hist, bench_result_t *res/*out*/)
+{
+	res->samples = hist->count;
+	if (!hist->count)
+		return;
+
+	res->p50 = hist_percentile(hist, 50);
+	res->p99 = hist_percentile(hist, 99);
+	res->max = (double)hist->max;
+}
+
+/* Combine the results of all workers for test case 'j', called by worker 0 */
+static void aggregate_results(run_bench_arg_t *args, int j, uint32_t rounds)
+{
+	const int num_workers = args->opt.num_workers;
+	bench_result_t *aggr = &args->aggr_result[j];
+	bench_hist_t *merged = &args->hist[num_workers];
+	double avg = 0.0;
+	double mops = 0.0;
+
+	hist_reset(merged);
+
+	/* All workers are waiting at the next barrier, their histograms are stable */
+	for (int w = 0; w < num_workers; w++) {
+		const bench_result_t *res = &args->core_result[w * args->num_bench + j];
+
+		avg += res->avg;
+		mops += res->mops;
+		hist_merge(merged, &args->hist[w]);
+	}
+
+	aggr->avg = avg / num_workers;
+	hist_result(merged, aggr);
+	aggr->mops = mops;
+	aggr->rounds = rounds;
+
+	args->result[j] = aggr->avg;
+}
+
+static void print_result(const run_bench_arg_t *args, int j)
+{
+	const bench_result_t *aggr = &args->aggr_result[j];
+	char name[64];
+
+	bench_name(&args->bench[j], name, sizeof(name));
+
+	printf("[%02d] %-50s: %12.2f %10.2f %10.2f %10.2f %10.2f\n", j + 1, name,
+	       aggr->avg, aggr->p50, aggr->p99, aggr->max, aggr->mops);
+
+	if (args->opt.num_workers < 2)
+		return;
+
+	for (int w = 0; w < args->opt.num_workers; w++) {
+		const bench_result_t *res = &args->core_result[w * args->num_bench + j];
+
+		printf("       core %-43d: %12.2f %10.2f %10.2f %10.2f %10.2f\n", w,
+		       res->avg, res->p50, res->p99, res->max, res->mops);
+	}
+}
+
+/*
+ * Run 'rounds' rounds of a test case, adding the time or CPU cycles of the
+ * run() calls to 'total' and their time to 'total_ns'. Returns the number of
+ * rounds run, less than 'rounds' if the test case failed.
+ */
+static uint32_t run_rounds(const bench_info_t *bench, uint32_t rounds, int meas_time,
+			   uint64_t *total/*out*/, uint64_t *total_ns/*out*/)
+{
+	uint64_t c1 = 0, c2 = 0;
+	odp_time_t t1, t2;
+	uint32_t round;
+
+	for (round = 0; round < rounds; round++) {
+		uint64_t ns;
+		int ok;
+
+		if (bench->init)
+			bench->init();
+
+		/* Time is always measured for the throughput */
+		t1 = odp_time_local();
+		if (!meas_time)
+			c1 = odp_cpu_cycles();
+
+		ok = bench->run();
+
+		if (!meas_time)
+			c2 = odp_cpu_cycles();
+		t2 = odp_time_local();
+
+		if (!ok)
+			break;
+
+		if (bench->term)
+			bench->term();
+
+		ns = odp_time_diff_ns(t2, t1);
+		*total += meas_time ? ns : odp_cpu_cycles_diff(c2, c1);
+		*total_ns += ns;
+	}
+
+	return round;
+}
+
+/* Run 'rounds' rounds of a test case with each API call timestamped into 'hist' */
+static uint32_t sample_rounds(const bench_info_t *bench, uint32_t rounds, int meas_time,
+			      bench_hist_t *hist)
+{
+	uint64_t total = 0, total_ns = 0;
+	uint32_t ret;
+
+	sample_loc.hist = hist;
+	bench_sampling = 1;
+	ret = run_rounds(bench, rounds, meas_time, &total, &total_ns);
+	bench_sampling = 0;
+
+	return ret;
+}
+
 int run_benchmarks(void *arg)
 {
 	int i, j;
-	uint64_t c1 = 0, c2 = 0;
-	odp_time_t t1 = ODP_TIME_NULL, t2 = ODP_TIME_NULL;
 	run_bench_arg_t *args = arg;
 	cmd_opt_t *opt = &args->opt;
 	const int meas_time = opt->time;
+	const int num_workers = opt->num_workers;
+	bench_hist_t *hist;
 	int ret = 0;
 
+	worker_idx = odp_atomic_fetch_inc_u32(&args->worker_count);
+	hist = &args->hist[worker_idx];
+
 	/* Init EM */
 	if (em_init_core() != EM_OK) {
 		ODPH_ERR("EM core init failed\n");
+		odp_atomic_inc_u32(&args->workers_done);
 		return -1;
 	}
 
-	printf("\nAverage %s per function call\n", meas_time ? "time (nsec)" : "CPU cycles");
-	printf("------------------------------------------------------\n");
+	sample_calibrate(hist, meas_time);
 
-	/* Run each test twice. Results from the first warm-up round are ignored. */
-	for (i = 0; i < 2; i++) {
-		uint64_t total = 0;
-		uint32_t round = 1;
+	if (worker_idx == 0) {
+		printf("\n%s per function call on %d core(s)\n",
+		       meas_time ? "Time (nsec)" : "CPU cycles", num_workers);
+		printf("p50/p99/max: latency of single calls, each timestamped separately in extra\n"
+		       "sampling rounds (timestamp overhead of %" PRIu64 " %s subtracted)\n",
+		       sample_loc.overhead, meas_time ? "nsec" : "cycles");
+		printf("Throughput in Mcalls/s\n");
+		printf("-------------------------------------------------------------------------"
+		       "--------------------------------------\n");
+		printf("%-55s  %12s %10s %10s %10s %10s\n", "", "avg", "p50", "p99",
+		       "max", "Mcalls/s");
+	}
 
-		for (j = 0; j < args->num_bench && !odp_atomic_load_u32(&exit_thread); round++) {
-			int ret;
-			const char *desc;
+	/*
+	 * Run each test twice. Results from the first warm-up round are ignored.
+	 * The measured rounds are followed by the per-call sampling rounds, which
+	 * are kept apart so that the timestamps do not add to the averages.
+	 */
+	for (i = 0; i < 2; i++) {
+		for (j = 0; j < args->num_bench; j++) {
 			const bench_info_t *bench = &args->bench[j];
+			const uint32_t repeat = bench_repeat(bench);
+			bench_result_t *res = &args->core_result[worker_idx * args->num_bench + j];
 			uint32_t max_rounds = opt->rounds;
+			uint64_t total = 0, total_ns = 0;
+			uint32_t round;
 
 			if (bench->max_rounds && max_rounds > bench->max_rounds)
 				max_rounds = bench->max_rounds;
 
 			/* Run selected test indefinitely */
 			if (opt->bench_idx) {
-				if ((j + 1) != opt->bench_idx) {
-					j++;
+				if ((j + 1) != opt->bench_idx)
 					continue;
-				}
 
 				run_indef(bench);
 				goto exit;
 			}
 
-			desc = bench->desc != NULL ? bench->desc : bench->name;
-
-			if (bench->init)
-				bench->init();
+			if (sync_workers(args))
+				goto exit;
 
-			if (meas_time)
-				t1 = odp_time_local();
-			else
-				c1 = odp_cpu_cycles();
+			hist_reset(hist);
 
-			ret = bench->run();
+			round = run_rounds(bench, max_rounds, meas_time, &total, &total_ns);
+			if (round == max_rounds && i > 0)
+				round = sample_rounds(bench, max_rounds, meas_time, hist);
 
-			if (meas_time)
-				t2 = odp_time_local();
-			else
-				c2 = odp_cpu_cycles();
+			if (round < max_rounds) {
+				char name[64];
 
-			if (!ret) {
-				ODPH_ERR("Benchmark %s failed\n", desc);
+				bench_name(bench, name, sizeof(name));
+				ODPH_ERR("Benchmark %s failed\n", name);
 				args->bench_failed = -1;
 				ret = -1;
-				goto exit;
+				/* Let the other workers stop at the next test case */
+				odp_atomic_store_u32(&exit_thread, 1);
+			} else {
+				res->avg = ((double)total) / ((uint64_t)max_rounds * repeat);
+				hist_result(hist, res);
+				res->mops = total_ns ?
+					((double)max_rounds * repeat * 1000) / total_ns : 0;
+				res->rounds = max_rounds;
 			}
 
-			if (bench->term)
-				bench->term();
-
-			if (meas_time)
-				total += odp_time_diff_ns(t2, t1);
-			else
-				total += odp_cpu_cycles_diff(c2, c1);
-
-			if (round >= max_rounds) {
-				/* Each benchmark runs internally REPEAT_COUNT times. */
-				args->result[j] = ((double)total) / (max_rounds * REPEAT_COUNT);
+			/* Also a failed worker waits here to keep the barriers in step */
+			if (num_workers > 1)
+				odp_barrier_wait(&args->barrier);
 
+			if (worker_idx == 0 && !args->bench_failed) {
+				aggregate_results(args, j, max_rounds);
 				/* No print from warm-up round */
-				if (i > 0) {
-					if (bench->desc != NULL)
-						printf("[%02d] %-50s: %12.2f\n", j + 1, desc,
-						       args->result[j]);
-					else
-						printf("[%02d] em_%-47s: %12.2f\n", j + 1, desc,
-						       args->result[j]);
-				}
-
-				j++;
-				total = 0;
-				round = 1;
+				if (i > 0)
+					print_result(args, j);
 			}
 		}
 	}
 
 exit:
+	if (args->keep_dispatching)
+		dispatch_until_released(args);
+
 	if (em_term_core() != EM_OK)
 		ODPH_ERR("EM core terminate failed\n");
 
 	return ret;
 }
 
+int parse_output_format(const char *format, cmd_opt_t *opt/*out*/)
+{
+	if (!strcmp(format, "json"))
+		opt->output_csv = 0;
+	else if (!strcmp(format, "csv"))
+		opt->output_csv = 1;
+	else
+		return -1;
+
+	return 0;
+}
+
+static void write_result_json(FILE *file, const bench_result_t *res)
+{
+	fprintf(file, "\"avg\": %.2f, \"p50\": %.2f, \"p99\": %.2f, \"max\": %.2f, "
+		"\"mcalls_per_sec\": %.3f, \"rounds\": %" PRIu32 ", \"samples\": %" PRIu64,
+		res->avg, res->p50, res->p99, res->max, res->mops, res->rounds, res->samples);
+}
+
+static void write_results_json(FILE *file, const char *prog_name, const char *time_str,
+			       const run_bench_arg_t *args)
+{
+	const int num_workers = args->opt.num_workers;
+	int first = 1;
+
+	fprintf(file, "{\n"
+		"  \"program\": \"%s\",\n"
+		"  \"date\": \"%s\",\n"
+		"  \"unit\": \"%s\",\n"
+		"  \"workers\": %d,\n"
+		"  \"repeat_count\": %d,\n"
+		"  \"results\": [",
+		prog_name, time_str, args->opt.time ? "nsec" : "cycles", num_workers,
+		REPEAT_COUNT);
+
+	for (int j = 0; j < args->num_bench; j++) {
+		const bench_result_t *aggr = &args->aggr_result[j];
+		char name[64];
+
+		if (!aggr->rounds)
+			continue;
+
+		bench_name(&args->bench[j], name, sizeof(name));
+		fprintf(file, "%s\n    {\"index\": %d, \"name\": \"%s\", "
+			"\"repeat_count\": %" PRIu32 ", ",
+			first ? "" : ",", j + 1, name, bench_repeat(&args->bench[j]));
+		write_result_json(file, aggr);
+		fprintf(file, ",\n     \"cores\": [");
+
+		for (int w = 0; w < num_workers; w++) {
+			fprintf(file, "%s{\"core\": %d, ", w ? ", " : "", w);
+			write_result_json(file, &args->core_result[w * args->num_bench + j]);
+			fprintf(file, "}");
+		}
+		fprintf(file, "]}");
+		first = 0;
+	}
+
+	fprintf(file, "\n  ]\n}\n");
+}
+
+static void write_result_csv(FILE *file, const char *prog_name, const char *time_str,
+			     int j, const char *name, const char *core,
+			     const bench_result_t *res)
+{
+	fprintf(file, "%s,%s,%d,\"%s\",%s,%.2f,%.2f,%.2f,%.2f,%.3f,%" PRIu64 "\n", prog_name,
+		time_str, j + 1, name, core, res->avg, res->p50, res->p99, res->max, res->mops,
+		res->samples);
+}
+
+static void write_results_csv(FILE *file, const char *prog_name, const char *time_str,
+			      const run_bench_arg_t *args)
+{
+	const int num_workers = args->opt.num_workers;
+
+	fprintf(file, "Program,Date,Index,Name,Core,Avg(%s),P50,P99,Max,Mcalls/s,Samples\n",
+		args->opt.time ? "nsec" : "cycles");
+
+	for (int j = 0; j < args->num_bench; j++) {
+		const bench_result_t *aggr = &args->aggr_result[j];
+		char name[64];
+
+		if (!aggr->rounds)
+			continue;
+
+		bench_name(&args->bench[j], name, sizeof(name));
+		write_result_csv(file, prog_name, time_str, j, name, "all", aggr);
+
+		if (num_workers < 2)
+			continue;
+
+		for (int w = 0; w < num_workers; w++) {
+			char core[16];
+
+			snprintf(core, sizeof(core), "%d", w);
+			write_result_csv(file, prog_name, time_str, j, name, core,
+					 &args->core_result[w * args->num_bench + j]);
+		}
+	}
+}
+
+/* Write the per-core and aggregate results to the file given with --output */
+void write_results(const char *prog_name, const run_bench_arg_t *args)
+{
+	FILE *file;
+	char time_str[72] = {0};
+
+	if (args->opt.output == NULL || args->aggr_result == NULL)
+		return;
+
+	fill_time_str(time_str);
+
+	file = fopen(args->opt.output, "w");
+	if (file == NULL) {
+		perror("Failed to open the output file");
+		return;
+	}
+
+	if (args->opt.output_csv)
+		write_results_csv(file, prog_name, time_str, args);
+	else
+		write_results_json(file, prog_name, time_str, args);
+
+	fclose(file);
+}
+
 void fill_time_str(char *time_str/*out*/)
 {
 	time_t t;
@@ -176,3 +718,358 @@ void fill_time_str(char *time_str/*out*/)
 	sprintf(time_str, "%d-%d-%d-%d:%d:%d", tm.tm_year + 1900, tm.tm_mon + 1,
 		tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
 }
+
+/* Print usage information */
+static void usage(const bench_suite_t *suite)
+{
+	printf("\n"
+	       "%s\n"
+	       "\n"
+	       "Options:\n"
+	       "  -t, --time <opt>        Time measurement.\n"
+	       "                          0: measure CPU cycles (default)\n"
+	       "                          1: measure time\n"
+	       "  -i, --index <idx>       Benchmark index to run indefinitely.\n"
+	       "  -r, --rounds <num>      Run each test case 'num' times (default %u).\n"
+	       "  -n, --num-workers <num> Run each test case on 'num' cores in parallel\n"
+	       "                          (default 1, max %d).\n"
+	       "  -o, --output <file>     Write per-core results and per-call percentiles\n"
+	       "                          to 'file'.\n"
+	       "  -f, --format <fmt>      Output file format: json (default) or csv.\n",
+	       suite->desc, ROUNDS, MAX_WORKERS);
+
+	if (suite->usage)
+		suite->usage();
+
+	printf("  -h, --help              Display help and exit.\n\n"
+	       "\n");
+}
+
+/* Parse command line arguments */
+static int parse_args(int argc, char *argv[], const bench_suite_t *suite,
+		      cmd_opt_t *cmd_opt/*out*/)
+{
+	int opt;
+	int long_index;
+	int num_opts = 0;
+	char shortopts[64];
+	struct option longopts[8 + MAX_SUITE_OPTS] = {
+		{"time", required_argument, NULL, 't'},
+		{"index", required_argument, NULL, 'i'},
+		{"rounds", required_argument, NULL, 'r'},
+		{"num-workers", required_argument, NULL, 'n'},
+		{"output", required_argument, NULL, 'o'},
+		{"format", required_argument, NULL, 'f'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	snprintf(shortopts, sizeof(shortopts), "t:i:r:n:o:f:h%s",
+		 suite->shortopts ? suite->shortopts : "");
+
+	/* Append the program specific long options before the terminating entry */
+	while (longopts[num_opts].name != NULL)
+		num_opts++;
+	for (int i = 0; suite->longopts && suite->longopts[i].name != NULL; i++) {
+		if (i == MAX_SUITE_OPTS) {
+			ODPH_ERR("Too many program specific options\n");
+			return -1;
+		}
+		longopts[num_opts++] = suite->longopts[i];
+	}
+
+	cmd_opt->time = 0; /* Measure CPU cycles */
+	cmd_opt->bench_idx = 0; /* Run all benchmarks */
+	cmd_opt->rounds = ROUNDS;
+	cmd_opt->write_csv = 0;
+	cmd_opt->num_workers = 1;
+	cmd_opt->output = NULL;
+	cmd_opt->output_csv = 0;
+
+	while (1) {
+		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 't':
+			cmd_opt->time = atoi(optarg);
+			break;
+		case 'i':
+			cmd_opt->bench_idx = atoi(optarg);
+			break;
+		case 'r':
+			cmd_opt->rounds = atoi(optarg);
+			break;
+		case 'n':
+			cmd_opt->num_workers = atoi(optarg);
+			break;
+		case 'o':
+			cmd_opt->output = optarg;
+			break;
+		case 'f':
+			if (parse_output_format(optarg, cmd_opt)) {
+				ODPH_ERR("Bad output format: %s\n", optarg);
+				return -1;
+			}
+			break;
+		case 'h':
+			usage(suite);
+			return 1;
+		default:
+			if (opt != '?' && suite->parse_opt && !suite->parse_opt(opt, optarg))
+				break;
+			ODPH_ERR("Bad option. Use -h for help.\n");
+			return -1;
+		}
+	}
+
+	if (cmd_opt->rounds < 1) {
+		ODPH_ERR("Invalid test cycle repeat count: %u\n", cmd_opt->rounds);
+		return -1;
+	}
+
+	if (cmd_opt->bench_idx < 0 || cmd_opt->bench_idx > suite->num_bench) {
+		ODPH_ERR("Bad bench index %i\n", cmd_opt->bench_idx);
+		return -1;
+	}
+
+	if (cmd_opt->num_workers < 1 || cmd_opt->num_workers > MAX_WORKERS) {
+		ODPH_ERR("Invalid number of workers: %d (max %d)\n",
+			 cmd_opt->num_workers, MAX_WORKERS);
+		return -1;
+	}
+
+	if (suite->check_opts && suite->check_opts())
+		return -1;
+
+	optind = 1; /* Reset 'extern optind' from the getopt lib */
+
+	return 0;
+}
+
+/* Print system and application info */
+static void print_info(const char *cpumask_str, const cmd_opt_t *com_opt,
+		       const bench_suite_t *suite)
+{
+	const int len = (int)strlen(suite->name) + (int)strlen(" options");
+
+	odp_sys_info_print();
+
+	printf("\n"
+	       "%s options\n"
+	       "%.*s\n", suite->name, len,
+	       "------------------------------------------------------------");
+
+	printf("Worker CPU mask:   %s\n", cpumask_str);
+	printf("Measurement unit:  %s\n", com_opt->time ? "nsec" : "CPU cycles");
+	printf("Test rounds:       %u\n", com_opt->rounds);
+	printf("Worker cores:      %d\n", com_opt->num_workers);
+	if (suite->print_info)
+		suite->print_info();
+	printf("\n");
+}
+
+/*
+ * Common main() of the benchmark programs: initialize ODP and EM, run the
+ * test cases of 'suite' on the worker cores and write the results.
+ */
+int bench_main(int argc, char *argv[], const bench_suite_t *suite)
+{
+	em_conf_t conf;
+	cmd_opt_t cmd_opt;
+	em_pool_cfg_t pool_conf;
+	em_core_mask_t core_mask;
+	odph_helper_options_t helper_options;
+	odph_thread_t worker_thread[MAX_WORKERS];
+	odph_thread_common_param_t thr_common;
+	odph_thread_param_t thr_param;
+	odp_shm_t shm;
+	odp_cpumask_t worker_mask;
+	odp_instance_t instance;
+	odp_init_t init_param;
+	run_bench_arg_t *args;
+	double *result;
+	int num_workers;
+	size_t shm_size;
+	char cpumask_str[ODP_CPUMASK_STR_SIZE];
+	int ret = 0;
+
+	/* Let helper collect its own arguments (e.g. --odph_proc) */
+	argc = odph_parse_options(argc, argv);
+	if (odph_options(&helper_options)) {
+		ODPH_ERR("Reading ODP helper options failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Parse and store the application arguments */
+	ret = parse_args(argc, argv, suite, &cmd_opt);
+	if (ret)
+		exit(EXIT_FAILURE);
+
+	result = calloc(suite->num_bench, sizeof(double));
+	if (result == NULL) {
+		ODPH_ERR("Result table alloc failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odp_init_param_init(&init_param);
+	init_param.mem_model = helper_options.mem_model;
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(&instance, &init_param, NULL)) {
+		ODPH_ERR("Global init failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(instance, ODP_THREAD_CONTROL)) {
+		ODPH_ERR("Local init failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odp_schedule_config(NULL);
+
+	/* Get worker CPUs */
+	num_workers = cmd_opt.num_workers;
+	if (odp_cpumask_default_worker(&worker_mask, num_workers) != num_workers) {
+		ODPH_ERR("Unable to allocate %d worker threads\n", num_workers);
+		ret = -1;
+		goto odp_term;
+	}
+	(void)odp_cpumask_to_str(&worker_mask, cpumask_str, ODP_CPUMASK_STR_SIZE);
+
+	print_info(cpumask_str, &cmd_opt, suite);
+
+	/* Init EM */
+	em_core_mask_zero(&core_mask);
+	em_core_mask_set(odp_cpu_id(), &core_mask);
+	odp_cpumask_or(&core_mask.odp_cpumask, &core_mask.odp_cpumask, &worker_mask);
+	if (odp_cpumask_count(&core_mask.odp_cpumask) != num_workers + 1) {
+		ret = -1;
+		goto odp_term;
+	}
+
+	suite->pool_config(&pool_conf, num_workers);
+
+	em_conf_init(&conf);
+	if (helper_options.mem_model == ODP_MEM_MODEL_PROCESS)
+		conf.process_per_core = 1;
+	else
+		conf.thread_per_core = 1;
+	conf.default_pool_cfg = pool_conf;
+	conf.core_count = num_workers + 1;
+	conf.phys_mask = core_mask;
+	conf.event_timer = suite->event_timer;
+
+	if (em_init(&conf) != EM_OK) {
+		ODPH_ERR("EM init failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (em_init_core() != EM_OK) {
+		ODPH_ERR("EM core init failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (setup_sig_handler()) {
+		ODPH_ERR("Signal handler setup failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Reserve memory for args from shared mem */
+	shm_size = suite->data_size + num_workers * suite->worker_size;
+	shm = odp_shm_reserve("shm_args", shm_size, ODP_CACHE_LINE_SIZE, 0);
+	if (shm == ODP_SHM_INVALID) {
+		ODPH_ERR("Shared mem reserve failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	args = odp_shm_addr(shm);
+	if (args == NULL) {
+		ODPH_ERR("Shared mem alloc failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odp_atomic_init_u32(&exit_thread, 0);
+
+	memset(args, 0, shm_size);
+	args->bench = suite->bench;
+	args->num_bench = suite->num_bench;
+	args->opt = cmd_opt;
+	args->result = result;
+	args->keep_dispatching = suite->keep_dispatching;
+	args->result_shm = ODP_SHM_INVALID;
+
+	if (init_bench_results(args))
+		exit(EXIT_FAILURE);
+
+	if (suite->init(args))
+		exit(EXIT_FAILURE);
+
+	memset(worker_thread, 0, sizeof(worker_thread));
+
+	odph_thread_common_param_init(&thr_common);
+	thr_common.instance = instance;
+	thr_common.cpumask = &worker_mask;
+	thr_common.share_param = 1;
+
+	odph_thread_param_init(&thr_param);
+	thr_param.start = run_benchmarks;
+	thr_param.arg = args;
+	thr_param.thr_type = ODP_THREAD_WORKER;
+
+	odph_thread_create(worker_thread, &thr_common, &thr_param, num_workers);
+
+	/* Tear down while the workers are still dispatching */
+	if (suite->keep_dispatching) {
+		wait_workers(args);
+		if (suite->term_dispatching && suite->term_dispatching())
+			ret = -1;
+		release_workers(args);
+	}
+
+	odph_thread_join(worker_thread, num_workers);
+
+	if (args->bench_failed)
+		ret = -1;
+
+	if (!ret)
+		write_results(suite->name, args);
+
+	if (suite->term && suite->term())
+		ret = -1;
+
+	if (term_bench_results(args))
+		ret = -1;
+
+	if (em_term_core() != EM_OK)
+		ODPH_ERR("EM core terminate failed\n");
+
+	if (em_term(&conf) != EM_OK)
+		ODPH_ERR("EM terminate failed\n");
+
+	if (odp_shm_free(shm)) {
+		ODPH_ERR("Shared mem free failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+odp_term:
+	if (odp_term_local()) {
+		ODPH_ERR("Local term failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global(instance)) {
+		ODPH_ERR("Global term failed\n");
+		exit(EXIT_FAILURE);
+	}
+
+	free(result);
+
+	if (ret < 0)
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
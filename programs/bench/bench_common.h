@@ -7,6 +7,7 @@
 #ifndef BENCH_COMMON_H
 #define BENCH_COMMON_H
 
+#include <getopt.h>
 #include <inttypes.h>
 #include <stdlib.h>
 #include <event_machine.h>
@@ -19,10 +20,41 @@
 /* Default number of rounds per test case */
 #define ROUNDS 1000u
 
+/* Empty dispatch rounds after which the queues of a test are considered drained */
+#define DRAIN_ROUNDS 100
+
+/* Maximum number of worker cores running the benchmarks in parallel */
+#define MAX_WORKERS 32
+
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 
 #define BENCH_INFO(run, init, term, max, name) \
-	{#run, run, init, term, max, name}
+	{#run, run, init, term, max, name, 0}
+
+/* Test case doing 'repeat' API function calls per round instead of REPEAT_COUNT */
+#define BENCH_INFO_REPEAT(run, init, term, max, name, repeat) \
+	{#run, run, init, term, max, name, repeat}
+
+/*
+ * Loop condition of the API call loop of a test function:
+ *	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
+ * It is evaluated before the first call and after each call. In the per-call
+ * sampling rounds every call is timestamped separately, otherwise this is
+ * just 'i < num'.
+ */
+#define BENCH_LOOP(i, num) \
+	(odp_likely(!bench_sampling) ? (i) < (num) : bench_loop_sample((i), (num)))
+
+/*
+ * Per-call latency histogram: values below 2^HIST_SUB_BITS have their own
+ * buckets, above that each power of two is split into 2^HIST_SUB_BITS linear
+ * buckets (max error 6.25%). Values beyond 2^HIST_MAX_BITS go into the last
+ * bucket.
+ */
+#define HIST_SUB_BITS  4
+#define HIST_SUB  (1 << HIST_SUB_BITS)
+#define HIST_MAX_BITS  40
+#define HIST_BUCKETS  ((HIST_MAX_BITS - HIST_SUB_BITS + 1) * HIST_SUB)
 
 /* Initialize benchmark resources */
 typedef void (*bench_init_fn_t)(void);
@@ -53,6 +85,9 @@ typedef struct {
 	/* Override default test name */
 	const char *desc;
 
+	/* Number of API function calls per round, 0: REPEAT_COUNT */
+	uint32_t repeat_count;
+
 } bench_info_t;
 
 /* Common command line options */
@@ -68,8 +103,50 @@ typedef struct {
 
 	/* Write result to a csv file(mainly used in CI) or not */
 	int write_csv;
+
+	/* Number of worker cores running each benchmark in parallel */
+	int num_workers;
+
+	/* Write per-core results and per-call percentiles to this file, or NULL */
+	const char *output;
+
+	/* Format of the output file: 0 = JSON, 1 = CSV */
+	int output_csv;
 } cmd_opt_t;
 
+/* Result of one test case on one worker core */
+typedef struct {
+	/* Average CPU cycles or nsec per function call */
+	double avg;
+
+	/* Per-call latency percentiles from the sampling rounds */
+	double p50;
+	double p99;
+	double max;
+
+	/* Throughput in millions of function calls per second */
+	double mops;
+
+	/* Number of measured rounds, 0 if the test case was not run */
+	uint32_t rounds;
+
+	/* Number of timestamped calls */
+	uint64_t samples;
+
+} bench_result_t;
+
+/* Per-call latencies of one test case, in CPU cycles or nsec */
+typedef struct {
+	uint64_t bucket[HIST_BUCKETS];
+
+	/* Number of samples */
+	uint64_t count;
+
+	uint64_t min;
+	uint64_t max;
+
+} bench_hist_t;
+
 typedef struct {
 	cmd_opt_t opt;
 
@@ -79,18 +156,134 @@ typedef struct {
 	/* Number of benchmark functions */
 	int num_bench;
 
-	/* Result of the test e.g. CPU cycles per run */
+	/* Result of the test e.g. CPU cycles per run, averaged over all workers */
 	double *result;
 
 	/* Benchmark run failed */
 	int bench_failed;
 
+	/* Per-core results, 'num_bench' entries per worker */
+	bench_result_t *core_result;
+
+	/* Results over all workers, 'num_bench' entries */
+	bench_result_t *aggr_result;
+
+	/*
+	 * Per-call latency histograms of the running test case, one per worker
+	 * plus the sum over all workers
+	 */
+	bench_hist_t *hist;
+
+	/* Shared memory for the results and histograms above */
+	odp_shm_t result_shm;
+
+	/* Keeps the workers in step, one test case at a time */
+	odp_barrier_t barrier;
+
+	/* Worker index allocation */
+	odp_atomic_u32_t worker_count;
+
+	/* Stop decision shared by all workers */
+	odp_atomic_u32_t stop;
+
+	/*
+	 * Workers keep dispatching after the tests until release_workers(),
+	 * needed when the control core uses EM sync-APIs in the teardown
+	 */
+	int keep_dispatching;
+
+	/* Number of workers done with the tests */
+	odp_atomic_u32_t workers_done;
+
+	/* Set by release_workers() */
+	odp_atomic_u32_t release;
+
 } run_bench_arg_t;
 
+/* Maximum number of program specific command line options of a suite */
+#define MAX_SUITE_OPTS 8
+
+/*
+ * Benchmark program run by bench_main(). The program data in shared memory
+ * starts with a run_bench_arg_t followed by the program global data, in
+ * total 'data_size' bytes, and then 'worker_size' bytes of data per worker.
+ */
+typedef struct {
+	/* Program name, e.g. "bench_queue" */
+	const char *name;
+
+	/* One line description for the usage information */
+	const char *desc;
+
+	/* Test cases */
+	bench_info_t *bench;
+	int num_bench;
+
+	/* Size of the shared program data and of the per worker data */
+	size_t data_size;
+	size_t worker_size;
+
+	/* Program specific command line options, e.g. "b:", or NULL */
+	const char *shortopts;
+
+	/* Long versions of 'shortopts', terminated by a zeroed entry */
+	const struct option *longopts;
+
+	/* Parse a program specific option, returns 0 on success */
+	int (*parse_opt)(int opt, const char *arg);
+
+	/* Check the program specific options after parsing, returns 0 on success */
+	int (*check_opts)(void);
+
+	/* Print the usage lines of the program specific options */
+	void (*usage)(void);
+
+	/* Print the values of the program specific options */
+	void (*print_info)(void);
+
+	/* Default EM pool configuration */
+	void (*pool_config)(em_pool_cfg_t *pool_conf/*out*/, int num_workers);
+
+	/* Enable the EM timer add-on */
+	int event_timer;
+
+	/*
+	 * Workers keep dispatching until term_dispatching() has been called,
+	 * see run_bench_arg_t::keep_dispatching
+	 */
+	int keep_dispatching;
+
+	/*
+	 * Create the program resources before the workers start. 'data' is the
+	 * zeroed shared program data with run_bench_arg_t already filled in.
+	 */
+	int (*init)(void *data);
+
+	/* Delete resources while the workers still dispatch, or NULL */
+	int (*term_dispatching)(void);
+
+	/* Delete resources after the workers have exited, or NULL */
+	int (*term)(void);
+
+} bench_suite_t;
+
 extern odp_atomic_u32_t exit_thread;
 
+/* Set on the worker during the per-call sampling rounds, see BENCH_LOOP() */
+extern __thread int bench_sampling;
+
+int bench_loop_sample(int i, int num);
+
 int setup_sig_handler(void);
+int init_bench_results(run_bench_arg_t *args);
+int term_bench_results(run_bench_arg_t *args);
 int run_benchmarks(void *arg);
+int bench_worker_idx(void);
+void wait_workers(run_bench_arg_t *args);
+void release_workers(run_bench_arg_t *args);
 void fill_time_str(char *time_str/*out*/);
+int parse_output_format(const char *format, cmd_opt_t *opt/*out*/);
+void write_results(const char *prog_name, const run_bench_arg_t *args);
+int bench_main(int argc, char *argv[], const bench_suite_t *suite);
 
 #endif /* BENCH_COMMON_H */
@@ -0,0 +1,477 @@
+/* Copyright (c) 2023, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+#include "bench_common.h"
+
+#include <event_machine/platform/event_machine_odp_ext.h>
+#include <string.h>
+
+/* Maximum number of test events per worker */
+#define MAX_EVENTS (REPEAT_COUNT * EM_SCHED_MULTI_MAX_BURST)
+
+/* Default event size */
+#define EVENT_SIZE 256
+
+/* Default dispatch burst size */
+#define BURST_SIZE 1
+
+/* Maximum number of retries */
+#define MAX_RETRY 1024
+
+/* Command line options specific to this dispatch bench */
+typedef struct {
+	/* Dispatch burst size, em_dispatch_opt_t::burst_size */
+	int burst_size;
+} dispatch_opt_t;
+
+/* Per worker test data */
+typedef struct {
+	/* Test case input data */
+	em_event_t event_tbl[MAX_EVENTS];
+
+	/* Number of deferred calls run, see deferred_fn() */
+	uint64_t defer_cnt;
+
+} thr_args_t;
+
+typedef struct {
+	run_bench_arg_t run_bench_arg;
+
+	dispatch_opt_t dispatch_opt;
+
+	/* Options given to em_dispatch_rounds() in the tests */
+	em_dispatch_opt_t em_dispatch_opt;
+
+	/* Started EO receiving the events, the receive function frees them */
+	em_eo_t eo;
+
+	/* Queues of the EO above, shared by all workers */
+	em_queue_t local_queue;
+	em_queue_t atomic_queue;
+	em_queue_t parallel_queue;
+	em_queue_t ordered_queue;
+
+	/* Test data of each worker, run_bench_arg.opt.num_workers entries */
+	thr_args_t thr[];
+
+} gbl_args_t;
+
+static gbl_args_t *gbl_args;
+
+/* Test data of the calling worker */
+static inline thr_args_t *thr_args(void)
+{
+	return &gbl_args->thr[bench_worker_idx()];
+}
+
+static em_status_t eo_start(void *eo_ctx ODP_UNUSED, em_eo_t eo ODP_UNUSED,
+			    const em_eo_conf_t *conf ODP_UNUSED)
+{
+	return EM_OK;
+}
+
+static em_status_t eo_stop(void *eo_ctx ODP_UNUSED, em_eo_t eo ODP_UNUSED)
+{
+	return EM_OK;
+}
+
+static void eo_receive(void *eo_ctx ODP_UNUSED, em_event_t event,
+		       em_event_type_t type, em_queue_t queue ODP_UNUSED,
+		       void *q_ctx ODP_UNUSED)
+{
+	/* Immediate events (em_send_imm()) have nothing to free */
+	if (type != EM_EVENT_TYPE_IMMEDIATE)
+		em_free(event);
+}
+
+static em_queue_t create_queue(const char *name, em_queue_type_t type,
+			       em_queue_group_t group)
+{
+	em_queue_conf_t conf;
+	em_queue_t queue;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.flags = EM_QUEUE_FLAG_DEFAULT;
+	/* All workers may send their test events into the same queue */
+	conf.min_events = gbl_args->run_bench_arg.opt.num_workers * REPEAT_COUNT *
+			  gbl_args->dispatch_opt.burst_size;
+
+	queue = em_queue_create(name, type, EM_QUEUE_PRIO_NORMAL, group, &conf);
+	if (queue == EM_QUEUE_UNDEF)
+		ODPH_ERR("EM queue %s create failed\n", name);
+
+	return queue;
+}
+
+/* Create and start the EO receiving the test events and its queues */
+static int create_eo(void)
+{
+	em_status_t err, start_err = EM_ERROR;
+	em_eo_t eo;
+
+	eo = em_eo_create("bench-dispatch-eo", eo_start, NULL, eo_stop, NULL,
+			  eo_receive, NULL);
+	if (eo == EM_EO_UNDEF) {
+		ODPH_ERR("EO create failed\n");
+		return -1;
+	}
+	gbl_args->eo = eo;
+
+	gbl_args->local_queue = create_queue("local-queue", EM_QUEUE_TYPE_LOCAL,
+					     EM_QUEUE_GROUP_UNDEF);
+	gbl_args->atomic_queue = create_queue("atomic-queue", EM_QUEUE_TYPE_ATOMIC,
+					      EM_QUEUE_GROUP_DEFAULT);
+	gbl_args->parallel_queue = create_queue("parallel-queue", EM_QUEUE_TYPE_PARALLEL,
+						EM_QUEUE_GROUP_DEFAULT);
+	gbl_args->ordered_queue = create_queue("ordered-queue", EM_QUEUE_TYPE_PARALLEL_ORDERED,
+					       EM_QUEUE_GROUP_DEFAULT);
+	if (gbl_args->local_queue == EM_QUEUE_UNDEF ||
+	    gbl_args->atomic_queue == EM_QUEUE_UNDEF ||
+	    gbl_args->parallel_queue == EM_QUEUE_UNDEF ||
+	    gbl_args->ordered_queue == EM_QUEUE_UNDEF)
+		return -1;
+
+	if (em_eo_add_queue_sync(eo, gbl_args->local_queue) != EM_OK ||
+	    em_eo_add_queue_sync(eo, gbl_args->atomic_queue) != EM_OK ||
+	    em_eo_add_queue_sync(eo, gbl_args->parallel_queue) != EM_OK ||
+	    em_eo_add_queue_sync(eo, gbl_args->ordered_queue) != EM_OK) {
+		ODPH_ERR("EO add queue failed\n");
+		return -1;
+	}
+
+	/* No local start function, the start completes on this core */
+	err = em_eo_start_sync(eo, &start_err, NULL);
+	if (err != EM_OK || start_err != EM_OK) {
+		ODPH_ERR("EO start failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Stop and delete the EO and its queues. Called while the workers keep
+ * dispatching, em_eo_stop_sync() needs all EM cores to respond.
+ */
+static int delete_eo(void)
+{
+	int ret = 0;
+
+	if (gbl_args->eo == EM_EO_UNDEF)
+		return 0;
+
+	if (em_eo_get_state(gbl_args->eo) == EM_EO_STATE_RUNNING &&
+	    em_eo_stop_sync(gbl_args->eo) != EM_OK) {
+		ODPH_ERR("EO stop failed\n");
+		ret = -1;
+	}
+
+	/* Also deletes the queues of the EO */
+	if (em_eo_delete(gbl_args->eo) != EM_OK) {
+		ODPH_ERR("EO delete failed\n");
+		ret = -1;
+	}
+	gbl_args->eo = EM_EO_UNDEF;
+
+	return ret;
+}
+
+static void allocate_test_events(em_event_t event[], int num)
+{
+	int num_events = 0;
+	int num_retries = 0;
+
+	while (num_events < num) {
+		int ret;
+
+		ret = em_alloc_multi(&event[num_events], num - num_events,
+				     EVENT_SIZE, EM_EVENT_TYPE_SW, EM_POOL_DEFAULT);
+		if (ret < 1) {
+			num_retries++;
+			if (ret < 0 || num_retries > MAX_RETRY)
+				ODPH_ABORT("Allocating test events failed\n");
+			continue;
+		}
+		num_retries = 0;
+		num_events += ret;
+	}
+}
+
+static void create_events(void)
+{
+	allocate_test_events(thr_args()->event_tbl, REPEAT_COUNT);
+}
+
+/* Queue 'burst_size' events per test round */
+static inline void create_send_events(em_queue_t queue)
+{
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	const int burst_size = gbl_args->dispatch_opt.burst_size;
+	int ret = 0;
+
+	allocate_test_events(event_tbl, REPEAT_COUNT * burst_size);
+
+	for (int i = 0; i < REPEAT_COUNT; i++)
+		ret += em_send_multi(&event_tbl[i * burst_size], burst_size, queue);
+	if (ret != REPEAT_COUNT * burst_size)
+		ODPH_ABORT("Sending test events failed\n");
+}
+
+static void create_send_atomic_events(void)
+{
+	create_send_events(gbl_args->atomic_queue);
+}
+
+static void create_send_parallel_events(void)
+{
+	create_send_events(gbl_args->parallel_queue);
+}
+
+static void create_send_ordered_events(void)
+{
+	create_send_events(gbl_args->ordered_queue);
+}
+
+/* Deferred call run by the dispatcher, see defer_dispatch() */
+static void deferred_fn(void *arg)
+{
+	uint64_t *defer_cnt = arg;
+
+	(*defer_cnt)++;
+}
+
+/* Dispatch the events left over from the test, the EO receive function frees them */
+static void dispatch_events(void)
+{
+	em_dispatch_duration_t duration;
+
+	memset(&duration, 0, sizeof(duration));
+	duration.select = EM_DISPATCH_DURATION_NO_EVENTS_ROUNDS;
+	duration.no_events.rounds = DRAIN_ROUNDS;
+
+	if (em_dispatch_duration(&duration, &gbl_args->em_dispatch_opt, NULL) != EM_OK)
+		ODPH_ABORT("Dispatching test events failed\n");
+}
+
+/**
+ * Test functions
+ */
+
+static int dispatch_rounds(void)
+{
+	const em_dispatch_opt_t *opt = &gbl_args->em_dispatch_opt;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_dispatch_rounds(1, opt, NULL);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+/* Local queue events are dispatched by the sending core, send one per round */
+static int send_dispatch_local(void)
+{
+	const em_dispatch_opt_t *opt = &gbl_args->em_dispatch_opt;
+	em_queue_t local_queue = gbl_args->local_queue;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_send(event_tbl[i], local_queue);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+		err = em_dispatch_rounds(1, opt, NULL);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+/*
+ * The local queue way to run a function on this core after the current event:
+ * allocate an event, send it to a local queue and dispatch, the EO receive
+ * function frees it. Compare with defer_dispatch().
+ */
+static int alloc_send_dispatch_local(void)
+{
+	const em_dispatch_opt_t *opt = &gbl_args->em_dispatch_opt;
+	em_queue_t local_queue = gbl_args->local_queue;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		em_event_t event = em_alloc(EVENT_SIZE, EM_EVENT_TYPE_SW, EM_POOL_DEFAULT);
+
+		if (unlikely(event == EM_EVENT_UNDEF))
+			return 0; /* error */
+		err = em_send(event, local_queue);
+		if (unlikely(err != EM_OK)) {
+			em_free(event);
+			return 0; /* error */
+		}
+		err = em_dispatch_rounds(1, opt, NULL);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+/* Immediate events carry the payload in the local queue entry, no events */
+static int send_imm_dispatch_local(void)
+{
+	const em_dispatch_opt_t *opt = &gbl_args->em_dispatch_opt;
+	em_queue_t local_queue = gbl_args->local_queue;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_send_imm(i, local_queue);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+		err = em_dispatch_rounds(1, opt, NULL);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+/* Deferred calls are run by the dispatcher of the deferring core, no events */
+static int defer_dispatch(void)
+{
+	const em_dispatch_opt_t *opt = &gbl_args->em_dispatch_opt;
+	uint64_t *defer_cnt = &thr_args()->defer_cnt;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_defer(deferred_fn, defer_cnt);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+		err = em_dispatch_rounds(1, opt, NULL);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+bench_info_t test_suite[] = {
+	BENCH_INFO(dispatch_rounds, NULL, NULL, 0,
+		   "em_dispatch_rounds(1): no events"),
+	BENCH_INFO(dispatch_rounds, create_send_atomic_events, dispatch_events, 0,
+		   "em_dispatch_rounds(1): atomic-Q"),
+	BENCH_INFO(dispatch_rounds, create_send_parallel_events, dispatch_events, 0,
+		   "em_dispatch_rounds(1): parallel-Q"),
+	BENCH_INFO(dispatch_rounds, create_send_ordered_events, dispatch_events, 0,
+		   "em_dispatch_rounds(1): parallel-ordered-Q"),
+	BENCH_INFO(send_dispatch_local, create_events, NULL, 0,
+		   "em_send+em_dispatch_rounds(1): local-Q"),
+	BENCH_INFO(alloc_send_dispatch_local, NULL, NULL, 0,
+		   "em_alloc+em_send+em_dispatch_rounds(1): local-Q"),
+	BENCH_INFO(send_imm_dispatch_local, NULL, NULL, 0,
+		   "em_send_imm+em_dispatch_rounds(1): local-Q"),
+	BENCH_INFO(defer_dispatch, NULL, NULL, 0,
+		   "em_defer+em_dispatch_rounds(1)"),
+};
+
+/* Command line options of this program, copied to gbl_args in init_bench() */
+static dispatch_opt_t dispatch_opt = {
+	.burst_size = BURST_SIZE
+};
+
+static const struct option dispatch_longopts[] = {
+	{"burst", required_argument, NULL, 'b'},
+	{NULL, 0, NULL, 0}
+};
+
+static void dispatch_usage(void)
+{
+	printf("  -b, --burst <num>       Dispatch burst size, events queued per dispatch\n"
+	       "                          round (default %d, max %d).\n",
+	       BURST_SIZE, EM_SCHED_MULTI_MAX_BURST);
+}
+
+static int dispatch_parse_opt(int opt, const char *arg)
+{
+	if (opt != 'b')
+		return -1;
+
+	dispatch_opt.burst_size = atoi(arg);
+	return 0;
+}
+
+static int dispatch_check_opts(void)
+{
+	if (dispatch_opt.burst_size < 1 ||
+	    dispatch_opt.burst_size > EM_SCHED_MULTI_MAX_BURST) {
+		ODPH_ERR("Invalid burst size: %d (max %d)\n",
+			 dispatch_opt.burst_size, EM_SCHED_MULTI_MAX_BURST);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void dispatch_print_info(void)
+{
+	printf("Burst size:        %d\n", dispatch_opt.burst_size);
+}
+
+static void init_default_pool_config(em_pool_cfg_t *pool_conf, int num_workers)
+{
+	em_pool_cfg_init(pool_conf);
+
+	pool_conf->event_type = EM_EVENT_TYPE_SW;
+	pool_conf->num_subpools = 1;
+	pool_conf->subpool[0].size = EVENT_SIZE;
+	/* Room also for the events not yet dispatched from the previous round */
+	pool_conf->subpool[0].num = 2 * REPEAT_COUNT * dispatch_opt.burst_size * num_workers;
+}
+
+/* Create the EO and its queues, 'data' is the shared program data */
+static int init_bench(void *data)
+{
+	gbl_args = data;
+	gbl_args->dispatch_opt = dispatch_opt;
+	gbl_args->eo = EM_EO_UNDEF;
+
+	em_dispatch_opt_init(&gbl_args->em_dispatch_opt);
+	gbl_args->em_dispatch_opt.burst_size = dispatch_opt.burst_size;
+
+	return create_eo();
+}
+
+static const bench_suite_t bench_suite = {
+	.name = "bench_dispatch",
+	.desc = "EM dispatcher micro benchmarks",
+	.bench = test_suite,
+	.num_bench = ARRAY_SIZE(test_suite),
+	.data_size = sizeof(gbl_args_t),
+	.worker_size = sizeof(thr_args_t),
+	.shortopts = "b:",
+	.longopts = dispatch_longopts,
+	.parse_opt = dispatch_parse_opt,
+	.check_opts = dispatch_check_opts,
+	.usage = dispatch_usage,
+	.print_info = dispatch_print_info,
+	.pool_config = init_default_pool_config,
+	/* Workers serve em_eo_stop_sync() in delete_eo() */
+	.keep_dispatching = 1,
+	.init = init_bench,
+	.term_dispatching = delete_eo,
+};
+
+int main(int argc, char *argv[])
+{
+	return bench_main(argc, argv, &bench_suite);
+}
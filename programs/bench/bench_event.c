@@ -47,16 +47,8 @@ typedef struct {
 	int vector_size;
 } event_opt_t;
 
+/* Per worker test data */
 typedef struct {
-	run_bench_arg_t run_bench_arg;
-
-	event_opt_t event_opt;
-
-	/* Pools for allocating test events */
-	em_pool_t sw_event_pool;
-	em_pool_t packet_pool;
-	em_pool_t vector_pool;
-
 	/* Test queues */
 	em_queue_t unsched_queue;
 
@@ -70,10 +62,31 @@ typedef struct {
 	em_pool_t        pool_tbl[MAX_EVENTS];
 	odp_event_t odp_event_tbl[MAX_EVENTS];
 
+} thr_args_t;
+
+typedef struct {
+	run_bench_arg_t run_bench_arg;
+
+	event_opt_t event_opt;
+
+	/* Pools for allocating test events */
+	em_pool_t sw_event_pool;
+	em_pool_t packet_pool;
+	em_pool_t vector_pool;
+
+	/* Test data of each worker, run_bench_arg.opt.num_workers entries */
+	thr_args_t thr[];
+
 } gbl_args_t;
 
 static gbl_args_t *gbl_args;
 
+/* Test data of the calling worker */
+static inline thr_args_t *thr_args(void)
+{
+	return &gbl_args->thr[bench_worker_idx()];
+}
+
 static int create_pools(void)
 {
 	em_pool_cfg_t pool_conf;
@@ -83,6 +96,8 @@ static int create_pools(void)
 	/* event_clone() and event_ref() tests require at least 2 x REPEAT_COUNT events */
 	num_events = gbl_args->event_opt.burst_size < 2 ? 2 * REPEAT_COUNT :
 			gbl_args->event_opt.burst_size * REPEAT_COUNT;
+	/* All workers allocate their test events from the same pools */
+	num_events *= gbl_args->run_bench_arg.opt.num_workers;
 
 	em_pool_cfg_init(&pool_conf);
 	pool_conf.event_type = EM_EVENT_TYPE_SW;
@@ -131,6 +146,7 @@ static int create_pools(void)
 	return 0;
 }
 
+/* Each worker gets its own unscheduled queue */
 static int create_queues(void)
 {
 	em_queue_t unsched_queue = EM_QUEUE_UNDEF;
@@ -141,46 +157,57 @@ static int create_queues(void)
 	conf.min_events = burst_size * REPEAT_COUNT;
 	conf.conf_len = 0;
 
-	unsched_queue = em_queue_create("unsch-queue", EM_QUEUE_TYPE_UNSCHEDULED,
-					EM_QUEUE_PRIO_UNDEF, EM_QUEUE_GROUP_UNDEF, &conf);
-	if (unsched_queue == EM_QUEUE_UNDEF) {
-		ODPH_ERR("EM unscheduled queue create failed\n");
-		return -1;
-	}
+	for (int i = 0; i < gbl_args->run_bench_arg.opt.num_workers; i++) {
+		unsched_queue = em_queue_create("unsch-queue", EM_QUEUE_TYPE_UNSCHEDULED,
+						EM_QUEUE_PRIO_UNDEF, EM_QUEUE_GROUP_UNDEF, &conf);
+		if (unsched_queue == EM_QUEUE_UNDEF) {
+			ODPH_ERR("EM unscheduled queue create failed\n");
+			return -1;
+		}
 
-	gbl_args->unsched_queue = unsched_queue;
+		gbl_args->thr[i].unsched_queue = unsched_queue;
+	}
 
 	return 0;
 }
 
 static int delete_queues(void)
 {
-	em_queue_t unsched_queue = gbl_args->unsched_queue;
 	em_event_t event = EM_EVENT_UNDEF;
 	em_status_t err;
+	int ret = 0;
 
-	if (unsched_queue == EM_QUEUE_UNDEF)
-		return -1;
+	for (int i = 0; i < gbl_args->run_bench_arg.opt.num_workers; i++) {
+		em_queue_t unsched_queue = gbl_args->thr[i].unsched_queue;
 
-	do {
-		event = em_queue_dequeue(unsched_queue);
-		if (event != EM_EVENT_UNDEF)
-			em_free(event);
-	} while (event != EM_EVENT_UNDEF);
+		if (unsched_queue == EM_QUEUE_UNDEF) {
+			ret = -1;
+			continue;
+		}
 
-	err = em_queue_delete(unsched_queue);
-	if (err != EM_OK) {
-		ODPH_ERR("em_queue_delete() fails\n");
-		return -1;
-	}
+		do {
+			event = em_queue_dequeue(unsched_queue);
+			if (event != EM_EVENT_UNDEF)
+				em_free(event);
+		} while (event != EM_EVENT_UNDEF);
 
-	gbl_args->unsched_queue = EM_QUEUE_UNDEF;
+		err = em_queue_delete(unsched_queue);
+		if (err != EM_OK) {
+			ODPH_ERR("em_queue_delete() fails\n");
+			ret = -1;
+			continue;
+		}
 
-	return 0;
+		gbl_args->thr[i].unsched_queue = EM_QUEUE_UNDEF;
+	}
+
+	return ret;
 }
 
 static void init_test_events(em_event_t event[], int num)
 {
+	odp_event_t *odp_event = thr_args()->odp_event_tbl;
+
 	for (int i = 0; i < num; i++) {
 		em_status_t ret;
 
@@ -188,7 +215,7 @@ static void init_test_events(em_event_t event[], int num)
 		if (ret != EM_OK)
 			ODPH_ABORT("Setting event user area ID failed\n");
 
-		gbl_args->odp_event_tbl[i] = em_odp_event2odp(event[i]);
+		odp_event[i] = em_odp_event2odp(event[i]);
 	}
 }
 
@@ -256,57 +283,57 @@ static void allocate_test_ext_pktevents(em_pool_t pool, em_event_type_t type,
 
 static void create_packets(void)
 {
-	allocate_test_events(gbl_args->packet_pool, EM_EVENT_TYPE_PACKET, gbl_args->event_tbl,
+	allocate_test_events(gbl_args->packet_pool, EM_EVENT_TYPE_PACKET, thr_args()->event_tbl,
 			     REPEAT_COUNT);
-	init_test_events(gbl_args->event_tbl, REPEAT_COUNT);
+	init_test_events(thr_args()->event_tbl, REPEAT_COUNT);
 }
 
 /* Simulate events/pkts from pktio */
 static void create_ext_packets(void)
 {
 	allocate_test_ext_pktevents(gbl_args->packet_pool, EM_EVENT_TYPE_PACKET,
-				    gbl_args->event_tbl, REPEAT_COUNT);
+				    thr_args()->event_tbl, REPEAT_COUNT);
 }
 
 static void create_packets_multi(void)
 {
 	const int num_events = REPEAT_COUNT * gbl_args->event_opt.burst_size;
 
-	allocate_test_events(gbl_args->packet_pool, EM_EVENT_TYPE_PACKET, gbl_args->event_tbl,
+	allocate_test_events(gbl_args->packet_pool, EM_EVENT_TYPE_PACKET, thr_args()->event_tbl,
 			     num_events);
-	init_test_events(gbl_args->event_tbl, num_events);
+	init_test_events(thr_args()->event_tbl, num_events);
 }
 
 static void create_sw_events(void)
 {
-	allocate_test_events(gbl_args->sw_event_pool, EM_EVENT_TYPE_SW, gbl_args->event_tbl,
+	allocate_test_events(gbl_args->sw_event_pool, EM_EVENT_TYPE_SW, thr_args()->event_tbl,
 			     REPEAT_COUNT);
-	init_test_events(gbl_args->event_tbl, REPEAT_COUNT);
+	init_test_events(thr_args()->event_tbl, REPEAT_COUNT);
 }
 
 static void create_sw_events_multi(void)
 {
 	const int num_events = REPEAT_COUNT * gbl_args->event_opt.burst_size;
 
-	allocate_test_events(gbl_args->sw_event_pool, EM_EVENT_TYPE_SW, gbl_args->event_tbl,
+	allocate_test_events(gbl_args->sw_event_pool, EM_EVENT_TYPE_SW, thr_args()->event_tbl,
 			     num_events);
-	init_test_events(gbl_args->event_tbl, num_events);
+	init_test_events(thr_args()->event_tbl, num_events);
 }
 
 static void create_vectors(void)
 {
-	allocate_test_events(gbl_args->vector_pool, EM_EVENT_TYPE_VECTOR, gbl_args->event_tbl,
+	allocate_test_events(gbl_args->vector_pool, EM_EVENT_TYPE_VECTOR, thr_args()->event_tbl,
 			     REPEAT_COUNT);
-	init_test_events(gbl_args->event_tbl, REPEAT_COUNT);
+	init_test_events(thr_args()->event_tbl, REPEAT_COUNT);
 }
 
 static void create_vectors_multi(void)
 {
 	const int num_events = REPEAT_COUNT * gbl_args->event_opt.burst_size;
 
-	allocate_test_events(gbl_args->vector_pool, EM_EVENT_TYPE_VECTOR, gbl_args->event_tbl,
+	allocate_test_events(gbl_args->vector_pool, EM_EVENT_TYPE_VECTOR, thr_args()->event_tbl,
 			     num_events);
-	init_test_events(gbl_args->event_tbl, REPEAT_COUNT);
+	init_test_events(thr_args()->event_tbl, REPEAT_COUNT);
 }
 
 static void free_event_tbl(em_event_t event_tbl[], int num)
@@ -321,27 +348,27 @@ static void free_event_tbl(em_event_t event_tbl[], int num)
 
 static void free_events(void)
 {
-	free_event_tbl(gbl_args->event_tbl, REPEAT_COUNT);
+	free_event_tbl(thr_args()->event_tbl, REPEAT_COUNT);
 }
 
 static void free_events_multi(void)
 {
-	free_event_tbl(gbl_args->event_tbl, REPEAT_COUNT * gbl_args->event_opt.burst_size);
+	free_event_tbl(thr_args()->event_tbl, REPEAT_COUNT * gbl_args->event_opt.burst_size);
 }
 
 static void free_vectors(void)
 {
 	/* Restore correct vector size after event_vector_set_size() test */
 	for (int i = 0; i < REPEAT_COUNT; i++)
-		em_event_vector_size_set(gbl_args->event_tbl[i], 0);
+		em_event_vector_size_set(thr_args()->event_tbl[i], 0);
 
 	free_events();
 }
 
 static void free_clone_events(void)
 {
-	free_event_tbl(gbl_args->event_tbl, REPEAT_COUNT);
-	free_event_tbl(gbl_args->event2_tbl, REPEAT_COUNT);
+	free_event_tbl(thr_args()->event_tbl, REPEAT_COUNT);
+	free_event_tbl(thr_args()->event2_tbl, REPEAT_COUNT);
 }
 
 /**
@@ -350,10 +377,10 @@ static void free_clone_events(void)
 
 static inline int event_alloc(em_pool_t pool, em_event_type_t type, int event_size)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		event_tbl[i] = em_alloc(event_size, type, pool);
 
 	return i;
@@ -379,11 +406,11 @@ static int event_vector_alloc(void)
 
 static inline int event_alloc_multi(em_pool_t pool, em_event_type_t type, int event_size)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	const int burst_size = gbl_args->event_opt.burst_size;
 	int ret = 0;
 
-	for (int i = 0; i < REPEAT_COUNT; i++)
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ret += em_alloc_multi(&event_tbl[i * burst_size], burst_size, event_size,
 				      type, pool);
 
@@ -412,7 +439,7 @@ static inline int alloc_free(em_pool_t pool, em_event_type_t type, int event_siz
 {
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++) {
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
 		em_event_t event;
 
 		event = em_alloc(event_size, type, pool);
@@ -443,11 +470,11 @@ static int event_vector_alloc_free(void)
 
 static inline int alloc_free_multi(em_pool_t pool, em_event_type_t type, int event_size)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	const int burst_size = gbl_args->event_opt.burst_size;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++) {
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
 		int ret;
 
 		ret = em_alloc_multi(event_tbl, burst_size, event_size, type, pool);
@@ -478,10 +505,10 @@ static int event_vector_alloc_free_multi(void)
 
 static int event_free(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		em_free(event_tbl[i]);
 
 	return i;
@@ -489,11 +516,11 @@ static int event_free(void)
 
 static int event_free_multi(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	const int burst_size = gbl_args->event_opt.burst_size;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		em_free_multi(&event_tbl[i * burst_size], burst_size);
 
 	return i;
@@ -501,11 +528,11 @@ static int event_free_multi(void)
 
 static int event_pointer(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	void **ptr = gbl_args->ptr_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	void **ptr = thr_args()->ptr_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ptr[i] = em_event_pointer(event_tbl[i]);
 
 	return i;
@@ -513,11 +540,11 @@ static int event_pointer(void)
 
 static int event_uarea_get(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	void **ptr = gbl_args->ptr_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	void **ptr = thr_args()->ptr_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ptr[i] = em_event_uarea_get(event_tbl[i], NULL);
 
 	return i;
@@ -525,12 +552,12 @@ static int event_uarea_get(void)
 
 static int event_uarea_get_size(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	void **ptr = gbl_args->ptr_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	void **ptr = thr_args()->ptr_tbl;
 	size_t size = 0;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ptr[i] = em_event_uarea_get(event_tbl[i], &size);
 
 	return size;
@@ -538,11 +565,11 @@ static int event_uarea_get_size(void)
 
 static int event_get_size(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	uint32_t *u32 = gbl_args->u32_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	uint32_t *u32 = thr_args()->u32_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		u32[i] = em_event_get_size(event_tbl[i]);
 
 	return i;
@@ -550,11 +577,11 @@ static int event_get_size(void)
 
 static int event_get_type(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	em_event_type_t *et = gbl_args->et_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	em_event_type_t *et = thr_args()->et_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		et[i] = em_event_get_type(event_tbl[i]);
 
 	return i;
@@ -562,12 +589,12 @@ static int event_get_type(void)
 
 static int event_get_type_multi(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	em_event_type_t *et = gbl_args->et_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	em_event_type_t *et = thr_args()->et_tbl;
 	const int burst_size = gbl_args->event_opt.burst_size;
 	int ret = 0;
 
-	for (int i = 0; i < REPEAT_COUNT; i++)
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ret += em_event_get_type_multi(&event_tbl[i * burst_size], burst_size,
 					       &et[i * burst_size]);
 
@@ -576,12 +603,12 @@ static int event_get_type_multi(void)
 
 static int event_same_type_multi(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	em_event_type_t *et = gbl_args->et_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	em_event_type_t *et = thr_args()->et_tbl;
 	const int burst_size = gbl_args->event_opt.burst_size;
 	int ret = 0;
 
-	for (int i = 0; i < REPEAT_COUNT; i++)
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ret += em_event_same_type_multi(&event_tbl[i * burst_size], burst_size, &et[i]);
 
 	return ret;
@@ -589,10 +616,10 @@ static int event_same_type_multi(void)
 
 static int event_set_type(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		em_event_set_type(event_tbl[i], EM_EVENT_TYPE_SW + 1);
 
 	return i;
@@ -600,11 +627,11 @@ static int event_set_type(void)
 
 static int event_get_pool(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	em_pool_t *pool = gbl_args->pool_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	em_pool_t *pool = thr_args()->pool_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		pool[i] = em_event_get_pool(event_tbl[i]);
 
 	return i;
@@ -612,12 +639,12 @@ static int event_get_pool(void)
 
 static int event_uarea_id_get(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	uint16_t *u16 = gbl_args->u16_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	uint16_t *u16 = thr_args()->u16_tbl;
 	bool isset;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		em_event_uarea_id_get(event_tbl[i], &isset, &u16[i]);
 
 	return i + isset;
@@ -625,10 +652,10 @@ static int event_uarea_id_get(void)
 
 static int event_uarea_id_set(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		em_event_uarea_id_set(event_tbl[i], i);
 
 	return i;
@@ -637,10 +664,10 @@ static int event_uarea_id_set(void)
 static int event_uarea_info(void)
 {
 	em_event_uarea_info_t uarea_info;
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		em_event_uarea_info(event_tbl[i], &uarea_info /*out*/);
 
 	return i;
@@ -648,10 +675,10 @@ static int event_uarea_info(void)
 
 static int event_has_ref(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int ret = 0;
 
-	for (int i = 0; i < REPEAT_COUNT; i++)
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ret += em_event_has_ref(event_tbl[i]);
 
 	return !ret;
@@ -659,11 +686,11 @@ static int event_has_ref(void)
 
 static int event_ref(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	em_event_t *event2_tbl = gbl_args->event2_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	em_event_t *event2_tbl = thr_args()->event2_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		event2_tbl[i] = em_event_ref(event_tbl[i]);
 
 	return i;
@@ -671,11 +698,11 @@ static int event_ref(void)
 
 static int event_clone(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	em_event_t *event2_tbl = gbl_args->event2_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	em_event_t *event2_tbl = thr_args()->event2_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		event2_tbl[i] = em_event_clone(event_tbl[i], EM_POOL_UNDEF);
 
 	return i;
@@ -683,12 +710,12 @@ static int event_clone(void)
 
 static int event_clone_part(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	em_event_t *event2_tbl = gbl_args->event2_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	em_event_t *event2_tbl = thr_args()->event2_tbl;
 	uint32_t size = em_event_get_size(event_tbl[0]); /* all events are of same size */
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		event2_tbl[i] = em_event_clone_part(event_tbl[i], EM_POOL_UNDEF, 0, size, true);
 
 	return i;
@@ -696,12 +723,12 @@ static int event_clone_part(void)
 
 static int event_clone_part__no_uarea(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	em_event_t *event2_tbl = gbl_args->event2_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	em_event_t *event2_tbl = thr_args()->event2_tbl;
 	uint32_t size = em_event_get_size(event_tbl[0]); /* all events are of same size */
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		event2_tbl[i] = em_event_clone_part(event_tbl[i], EM_POOL_UNDEF, 0, size, false);
 
 	return i;
@@ -709,10 +736,10 @@ static int event_clone_part__no_uarea(void)
 
 static int event_vector_free(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		em_event_vector_free(event_tbl[i]);
 
 	return i;
@@ -720,11 +747,11 @@ static int event_vector_free(void)
 
 static int event_vector_tbl(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	em_event_t *ev_tbl;
 	int ret = 0;
 
-	for (int i = 0; i < REPEAT_COUNT; i++)
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ret += em_event_vector_tbl(event_tbl[i], &ev_tbl);
 
 	return !ret;
@@ -732,10 +759,10 @@ static int event_vector_tbl(void)
 
 static int event_vector_size(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int ret = 0;
 
-	for (int i = 0; i < REPEAT_COUNT; i++)
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ret += em_event_vector_size(event_tbl[i]);
 
 	return !ret;
@@ -743,10 +770,10 @@ static int event_vector_size(void)
 
 static int event_vector_max_size(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int ret = 0;
 
-	for (int i = 0; i < REPEAT_COUNT; i++)
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ret += em_event_vector_max_size(event_tbl[i]);
 
 	return ret;
@@ -754,10 +781,10 @@ static int event_vector_max_size(void)
 
 static int event_vector_size_set(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		/* Against strict API. Size is fixed in free_vectors(). */
 		em_event_vector_size_set(event_tbl[i], 1);
 
@@ -766,11 +793,11 @@ static int event_vector_size_set(void)
 
 static int event_vector_info(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	em_event_vector_info_t vector_info;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		em_event_vector_info(event_tbl[i], &vector_info);
 
 	return i;
@@ -778,10 +805,10 @@ static int event_vector_info(void)
 
 static int core_id(void)
 {
-	uint32_t *u32 = gbl_args->u32_tbl;
+	uint32_t *u32 = thr_args()->u32_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		u32[i] = em_core_id();
 
 	return i;
@@ -789,10 +816,10 @@ static int core_id(void)
 
 static int core_count(void)
 {
-	uint32_t *u32 = gbl_args->u32_tbl;
+	uint32_t *u32 = thr_args()->u32_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		u32[i] = em_core_count();
 
 	return i;
@@ -800,11 +827,11 @@ static int core_count(void)
 
 static int odp_event2odp(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	odp_event_t *odp_event = gbl_args->odp_event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	odp_event_t *odp_event = thr_args()->odp_event_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		odp_event[i] = em_odp_event2odp(event_tbl[i]);
 
 	return i;
@@ -812,12 +839,12 @@ static int odp_event2odp(void)
 
 static int odp_events2odp(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	odp_event_t *odp_event = gbl_args->odp_event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	odp_event_t *odp_event = thr_args()->odp_event_tbl;
 	const int burst_size = gbl_args->event_opt.burst_size;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		em_odp_events2odp(&event_tbl[i * burst_size], &odp_event[i * burst_size],
 				  burst_size);
 
@@ -826,11 +853,11 @@ static int odp_events2odp(void)
 
 static int odp_event2em(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	odp_event_t *odp_event = gbl_args->odp_event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	odp_event_t *odp_event = thr_args()->odp_event_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		event_tbl[i] = em_odp_event2em(odp_event[i]);
 
 	return i;
@@ -838,12 +865,12 @@ static int odp_event2em(void)
 
 static int odp_events2em(void)
 {
-	em_event_t *event_tbl = gbl_args->event_tbl;
-	odp_event_t *odp_event = gbl_args->odp_event_tbl;
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	odp_event_t *odp_event = thr_args()->odp_event_tbl;
 	const int burst_size = gbl_args->event_opt.burst_size;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		em_odp_events2em(&odp_event[i * burst_size], &event_tbl[i * burst_size],
 				 burst_size);
 
@@ -852,12 +879,12 @@ static int odp_events2em(void)
 
 static int unsched_send(void)
 {
-	em_queue_t unsched_queue = gbl_args->unsched_queue;
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_queue_t unsched_queue = thr_args()->unsched_queue;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	em_status_t err;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++) {
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
 		err = em_send(event_tbl[i], unsched_queue);
 		if (unlikely(err != EM_OK))
 			return 0; /* error */
@@ -868,12 +895,12 @@ static int unsched_send(void)
 
 static inline int unsched_send_multi(void)
 {
-	em_queue_t unsched_queue = gbl_args->unsched_queue;
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_queue_t unsched_queue = thr_args()->unsched_queue;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	const int burst_size = gbl_args->event_opt.burst_size;
 	int ret = 0;
 
-	for (int i = 0; i < REPEAT_COUNT; i++)
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ret += em_send_multi(&event_tbl[i * burst_size], burst_size, unsched_queue);
 
 	if (unlikely(ret != burst_size * REPEAT_COUNT))
@@ -884,11 +911,11 @@ static inline int unsched_send_multi(void)
 
 static int unsched_dequeue(void)
 {
-	em_queue_t unsched_queue = gbl_args->unsched_queue;
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_queue_t unsched_queue = thr_args()->unsched_queue;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++) {
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
 		event_tbl[i] = em_queue_dequeue(unsched_queue);
 		if (unlikely(event_tbl[i] == EM_EVENT_UNDEF))
 			return 0; /* error */
@@ -899,12 +926,12 @@ static int unsched_dequeue(void)
 
 static int unsched_dequeue_multi(void)
 {
-	em_queue_t unsched_queue = gbl_args->unsched_queue;
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_queue_t unsched_queue = thr_args()->unsched_queue;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	const int burst_size = gbl_args->event_opt.burst_size;
 	int ret = 0;
 
-	for (int i = 0; i < REPEAT_COUNT; i++)
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
 		ret += em_queue_dequeue_multi(unsched_queue,
 					      &event_tbl[i * burst_size],
 					      burst_size);
@@ -917,12 +944,12 @@ static int unsched_dequeue_multi(void)
 
 static int unsched_send_dequeue(void)
 {
-	em_queue_t unsched_queue = gbl_args->unsched_queue;
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_queue_t unsched_queue = thr_args()->unsched_queue;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	em_status_t err;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++) {
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
 		err = em_send(event_tbl[i], unsched_queue);
 		if (unlikely(err != EM_OK))
 			return 0; /* error */
@@ -936,13 +963,13 @@ static int unsched_send_dequeue(void)
 
 static int unsched_send_dequeue_multi(void)
 {
-	em_queue_t unsched_queue = gbl_args->unsched_queue;
-	em_event_t *event_tbl = gbl_args->event_tbl;
+	em_queue_t unsched_queue = thr_args()->unsched_queue;
+	em_event_t *event_tbl = thr_args()->event_tbl;
 	const int burst_size = gbl_args->event_opt.burst_size;
 	int ret_send = 0;
 	int ret_deq = 0;
 
-	for (int i = 0; i < REPEAT_COUNT; i++) {
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
 		ret_send += em_send_multi(&event_tbl[i * burst_size],
 					  burst_size, unsched_queue);
 		ret_deq += em_queue_dequeue_multi(unsched_queue,
@@ -1149,8 +1176,13 @@ static void usage(void)
 	       "  -w, --write-csv         Write result to csv files(used in CI) or not.\n"
 	       "                          default: not write\n"
 	       "  -v, --vector_size <num> Test vector size (default %u).\n"
+	       "  -n, --num-workers <num> Run each test case on 'num' cores in parallel\n"
+	       "                          (default 1, max %d).\n"
+	       "  -o, --output <file>     Write per-core results and per-call percentiles\n"
+	       "                          to 'file'.\n"
+	       "  -f, --format <fmt>      Output file format: json (default) or csv.\n"
 	       "  -h, --help              Display help and exit.\n\n"
-	       "\n", BURST_SIZE, EVENT_SIZE, ROUNDS, VECTOR_SIZE);
+	       "\n", BURST_SIZE, EVENT_SIZE, ROUNDS, VECTOR_SIZE, MAX_WORKERS);
 }
 
 /* Parse command line arguments */
@@ -1168,17 +1200,23 @@ static int parse_args(int argc, char *argv[], int num_bench, cmd_opt_t *com_opt/
 		{"rounds", required_argument, NULL, 'r'},
 		{"write-csv", no_argument, NULL, 'w'},
 		{"vector_size", required_argument, NULL, 'v'},
+		{"num-workers", required_argument, NULL, 'n'},
+		{"output", required_argument, NULL, 'o'},
+		{"format", required_argument, NULL, 'f'},
 		{"help", no_argument, NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts =  "b:c:e:t:i:r:wv:h";
+	static const char *shortopts =  "b:c:e:t:i:r:wv:n:o:f:h";
 
 	event_opt->burst_size = BURST_SIZE;
 	com_opt->time = 0; /* Measure CPU cycles */
 	com_opt->bench_idx = 0; /* Run all benchmarks */
 	com_opt->rounds = ROUNDS;
 	com_opt->write_csv = 0; /* Do not write result to csv files */
+	com_opt->num_workers = 1;
+	com_opt->output = NULL;
+	com_opt->output_csv = 0;
 	event_opt->cache_size = -1;
 	event_opt->event_size = EVENT_SIZE;
 	event_opt->vector_size = VECTOR_SIZE;
@@ -1214,6 +1252,18 @@ static int parse_args(int argc, char *argv[], int num_bench, cmd_opt_t *com_opt/
 		case 'v':
 			event_opt->vector_size = atoi(optarg);
 			break;
+		case 'n':
+			com_opt->num_workers = atoi(optarg);
+			break;
+		case 'o':
+			com_opt->output = optarg;
+			break;
+		case 'f':
+			if (parse_output_format(optarg, com_opt)) {
+				ODPH_ERR("Bad output format: %s\n", optarg);
+				return -1;
+			}
+			break;
 		case 'h':
 			usage();
 			return 1;
@@ -1239,6 +1289,12 @@ static int parse_args(int argc, char *argv[], int num_bench, cmd_opt_t *com_opt/
 		return -1;
 	}
 
+	if (com_opt->num_workers < 1 || com_opt->num_workers > MAX_WORKERS) {
+		ODPH_ERR("Invalid number of workers: %d (max %d)\n",
+			 com_opt->num_workers, MAX_WORKERS);
+		return -1;
+	}
+
 	optind = 1; /* Reset 'extern optind' from the getopt lib */
 
 	return 0;
@@ -1264,6 +1320,7 @@ static void print_info(const char *cpumask_str, const event_opt_t *event_opt,
 		printf("Pool cache size:   %d\n", event_opt->cache_size);
 	printf("Test rounds:       %u\n", com_opt->rounds);
 	printf("Vector size:       %d\n", event_opt->vector_size);
+	printf("Worker cores:      %d\n", com_opt->num_workers);
 	printf("\n");
 }
 
@@ -1372,14 +1429,15 @@ int main(int argc, char *argv[])
 	em_pool_cfg_t pool_conf;
 	em_core_mask_t core_mask;
 	odph_helper_options_t helper_options;
-	odph_thread_t worker_thread;
+	odph_thread_t worker_thread[MAX_WORKERS];
 	odph_thread_common_param_t thr_common;
 	odph_thread_param_t thr_param;
 	odp_shm_t shm;
-	odp_cpumask_t cpumask, default_mask;
+	odp_cpumask_t default_mask;
 	odp_instance_t instance;
 	odp_init_t init_param;
-	int worker_cpu;
+	int num_workers;
+	size_t shm_size;
 	/* CPU mask as string */
 	char cpumask_str[ODP_CPUMASK_STR_SIZE];
 	int ret = 0;
@@ -1415,17 +1473,21 @@ int main(int argc, char *argv[])
 
 	odp_schedule_config(NULL);
 
-	/* Get worker CPU */
-	if (odp_cpumask_default_worker(&default_mask, 1) != 1) {
-		ODPH_ERR("Unable to allocate worker thread\n");
+	/* Get worker CPUs */
+	num_workers = com_opt.num_workers;
+	if (odp_cpumask_default_worker(&default_mask, num_workers) != num_workers) {
+		ODPH_ERR("Unable to allocate %d worker threads\n", num_workers);
 		exit(EXIT_FAILURE);
 	}
-	worker_cpu = odp_cpumask_first(&default_mask);
 
 	/* Init EM */
 	em_core_mask_zero(&core_mask);
 	em_core_mask_set(odp_cpu_id(), &core_mask);
-	em_core_mask_set(worker_cpu, &core_mask);
+	odp_cpumask_or(&core_mask.odp_cpumask, &core_mask.odp_cpumask, &default_mask);
+	if (em_core_mask_count(&core_mask) != num_workers + 1) {
+		ODPH_ERR("Worker CPUs overlap with the control CPU\n");
+		exit(EXIT_FAILURE);
+	}
 
 	init_default_pool_config(&pool_conf);
 
@@ -1435,7 +1497,7 @@ int main(int argc, char *argv[])
 	else
 		conf.thread_per_core = 1;
 	conf.default_pool_cfg = pool_conf;
-	conf.core_count = 2;
+	conf.core_count = num_workers + 1;
 	conf.phys_mask = core_mask;
 
 	if (em_init(&conf) != EM_OK) {
@@ -1454,7 +1516,8 @@ int main(int argc, char *argv[])
 	}
 
 	/* Reserve memory for args from shared mem */
-	shm = odp_shm_reserve("shm_args", sizeof(gbl_args_t), ODP_CACHE_LINE_SIZE, 0);
+	shm_size = sizeof(gbl_args_t) + num_workers * sizeof(thr_args_t);
+	shm = odp_shm_reserve("shm_args", shm_size, ODP_CACHE_LINE_SIZE, 0);
 	if (shm == ODP_SHM_INVALID) {
 		ODPH_ERR("Shared mem reserve failed\n");
 		exit(EXIT_FAILURE);
@@ -1468,32 +1531,42 @@ int main(int argc, char *argv[])
 
 	odp_atomic_init_u32(&exit_thread, 0);
 
-	memset(gbl_args, 0, sizeof(gbl_args_t));
+	memset(gbl_args, 0, shm_size);
 	gbl_args->sw_event_pool = EM_POOL_UNDEF;
 	gbl_args->packet_pool = EM_POOL_UNDEF;
-	gbl_args->unsched_queue = EM_QUEUE_UNDEF;
+	gbl_args->vector_pool = EM_POOL_UNDEF;
 
 	gbl_args->event_opt = event_opt;
 	gbl_args->run_bench_arg.opt = com_opt;
 	gbl_args->run_bench_arg.bench = test_suite;
 	gbl_args->run_bench_arg.num_bench = num_bench;
 	gbl_args->run_bench_arg.result = result;
-
-	for (int i = 0; i < MAX_EVENTS; i++) {
-		gbl_args->event_tbl[i] = EM_EVENT_UNDEF;
-		gbl_args->event2_tbl[i] = EM_EVENT_UNDEF;
-		gbl_args->ptr_tbl[i] = NULL;
-		gbl_args->u16_tbl[i] = 0;
-		gbl_args->u32_tbl[i] = 0;
-		gbl_args->et_tbl[i] = EM_EVENT_TYPE_UNDEF;
-		gbl_args->pool_tbl[i] = EM_POOL_UNDEF;
-		gbl_args->odp_event_tbl[i] = ODP_EVENT_INVALID;
+	gbl_args->run_bench_arg.result_shm = ODP_SHM_INVALID;
+
+	for (int w = 0; w < num_workers; w++) {
+		thr_args_t *thr = &gbl_args->thr[w];
+
+		thr->unsched_queue = EM_QUEUE_UNDEF;
+
+		for (int i = 0; i < MAX_EVENTS; i++) {
+			thr->event_tbl[i] = EM_EVENT_UNDEF;
+			thr->event2_tbl[i] = EM_EVENT_UNDEF;
+			thr->ptr_tbl[i] = NULL;
+			thr->u16_tbl[i] = 0;
+			thr->u32_tbl[i] = 0;
+			thr->et_tbl[i] = EM_EVENT_TYPE_UNDEF;
+			thr->pool_tbl[i] = EM_POOL_UNDEF;
+			thr->odp_event_tbl[i] = ODP_EVENT_INVALID;
+		}
 	}
 
 	(void)odp_cpumask_to_str(&default_mask, cpumask_str, sizeof(cpumask_str));
 
 	print_info(cpumask_str, &event_opt, &com_opt);
 
+	if (init_bench_results(&gbl_args->run_bench_arg))
+		goto exit;
+
 	if (create_queues())
 		goto exit;
 
@@ -1501,13 +1574,11 @@ int main(int argc, char *argv[])
 	if (create_pools())
 		goto exit;
 
-	memset(&worker_thread, 0, sizeof(odph_thread_t));
-	odp_cpumask_zero(&cpumask);
-	odp_cpumask_set(&cpumask, worker_cpu);
+	memset(worker_thread, 0, sizeof(worker_thread));
 
 	odph_thread_common_param_init(&thr_common);
 	thr_common.instance = instance;
-	thr_common.cpumask = &cpumask;
+	thr_common.cpumask = &default_mask;
 	thr_common.share_param = 1;
 
 	odph_thread_param_init(&thr_param);
@@ -1515,15 +1586,18 @@ int main(int argc, char *argv[])
 	thr_param.arg = &gbl_args->run_bench_arg;
 	thr_param.thr_type = ODP_THREAD_WORKER;
 
-	odph_thread_create(&worker_thread, &thr_common, &thr_param, 1);
+	odph_thread_create(worker_thread, &thr_common, &thr_param, num_workers);
 
-	odph_thread_join(&worker_thread, 1);
+	odph_thread_join(worker_thread, num_workers);
 
 	ret = gbl_args->run_bench_arg.bench_failed;
 
 	if (com_opt.write_csv)
 		write_result_to_csv();
 
+	if (!ret)
+		write_results("bench_event", &gbl_args->run_bench_arg);
+
 exit:
 	if (gbl_args->sw_event_pool != EM_POOL_UNDEF)
 		em_pool_delete(gbl_args->sw_event_pool);
@@ -1537,6 +1611,9 @@ exit:
 	if (delete_queues())
 		ODPH_ERR("Deleting queues failed\n");
 
+	if (term_bench_results(&gbl_args->run_bench_arg))
+		ret = -1;
+
 	if (em_term_core() != EM_OK)
 		ODPH_ERR("EM core terminate failed\n");
 
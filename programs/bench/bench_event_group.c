@@ -0,0 +1,478 @@
+/* Copyright (c) 2023, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+#include "bench_common.h"
+
+#include <string.h>
+
+/*
+ * Event groups created per test round, kept well below EM_MAX_EVENT_GROUPS
+ * also with the maximum number of workers.
+ */
+#define EGRP_REPEAT_COUNT 16
+
+/* Default event size */
+#define EVENT_SIZE 256
+
+/* Maximum number of retries */
+#define MAX_RETRY 1024
+
+/* Per worker test data */
+typedef struct {
+	/* Event group applied and reused over the rounds */
+	em_event_group_t egrp;
+
+	/* Test case input / output data */
+	em_event_group_t egrp_tbl[EGRP_REPEAT_COUNT];
+	em_event_t event_tbl[REPEAT_COUNT];
+
+} thr_args_t;
+
+typedef struct {
+	run_bench_arg_t run_bench_arg;
+
+	/* Options given to em_dispatch_rounds() in the tests: one event per round */
+	em_dispatch_opt_t em_dispatch_opt;
+
+	/* Started EO receiving the events, the receive function frees them */
+	em_eo_t eo;
+
+	/* Queues of the EO above, shared by all workers */
+	em_queue_t local_queue;
+	em_queue_t atomic_queue;
+	/* Events received from this queue end their event group processing early */
+	em_queue_t end_queue;
+
+	/* Test data of each worker, run_bench_arg.opt.num_workers entries */
+	thr_args_t thr[];
+
+} gbl_args_t;
+
+static gbl_args_t *gbl_args;
+
+/* Test data of the calling worker */
+static inline thr_args_t *thr_args(void)
+{
+	return &gbl_args->thr[bench_worker_idx()];
+}
+
+static em_status_t eo_start(void *eo_ctx ODP_UNUSED, em_eo_t eo ODP_UNUSED,
+			    const em_eo_conf_t *conf ODP_UNUSED)
+{
+	return EM_OK;
+}
+
+static em_status_t eo_stop(void *eo_ctx ODP_UNUSED, em_eo_t eo ODP_UNUSED)
+{
+	return EM_OK;
+}
+
+static void eo_receive(void *eo_ctx ODP_UNUSED, em_event_t event,
+		       em_event_type_t type ODP_UNUSED, em_queue_t queue,
+		       void *q_ctx ODP_UNUSED)
+{
+	if (queue == gbl_args->end_queue)
+		em_event_group_processing_end();
+
+	em_free(event);
+}
+
+static em_queue_t create_queue(const char *name, em_queue_type_t type,
+			       em_queue_group_t group)
+{
+	em_queue_conf_t conf;
+	em_queue_t queue;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.flags = EM_QUEUE_FLAG_DEFAULT;
+	/* All workers may send their test events into the same queue */
+	conf.min_events = gbl_args->run_bench_arg.opt.num_workers * REPEAT_COUNT;
+
+	queue = em_queue_create(name, type, EM_QUEUE_PRIO_NORMAL, group, &conf);
+	if (queue == EM_QUEUE_UNDEF)
+		ODPH_ERR("EM queue %s create failed\n", name);
+
+	return queue;
+}
+
+/* Create and start the EO receiving the test events and its queues */
+static int create_eo(void)
+{
+	em_status_t err, start_err = EM_ERROR;
+	em_eo_t eo;
+
+	eo = em_eo_create("bench-egrp-eo", eo_start, NULL, eo_stop, NULL,
+			  eo_receive, NULL);
+	if (eo == EM_EO_UNDEF) {
+		ODPH_ERR("EO create failed\n");
+		return -1;
+	}
+	gbl_args->eo = eo;
+
+	gbl_args->local_queue = create_queue("local-queue", EM_QUEUE_TYPE_LOCAL,
+					     EM_QUEUE_GROUP_UNDEF);
+	gbl_args->atomic_queue = create_queue("atomic-queue", EM_QUEUE_TYPE_ATOMIC,
+					      EM_QUEUE_GROUP_DEFAULT);
+	gbl_args->end_queue = create_queue("end-queue", EM_QUEUE_TYPE_ATOMIC,
+					   EM_QUEUE_GROUP_DEFAULT);
+	if (gbl_args->local_queue == EM_QUEUE_UNDEF ||
+	    gbl_args->atomic_queue == EM_QUEUE_UNDEF ||
+	    gbl_args->end_queue == EM_QUEUE_UNDEF)
+		return -1;
+
+	if (em_eo_add_queue_sync(eo, gbl_args->local_queue) != EM_OK ||
+	    em_eo_add_queue_sync(eo, gbl_args->atomic_queue) != EM_OK ||
+	    em_eo_add_queue_sync(eo, gbl_args->end_queue) != EM_OK) {
+		ODPH_ERR("EO add queue failed\n");
+		return -1;
+	}
+
+	/* No local start function, the start completes on this core */
+	err = em_eo_start_sync(eo, &start_err, NULL);
+	if (err != EM_OK || start_err != EM_OK) {
+		ODPH_ERR("EO start failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Stop and delete the EO and its queues. Called while the workers keep
+ * dispatching, em_eo_stop_sync() needs all EM cores to respond.
+ */
+static int delete_eo(void)
+{
+	int ret = 0;
+
+	if (gbl_args->eo == EM_EO_UNDEF)
+		return 0;
+
+	if (em_eo_get_state(gbl_args->eo) == EM_EO_STATE_RUNNING &&
+	    em_eo_stop_sync(gbl_args->eo) != EM_OK) {
+		ODPH_ERR("EO stop failed\n");
+		ret = -1;
+	}
+
+	/* Also deletes the queues of the EO */
+	if (em_eo_delete(gbl_args->eo) != EM_OK) {
+		ODPH_ERR("EO delete failed\n");
+		ret = -1;
+	}
+	gbl_args->eo = EM_EO_UNDEF;
+
+	return ret;
+}
+
+/* Create the event group of each worker */
+static int create_worker_egrps(void)
+{
+	for (int i = 0; i < gbl_args->run_bench_arg.opt.num_workers; i++) {
+		gbl_args->thr[i].egrp = em_event_group_create();
+		if (gbl_args->thr[i].egrp == EM_EVENT_GROUP_UNDEF) {
+			ODPH_ERR("Event group create failed\n");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int delete_worker_egrps(void)
+{
+	int ret = 0;
+
+	for (int i = 0; i < gbl_args->run_bench_arg.opt.num_workers; i++) {
+		em_event_group_t egrp = gbl_args->thr[i].egrp;
+
+		if (egrp == EM_EVENT_GROUP_UNDEF)
+			continue;
+
+		if (em_event_group_delete(egrp) != EM_OK) {
+			ODPH_ERR("Event group delete failed\n");
+			ret = -1;
+		}
+		gbl_args->thr[i].egrp = EM_EVENT_GROUP_UNDEF;
+	}
+
+	return ret;
+}
+
+static void create_egrps(void)
+{
+	em_event_group_t *egrp_tbl = thr_args()->egrp_tbl;
+
+	for (int i = 0; i < EGRP_REPEAT_COUNT; i++) {
+		egrp_tbl[i] = em_event_group_create();
+		if (egrp_tbl[i] == EM_EVENT_GROUP_UNDEF)
+			ODPH_ABORT("Creating test event groups failed\n");
+	}
+}
+
+static void delete_egrps(void)
+{
+	em_event_group_t *egrp_tbl = thr_args()->egrp_tbl;
+
+	for (int i = 0; i < EGRP_REPEAT_COUNT; i++) {
+		if (em_event_group_delete(egrp_tbl[i]) != EM_OK)
+			ODPH_ABORT("Deleting test event groups failed\n");
+		egrp_tbl[i] = EM_EVENT_GROUP_UNDEF;
+	}
+}
+
+/* Abort the event groups applied in the test before deleting them */
+static void abort_delete_egrps(void)
+{
+	em_event_group_t *egrp_tbl = thr_args()->egrp_tbl;
+
+	for (int i = 0; i < EGRP_REPEAT_COUNT; i++) {
+		if (em_event_group_abort(egrp_tbl[i]) != EM_OK)
+			ODPH_ABORT("Aborting test event groups failed\n");
+	}
+
+	delete_egrps();
+}
+
+static void create_events(void)
+{
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	int num_events = 0;
+	int num_retries = 0;
+
+	while (num_events < REPEAT_COUNT) {
+		int ret;
+
+		ret = em_alloc_multi(&event_tbl[num_events], REPEAT_COUNT - num_events,
+				     EVENT_SIZE, EM_EVENT_TYPE_SW, EM_POOL_DEFAULT);
+		if (ret < 1) {
+			num_retries++;
+			if (ret < 0 || num_retries > MAX_RETRY)
+				ODPH_ABORT("Allocating test events failed\n");
+			continue;
+		}
+		num_retries = 0;
+		num_events += ret;
+	}
+}
+
+/* Apply the event group of the worker for the events of one test round */
+static void apply_egrp_create_events(void)
+{
+	if (em_event_group_apply(thr_args()->egrp, REPEAT_COUNT, 0, NULL) != EM_OK)
+		ODPH_ABORT("Applying test event group failed\n");
+
+	create_events();
+}
+
+static void create_send_events(em_queue_t queue, bool use_egrp)
+{
+	thr_args_t *thr = thr_args();
+	em_status_t err;
+
+	if (use_egrp)
+		apply_egrp_create_events();
+	else
+		create_events();
+
+	for (int i = 0; i < REPEAT_COUNT; i++) {
+		if (use_egrp)
+			err = em_send_group(thr->event_tbl[i], queue, thr->egrp);
+		else
+			err = em_send(thr->event_tbl[i], queue);
+		if (err != EM_OK)
+			ODPH_ABORT("Sending test events failed\n");
+		thr->event_tbl[i] = EM_EVENT_UNDEF;
+	}
+}
+
+static void create_send_atomic_events(void)
+{
+	create_send_events(gbl_args->atomic_queue, false);
+}
+
+static void create_send_atomic_egrp_events(void)
+{
+	create_send_events(gbl_args->atomic_queue, true);
+}
+
+static void create_send_end_egrp_events(void)
+{
+	create_send_events(gbl_args->end_queue, true);
+}
+
+/*
+ * Dispatch the events left over from the test, the EO receive function frees
+ * them and the event group count of the worker drops back to zero.
+ */
+static void dispatch_events(void)
+{
+	em_dispatch_duration_t duration;
+
+	memset(&duration, 0, sizeof(duration));
+	duration.select = EM_DISPATCH_DURATION_NO_EVENTS_ROUNDS;
+	duration.no_events.rounds = DRAIN_ROUNDS;
+
+	if (em_dispatch_duration(&duration, NULL, NULL) != EM_OK)
+		ODPH_ABORT("Dispatching test events failed\n");
+}
+
+/**
+ * Test functions
+ */
+
+static int event_group_create(void)
+{
+	em_event_group_t *egrp_tbl = thr_args()->egrp_tbl;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, EGRP_REPEAT_COUNT); i++) {
+		egrp_tbl[i] = em_event_group_create();
+		if (unlikely(egrp_tbl[i] == EM_EVENT_GROUP_UNDEF))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+static int event_group_delete(void)
+{
+	em_event_group_t *egrp_tbl = thr_args()->egrp_tbl;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, EGRP_REPEAT_COUNT); i++) {
+		err = em_event_group_delete(egrp_tbl[i]);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+		egrp_tbl[i] = EM_EVENT_GROUP_UNDEF;
+	}
+
+	return i;
+}
+
+static int event_group_apply(void)
+{
+	em_event_group_t *egrp_tbl = thr_args()->egrp_tbl;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, EGRP_REPEAT_COUNT); i++) {
+		err = em_event_group_apply(egrp_tbl[i], 1, 0, NULL);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+/* Local queue events are dispatched only later by dispatch_events() */
+static int send_group(void)
+{
+	thr_args_t *thr = thr_args();
+	const em_queue_t queue = gbl_args->local_queue;
+	const em_event_group_t egrp = thr->egrp;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_send_group(thr->event_tbl[i], queue, egrp);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+/* One event per round, includes the event group count decrement after receive */
+static int dispatch_rounds(void)
+{
+	const em_dispatch_opt_t *opt = &gbl_args->em_dispatch_opt;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_dispatch_rounds(1, opt, NULL);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+bench_info_t test_suite[] = {
+	BENCH_INFO_REPEAT(event_group_create, NULL, delete_egrps, 0, NULL,
+			  EGRP_REPEAT_COUNT),
+	BENCH_INFO_REPEAT(event_group_delete, create_egrps, NULL, 0, NULL,
+			  EGRP_REPEAT_COUNT),
+	BENCH_INFO_REPEAT(event_group_apply, create_egrps, abort_delete_egrps, 0, NULL,
+			  EGRP_REPEAT_COUNT),
+	BENCH_INFO(send_group, apply_egrp_create_events, dispatch_events, 0,
+		   "em_send_group(): local-Q"),
+	BENCH_INFO(dispatch_rounds, create_send_atomic_events, dispatch_events, 0,
+		   "em_dispatch_rounds(1): atomic-Q"),
+	BENCH_INFO(dispatch_rounds, create_send_atomic_egrp_events, dispatch_events, 0,
+		   "em_dispatch_rounds(1): atomic-Q, event group"),
+	BENCH_INFO(dispatch_rounds, create_send_end_egrp_events, dispatch_events, 0,
+		   "em_dispatch_rounds(1): atomic-Q, em_event_group_processing_end()"),
+};
+
+static void init_default_pool_config(em_pool_cfg_t *pool_conf, int num_workers)
+{
+	em_pool_cfg_init(pool_conf);
+
+	pool_conf->event_type = EM_EVENT_TYPE_SW;
+	pool_conf->num_subpools = 1;
+	pool_conf->subpool[0].size = EVENT_SIZE;
+	pool_conf->subpool[0].num = 2 * REPEAT_COUNT * num_workers;
+}
+
+/* Create the EO and the event groups, 'data' is the shared program data */
+static int init_bench(void *data)
+{
+	gbl_args = data;
+	gbl_args->eo = EM_EO_UNDEF;
+	for (int i = 0; i < gbl_args->run_bench_arg.opt.num_workers; i++)
+		gbl_args->thr[i].egrp = EM_EVENT_GROUP_UNDEF;
+
+	em_dispatch_opt_init(&gbl_args->em_dispatch_opt);
+	gbl_args->em_dispatch_opt.burst_size = 1;
+
+	if (create_eo())
+		return -1;
+
+	return create_worker_egrps();
+}
+
+/* Delete the EO and the event groups while the workers are still dispatching */
+static int term_dispatching(void)
+{
+	int ret = 0;
+
+	if (delete_eo())
+		ret = -1;
+	if (delete_worker_egrps())
+		ret = -1;
+
+	return ret;
+}
+
+static const bench_suite_t bench_suite = {
+	.name = "bench_event_group",
+	.desc = "EM event group API micro benchmarks",
+	.bench = test_suite,
+	.num_bench = ARRAY_SIZE(test_suite),
+	.data_size = sizeof(gbl_args_t),
+	.worker_size = sizeof(thr_args_t),
+	.pool_config = init_default_pool_config,
+	/* Workers serve em_eo_stop_sync() in delete_eo() */
+	.keep_dispatching = 1,
+	.init = init_bench,
+	.term_dispatching = term_dispatching,
+};
+
+int main(int argc, char *argv[])
+{
+	return bench_main(argc, argv, &bench_suite);
+}
@@ -22,14 +22,8 @@
 /* Maximum number of pool statistics to get */
 #define MAX_POOL_STATS 1024u
 
-/* Number of EM core count */
-#define CORE_COUNT 2
-
+/* Per worker test case input / output data */
 typedef struct {
-	/* Command line options and benchmark info */
-	run_bench_arg_t run_bench_arg;
-
-	/* Test case input / output data */
 	int subpools[EM_MAX_SUBPOOLS];
 	em_pool_stats_opt_t stats_opt;
 	odp_pool_stats_opt_t stats_opt_odp;
@@ -39,10 +33,25 @@ typedef struct {
 	em_pool_stats_selected_t pool_stats_selected[MAX_POOL_STATS];
 	em_pool_subpool_stats_selected_t subpool_stats_selected[MAX_POOL_STATS];
 
+} thr_args_t;
+
+typedef struct {
+	/* Command line options and benchmark info */
+	run_bench_arg_t run_bench_arg;
+
+	/* Test data of each worker, run_bench_arg.opt.num_workers entries */
+	thr_args_t thr[];
+
 } gbl_args_t;
 
 static gbl_args_t *gbl_args;
 
+/* Test data of the calling worker */
+static inline thr_args_t *thr_args(void)
+{
+	return &gbl_args->thr[bench_worker_idx()];
+}
+
 ODP_STATIC_ASSERT(REPEAT_COUNT <= MAX_POOL_STATS, "REPEAT_COUNT is bigger than MAX_POOL_STATS\n");
 
 /**
@@ -50,85 +59,94 @@ ODP_STATIC_ASSERT(REPEAT_COUNT <= MAX_POOL_STATS, "REPEAT_COUNT is bigger than M
  */
 static int pool_stats(void)
 {
+	em_pool_stats_t *pool_stats = thr_args()->pool_stats;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
-		em_pool_stats(EM_POOL_DEFAULT, &gbl_args->pool_stats[i]);
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
+		em_pool_stats(EM_POOL_DEFAULT, &pool_stats[i]);
 
 	return i;
 }
 
 static void set_stats_opt(void)
 {
-	gbl_args->stats_opt.all = 0;
-	gbl_args->stats_opt.available = 1;
-	gbl_args->stats_opt.alloc_ops = 1;
-	gbl_args->stats_opt.alloc_fails = 1;
-	gbl_args->stats_opt.cache_alloc_ops = 1;
-	gbl_args->stats_opt.cache_free_ops = 1;
-	gbl_args->stats_opt.free_ops = 1;
-	gbl_args->stats_opt.total_ops = 1;
-	gbl_args->stats_opt.cache_available = 1;
+	em_pool_stats_opt_t *stats_opt = &thr_args()->stats_opt;
+
+	stats_opt->all = 0;
+	stats_opt->available = 1;
+	stats_opt->alloc_ops = 1;
+	stats_opt->alloc_fails = 1;
+	stats_opt->cache_alloc_ops = 1;
+	stats_opt->cache_free_ops = 1;
+	stats_opt->free_ops = 1;
+	stats_opt->total_ops = 1;
+	stats_opt->cache_available = 1;
 }
 
 /* Don't read statistics about cache_available */
 static void set_stats_opt_no_cache_avail(void)
 {
-	gbl_args->stats_opt.all = 0;
-	gbl_args->stats_opt.available = 1;
-	gbl_args->stats_opt.alloc_ops = 1;
-	gbl_args->stats_opt.alloc_fails = 1;
-	gbl_args->stats_opt.cache_alloc_ops = 1;
-	gbl_args->stats_opt.cache_free_ops = 1;
-	gbl_args->stats_opt.free_ops = 1;
-	gbl_args->stats_opt.total_ops = 1;
+	em_pool_stats_opt_t *stats_opt = &thr_args()->stats_opt;
+
+	stats_opt->all = 0;
+	stats_opt->available = 1;
+	stats_opt->alloc_ops = 1;
+	stats_opt->alloc_fails = 1;
+	stats_opt->cache_alloc_ops = 1;
+	stats_opt->cache_free_ops = 1;
+	stats_opt->free_ops = 1;
+	stats_opt->total_ops = 1;
 }
 
 static int pool_stats_selected(void)
 {
+	thr_args_t *thr = thr_args();
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
-		em_pool_stats_selected(EM_POOL_DEFAULT, &gbl_args->pool_stats_selected[i],
-				       &gbl_args->stats_opt);
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
+		em_pool_stats_selected(EM_POOL_DEFAULT, &thr->pool_stats_selected[i],
+				       &thr->stats_opt);
 
 	return i;
 }
 
 static void set_subpools(void)
 {
-	gbl_args->subpools[0] = 0;
+	thr_args()->subpools[0] = 0;
 }
 
 static int subpool_stats(void)
 {
+	thr_args_t *thr = thr_args();
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
-		em_pool_subpool_stats(EM_POOL_DEFAULT, gbl_args->subpools, 1,
-				      &gbl_args->subpool_stats[i]);
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
+		em_pool_subpool_stats(EM_POOL_DEFAULT, thr->subpools, 1,
+				      &thr->subpool_stats[i]);
 
 	return i;
 }
 
 static int subpool_stats_selected(void)
 {
+	thr_args_t *thr = thr_args();
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
-		em_pool_subpool_stats_selected(EM_POOL_DEFAULT, gbl_args->subpools, 1,
-					       &gbl_args->subpool_stats_selected[i],
-					       &gbl_args->stats_opt);
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
+		em_pool_subpool_stats_selected(EM_POOL_DEFAULT, thr->subpools, 1,
+					       &thr->subpool_stats_selected[i],
+					       &thr->stats_opt);
 
 	return i;
 }
 
 static int pool_info(void)
 {
+	em_pool_info_t *pool_info = thr_args()->pool_info;
 	int i;
 
-	for (i = 0; i < REPEAT_COUNT; i++)
-		em_pool_info(EM_POOL_DEFAULT, &gbl_args->pool_info[i]);
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
+		em_pool_info(EM_POOL_DEFAULT, &pool_info[i]);
 
 	return i;
 }
@@ -160,8 +178,13 @@ static void usage(void)
 	       "  -r, --rounds <num>      Run each test case 'num' times (default %u).\n"
 	       "  -w, --write-csv         Write result to csv files(used in CI) or not.\n"
 	       "                          default: not write\n"
+	       "  -n, --num-workers <num> Run each test case on 'num' cores in parallel\n"
+	       "                          (default 1, max %d).\n"
+	       "  -o, --output <file>     Write per-core results and per-call percentiles\n"
+	       "                          to 'file'.\n"
+	       "  -f, --format <fmt>      Output file format: json (default) or csv.\n"
 	       "  -h, --help              Display help and exit.\n\n"
-	       "\n", ROUNDS);
+	       "\n", ROUNDS, MAX_WORKERS);
 }
 
 /* Parse command line arguments */
@@ -174,16 +197,22 @@ static int parse_args(int argc, char *argv[], int num_bench, cmd_opt_t *cmd_opt/
 		{"index", required_argument, NULL, 'i'},
 		{"rounds", required_argument, NULL, 'r'},
 		{"write-csv", no_argument, NULL, 'w'},
+		{"num-workers", required_argument, NULL, 'n'},
+		{"output", required_argument, NULL, 'o'},
+		{"format", required_argument, NULL, 'f'},
 		{"help", no_argument, NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
 
-	static const char *shortopts =  "t:i:r:wh";
+	static const char *shortopts =  "t:i:r:wn:o:f:h";
 
 	cmd_opt->time = 0; /* Measure CPU cycles */
 	cmd_opt->bench_idx = 0; /* Run all benchmarks */
 	cmd_opt->rounds = ROUNDS;
 	cmd_opt->write_csv = 0; /* Do not write result to csv files */
+	cmd_opt->num_workers = 1;
+	cmd_opt->output = NULL;
+	cmd_opt->output_csv = 0;
 
 	while (1) {
 		opt = getopt_long(argc, argv, shortopts, longopts, &long_index);
@@ -204,6 +233,18 @@ static int parse_args(int argc, char *argv[], int num_bench, cmd_opt_t *cmd_opt/
 		case 'w':
 			cmd_opt->write_csv = 1;
 			break;
+		case 'n':
+			cmd_opt->num_workers = atoi(optarg);
+			break;
+		case 'o':
+			cmd_opt->output = optarg;
+			break;
+		case 'f':
+			if (parse_output_format(optarg, cmd_opt)) {
+				ODPH_ERR("Bad output format: %s\n", optarg);
+				return -1;
+			}
+			break;
 		case 'h':
 			usage();
 			return 1;
@@ -223,6 +264,12 @@ static int parse_args(int argc, char *argv[], int num_bench, cmd_opt_t *cmd_opt/
 		return -1;
 	}
 
+	if (cmd_opt->num_workers < 1 || cmd_opt->num_workers > MAX_WORKERS) {
+		ODPH_ERR("Invalid number of workers: %d (max %d)\n",
+			 cmd_opt->num_workers, MAX_WORKERS);
+		return -1;
+	}
+
 	optind = 1; /* Reset 'extern optind' from the getopt lib */
 
 	return 0;
@@ -240,6 +287,7 @@ static void print_info(const char *cpumask_str, const cmd_opt_t *com_opt)
 	printf("Worker CPU mask:   %s\n", cpumask_str);
 	printf("Measurement unit:  %s\n", com_opt->time ? "nsec" : "CPU cycles");
 	printf("Test rounds:       %u\n", com_opt->rounds);
+	printf("Worker cores:      %d\n", com_opt->num_workers);
 	printf("\n");
 }
 
@@ -332,14 +380,15 @@ int main(int argc, char *argv[])
 	em_pool_cfg_t pool_conf;
 	em_core_mask_t core_mask;
 	odph_helper_options_t helper_options;
-	odph_thread_t worker_thread;
+	odph_thread_t worker_thread[MAX_WORKERS];
 	odph_thread_common_param_t thr_common;
 	odph_thread_param_t thr_param;
 	odp_shm_t shm;
-	odp_cpumask_t cpumask, worker_mask;
+	odp_cpumask_t worker_mask;
 	odp_instance_t instance;
 	odp_init_t init_param;
-	int worker_cpu;
+	int num_workers;
+	size_t shm_size;
 	char cpumask_str[ODP_CPUMASK_STR_SIZE];
 	int ret = 0;
 	int num_bench = ARRAY_SIZE(test_suite);
@@ -374,12 +423,12 @@ int main(int argc, char *argv[])
 
 	odp_schedule_config(NULL);
 
-	/* Get worker CPU */
-	if (odp_cpumask_default_worker(&worker_mask, 1) != 1) {
-		ODPH_ERR("Unable to allocate worker thread\n");
+	/* Get worker CPUs */
+	num_workers = cmd_opt.num_workers;
+	if (odp_cpumask_default_worker(&worker_mask, num_workers) != num_workers) {
+		ODPH_ERR("Unable to allocate %d worker threads\n", num_workers);
 		goto odp_term;
 	}
-	worker_cpu = odp_cpumask_first(&worker_mask);
 	(void)odp_cpumask_to_str(&worker_mask, cpumask_str, ODP_CPUMASK_STR_SIZE);
 
 	print_info(cpumask_str, &cmd_opt);
@@ -387,8 +436,8 @@ int main(int argc, char *argv[])
 	/* Init EM */
 	em_core_mask_zero(&core_mask);
 	em_core_mask_set(odp_cpu_id(), &core_mask);
-	em_core_mask_set(worker_cpu, &core_mask);
-	if (odp_cpumask_count(&core_mask.odp_cpumask) != CORE_COUNT)
+	odp_cpumask_or(&core_mask.odp_cpumask, &core_mask.odp_cpumask, &worker_mask);
+	if (odp_cpumask_count(&core_mask.odp_cpumask) != num_workers + 1)
 		goto odp_term;
 
 	init_default_pool_config(&pool_conf);
@@ -399,7 +448,7 @@ int main(int argc, char *argv[])
 	else
 		conf.thread_per_core = 1;
 	conf.default_pool_cfg = pool_conf;
-	conf.core_count = CORE_COUNT;
+	conf.core_count = num_workers + 1;
 	conf.phys_mask = core_mask;
 
 	if (em_init(&conf) != EM_OK) {
@@ -418,7 +467,8 @@ int main(int argc, char *argv[])
 	}
 
 	/* Reserve memory for args from shared mem */
-	shm = odp_shm_reserve("shm_args", sizeof(gbl_args_t), ODP_CACHE_LINE_SIZE, 0);
+	shm_size = sizeof(gbl_args_t) + num_workers * sizeof(thr_args_t);
+	shm = odp_shm_reserve("shm_args", shm_size, ODP_CACHE_LINE_SIZE, 0);
 	if (shm == ODP_SHM_INVALID) {
 		ODPH_ERR("Shared mem reserve failed\n");
 		exit(EXIT_FAILURE);
@@ -432,21 +482,22 @@ int main(int argc, char *argv[])
 
 	odp_atomic_init_u32(&exit_thread, 0);
 
-	memset(gbl_args, 0, sizeof(gbl_args_t));
+	memset(gbl_args, 0, shm_size);
 	gbl_args->run_bench_arg.bench = test_suite;
 	gbl_args->run_bench_arg.num_bench = num_bench;
 	gbl_args->run_bench_arg.opt = cmd_opt;
 	gbl_args->run_bench_arg.result = result;
 
+	if (init_bench_results(&gbl_args->run_bench_arg))
+		exit(EXIT_FAILURE);
+
 	alloc_free_event();
 
-	memset(&worker_thread, 0, sizeof(odph_thread_t));
-	odp_cpumask_zero(&cpumask);
-	odp_cpumask_set(&cpumask, worker_cpu);
+	memset(worker_thread, 0, sizeof(worker_thread));
 
 	odph_thread_common_param_init(&thr_common);
 	thr_common.instance = instance;
-	thr_common.cpumask = &cpumask;
+	thr_common.cpumask = &worker_mask;
 	thr_common.share_param = 1;
 
 	odph_thread_param_init(&thr_param);
@@ -454,15 +505,21 @@ int main(int argc, char *argv[])
 	thr_param.arg = &gbl_args->run_bench_arg;
 	thr_param.thr_type = ODP_THREAD_WORKER;
 
-	odph_thread_create(&worker_thread, &thr_common, &thr_param, 1);
+	odph_thread_create(worker_thread, &thr_common, &thr_param, num_workers);
 
-	odph_thread_join(&worker_thread, 1);
+	odph_thread_join(worker_thread, num_workers);
 
 	ret = gbl_args->run_bench_arg.bench_failed;
 
 	if (cmd_opt.write_csv)
 		write_result_to_csv();
 
+	if (!ret)
+		write_results("bench_pool", &gbl_args->run_bench_arg);
+
+	if (term_bench_results(&gbl_args->run_bench_arg))
+		ret = -1;
+
 	if (em_term_core() != EM_OK)
 		ODPH_ERR("EM core terminate failed\n");
 
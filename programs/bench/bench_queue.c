@@ -0,0 +1,577 @@
+/* Copyright (c) 2023, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+#include "bench_common.h"
+
+#include <string.h>
+
+/* Number of queues created, deleted or added to an EO per round */
+#define QUEUE_REPEAT_COUNT 16
+
+/* Burst size for em_queue_dequeue_multi() */
+#define BURST_SIZE 8
+
+/* Maximum number of test events per worker */
+#define MAX_EVENTS (REPEAT_COUNT * BURST_SIZE)
+
+/* Default event size */
+#define EVENT_SIZE 256
+
+/* Maximum number of retries */
+#define MAX_RETRY 1024
+
+/* Per worker test data */
+typedef struct {
+	/* Unscheduled queue of this worker */
+	em_queue_t unsched_queue;
+
+	/* EO (not started) for em_eo_add_queue_sync() tests */
+	em_eo_t eo;
+
+	/* Test case input / output data */
+	em_queue_t queue_tbl[QUEUE_REPEAT_COUNT];
+	em_event_t event_tbl[MAX_EVENTS];
+
+} thr_args_t;
+
+typedef struct {
+	run_bench_arg_t run_bench_arg;
+
+	/* Started EO receiving the events sent in the tests */
+	em_eo_t eo;
+
+	/* Queues of the EO above, shared by all workers */
+	em_queue_t local_queue;
+	em_queue_t atomic_queue;
+	em_queue_t parallel_queue;
+	em_queue_t ordered_queue;
+
+	/* Output queue, the output function frees the events */
+	em_queue_t output_queue;
+
+	/* Test data of each worker, run_bench_arg.opt.num_workers entries */
+	thr_args_t thr[];
+
+} gbl_args_t;
+
+static gbl_args_t *gbl_args;
+
+/* Test data of the calling worker */
+static inline thr_args_t *thr_args(void)
+{
+	return &gbl_args->thr[bench_worker_idx()];
+}
+
+static em_status_t eo_start(void *eo_ctx ODP_UNUSED, em_eo_t eo ODP_UNUSED,
+			    const em_eo_conf_t *conf ODP_UNUSED)
+{
+	return EM_OK;
+}
+
+static em_status_t eo_stop(void *eo_ctx ODP_UNUSED, em_eo_t eo ODP_UNUSED)
+{
+	return EM_OK;
+}
+
+static void eo_receive(void *eo_ctx ODP_UNUSED, em_event_t event,
+		       em_event_type_t type ODP_UNUSED, em_queue_t queue ODP_UNUSED,
+		       void *q_ctx ODP_UNUSED)
+{
+	em_free(event);
+}
+
+static int output_free(const em_event_t events[], const unsigned int num,
+		       const em_queue_t output_queue ODP_UNUSED,
+		       void *output_fn_args ODP_UNUSED)
+{
+	for (unsigned int i = 0; i < num; i++)
+		em_free(events[i]);
+
+	return num;
+}
+
+static em_queue_t create_queue(const char *name, em_queue_type_t type,
+			       em_queue_group_t group)
+{
+	em_queue_conf_t conf;
+	em_queue_t queue;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.flags = EM_QUEUE_FLAG_DEFAULT;
+	/* All workers may send their test events into the same queue */
+	conf.min_events = gbl_args->run_bench_arg.opt.num_workers * REPEAT_COUNT;
+
+	queue = em_queue_create(name, type, EM_QUEUE_PRIO_NORMAL, group, &conf);
+	if (queue == EM_QUEUE_UNDEF)
+		ODPH_ERR("EM queue %s create failed\n", name);
+
+	return queue;
+}
+
+/* Create and start the EO receiving the test events and its queues */
+static int create_eo(void)
+{
+	em_output_queue_conf_t output_conf;
+	em_queue_conf_t conf;
+	em_status_t err, start_err = EM_ERROR;
+	em_eo_t eo;
+
+	eo = em_eo_create("bench-queue-eo", eo_start, NULL, eo_stop, NULL,
+			  eo_receive, NULL);
+	if (eo == EM_EO_UNDEF) {
+		ODPH_ERR("EO create failed\n");
+		return -1;
+	}
+	gbl_args->eo = eo;
+
+	gbl_args->local_queue = create_queue("local-queue", EM_QUEUE_TYPE_LOCAL,
+					     EM_QUEUE_GROUP_UNDEF);
+	gbl_args->atomic_queue = create_queue("atomic-queue", EM_QUEUE_TYPE_ATOMIC,
+					      EM_QUEUE_GROUP_DEFAULT);
+	gbl_args->parallel_queue = create_queue("parallel-queue", EM_QUEUE_TYPE_PARALLEL,
+						EM_QUEUE_GROUP_DEFAULT);
+	gbl_args->ordered_queue = create_queue("ordered-queue", EM_QUEUE_TYPE_PARALLEL_ORDERED,
+					       EM_QUEUE_GROUP_DEFAULT);
+	if (gbl_args->local_queue == EM_QUEUE_UNDEF ||
+	    gbl_args->atomic_queue == EM_QUEUE_UNDEF ||
+	    gbl_args->parallel_queue == EM_QUEUE_UNDEF ||
+	    gbl_args->ordered_queue == EM_QUEUE_UNDEF)
+		return -1;
+
+	if (em_eo_add_queue_sync(eo, gbl_args->local_queue) != EM_OK ||
+	    em_eo_add_queue_sync(eo, gbl_args->atomic_queue) != EM_OK ||
+	    em_eo_add_queue_sync(eo, gbl_args->parallel_queue) != EM_OK ||
+	    em_eo_add_queue_sync(eo, gbl_args->ordered_queue) != EM_OK) {
+		ODPH_ERR("EO add queue failed\n");
+		return -1;
+	}
+
+	memset(&output_conf, 0, sizeof(output_conf));
+	output_conf.output_fn = output_free;
+	output_conf.output_fn_args = NULL;
+	output_conf.args_len = 0;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.flags = EM_QUEUE_FLAG_DEFAULT;
+	conf.min_events = 0; /* system default */
+	conf.conf_len = sizeof(output_conf);
+	conf.conf = &output_conf;
+
+	gbl_args->output_queue = em_queue_create("output-queue", EM_QUEUE_TYPE_OUTPUT,
+						 EM_QUEUE_PRIO_UNDEF, EM_QUEUE_GROUP_UNDEF,
+						 &conf);
+	if (gbl_args->output_queue == EM_QUEUE_UNDEF) {
+		ODPH_ERR("EM output queue create failed\n");
+		return -1;
+	}
+
+	/* No local start function, the start completes on this core */
+	err = em_eo_start_sync(eo, &start_err, NULL);
+	if (err != EM_OK || start_err != EM_OK) {
+		ODPH_ERR("EO start failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Stop and delete the EO and its queues. Called while the workers keep
+ * dispatching, em_eo_stop_sync() needs all EM cores to respond.
+ */
+static int delete_eo(void)
+{
+	int ret = 0;
+
+	if (gbl_args->eo != EM_EO_UNDEF) {
+		if (em_eo_get_state(gbl_args->eo) == EM_EO_STATE_RUNNING &&
+		    em_eo_stop_sync(gbl_args->eo) != EM_OK) {
+			ODPH_ERR("EO stop failed\n");
+			ret = -1;
+		}
+
+		/* Also deletes the queues of the EO */
+		if (em_eo_delete(gbl_args->eo) != EM_OK) {
+			ODPH_ERR("EO delete failed\n");
+			ret = -1;
+		}
+		gbl_args->eo = EM_EO_UNDEF;
+	}
+
+	if (gbl_args->output_queue != EM_QUEUE_UNDEF &&
+	    em_queue_delete(gbl_args->output_queue) != EM_OK) {
+		ODPH_ERR("EM output queue delete failed\n");
+		ret = -1;
+	}
+	gbl_args->output_queue = EM_QUEUE_UNDEF;
+
+	return ret;
+}
+
+/* Each worker gets its own unscheduled queue */
+static int create_queues(void)
+{
+	em_queue_t unsched_queue;
+	em_queue_conf_t conf;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.flags = EM_QUEUE_FLAG_DEFAULT;
+	conf.min_events = MAX_EVENTS;
+	conf.conf_len = 0;
+
+	for (int i = 0; i < gbl_args->run_bench_arg.opt.num_workers; i++) {
+		unsched_queue = em_queue_create("unsch-queue", EM_QUEUE_TYPE_UNSCHEDULED,
+						EM_QUEUE_PRIO_UNDEF, EM_QUEUE_GROUP_UNDEF, &conf);
+		if (unsched_queue == EM_QUEUE_UNDEF) {
+			ODPH_ERR("EM unscheduled queue create failed\n");
+			return -1;
+		}
+
+		gbl_args->thr[i].unsched_queue = unsched_queue;
+	}
+
+	return 0;
+}
+
+static int delete_queues(void)
+{
+	em_event_t event;
+	int ret = 0;
+
+	for (int i = 0; i < gbl_args->run_bench_arg.opt.num_workers; i++) {
+		em_queue_t unsched_queue = gbl_args->thr[i].unsched_queue;
+
+		if (unsched_queue == EM_QUEUE_UNDEF)
+			continue;
+
+		do {
+			event = em_queue_dequeue(unsched_queue);
+			if (event != EM_EVENT_UNDEF)
+				em_free(event);
+		} while (event != EM_EVENT_UNDEF);
+
+		if (em_queue_delete(unsched_queue) != EM_OK) {
+			ODPH_ERR("em_queue_delete() fails\n");
+			ret = -1;
+			continue;
+		}
+
+		gbl_args->thr[i].unsched_queue = EM_QUEUE_UNDEF;
+	}
+
+	return ret;
+}
+
+static void create_test_queues(void)
+{
+	em_queue_t *queue_tbl = thr_args()->queue_tbl;
+
+	for (int i = 0; i < QUEUE_REPEAT_COUNT; i++) {
+		queue_tbl[i] = em_queue_create("bench-queue", EM_QUEUE_TYPE_ATOMIC,
+					       EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_DEFAULT,
+					       NULL);
+		if (queue_tbl[i] == EM_QUEUE_UNDEF)
+			ODPH_ABORT("Creating test queues failed\n");
+	}
+}
+
+static void delete_test_queues(void)
+{
+	em_queue_t *queue_tbl = thr_args()->queue_tbl;
+
+	for (int i = 0; i < QUEUE_REPEAT_COUNT; i++) {
+		if (em_queue_delete(queue_tbl[i]) != EM_OK)
+			ODPH_ABORT("Deleting test queues failed\n");
+		queue_tbl[i] = EM_QUEUE_UNDEF;
+	}
+}
+
+/* EO is never started: adding queues and deleting it are core local operations */
+static void create_test_eo(void)
+{
+	thr_args_t *thr = thr_args();
+
+	thr->eo = em_eo_create("bench-add-queue-eo", eo_start, NULL, eo_stop, NULL,
+			       eo_receive, NULL);
+	if (thr->eo == EM_EO_UNDEF)
+		ODPH_ABORT("Creating test EO failed\n");
+
+	create_test_queues();
+}
+
+static void delete_test_eo(void)
+{
+	thr_args_t *thr = thr_args();
+
+	/* Also deletes the queues added to the EO */
+	if (em_eo_delete(thr->eo) != EM_OK)
+		ODPH_ABORT("Deleting test EO failed\n");
+
+	thr->eo = EM_EO_UNDEF;
+	for (int i = 0; i < QUEUE_REPEAT_COUNT; i++)
+		thr->queue_tbl[i] = EM_QUEUE_UNDEF;
+}
+
+static void allocate_test_events(em_event_t event[], int num)
+{
+	int num_events = 0;
+	int num_retries = 0;
+
+	while (num_events < num) {
+		int ret;
+
+		ret = em_alloc_multi(&event[num_events], num - num_events,
+				     EVENT_SIZE, EM_EVENT_TYPE_SW, EM_POOL_DEFAULT);
+		if (ret < 1) {
+			num_retries++;
+			if (ret < 0 || num_retries > MAX_RETRY)
+				ODPH_ABORT("Allocating test events failed\n");
+			continue;
+		}
+		num_retries = 0;
+		num_events += ret;
+	}
+}
+
+static void create_events(void)
+{
+	allocate_test_events(thr_args()->event_tbl, REPEAT_COUNT);
+}
+
+/* Fill the unscheduled queue for the em_queue_dequeue_multi() test */
+static void create_send_unsched_events(void)
+{
+	thr_args_t *thr = thr_args();
+	int ret = 0;
+
+	allocate_test_events(thr->event_tbl, MAX_EVENTS);
+
+	for (int i = 0; i < REPEAT_COUNT; i++)
+		ret += em_send_multi(&thr->event_tbl[i * BURST_SIZE], BURST_SIZE,
+				     thr->unsched_queue);
+	if (ret != MAX_EVENTS)
+		ODPH_ABORT("Sending test events failed\n");
+}
+
+static void free_events_multi(void)
+{
+	em_event_t *event_tbl = thr_args()->event_tbl;
+
+	for (int i = 0; i < MAX_EVENTS; i++) {
+		if (event_tbl[i] != EM_EVENT_UNDEF) {
+			em_free(event_tbl[i]);
+			event_tbl[i] = EM_EVENT_UNDEF;
+		}
+	}
+}
+
+/* Dispatch the sent events, the EO receive function frees them */
+static void dispatch_events(void)
+{
+	em_dispatch_duration_t duration;
+
+	memset(&duration, 0, sizeof(duration));
+	duration.select = EM_DISPATCH_DURATION_NO_EVENTS_ROUNDS;
+	duration.no_events.rounds = DRAIN_ROUNDS;
+
+	if (em_dispatch_duration(&duration, NULL, NULL) != EM_OK)
+		ODPH_ABORT("Dispatching test events failed\n");
+}
+
+static void dequeue_free_events(void)
+{
+	em_queue_t unsched_queue = thr_args()->unsched_queue;
+	em_event_t event_tbl[BURST_SIZE];
+	int num;
+
+	do {
+		num = em_queue_dequeue_multi(unsched_queue, event_tbl, BURST_SIZE);
+		if (num > 0)
+			em_free_multi(event_tbl, num);
+	} while (num > 0);
+}
+
+/**
+ * Test functions
+ */
+
+static int queue_create(void)
+{
+	em_queue_t *queue_tbl = thr_args()->queue_tbl;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, QUEUE_REPEAT_COUNT); i++) {
+		queue_tbl[i] = em_queue_create("bench-queue", EM_QUEUE_TYPE_ATOMIC,
+					       EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_DEFAULT,
+					       NULL);
+		if (unlikely(queue_tbl[i] == EM_QUEUE_UNDEF))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+static int queue_delete(void)
+{
+	em_queue_t *queue_tbl = thr_args()->queue_tbl;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, QUEUE_REPEAT_COUNT); i++) {
+		err = em_queue_delete(queue_tbl[i]);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+		queue_tbl[i] = EM_QUEUE_UNDEF;
+	}
+
+	return i;
+}
+
+static int eo_add_queue_sync(void)
+{
+	thr_args_t *thr = thr_args();
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, QUEUE_REPEAT_COUNT); i++) {
+		err = em_eo_add_queue_sync(thr->eo, thr->queue_tbl[i]);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+static inline int send_events(em_queue_t queue)
+{
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_send(event_tbl[i], queue);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+static int send_local(void)
+{
+	return send_events(gbl_args->local_queue);
+}
+
+static int send_unsched(void)
+{
+	return send_events(thr_args()->unsched_queue);
+}
+
+static int send_output(void)
+{
+	return send_events(gbl_args->output_queue);
+}
+
+static int send_atomic(void)
+{
+	return send_events(gbl_args->atomic_queue);
+}
+
+static int send_parallel(void)
+{
+	return send_events(gbl_args->parallel_queue);
+}
+
+static int send_ordered(void)
+{
+	return send_events(gbl_args->ordered_queue);
+}
+
+static int unsched_dequeue_multi(void)
+{
+	thr_args_t *thr = thr_args();
+	int ret = 0;
+
+	for (int i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
+		ret += em_queue_dequeue_multi(thr->unsched_queue,
+					      &thr->event_tbl[i * BURST_SIZE],
+					      BURST_SIZE);
+
+	if (unlikely(ret != MAX_EVENTS))
+		return 0; /* error */
+
+	return ret;
+}
+
+bench_info_t test_suite[] = {
+	BENCH_INFO_REPEAT(queue_create, NULL, delete_test_queues, 100,
+			  "em_queue_create(atomic-Q)", QUEUE_REPEAT_COUNT),
+	BENCH_INFO_REPEAT(queue_delete, create_test_queues, NULL, 100,
+			  "em_queue_delete(atomic-Q)", QUEUE_REPEAT_COUNT),
+	BENCH_INFO_REPEAT(eo_add_queue_sync, create_test_eo, delete_test_eo, 100,
+			  "em_eo_add_queue_sync(atomic-Q)", QUEUE_REPEAT_COUNT),
+	BENCH_INFO(send_local, create_events, dispatch_events, 0,
+		   "em_send(local-Q)"),
+	BENCH_INFO(send_unsched, create_events, dequeue_free_events, 0,
+		   "em_send(unsched-Q)"),
+	BENCH_INFO(send_output, create_events, NULL, 0,
+		   "em_send(output-Q)"),
+	BENCH_INFO(send_atomic, create_events, dispatch_events, 0,
+		   "em_send(atomic-Q)"),
+	BENCH_INFO(send_parallel, create_events, dispatch_events, 0,
+		   "em_send(parallel-Q)"),
+	BENCH_INFO(send_ordered, create_events, dispatch_events, 0,
+		   "em_send(parallel-ordered-Q)"),
+	BENCH_INFO(unsched_dequeue_multi, create_send_unsched_events, free_events_multi, 0,
+		   "em_queue_dequeue_multi(unsched-Q)"),
+};
+
+static void init_default_pool_config(em_pool_cfg_t *pool_conf, int num_workers)
+{
+	em_pool_cfg_init(pool_conf);
+
+	pool_conf->event_type = EM_EVENT_TYPE_SW;
+	pool_conf->num_subpools = 1;
+	pool_conf->subpool[0].size = EVENT_SIZE;
+	/* Room also for the events not yet dispatched from the previous round */
+	pool_conf->subpool[0].num = 2 * MAX_EVENTS * num_workers;
+}
+
+/* Create the test queues and the EO, 'data' is the shared program data */
+static int init_bench(void *data)
+{
+	gbl_args = data;
+	gbl_args->eo = EM_EO_UNDEF;
+	gbl_args->output_queue = EM_QUEUE_UNDEF;
+	for (int i = 0; i < gbl_args->run_bench_arg.opt.num_workers; i++) {
+		gbl_args->thr[i].unsched_queue = EM_QUEUE_UNDEF;
+		gbl_args->thr[i].eo = EM_EO_UNDEF;
+	}
+
+	if (create_queues())
+		return -1;
+
+	return create_eo();
+}
+
+static const bench_suite_t bench_suite = {
+	.name = "bench_queue",
+	.desc = "EM queue API micro benchmarks",
+	.bench = test_suite,
+	.num_bench = ARRAY_SIZE(test_suite),
+	.data_size = sizeof(gbl_args_t),
+	.worker_size = sizeof(thr_args_t),
+	.pool_config = init_default_pool_config,
+	/* Workers serve em_eo_stop_sync() in delete_eo() */
+	.keep_dispatching = 1,
+	.init = init_bench,
+	.term_dispatching = delete_eo,
+	.term = delete_queues,
+};
+
+int main(int argc, char *argv[])
+{
+	return bench_main(argc, argv, &bench_suite);
+}
@@ -0,0 +1,557 @@
+/* Copyright (c) 2023, Nokia
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+#include "bench_common.h"
+
+#include <event_machine/add-ons/event_machine_timer.h>
+
+#include <string.h>
+
+/* User area size in bytes, the user area ID identifies the owner of a timeout event */
+#define UAREA_SIZE 8
+
+/* Default event size */
+#define EVENT_SIZE 256
+
+/* Relative timeout and period in the tests, long enough not to expire during a round */
+#define TMO_NS (1000ULL * 1000ULL * 1000ULL) /* 1s */
+
+/* Minimum delay before the first periodic timeout in the em_tmo_ack() test */
+#define START_NS (2ULL * 1000ULL * 1000ULL) /* 2ms */
+
+/* Maximum number of retries */
+#define MAX_RETRY 1024
+
+/* Per worker test data */
+typedef struct {
+	/* One-shot and periodic timeouts reused over the rounds */
+	em_tmo_t tmo_tbl[REPEAT_COUNT];
+	em_tmo_t periodic_tmo_tbl[REPEAT_COUNT];
+
+	/* Test case input / output data */
+	em_tmo_t new_tmo_tbl[REPEAT_COUNT];
+	em_event_t event_tbl[REPEAT_COUNT];
+	em_timer_tick_t tick_tbl[REPEAT_COUNT];
+
+	/* Periodic timeout events received by any worker for this worker */
+	odp_atomic_u32_t num_received;
+
+} thr_args_t;
+
+typedef struct {
+	run_bench_arg_t run_bench_arg;
+
+	/* Timer of the tests */
+	em_timer_t timer;
+
+	/* Relative timeout / period and first periodic timeout offset in ticks */
+	em_timer_tick_t tmo_ticks;
+	em_timer_tick_t start_ticks;
+
+	/* Started EO receiving the timeout events */
+	em_eo_t eo;
+	em_queue_t queue;
+
+	/* Test data of each worker, run_bench_arg.opt.num_workers entries */
+	thr_args_t thr[];
+
+} gbl_args_t;
+
+static gbl_args_t *gbl_args;
+
+/* Test data of the calling worker */
+static inline thr_args_t *thr_args(void)
+{
+	return &gbl_args->thr[bench_worker_idx()];
+}
+
+static em_status_t eo_start(void *eo_ctx ODP_UNUSED, em_eo_t eo ODP_UNUSED,
+			    const em_eo_conf_t *conf ODP_UNUSED)
+{
+	return EM_OK;
+}
+
+static em_status_t eo_stop(void *eo_ctx ODP_UNUSED, em_eo_t eo ODP_UNUSED)
+{
+	return EM_OK;
+}
+
+/*
+ * Periodic timeout events are handed to the worker that set the timeout, the
+ * user area ID holds 'worker index * REPEAT_COUNT + timeout index'. Events of
+ * canceled timeouts are freed.
+ */
+static void eo_receive(void *eo_ctx ODP_UNUSED, em_event_t event,
+		       em_event_type_t type ODP_UNUSED, em_queue_t queue ODP_UNUSED,
+		       void *q_ctx ODP_UNUSED)
+{
+	const uint32_t max_id = gbl_args->run_bench_arg.opt.num_workers * REPEAT_COUNT;
+	em_tmo_t tmo = EM_TMO_UNDEF;
+	bool is_set = false;
+	uint16_t id = 0;
+
+	if (em_tmo_get_type(event, &tmo, false) != EM_TMO_TYPE_PERIODIC ||
+	    em_tmo_get_state(tmo) != EM_TMO_STATE_ACTIVE ||
+	    em_event_uarea_id_get(event, &is_set, &id) != EM_OK ||
+	    !is_set || id >= max_id) {
+		(void)em_tmo_get_type(event, NULL, true);
+		em_free(event);
+		return;
+	}
+
+	thr_args_t *thr = &gbl_args->thr[id / REPEAT_COUNT];
+
+	thr->event_tbl[id % REPEAT_COUNT] = event;
+	odp_atomic_inc_u32(&thr->num_received);
+}
+
+/* Create and start the EO receiving the timeout events and its queue */
+static int create_eo(void)
+{
+	em_status_t err, start_err = EM_ERROR;
+	em_queue_t queue;
+	em_eo_t eo;
+
+	eo = em_eo_create("bench-timer-eo", eo_start, NULL, eo_stop, NULL,
+			  eo_receive, NULL);
+	if (eo == EM_EO_UNDEF) {
+		ODPH_ERR("EO create failed\n");
+		return -1;
+	}
+	gbl_args->eo = eo;
+
+	queue = em_queue_create("timeout-queue", EM_QUEUE_TYPE_ATOMIC, EM_QUEUE_PRIO_NORMAL,
+				EM_QUEUE_GROUP_DEFAULT, NULL);
+	if (queue == EM_QUEUE_UNDEF) {
+		ODPH_ERR("EM queue create failed\n");
+		return -1;
+	}
+	gbl_args->queue = queue;
+
+	if (em_eo_add_queue_sync(eo, queue) != EM_OK) {
+		ODPH_ERR("EO add queue failed\n");
+		return -1;
+	}
+
+	/* No local start function, the start completes on this core */
+	err = em_eo_start_sync(eo, &start_err, NULL);
+	if (err != EM_OK || start_err != EM_OK) {
+		ODPH_ERR("EO start failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Stop and delete the EO and its queue. Called while the workers keep
+ * dispatching, em_eo_stop_sync() needs all EM cores to respond.
+ */
+static int delete_eo(void)
+{
+	int ret = 0;
+
+	if (gbl_args->eo == EM_EO_UNDEF)
+		return 0;
+
+	if (em_eo_get_state(gbl_args->eo) == EM_EO_STATE_RUNNING &&
+	    em_eo_stop_sync(gbl_args->eo) != EM_OK) {
+		ODPH_ERR("EO stop failed\n");
+		ret = -1;
+	}
+
+	/* Also deletes the queue of the EO */
+	if (em_eo_delete(gbl_args->eo) != EM_OK) {
+		ODPH_ERR("EO delete failed\n");
+		ret = -1;
+	}
+	gbl_args->eo = EM_EO_UNDEF;
+
+	return ret;
+}
+
+/* Create the timer and the timeouts reused by the workers */
+static int create_timer(void)
+{
+	const int num_workers = gbl_args->run_bench_arg.opt.num_workers;
+	em_timer_attr_t attr;
+	uint64_t start_ns;
+	em_timer_t timer;
+
+	em_timer_attr_init(&attr);
+	strncpy(attr.name, "bench-timer", EM_TIMER_NAME_LEN - 1);
+	/* Reused one-shot and periodic timeouts plus the ones of the create test */
+	attr.num_tmo = 3 * REPEAT_COUNT * num_workers;
+
+	timer = em_timer_create(&attr);
+	if (timer == EM_TIMER_UNDEF) {
+		ODPH_ERR("Timer create failed\n");
+		return -1;
+	}
+	gbl_args->timer = timer;
+
+	if (em_timer_get_attr(timer, &attr) != EM_OK) {
+		ODPH_ERR("Timer get attr failed\n");
+		return -1;
+	}
+
+	start_ns = 2 * attr.resparam.min_tmo;
+	if (start_ns < START_NS)
+		start_ns = START_NS;
+	gbl_args->start_ticks = em_timer_ns_to_tick(timer, start_ns);
+	gbl_args->tmo_ticks = em_timer_ns_to_tick(timer, TMO_NS);
+
+	for (int i = 0; i < num_workers; i++) {
+		thr_args_t *thr = &gbl_args->thr[i];
+
+		for (int j = 0; j < REPEAT_COUNT; j++) {
+			thr->tmo_tbl[j] = em_tmo_create(timer, EM_TMO_FLAG_ONESHOT,
+							gbl_args->queue);
+			thr->periodic_tmo_tbl[j] = em_tmo_create(timer, EM_TMO_FLAG_PERIODIC,
+								 gbl_args->queue);
+			if (thr->tmo_tbl[j] == EM_TMO_UNDEF ||
+			    thr->periodic_tmo_tbl[j] == EM_TMO_UNDEF) {
+				ODPH_ERR("Timeout create failed\n");
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int delete_timer(void)
+{
+	em_event_t event;
+	int ret = 0;
+
+	if (gbl_args->timer == EM_TIMER_UNDEF)
+		return 0;
+
+	for (int i = 0; i < gbl_args->run_bench_arg.opt.num_workers; i++) {
+		thr_args_t *thr = &gbl_args->thr[i];
+
+		for (int j = 0; j < REPEAT_COUNT; j++) {
+			if (thr->tmo_tbl[j] != EM_TMO_UNDEF &&
+			    em_tmo_delete(thr->tmo_tbl[j], &event) != EM_OK)
+				ret = -1;
+			if (thr->periodic_tmo_tbl[j] != EM_TMO_UNDEF &&
+			    em_tmo_delete(thr->periodic_tmo_tbl[j], &event) != EM_OK)
+				ret = -1;
+			thr->tmo_tbl[j] = EM_TMO_UNDEF;
+			thr->periodic_tmo_tbl[j] = EM_TMO_UNDEF;
+		}
+	}
+
+	if (ret)
+		ODPH_ERR("Timeout delete failed\n");
+
+	if (em_timer_delete(gbl_args->timer) != EM_OK) {
+		ODPH_ERR("Timer delete failed\n");
+		ret = -1;
+	}
+	gbl_args->timer = EM_TIMER_UNDEF;
+
+	return ret;
+}
+
+static void create_events(void)
+{
+	em_event_t *event_tbl = thr_args()->event_tbl;
+	const int id_base = bench_worker_idx() * REPEAT_COUNT;
+	int num_events = 0;
+	int num_retries = 0;
+
+	while (num_events < REPEAT_COUNT) {
+		int ret;
+
+		ret = em_alloc_multi(&event_tbl[num_events], REPEAT_COUNT - num_events,
+				     EVENT_SIZE, EM_EVENT_TYPE_SW, EM_POOL_DEFAULT);
+		if (ret < 1) {
+			num_retries++;
+			if (ret < 0 || num_retries > MAX_RETRY)
+				ODPH_ABORT("Allocating test events failed\n");
+			continue;
+		}
+		num_retries = 0;
+		num_events += ret;
+	}
+
+	for (int i = 0; i < REPEAT_COUNT; i++) {
+		if (em_event_uarea_id_set(event_tbl[i], id_base + i) != EM_OK)
+			ODPH_ABORT("Setting event user area ID failed\n");
+	}
+}
+
+static void free_events(void)
+{
+	em_event_t *event_tbl = thr_args()->event_tbl;
+
+	for (int i = 0; i < REPEAT_COUNT; i++) {
+		if (event_tbl[i] != EM_EVENT_UNDEF) {
+			em_free(event_tbl[i]);
+			event_tbl[i] = EM_EVENT_UNDEF;
+		}
+	}
+}
+
+static void create_tmos(void)
+{
+	em_tmo_t *tmo_tbl = thr_args()->new_tmo_tbl;
+
+	for (int i = 0; i < REPEAT_COUNT; i++) {
+		tmo_tbl[i] = em_tmo_create(gbl_args->timer, EM_TMO_FLAG_ONESHOT,
+					   gbl_args->queue);
+		if (tmo_tbl[i] == EM_TMO_UNDEF)
+			ODPH_ABORT("Creating test timeouts failed\n");
+	}
+}
+
+static void delete_tmos(void)
+{
+	em_tmo_t *tmo_tbl = thr_args()->new_tmo_tbl;
+	em_event_t event;
+
+	for (int i = 0; i < REPEAT_COUNT; i++) {
+		if (em_tmo_delete(tmo_tbl[i], &event) != EM_OK)
+			ODPH_ABORT("Deleting test timeouts failed\n");
+		tmo_tbl[i] = EM_TMO_UNDEF;
+	}
+}
+
+/* Cancel the timeouts set in the test and free the returned events */
+static void cancel_tmos(em_tmo_t tmo_tbl[])
+{
+	em_event_t *event_tbl = thr_args()->event_tbl;
+
+	for (int i = 0; i < REPEAT_COUNT; i++) {
+		em_event_t event = EM_EVENT_UNDEF;
+
+		/* A late periodic timeout event is freed by the receive function */
+		if (em_tmo_cancel(tmo_tbl[i], &event) == EM_OK && event != EM_EVENT_UNDEF)
+			em_free(event);
+		event_tbl[i] = EM_EVENT_UNDEF;
+	}
+}
+
+static void cancel_oneshot_tmos(void)
+{
+	cancel_tmos(thr_args()->tmo_tbl);
+}
+
+static void cancel_periodic_tmos(void)
+{
+	cancel_tmos(thr_args()->periodic_tmo_tbl);
+}
+
+static void create_events_set_tmos(void)
+{
+	thr_args_t *thr = thr_args();
+
+	create_events();
+
+	for (int i = 0; i < REPEAT_COUNT; i++) {
+		if (em_tmo_set_rel(thr->tmo_tbl[i], gbl_args->tmo_ticks,
+				   thr->event_tbl[i]) != EM_OK)
+			ODPH_ABORT("Setting test timeouts failed\n");
+		thr->event_tbl[i] = EM_EVENT_UNDEF;
+	}
+}
+
+/*
+ * Start the periodic timeouts and dispatch until the first timeout event of
+ * each has been received, em_tmo_ack() can be called only after that.
+ */
+static void start_periodic_tmos(void)
+{
+	thr_args_t *thr = thr_args();
+	em_timer_tick_t start;
+
+	create_events();
+	odp_atomic_store_u32(&thr->num_received, 0);
+
+	start = em_timer_current_tick(gbl_args->timer) + gbl_args->start_ticks;
+
+	for (int i = 0; i < REPEAT_COUNT; i++) {
+		if (em_tmo_set_periodic(thr->periodic_tmo_tbl[i], start, gbl_args->tmo_ticks,
+					thr->event_tbl[i]) != EM_OK)
+			ODPH_ABORT("Setting periodic test timeouts failed\n");
+		thr->event_tbl[i] = EM_EVENT_UNDEF;
+	}
+
+	while (odp_atomic_load_u32(&thr->num_received) < REPEAT_COUNT) {
+		if (em_dispatch_rounds(1, NULL, NULL) != EM_OK)
+			ODPH_ABORT("Dispatching timeout events failed\n");
+	}
+}
+
+/**
+ * Test functions
+ */
+
+static int timer_current_tick(void)
+{
+	em_timer_tick_t *tick_tbl = thr_args()->tick_tbl;
+	const em_timer_t timer = gbl_args->timer;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++)
+		tick_tbl[i] = em_timer_current_tick(timer);
+
+	return i;
+}
+
+static int tmo_create(void)
+{
+	em_tmo_t *tmo_tbl = thr_args()->new_tmo_tbl;
+	const em_timer_t timer = gbl_args->timer;
+	const em_queue_t queue = gbl_args->queue;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		tmo_tbl[i] = em_tmo_create(timer, EM_TMO_FLAG_ONESHOT, queue);
+		if (unlikely(tmo_tbl[i] == EM_TMO_UNDEF))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+static int tmo_delete(void)
+{
+	em_tmo_t *tmo_tbl = thr_args()->new_tmo_tbl;
+	em_event_t event;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_tmo_delete(tmo_tbl[i], &event);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+		tmo_tbl[i] = EM_TMO_UNDEF;
+	}
+
+	return i;
+}
+
+static int tmo_set_rel(void)
+{
+	thr_args_t *thr = thr_args();
+	const em_timer_tick_t ticks = gbl_args->tmo_ticks;
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_tmo_set_rel(thr->tmo_tbl[i], ticks, thr->event_tbl[i]);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+static int tmo_cancel(void)
+{
+	thr_args_t *thr = thr_args();
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_tmo_cancel(thr->tmo_tbl[i], &thr->event_tbl[i]);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+static int tmo_ack(void)
+{
+	thr_args_t *thr = thr_args();
+	em_status_t err;
+	int i;
+
+	for (i = 0; BENCH_LOOP(i, REPEAT_COUNT); i++) {
+		err = em_tmo_ack(thr->periodic_tmo_tbl[i], thr->event_tbl[i]);
+		if (unlikely(err != EM_OK))
+			return 0; /* error */
+	}
+
+	return i;
+}
+
+bench_info_t test_suite[] = {
+	BENCH_INFO(timer_current_tick, NULL, NULL, 0, NULL),
+	BENCH_INFO(tmo_create, NULL, delete_tmos, 0, NULL),
+	BENCH_INFO(tmo_delete, create_tmos, NULL, 0, NULL),
+	BENCH_INFO(tmo_set_rel, create_events, cancel_oneshot_tmos, 0, NULL),
+	BENCH_INFO(tmo_cancel, create_events_set_tmos, free_events, 0, NULL),
+	BENCH_INFO(tmo_ack, start_periodic_tmos, cancel_periodic_tmos, 100, NULL),
+};
+
+static void init_default_pool_config(em_pool_cfg_t *pool_conf, int num_workers)
+{
+	em_pool_cfg_init(pool_conf);
+
+	pool_conf->event_type = EM_EVENT_TYPE_SW;
+	pool_conf->user_area.in_use = true;
+	pool_conf->user_area.size = UAREA_SIZE;
+	pool_conf->num_subpools = 1;
+	pool_conf->subpool[0].size = EVENT_SIZE;
+	pool_conf->subpool[0].num = 2 * REPEAT_COUNT * num_workers;
+}
+
+/* Create the EO and the timer, 'data' is the shared program data */
+static int init_bench(void *data)
+{
+	gbl_args = data;
+	gbl_args->timer = EM_TIMER_UNDEF;
+	gbl_args->eo = EM_EO_UNDEF;
+	for (int i = 0; i < gbl_args->run_bench_arg.opt.num_workers; i++) {
+		odp_atomic_init_u32(&gbl_args->thr[i].num_received, 0);
+		for (int j = 0; j < REPEAT_COUNT; j++) {
+			gbl_args->thr[i].tmo_tbl[j] = EM_TMO_UNDEF;
+			gbl_args->thr[i].periodic_tmo_tbl[j] = EM_TMO_UNDEF;
+		}
+	}
+
+	if (create_eo())
+		return -1;
+
+	return create_timer();
+}
+
+/* Delete the timer and the EO while the workers are still dispatching */
+static int term_dispatching(void)
+{
+	int ret = 0;
+
+	if (delete_timer())
+		ret = -1;
+	if (delete_eo())
+		ret = -1;
+
+	return ret;
+}
+
+static const bench_suite_t bench_suite = {
+	.name = "bench_timer",
+	.desc = "EM timer API micro benchmarks",
+	.bench = test_suite,
+	.num_bench = ARRAY_SIZE(test_suite),
+	.data_size = sizeof(gbl_args_t),
+	.worker_size = sizeof(thr_args_t),
+	.pool_config = init_default_pool_config,
+	.event_timer = 1,
+	/* Workers serve em_eo_stop_sync() in delete_eo() */
+	.keep_dispatching = 1,
+	.init = init_bench,
+	.term_dispatching = term_dispatching,
+};
+
+int main(int argc, char *argv[])
+{
+	return bench_main(argc, argv, &bench_suite);
+}
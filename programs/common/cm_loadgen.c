@@ -0,0 +1,642 @@
+/*
+ *   Copyright (c) 2023, Nokia Solutions and Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+ /**
+  * @file
+  *
+  * EM-ODP open-loop load generator
+  */
+#include <inttypes.h>
+#include <math.h>
+
+#include <odp_api.h>
+#include <event_machine.h>
+#include <event_machine/platform/env/environment.h>
+
+#include "cm_setup.h"
+#include "cm_loadgen.h"
+
+#define LOADGEN_MAGIC  0x10ad6e40
+
+/** Maximum number of events sent per input poll, catch-up is spread out */
+#define LOADGEN_MAX_BURST  64
+
+/** Result print interval */
+#define LOADGEN_PRINT_NS  (2 * ODP_TIME_SEC_IN_NS)
+
+/** Max wait for the generator core to acknowledge a stop */
+#define LOADGEN_STOP_TMO_NS  ODP_TIME_SEC_IN_NS
+
+/*
+ * Latency histogram: values below 2^HIST_SUB_BITS ns have their own buckets,
+ * above that each power of two is split into 2^HIST_SUB_BITS linear buckets
+ * (max error 12.5%). Values beyond 2^HIST_MAX_BITS ns go into the last bucket.
+ */
+#define HIST_SUB_BITS  3
+#define HIST_SUB  (1 << HIST_SUB_BITS)
+#define HIST_MAX_BITS  40
+#define HIST_BUCKETS  ((HIST_MAX_BITS - HIST_SUB_BITS + 1) * HIST_SUB)
+
+/** Generator state */
+enum {
+	LOADGEN_IDLE = 0,
+	LOADGEN_RUNNING,
+	/* Stop requested, waiting for the generator core to acknowledge */
+	LOADGEN_STOPPING,
+	LOADGEN_STOPPED
+};
+
+/** Latency statistics of one EM-core, only written by that core */
+typedef struct {
+	uint64_t count;
+	uint64_t sum_ns;
+	uint64_t max_ns;
+	uint64_t hist[HIST_BUCKETS];
+} ODP_ALIGNED_CACHE loadgen_core_stat_t;
+
+/** Generator state, only accessed by the generator core after start */
+typedef struct {
+	uint64_t start_ns;
+	/* Next intended send time relative to 'start_ns' */
+	double next_ns;
+	/* Average interval between events */
+	double interval_ns;
+	/* Events left of the current burst (LOADGEN_BURSTY) */
+	uint32_t burst_left;
+	uint32_t queue_idx;
+	uint64_t rng;
+
+	uint64_t sent;
+	/* Failed alloc or send attempts, the event is retried at the next poll */
+	uint64_t alloc_fail;
+	uint64_t send_fail;
+	/* Events due but never sent before the stop, charged in gen_stop() */
+	uint64_t unsent;
+	/* Largest delay behind the schedule seen at a poll */
+	uint64_t max_lag_ns;
+
+	uint64_t print_ns;
+	uint64_t print_sent;
+	uint64_t print_done;
+} ODP_ALIGNED_CACHE loadgen_gen_t;
+
+typedef struct {
+	odp_atomic_u32_t state;
+	/* EM-core dedicated to the generator */
+	int gen_core;
+	em_queue_group_t queue_group;
+
+	em_queue_t queues[LOADGEN_MAX_QUEUES];
+	int num_queues;
+	em_pool_t pool;
+	uint32_t event_size;
+	uint32_t hops;
+
+	loadgen_gen_t gen;
+	loadgen_core_stat_t core_stat[MAX_THREADS];
+} loadgen_shm_t;
+
+static loadgen_shm_t *loadgen_shm;
+
+const char *loadgen_mode_str(loadgen_mode_t mode)
+{
+	const char *str;
+
+	switch (mode) {
+	case LOADGEN_DISABLED:
+		str = "disabled";
+		break;
+	case LOADGEN_CONSTANT:
+		str = "const";
+		break;
+	case LOADGEN_POISSON:
+		str = "poisson";
+		break;
+	case LOADGEN_BURSTY:
+		str = "burst";
+		break;
+	default:
+		str = "UNKNOWN";
+		break;
+	}
+
+	return str;
+}
+
+int loadgen_parse(const char *str, loadgen_conf_t *conf /* out */)
+{
+	char mode[16];
+	unsigned long long rate = 0;
+	unsigned int burst = 0;
+	int num;
+
+	num = sscanf(str, "%15[^,],%llu,%u", mode, &rate, &burst);
+	if (num < 2 || rate == 0)
+		return -1;
+
+	if (!strcmp(mode, "const"))
+		conf->mode = LOADGEN_CONSTANT;
+	else if (!strcmp(mode, "poisson"))
+		conf->mode = LOADGEN_POISSON;
+	else if (!strcmp(mode, "burst"))
+		conf->mode = LOADGEN_BURSTY;
+	else
+		return -1;
+
+	if (conf->mode == LOADGEN_BURSTY && burst == 0)
+		return -1;
+
+	conf->rate = rate;
+	conf->burst = conf->mode == LOADGEN_BURSTY ? burst : 1;
+
+	return 0;
+}
+
+void loadgen_mem_reserve(void)
+{
+	odp_shm_t shm;
+	uint32_t flags = 0;
+
+	/* Sanity check: loadgen_shm should not be set yet */
+	if (unlikely(loadgen_shm != NULL))
+		APPL_EXIT_FAILURE("loadgen shared memory ptr set - already initialized?");
+
+#if ODP_VERSION_API_NUM(1, 33, 0) > ODP_VERSION_API
+	flags |= ODP_SHM_SINGLE_VA;
+#else
+	odp_shm_capability_t shm_capa;
+	int ret = odp_shm_capability(&shm_capa);
+
+	if (unlikely(ret))
+		APPL_EXIT_FAILURE("shm capability error:%d", ret);
+
+	if (shm_capa.flags & ODP_SHM_SINGLE_VA)
+		flags |= ODP_SHM_SINGLE_VA;
+#endif
+	shm = odp_shm_reserve("loadgen_shm", sizeof(loadgen_shm_t),
+			      ODP_CACHE_LINE_SIZE, flags);
+	if (unlikely(shm == ODP_SHM_INVALID))
+		APPL_EXIT_FAILURE("loadgen shared mem reserve failed.");
+
+	loadgen_shm = odp_shm_addr(shm);
+	if (unlikely(loadgen_shm == NULL))
+		APPL_EXIT_FAILURE("obtaining loadgen shared mem addr failed.");
+
+	memset(loadgen_shm, 0, sizeof(loadgen_shm_t));
+	odp_atomic_init_u32(&loadgen_shm->state, LOADGEN_IDLE);
+	loadgen_shm->gen_core = -1;
+	loadgen_shm->queue_group = EM_QUEUE_GROUP_UNDEF;
+}
+
+void loadgen_mem_lookup(bool is_thread_per_core)
+{
+	odp_shm_t shm;
+	loadgen_shm_t *shm_addr;
+
+	shm = odp_shm_lookup("loadgen_shm");
+
+	shm_addr = odp_shm_addr(shm);
+	if (unlikely(shm_addr == NULL))
+		APPL_EXIT_FAILURE("loadgen shared mem addr lookup failed.");
+
+	/*
+	 * Set loadgen_shm in process-per-core mode, each process has own pointer.
+	 */
+	if (!is_thread_per_core && loadgen_shm != shm_addr)
+		loadgen_shm = shm_addr;
+}
+
+void loadgen_mem_free(void)
+{
+	odp_shm_t shm;
+
+	shm = odp_shm_lookup("loadgen_shm");
+	if (unlikely(shm == ODP_SHM_INVALID))
+		APPL_EXIT_FAILURE("loadgen shared mem lookup for free failed.");
+
+	if (odp_shm_free(shm) != 0)
+		APPL_EXIT_FAILURE("loadgen shared mem free failed.");
+	loadgen_shm = NULL;
+}
+
+bool loadgen_enabled(void)
+{
+	return appl_shm->appl_conf.loadgen.mode != LOADGEN_DISABLED;
+}
+
+/* The last EM-core runs the generator */
+static int gen_core_id(void)
+{
+	return em_core_count() - 1;
+}
+
+em_queue_group_t loadgen_queue_group(void)
+{
+	em_core_mask_t mask;
+	em_queue_group_t group;
+
+	if (!loadgen_enabled())
+		return EM_QUEUE_GROUP_DEFAULT;
+
+	if (loadgen_shm->queue_group != EM_QUEUE_GROUP_UNDEF)
+		return loadgen_shm->queue_group;
+
+	em_core_mask_zero(&mask);
+	em_core_mask_set_count(em_core_count(), &mask);
+	em_core_mask_clr(gen_core_id(), &mask);
+
+	group = em_queue_group_create_sync("loadgen-workers", &mask);
+	if (unlikely(group == EM_QUEUE_GROUP_UNDEF))
+		APPL_EXIT_FAILURE("loadgen queue group create failed");
+
+	loadgen_shm->queue_group = group;
+
+	return group;
+}
+
+void loadgen_start(const em_queue_t queues[], int num_queues, em_pool_t pool,
+		   uint32_t event_size, uint32_t hops)
+{
+	const loadgen_conf_t *conf = &appl_shm->appl_conf.loadgen;
+	loadgen_gen_t *gen = &loadgen_shm->gen;
+
+	if (unlikely(num_queues < 1 || num_queues > LOADGEN_MAX_QUEUES || hops < 1))
+		APPL_EXIT_FAILURE("loadgen: invalid queues:%d or hops:%u",
+				  num_queues, hops);
+
+	for (int i = 0; i < num_queues; i++)
+		loadgen_shm->queues[i] = queues[i];
+	loadgen_shm->num_queues = num_queues;
+	loadgen_shm->pool = pool;
+	loadgen_shm->event_size = MAX(event_size, (uint32_t)sizeof(loadgen_hdr_t));
+	loadgen_shm->hops = hops;
+	loadgen_shm->gen_core = gen_core_id();
+
+	gen->interval_ns = (double)ODP_TIME_SEC_IN_NS / (double)conf->rate;
+	gen->burst_left = conf->burst;
+	gen->rng = odp_time_global_ns() | 1;
+	gen->start_ns = odp_time_global_ns();
+	gen->print_ns = gen->start_ns + LOADGEN_PRINT_NS;
+
+	APPL_PRINT("\nLoad generator on EM-core:%02d: %s, %" PRIu64 " events/s",
+		   loadgen_shm->gen_core, loadgen_mode_str(conf->mode), conf->rate);
+	if (conf->mode == LOADGEN_BURSTY)
+		APPL_PRINT(", burst %u", conf->burst);
+	APPL_PRINT(", %d queues, %u hops\n\n", num_queues, hops);
+
+	odp_atomic_store_rel_u32(&loadgen_shm->state, LOADGEN_RUNNING);
+}
+
+/* xorshift64*: uniform in [0, 1) */
+static inline double rand_uniform(loadgen_gen_t *gen)
+{
+	uint64_t x = gen->rng;
+
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	gen->rng = x;
+
+	return (double)((x * 0x2545F4914F6CDD1DULL) >> 11) / (double)(1ULL << 53);
+}
+
+/* Advance the schedule to the intended send time of the next event */
+static inline void schedule_next(loadgen_gen_t *gen, loadgen_mode_t mode, uint32_t burst)
+{
+	switch (mode) {
+	case LOADGEN_POISSON:
+		gen->next_ns += -log(1.0 - rand_uniform(gen)) * gen->interval_ns;
+		break;
+	case LOADGEN_BURSTY:
+		if (--gen->burst_left == 0) {
+			gen->next_ns += gen->interval_ns * burst;
+			gen->burst_left = burst;
+		}
+		break;
+	default:
+		gen->next_ns += gen->interval_ns;
+		break;
+	}
+}
+
+/*
+ * Send the event intended for 'send_ns'. Returns false if it could not be
+ * allocated or sent, the system is overloaded: the caller retries it later
+ * with the same intended send time so that the delay is charged to it.
+ */
+static inline bool send_event(loadgen_gen_t *gen, uint64_t send_ns)
+{
+	em_event_t event;
+	loadgen_hdr_t *hdr;
+	em_queue_t queue;
+
+	event = em_alloc(loadgen_shm->event_size, EM_EVENT_TYPE_SW, loadgen_shm->pool);
+	if (unlikely(event == EM_EVENT_UNDEF)) {
+		gen->alloc_fail++;
+		return false;
+	}
+
+	hdr = em_event_pointer(event);
+	hdr->send_ns = send_ns;
+	hdr->hops = loadgen_shm->hops;
+	hdr->magic = LOADGEN_MAGIC;
+
+	queue = loadgen_shm->queues[gen->queue_idx];
+
+	if (unlikely(em_send(event, queue) != EM_OK)) {
+		em_free(event);
+		gen->send_fail++;
+		return false;
+	}
+
+	if (++gen->queue_idx == (uint32_t)loadgen_shm->num_queues)
+		gen->queue_idx = 0;
+	gen->sent++;
+
+	return true;
+}
+
+static inline int hist_idx(uint64_t ns)
+{
+	int msb, idx;
+
+	if (ns < HIST_SUB)
+		return (int)ns;
+
+	msb = 63 - __builtin_clzll(ns);
+	if (msb > HIST_MAX_BITS)
+		return HIST_BUCKETS - 1;
+
+	idx = (msb - HIST_SUB_BITS + 1) * HIST_SUB +
+	      (int)((ns >> (msb - HIST_SUB_BITS)) & (HIST_SUB - 1));
+
+	return MIN(idx, HIST_BUCKETS - 1);
+}
+
+/* Middle value of a histogram bucket */
+static uint64_t hist_value(int idx)
+{
+	int shift;
+
+	if (idx < HIST_SUB)
+		return idx;
+
+	shift = idx / HIST_SUB - 1;
+
+	return ((uint64_t)(HIST_SUB + idx % HIST_SUB) << shift) + ((1ULL << shift) >> 1);
+}
+
+static inline void stat_add(loadgen_core_stat_t *stat, uint64_t lat)
+{
+	stat->count++;
+	stat->sum_ns += lat;
+	if (lat > stat->max_ns)
+		stat->max_ns = lat;
+	stat->hist[hist_idx(lat)]++;
+}
+
+bool loadgen_receive(em_event_t event)
+{
+	loadgen_hdr_t *hdr = em_event_pointer(event);
+	uint64_t now, lat;
+
+	if (unlikely(hdr->magic != LOADGEN_MAGIC))
+		return false;
+
+	if (--hdr->hops > 0)
+		return false;
+
+	now = odp_time_global_ns();
+	lat = now > hdr->send_ns ? now - hdr->send_ns : 0;
+	hdr->magic = 0;
+	em_free(event);
+
+	stat_add(&loadgen_shm->core_stat[em_core_id()], lat);
+
+	return true;
+}
+
+/* Collect the latency results of all cores into 'sum' */
+static void collect_stats(loadgen_core_stat_t *sum)
+{
+	const int num_cores = em_core_count();
+
+	memset(sum, 0, sizeof(*sum));
+
+	for (int c = 0; c < num_cores; c++) {
+		const loadgen_core_stat_t *stat = &loadgen_shm->core_stat[c];
+
+		sum->count += stat->count;
+		sum->sum_ns += stat->sum_ns;
+		sum->max_ns = MAX(sum->max_ns, stat->max_ns);
+		for (int i = 0; i < HIST_BUCKETS; i++)
+			sum->hist[i] += stat->hist[i];
+	}
+}
+
+static double percentile_us(const loadgen_core_stat_t *sum, double pct)
+{
+	const uint64_t target = (uint64_t)ceil(sum->count * pct / 100.0);
+	uint64_t cnt = 0;
+
+	if (sum->count == 0)
+		return 0.0;
+
+	for (int i = 0; i < HIST_BUCKETS; i++) {
+		cnt += sum->hist[i];
+		if (cnt >= target && cnt > 0)
+			return MIN(hist_value(i), sum->max_ns) / 1000.0;
+	}
+
+	return sum->max_ns / 1000.0;
+}
+
+/*
+ * Print the send and completion rates since the previous print (whole run if
+ * 'final') and the latency percentiles since the start.
+ */
+static void print_results(uint64_t now, bool final)
+{
+	const loadgen_conf_t *conf = &appl_shm->appl_conf.loadgen;
+	loadgen_gen_t *gen = &loadgen_shm->gen;
+	static ENV_LOCAL loadgen_core_stat_t total;
+	uint64_t begin_ns = gen->print_ns - LOADGEN_PRINT_NS;
+	double sec;
+
+	collect_stats(&total);
+
+	if (final) {
+		begin_ns = gen->start_ns;
+		gen->print_sent = 0;
+		gen->print_done = 0;
+		APPL_PRINT("\nLoad generator results (%s, %" PRIu64 " events/s):\n",
+			   loadgen_mode_str(conf->mode), conf->rate);
+	}
+	sec = (double)(now - begin_ns) / ODP_TIME_SEC_IN_NS;
+
+	APPL_PRINT("loadgen: sent %.0f ev/s done %.0f ev/s stall %" PRIu64 " lag-max %.1f us"
+		   " | latency(us) avg %.1f p50 %.1f p90 %.1f p99 %.1f p99.9 %.1f max %.1f\n",
+		   (gen->sent - gen->print_sent) / sec,
+		   (total.count - gen->unsent - gen->print_done) / sec,
+		   gen->alloc_fail + gen->send_fail, gen->max_lag_ns / 1000.0,
+		   total.count ? (double)total.sum_ns / total.count / 1000.0 : 0.0,
+		   percentile_us(&total, 50.0), percentile_us(&total, 90.0),
+		   percentile_us(&total, 99.0), percentile_us(&total, 99.9),
+		   total.max_ns / 1000.0);
+
+	if (final) {
+		APPL_PRINT("loadgen: total sent %" PRIu64 " done %" PRIu64 " unsent %" PRIu64
+			   " (in the latency results with their overdue time)\n"
+			   "loadgen: failed alloc %" PRIu64 " send %" PRIu64
+			   " (retried, delay charged to the event)\n\n",
+			   gen->sent, total.count - gen->unsent, gen->unsent,
+			   gen->alloc_fail, gen->send_fail);
+		return;
+	}
+
+	gen->print_sent = gen->sent;
+	gen->print_done = total.count;
+	gen->print_ns = now + LOADGEN_PRINT_NS;
+}
+
+/*
+ * Stop sending, on the generator core. The events due by now but never sent
+ * are charged with the time they are overdue, a lower bound of the latency
+ * they would have had. The results are stable after LOADGEN_STOPPED.
+ */
+static void gen_stop(void)
+{
+	const loadgen_conf_t *conf = &appl_shm->appl_conf.loadgen;
+	loadgen_gen_t *gen = &loadgen_shm->gen;
+	loadgen_core_stat_t *stat = &loadgen_shm->core_stat[em_core_id()];
+	const uint64_t rel_ns = odp_time_global_ns() - gen->start_ns;
+
+	while (gen->next_ns <= (double)rel_ns) {
+		stat_add(stat, rel_ns - (uint64_t)gen->next_ns);
+		gen->unsent++;
+		schedule_next(gen, conf->mode, conf->burst);
+	}
+
+	odp_atomic_store_rel_u32(&loadgen_shm->state, LOADGEN_STOPPED);
+}
+
+int loadgen_pollfn(void)
+{
+	const loadgen_conf_t *conf = &appl_shm->appl_conf.loadgen;
+	loadgen_gen_t *gen;
+	uint64_t now, rel_ns;
+	uint32_t state;
+	int num = 0;
+
+	if (likely(em_core_id() != loadgen_shm->gen_core))
+		return 0;
+
+	state = odp_atomic_load_acq_u32(&loadgen_shm->state);
+	if (unlikely(state != LOADGEN_RUNNING)) {
+		/* Acknowledge the stop requested by loadgen_stop() */
+		if (state == LOADGEN_STOPPING)
+			gen_stop();
+		return 0;
+	}
+
+	if (unlikely(appl_shm->exit_flag))
+		return 0;
+
+	gen = &loadgen_shm->gen;
+	now = odp_time_global_ns();
+	rel_ns = now - gen->start_ns;
+
+	/*
+	 * Send all events due by now, spread a large catch-up over several polls.
+	 * An event that cannot be sent now is retried at the next poll.
+	 */
+	while (gen->next_ns <= (double)rel_ns && num < LOADGEN_MAX_BURST) {
+		if (unlikely(!send_event(gen, gen->start_ns + (uint64_t)gen->next_ns)))
+			break;
+		schedule_next(gen, conf->mode, conf->burst);
+		num++;
+	}
+
+	if (gen->next_ns < (double)rel_ns) {
+		uint64_t lag = rel_ns - (uint64_t)gen->next_ns;
+
+		if (lag > gen->max_lag_ns)
+			gen->max_lag_ns = lag;
+	}
+
+	if (unlikely(now >= gen->print_ns))
+		print_results(now, false);
+
+	return num;
+}
+
+void loadgen_stop(void)
+{
+	uint64_t tmo_ns;
+
+	if (!loadgen_enabled() ||
+	    odp_atomic_load_acq_u32(&loadgen_shm->state) != LOADGEN_RUNNING)
+		return;
+
+	if (em_core_id() == loadgen_shm->gen_core) {
+		gen_stop();
+	} else {
+		/*
+		 * The generator core acknowledges in loadgen_pollfn(), it keeps
+		 * dispatching until all cores have left the dispatch loop
+		 */
+		odp_atomic_store_rel_u32(&loadgen_shm->state, LOADGEN_STOPPING);
+		tmo_ns = odp_time_global_ns() + LOADGEN_STOP_TMO_NS;
+
+		while (odp_atomic_load_acq_u32(&loadgen_shm->state) != LOADGEN_STOPPED) {
+			if (odp_time_global_ns() > tmo_ns) {
+				APPL_ERROR("loadgen: no stop ack from EM-core:%02d, results may be inexact\n",
+					   loadgen_shm->gen_core);
+				break;
+			}
+			odp_cpu_pause();
+		}
+	}
+
+	print_results(odp_time_global_ns(), true);
+}
+
+void loadgen_term(void)
+{
+	em_status_t stat;
+
+	if (!loadgen_enabled() || loadgen_shm->queue_group == EM_QUEUE_GROUP_UNDEF)
+		return;
+
+	stat = em_queue_group_delete_sync(loadgen_shm->queue_group);
+	if (stat != EM_OK)
+		APPL_ERROR("loadgen queue group delete failed:%" PRI_STAT "", stat);
+	loadgen_shm->queue_group = EM_QUEUE_GROUP_UNDEF;
+}
@@ -0,0 +1,182 @@
+/*
+ *   Copyright (c) 2023, Nokia Solutions and Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Open-loop load generator for the performance test programs
+ *
+ * Enabled with the common option '-l, --loadgen <mode>,<rate>[,<burst>]'.
+ * The last EM-core is dedicated to the generator: it allocates and sends
+ * events into the application's entry queues at the configured rate from
+ * the EM input poll function and does not process any application events.
+ * The application queues must be created into loadgen_queue_group(), which
+ * contains all the other EM-cores.
+ *
+ * Each event carries its intended send time taken from the rate schedule,
+ * not the actual send time. Events that the generator sends late because the
+ * system could not keep up are thus charged for the whole delay, i.e. the
+ * latency results are corrected for coordinated omission. An event that
+ * cannot be allocated or sent is retried at the next poll with the same
+ * intended send time, and events still unsent at the stop are charged with
+ * the time they are overdue. The end-to-end latency is recorded when the
+ * event has been received 'hops' times.
+ */
+
+#ifndef CM_LOADGEN_H
+#define CM_LOADGEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <event_machine.h>
+
+#include "cm_setup.h"
+
+/** Maximum number of entry queues given to loadgen_start() */
+#define LOADGEN_MAX_QUEUES  1024
+
+/**
+ * Load generator header at the start of the event payload, the application
+ * must not modify the payload of load generator events.
+ */
+typedef struct {
+	/** Intended send time from the rate schedule (ns) */
+	uint64_t send_ns;
+	/** Receives left before the latency is recorded */
+	uint32_t hops;
+	/** Identifies load generator events */
+	uint32_t magic;
+} loadgen_hdr_t;
+
+const char *loadgen_mode_str(loadgen_mode_t mode);
+
+/**
+ * Parse the '--loadgen' option value '<mode>,<rate>[,<burst>]'
+ *
+ * @return 0 on success, -1 on error
+ */
+int loadgen_parse(const char *str, loadgen_conf_t *conf /* out */);
+
+/**
+ * Reserve shared memory for the load generator, called once before the
+ * EM-cores are started.
+ */
+void loadgen_mem_reserve(void);
+
+/**
+ * Lookup shared memory for the load generator
+ *
+ * Must be called once by each EM-core before using the load generator.
+ *
+ * @param is_thread_per_core  true:  EM running in thread-per-core mode
+ *                            false: EM running in process-per-core mode
+ */
+void loadgen_mem_lookup(bool is_thread_per_core);
+
+void loadgen_mem_free(void);
+
+/**
+ * @brief Is the open-loop load generator in use
+ *
+ * If true, the application should not send its own initial events but call
+ * loadgen_start() instead.
+ */
+bool loadgen_enabled(void);
+
+/**
+ * @brief Queue group of the application queues
+ *
+ * Returns a queue group of all EM-cores except the load generator core when
+ * the load generator is in use, EM_QUEUE_GROUP_DEFAULT otherwise.
+ * Call on EM-core 0 in test_start().
+ */
+em_queue_group_t loadgen_queue_group(void);
+
+/**
+ * @brief Start sending events into the given queues
+ *
+ * Call on EM-core 0 in test_start() after creating and starting the EOs.
+ * The events are sent round-robin into 'queues[]'.
+ *
+ * @param queues      Entry queues of the test topology
+ * @param num_queues  Number of entries in 'queues[]'
+ * @param pool        Event pool to allocate the events from
+ * @param event_size  Event size, at least sizeof(loadgen_hdr_t) is used
+ * @param hops        Receives per event before its latency is recorded
+ */
+void loadgen_start(const em_queue_t queues[], int num_queues, em_pool_t pool,
+		   uint32_t event_size, uint32_t hops);
+
+/**
+ * @brief Stop sending events and print the final results
+ *
+ * Called by cm_setup before test_stop(). Waits until the generator core has
+ * stopped sending before the results are read.
+ */
+void loadgen_stop(void);
+
+/**
+ * @brief Delete the queue group created by loadgen_queue_group()
+ *
+ * Called by cm_setup after test_stop() has deleted the application queues.
+ */
+void loadgen_term(void);
+
+/**
+ * @brief Account a receive of a load generator event
+ *
+ * Call at the start of the EO receive function. Decrements the hop count of
+ * the event and on the last hop records the end-to-end latency and frees the
+ * event.
+ *
+ * @return true if the event was consumed, the application should return
+ */
+bool loadgen_receive(em_event_t event);
+
+/**
+ * @brief Send load generator events due by now
+ *
+ * Given to EM via 'em_conf.input.input_poll_fn' by cm_setup - only sends
+ * events on the load generator core.
+ *
+ * @return number of events sent
+ */
+int loadgen_pollfn(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
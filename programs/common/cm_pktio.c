@@ -33,6 +33,8 @@
   *
   * EM-ODP packet I/O setup
   */
+#include <time.h>
+
 #include <odp_api.h>
 #include <odp/helper/odph_api.h>
 #include <event_machine.h>
@@ -48,6 +50,37 @@
 #define PKTIO_VEC_SIZE           PKTIO_VEC_POOL_VEC_SIZE
 #define PKTIO_VEC_TMO            ODP_TIME_MSEC_IN_NS
 
+/* Pcap file format, only the classic (not pcapng) format is supported */
+#define PCAP_MAGIC_USEC          0xa1b2c3d4
+#define PCAP_MAGIC_NSEC          0xa1b23c4d
+#define PCAP_LINKTYPE_ETHERNET   1
+
+/* Replay: time given for the output to drain after the last injection */
+#define REPLAY_DRAIN_NS          (500 * ODP_TIME_MSEC_IN_NS)
+
+/* Adaptive pktin polling: empty polls before backing off, initial back-off */
+#define ADAPTIVE_IDLE_POLLS      64
+#define ADAPTIVE_MIN_BACKOFF_NS  1000
+
+/** Pcap file header */
+typedef struct {
+	uint32_t magic;
+	uint16_t version_major;
+	uint16_t version_minor;
+	int32_t thiszone;
+	uint32_t sigfigs;
+	uint32_t snaplen;
+	uint32_t linktype;
+} pcap_file_hdr_t;
+
+/** Pcap record header, followed by 'incl_len' bytes of pkt data */
+typedef struct {
+	uint32_t ts_sec;
+	uint32_t ts_frac;
+	uint32_t incl_len;
+	uint32_t orig_len;
+} pcap_rec_hdr_t;
+
 static pktio_shm_t *pktio_shm;
 static __thread pktio_locm_t pktio_locm ODP_ALIGNED_CACHE;
 
@@ -55,6 +88,14 @@ static inline tx_burst_t *tx_drain_burst_acquire(void);
 static inline int pktin_queue_acquire(odp_pktin_queue_t **pktin_queue_ptr /*out*/);
 static inline odp_queue_t plain_queue_acquire(void);
 
+em_queue_flag_t pktio_queue_flags(em_queue_type_t type)
+{
+	if (pktio_shm->pktout.order_lock && type == EM_QUEUE_TYPE_PARALLEL_ORDERED)
+		return EM_QUEUE_FLAG_ORDER_LOCK;
+
+	return EM_QUEUE_FLAG_DEFAULT;
+}
+
 const char *pktin_mode_str(pktin_mode_t in_mode)
 {
 	const char *str;
@@ -83,6 +124,34 @@ const char *pktin_mode_str(pktin_mode_t in_mode)
 	return str;
 }
 
+const char *pktin_parse_str(odp_proto_layer_t layer)
+{
+	const char *str;
+
+	switch (layer) {
+	case ODP_PROTO_LAYER_NONE:
+		str = "none";
+		break;
+	case ODP_PROTO_LAYER_L2:
+		str = "L2";
+		break;
+	case ODP_PROTO_LAYER_L3:
+		str = "L3";
+		break;
+	case ODP_PROTO_LAYER_L4:
+		str = "L4";
+		break;
+	case ODP_PROTO_LAYER_ALL:
+		str = "all";
+		break;
+	default:
+		str = "UNKNOWN";
+		break;
+	}
+
+	return str;
+}
+
 bool pktin_polled_mode(pktin_mode_t in_mode)
 {
 	return in_mode == DIRECT_RECV ||
@@ -131,6 +200,46 @@ void pktio_mem_reserve(void)
 	memset(pktio_shm, 0, sizeof(pktio_shm_t));
 }
 
+/*
+ * Helper to pktio_mem_lookup(): process-per-core mode, take the pktin queues
+ * 'n % core_count == core', counting over all interfaces, and the pktout
+ * queue 'core' of each interface into exclusive use by this process.
+ */
+static void pktio_proc_init(void)
+{
+	pktio_proc_t *const proc = &pktio_locm.proc;
+	const int core = em_core_id();
+	const int core_count = em_core_count();
+	int n = 0;
+
+	proc->enable = true;
+	proc->num_pktin = 0;
+	proc->next_pktin = 0;
+	proc->tbl_num = 0;
+	memset(proc->tbl, 0, sizeof(proc->tbl));
+
+	for (int i = 0; i < pktio_shm->ifs.count; i++) {
+		const int if_idx = pktio_shm->ifs.idx[i];
+		const int num_out = pktio_shm->pktout.num_queues[if_idx];
+
+		proc->pktout[if_idx] = pktio_shm->pktout.queues[if_idx][core % num_out];
+
+		if (!pktin_polled_mode(pktio_shm->pktin.in_mode))
+			continue;
+
+		for (int q = 0; q < pktio_shm->pktin.num_queues[if_idx]; q++, n++) {
+			if (n % core_count != core)
+				continue;
+			proc->pktin[proc->num_pktin].if_idx = if_idx;
+			proc->pktin[proc->num_pktin].q = q;
+			proc->num_pktin++;
+		}
+	}
+
+	APPL_PRINT("EM-core:%02d pktio: %d own pktin queue(s), own pktout queues\n",
+		   core, proc->num_pktin);
+}
+
 void pktio_mem_lookup(bool is_thread_per_core)
 {
 	odp_shm_t shm;
@@ -147,6 +256,9 @@ void pktio_mem_lookup(bool is_thread_per_core)
 	 */
 	if (!is_thread_per_core && pktio_shm != shm_addr)
 		pktio_shm = shm_addr;
+
+	if (!is_thread_per_core)
+		pktio_proc_init();
 }
 
 void pktio_mem_free(void)
@@ -427,6 +539,166 @@ void pktio_pool_destroy(bool pktpool_em, bool pktin_vector, bool vecpool_em)
 	}
 }
 
+/**
+ * Helper to replay_init(): open a pcap file and check its header
+ */
+static FILE *replay_file_open(const char *file, bool *swap /*out*/)
+{
+	pcap_file_hdr_t hdr;
+	uint32_t linktype;
+	FILE *fp;
+
+	fp = fopen(file, "rb");
+	if (fp == NULL)
+		APPL_EXIT_FAILURE("replay: cannot open pcap file:%s", file);
+
+	if (fread(&hdr, sizeof(hdr), 1, fp) != 1)
+		APPL_EXIT_FAILURE("replay: pcap file:%s too short", file);
+
+	if (hdr.magic == PCAP_MAGIC_USEC || hdr.magic == PCAP_MAGIC_NSEC)
+		*swap = false;
+	else if (hdr.magic == __builtin_bswap32(PCAP_MAGIC_USEC) ||
+		 hdr.magic == __builtin_bswap32(PCAP_MAGIC_NSEC))
+		*swap = true;
+	else
+		APPL_EXIT_FAILURE("replay: %s: not a pcap file, magic:0x%08" PRIx32 "",
+				  file, hdr.magic);
+
+	linktype = *swap ? __builtin_bswap32(hdr.linktype) : hdr.linktype;
+	if (linktype != PCAP_LINKTYPE_ETHERNET)
+		APPL_EXIT_FAILURE("replay: %s: unsupported link type:%" PRIu32 "",
+				  file, linktype);
+
+	return fp;
+}
+
+/**
+ * Helper to replay_init(): read the next pcap record header
+ *
+ * @return captured length of the record's pkt, -1 at the end of the file
+ */
+static int64_t replay_file_next(FILE *fp, bool swap)
+{
+	pcap_rec_hdr_t rec;
+
+	if (fread(&rec, sizeof(rec), 1, fp) != 1)
+		return -1;
+
+	return swap ? __builtin_bswap32(rec.incl_len) : rec.incl_len;
+}
+
+static inline bool replay_pkt_len_ok(int64_t len)
+{
+	/* The injected copies are allocated from the pktio pool */
+	return len >= (int64_t)sizeof(odph_ethhdr_t) &&
+	       len <= PKTIO_PKT_POOL_BUF_SIZE;
+}
+
+/**
+ * Read the pcap file into template pkts allocated from a dedicated pool
+ */
+static void replay_init(const pktio_replay_conf_t *conf)
+{
+	pktio_replay_t *const replay = &pktio_shm->replay;
+	uint8_t data[PKTIO_PKT_POOL_BUF_SIZE];
+	odp_pool_param_t pool_params;
+	uint32_t num = 0;
+	uint32_t skipped = 0;
+	int64_t len;
+	bool swap;
+	FILE *fp;
+
+	replay->rate = conf->rate;
+	replay->loops = conf->loops;
+	strncpy(replay->file, conf->file, sizeof(replay->file) - 1);
+	if (conf->tx_file[0] != '\0')
+		snprintf(replay->tx_dev, sizeof(replay->tx_dev), "pcap:out=%s",
+			 conf->tx_file);
+	else
+		snprintf(replay->tx_dev, sizeof(replay->tx_dev), "null:0");
+
+	/* First pass: count the pkts to size the pool */
+	fp = replay_file_open(conf->file, &swap);
+	while ((len = replay_file_next(fp, swap)) >= 0) {
+		if (fseek(fp, (long)len, SEEK_CUR) != 0)
+			break;
+		if (!replay_pkt_len_ok(len)) {
+			skipped++;
+			continue;
+		}
+		if (num == PKTIO_REPLAY_MAX_PKTS) {
+			APPL_PRINT("\nWarning: replay: only the first %d pkts of %s used\n\n",
+				   PKTIO_REPLAY_MAX_PKTS, conf->file);
+			break;
+		}
+		num++;
+	}
+
+	if (num == 0)
+		APPL_EXIT_FAILURE("replay: no usable pkts in pcap file:%s", conf->file);
+
+	odp_pool_param_init(&pool_params);
+	pool_params.type = ODP_POOL_PACKET;
+	pool_params.pkt.num = num;
+	pool_params.pkt.len = PKTIO_PKT_POOL_BUF_SIZE;
+	pool_params.pkt.max_len = PKTIO_PKT_POOL_BUF_SIZE;
+
+	replay->pool = odp_pool_create("pktio-replay-pool", &pool_params);
+	if (replay->pool == ODP_POOL_INVALID)
+		APPL_EXIT_FAILURE("replay: pool creation failed, pkts:%u", num);
+
+	/* Second pass: read the pkts */
+	if (fseek(fp, sizeof(pcap_file_hdr_t), SEEK_SET) != 0)
+		APPL_EXIT_FAILURE("replay: %s: seek failed", conf->file);
+
+	replay->num_pkts = 0;
+	while (replay->num_pkts < num &&
+	       (len = replay_file_next(fp, swap)) >= 0) {
+		if (!replay_pkt_len_ok(len)) {
+			if (fseek(fp, (long)len, SEEK_CUR) != 0)
+				break;
+			continue;
+		}
+		if (fread(data, len, 1, fp) != 1)
+			break; /* truncated last record */
+
+		odp_packet_t pkt = odp_packet_alloc(replay->pool, len);
+
+		if (unlikely(pkt == ODP_PACKET_INVALID ||
+			     odp_packet_copy_from_mem(pkt, 0, len, data) != 0))
+			APPL_EXIT_FAILURE("replay: pkt alloc failed, len:%" PRIi64 "", len);
+
+		replay->pkts[replay->num_pkts++] = pkt;
+	}
+	fclose(fp);
+
+	if (replay->num_pkts == 0)
+		APPL_EXIT_FAILURE("replay: no usable pkts in pcap file:%s", conf->file);
+
+	replay->total = replay->loops ?
+			(uint64_t)replay->num_pkts * replay->loops : UINT64_MAX;
+	odp_atomic_init_u64(&replay->seq, 0);
+	odp_atomic_init_u64(&replay->drops, 0);
+	odp_atomic_init_u64(&replay->done_ns, 0);
+	memset(replay->core_stat, 0, sizeof(replay->core_stat));
+
+	APPL_PRINT("\nPcap replay: %s: %u pkts (%u skipped), loops:%u, rate:%" PRIu64 " pkts/s, Tx:%s\n",
+		   replay->file, replay->num_pkts, skipped, replay->loops,
+		   replay->rate, replay->tx_dev);
+}
+
+static void replay_term(void)
+{
+	pktio_replay_t *const replay = &pktio_shm->replay;
+
+	odp_packet_free_multi(replay->pkts, replay->num_pkts);
+	replay->num_pkts = 0;
+
+	if (odp_pool_destroy(replay->pool) != 0)
+		APPL_EXIT_FAILURE("replay: pool destroy failed.");
+	replay->pool = ODP_POOL_INVALID;
+}
+
 void pktio_init(const appl_conf_t *appl_conf)
 {
 	pktin_mode_t in_mode = appl_conf->pktio.in_mode;
@@ -441,6 +713,34 @@ void pktio_init(const appl_conf_t *appl_conf)
 
 	pktio_shm->pktin.in_mode = in_mode;
 	pktio_shm->pktin.pktin_queue_stash = ODP_STASH_INVALID;
+	pktio_shm->pktin.flow_affine = appl_conf->pktio.pktin_flow_affine &&
+				       pktin_sched_mode(in_mode);
+	pktio_shm->pktin.affine_next_core = 0;
+	pktio_shm->pktin.coalesce = appl_conf->pktio.pktin_coalesce &&
+				    pktin_polled_mode(in_mode);
+	pktio_shm->pktin.parse_layer = appl_conf->pktio.pktin_parse;
+	pktio_shm->pktin.adaptive_ns = pktin_polled_mode(in_mode) ?
+		(uint64_t)appl_conf->pktio.pktin_adaptive_us * ODP_TIME_USEC_IN_NS : 0;
+	memset(pktio_shm->adaptive_stat, 0, sizeof(pktio_shm->adaptive_stat));
+
+	pktio_shm->pktout.chksum = appl_conf->pktio.pktout_chksum;
+	pktio_shm->pktout.order_lock = appl_conf->pktio.pktout_order_lock;
+	for (int i = 0; i < IF_MAX_NUM; i++) {
+		pktio_shm->pktout.l3_chksum[i] = false;
+		pktio_shm->pktout.l4_chksum[i] = false;
+	}
+
+	pktio_shm->cls.enable = appl_conf->pktio.pktin_cls && in_mode == PLAIN_QUEUE;
+	pktio_shm->cls.num_pmr = 0;
+	for (int i = 0; i < IF_MAX_NUM; i++) {
+		pktio_shm->cls.if_enabled[i] = false;
+		pktio_shm->cls.default_cos[i] = ODP_COS_INVALID;
+		pktio_shm->cls.default_queue[i] = ODP_QUEUE_INVALID;
+		for (int j = 0; j < MAX_RX_PKT_QUEUES; j++) {
+			pktio_shm->cls.cos[i][j] = ODP_COS_INVALID;
+			pktio_shm->cls.pmr[i][j] = ODP_PMR_INVALID;
+		}
+	}
 
 	ret = odp_stash_capability(&stash_capa, ODP_STASH_TYPE_FIFO);
 	if (ret != 0)
@@ -511,6 +811,7 @@ void pktio_init(const appl_conf_t *appl_conf)
 
 	odp_ticketlock_init(&pktio_shm->tbl_lookup.lock);
 	pktio_shm->tbl_lookup.tbl_idx = 0;
+	odp_atomic_init_u32(&pktio_shm->tbl_lookup.num_pub, 0);
 	pktio_shm->tbl_lookup.ops = odph_cuckoo_table_ops;
 	odp_ticketlock_lock(&pktio_shm->tbl_lookup.lock);
 	pktio_shm->tbl_lookup.tbl =
@@ -520,6 +821,10 @@ void pktio_init(const appl_conf_t *appl_conf)
 	odp_ticketlock_unlock(&pktio_shm->tbl_lookup.lock);
 	if (unlikely(pktio_shm->tbl_lookup.tbl == NULL))
 		APPL_EXIT_FAILURE("rx pkt lookup table creation fails");
+
+	pktio_shm->replay.enable = appl_conf->pktio.replay.enable;
+	if (pktio_shm->replay.enable)
+		replay_init(&appl_conf->pktio.replay);
 }
 
 void pktio_deinit(const appl_conf_t *appl_conf)
@@ -531,6 +836,9 @@ void pktio_deinit(const appl_conf_t *appl_conf)
 	odp_stash_destroy(pktio_shm->pktout.tx_burst_stash);
 
 	pktio_shm->tbl_lookup.ops.f_des(pktio_shm->tbl_lookup.tbl);
+
+	if (pktio_shm->replay.enable)
+		replay_term();
 }
 
 static void pktio_tx_buffering_create(int if_num)
@@ -680,13 +988,224 @@ set_pktin_vector_params(odp_pktin_queue_param_t *pktin_queue_param,
 	pktin_queue_param->vector.max_tmo_ns = vec_tmo_ns;
 }
 
+/**
+ * Helper to pktin_config(): bind each scheduled pktin queue to the ODP
+ * schedule group of a single-core EM queue group, round-robin over the
+ * EM-cores and continuing over the interfaces.
+ */
+static void
+set_pktin_flow_affine_params(const char *dev, int num_rx,
+			     odp_pktin_queue_param_ovr_t queue_param_ovr[/*out:num_rx*/])
+{
+	const int core_count = em_core_count();
+	char name[EM_QUEUE_GROUP_NAME_LEN];
+
+	for (int i = 0; i < num_rx; i++) {
+		const int core = pktio_shm->pktin.affine_next_core;
+		em_queue_group_t core_group;
+
+		snprintf(name, sizeof(name), "%s%d",
+			 EM_QUEUE_GROUP_CORE_BASE_NAME, core);
+		name[sizeof(name) - 1] = '\0';
+
+		core_group = em_queue_group_find(name);
+		if (core_group == EM_QUEUE_GROUP_UNDEF)
+			APPL_EXIT_FAILURE("pktin, dev:'%s': no queue group '%s',\n"
+					  "set 'queue_group.create_core_queue_groups = true'",
+					  dev, name);
+
+		queue_param_ovr[i].group = em_odp_qgrp2odp(core_group);
+		APPL_PRINT("\tpktin queue:%d -> queue group:'%s'\n", i, name);
+
+		pktio_shm->pktin.affine_next_core = (core + 1) % core_count;
+	}
+}
+
+/**
+ * Helper to pktio_create(): can the pktio_add_queue() rules be installed
+ * into the ODP classifier
+ */
+static bool pktin_cls_supported(const char *dev)
+{
+	odp_cls_capability_t cls_capa;
+	bool ok;
+
+	if (odp_cls_capability(&cls_capa) != 0)
+		return false;
+
+	/* Rule: ip-proto + ipv4-dst [+ udp/tcp-dst-port] */
+	ok = cls_capa.supported_terms.bit.ip_proto &&
+	     cls_capa.supported_terms.bit.dip_addr &&
+	     cls_capa.supported_terms.bit.udp_dport &&
+	     cls_capa.supported_terms.bit.tcp_dport &&
+	     cls_capa.max_terms_per_pmr >= 3 &&
+	     cls_capa.max_cos >= 2;
+
+	if (!ok)
+		APPL_PRINT("\tpktin, dev:'%s': ODP classifier rules not supported, using sw lookup\n",
+			   dev);
+	return ok;
+}
+
+/**
+ * Helper to pktin_config(): create the default CoS of an interface
+ *
+ * Pkts not matching any PMR go to the plain queue of the default CoS. The
+ * queue is polled like the pktin queues and the pkts then go through the
+ * sw lookup.
+ */
+static odp_queue_t
+pktin_cls_default_create(const char *dev, int if_idx, odp_pktio_t pktio)
+{
+	odp_queue_param_t queue_param;
+	odp_cls_cos_param_t cos_param;
+	char name[ODP_COS_NAME_LEN];
+	odp_queue_t queue;
+	odp_cos_t cos;
+
+	snprintf(name, sizeof(name), "pktin-cls-dflt-if%d", if_idx);
+	name[sizeof(name) - 1] = '\0';
+
+	odp_queue_param_init(&queue_param);
+	queue_param.type = ODP_QUEUE_TYPE_PLAIN;
+	queue_param.enq_mode = ODP_QUEUE_OP_MT;
+	/* polled by one core at a time, see plain_queue_acquire() */
+	queue_param.deq_mode = ODP_QUEUE_OP_MT_UNSAFE;
+
+	queue = odp_queue_create(name, &queue_param);
+	if (unlikely(queue == ODP_QUEUE_INVALID))
+		APPL_EXIT_FAILURE("pktin, dev:'%s': default cls queue create failed", dev);
+
+	odp_cls_cos_param_init(&cos_param);
+	cos_param.queue = queue;
+	cos_param.pool = pktio_shm->pools.pktpool_odp;
+
+	cos = odp_cls_cos_create(name, &cos_param);
+	if (unlikely(cos == ODP_COS_INVALID))
+		APPL_EXIT_FAILURE("pktin, dev:'%s': default CoS create failed", dev);
+
+	if (unlikely(odp_pktio_default_cos_set(pktio, cos) != 0))
+		APPL_EXIT_FAILURE("pktin, dev:'%s': default CoS set failed", dev);
+
+	pktio_shm->cls.default_cos[if_idx] = cos;
+	pktio_shm->cls.default_queue[if_idx] = queue;
+	pktio_shm->cls.if_enabled[if_idx] = true;
+
+	return queue;
+}
+
+/**
+ * Helper to pktio_add_queue(): install a rule as a PMR on each interface
+ * using the classifier. Called with the lookup table lock held.
+ */
+static void pktin_cls_add(uint8_t proto, uint32_t ip_dst_be, uint16_t port_dst_be,
+			  em_queue_t queue, int idx)
+{
+	const em_queue_type_t type = em_queue_get_type(queue);
+	odp_cls_cos_param_t cos_param;
+	odp_pmr_param_t terms[3];
+	const uint32_t ip_mask = 0xffffffff;
+	const uint16_t port_mask = 0xffff;
+	const uint8_t proto_mask = 0xff;
+	char name[ODP_COS_NAME_LEN];
+	int num_terms = 2;
+
+	/* The classifier can only deliver into the ODP queue of a sched EM queue */
+	if (type != EM_QUEUE_TYPE_ATOMIC && type != EM_QUEUE_TYPE_PARALLEL &&
+	    type != EM_QUEUE_TYPE_PARALLEL_ORDERED)
+		return;
+
+	const odp_queue_t odp_queue = em_odp_queue_odp(queue);
+
+	if (unlikely(odp_queue == ODP_QUEUE_INVALID))
+		return;
+
+	/* PMR values in network byte order, like the sw lookup keys */
+	odp_cls_pmr_param_init(&terms[0]);
+	terms[0].term = ODP_PMR_IPPROTO;
+	terms[0].match.value = &proto;
+	terms[0].match.mask = &proto_mask;
+	terms[0].val_sz = sizeof(proto);
+
+	odp_cls_pmr_param_init(&terms[1]);
+	terms[1].term = ODP_PMR_DIP_ADDR;
+	terms[1].match.value = &ip_dst_be;
+	terms[1].match.mask = &ip_mask;
+	terms[1].val_sz = sizeof(ip_dst_be);
+
+	/* The sw lookup uses the dst port only for UDP and TCP */
+	if (proto == ODPH_IPPROTO_UDP || proto == ODPH_IPPROTO_TCP) {
+		odp_cls_pmr_param_init(&terms[2]);
+		terms[2].term = proto == ODPH_IPPROTO_UDP ?
+				ODP_PMR_UDP_DPORT : ODP_PMR_TCP_DPORT;
+		terms[2].match.value = &port_dst_be;
+		terms[2].match.mask = &port_mask;
+		terms[2].val_sz = sizeof(port_dst_be);
+		num_terms = 3;
+	}
+
+	for (int i = 0; i < pktio_shm->ifs.count; i++) {
+		const int if_idx = pktio_shm->ifs.idx[i];
+
+		if (!pktio_shm->cls.if_enabled[if_idx])
+			continue;
+
+		snprintf(name, sizeof(name), "pktin-cls-if%d-%d", if_idx, idx);
+		name[sizeof(name) - 1] = '\0';
+
+		odp_cls_cos_param_init(&cos_param);
+		cos_param.queue = odp_queue;
+		cos_param.pool = pktio_shm->pools.pktpool_odp;
+
+		odp_cos_t cos = odp_cls_cos_create(name, &cos_param);
+
+		if (unlikely(cos == ODP_COS_INVALID)) {
+			APPL_PRINT("Warning: %s: CoS create failed, using sw lookup\n", name);
+			continue;
+		}
+
+		odp_pmr_t pmr = odp_cls_pmr_create(terms, num_terms,
+						   pktio_shm->cls.default_cos[if_idx], cos);
+		if (unlikely(pmr == ODP_PMR_INVALID)) {
+			APPL_PRINT("Warning: %s: PMR create failed, using sw lookup\n", name);
+			odp_cls_cos_destroy(cos);
+			continue;
+		}
+
+		pktio_shm->cls.cos[if_idx][idx] = cos;
+		pktio_shm->cls.pmr[if_idx][idx] = pmr;
+		pktio_shm->cls.num_pmr++;
+	}
+}
+
+/**
+ * Destroy the rule PMRs and CoSes, unmatched pkts then go to the default CoS
+ */
+static void pktin_cls_rules_destroy(void)
+{
+	for (int i = 0; i < IF_MAX_NUM; i++) {
+		for (int j = 0; j < MAX_RX_PKT_QUEUES; j++) {
+			if (pktio_shm->cls.pmr[i][j] != ODP_PMR_INVALID) {
+				odp_cls_pmr_destroy(pktio_shm->cls.pmr[i][j]);
+				pktio_shm->cls.pmr[i][j] = ODP_PMR_INVALID;
+			}
+			if (pktio_shm->cls.cos[i][j] != ODP_COS_INVALID) {
+				odp_cls_cos_destroy(pktio_shm->cls.cos[i][j]);
+				pktio_shm->cls.cos[i][j] = ODP_COS_INVALID;
+			}
+		}
+	}
+	pktio_shm->cls.num_pmr = 0;
+}
+
 /** Helper to pktio_create() for packet input configuration */
 static void pktin_config(const char *dev, int if_idx, odp_pktio_t pktio,
 			 const odp_pktio_capability_t *pktio_capa,
 			 int if_count, int num_workers, pktin_mode_t in_mode,
-			 bool pktin_vector)
+			 bool pktin_vector, bool cls)
 {
 	odp_pktin_queue_param_t pktin_queue_param;
+	odp_pktin_queue_param_ovr_t queue_param_ovr[PKTIO_MAX_IN_QUEUES];
 	int num_rx, max;
 	int ret;
 
@@ -704,6 +1223,17 @@ static void pktin_config(const char *dev, int if_idx, odp_pktio_t pktio,
 	pktin_queue_param.hash_proto.proto.ipv4_udp = 1;
 	pktin_queue_param.num_queues = num_rx;
 
+	if (cls) {
+		/*
+		 * Classifier: pkts go into the CoS queues instead of hashed
+		 * pktin queues, only the default CoS queue is polled.
+		 */
+		num_rx = 1;
+		pktin_queue_param.classifier_enable = 1;
+		pktin_queue_param.hash_enable = 0;
+		pktin_queue_param.num_queues = num_rx;
+	}
+
 	if (pktin_polled_mode(in_mode)) {
 		pktin_queue_param.op_mode = ODP_PKTIO_OP_MT_UNSAFE;
 	} else if (pktin_sched_mode(in_mode)) {
@@ -718,6 +1248,12 @@ static void pktin_config(const char *dev, int if_idx, odp_pktio_t pktio,
 
 		pktin_queue_param.queue_param.sched.group = em_odp_qgrp2odp(EM_QUEUE_GROUP_DEFAULT);
 
+		if (pktio_shm->pktin.flow_affine) {
+			/* Per queue sched group overrides 'queue_param.sched.group' */
+			set_pktin_flow_affine_params(dev, num_rx, queue_param_ovr);
+			pktin_queue_param.queue_param_ovr = queue_param_ovr;
+		}
+
 		if (pktin_vector) {
 			if (!pktio_capa->vector.supported)
 				APPL_EXIT_FAILURE("pktin, dev:'%s': input vectors not supported",
@@ -733,7 +1269,10 @@ static void pktin_config(const char *dev, int if_idx, odp_pktio_t pktio,
 		APPL_EXIT_FAILURE("pktin, dev:'%s': input queue config failed: %d",
 				  dev, ret);
 
-	if (in_mode == PLAIN_QUEUE) {
+	if (cls) {
+		pktio_shm->pktin.plain_queues[if_idx][0] =
+			pktin_cls_default_create(dev, if_idx, pktio);
+	} else if (in_mode == PLAIN_QUEUE) {
 		ret = odp_pktin_event_queue(pktio, pktio_shm->pktin.plain_queues[if_idx]/*out*/,
 					    num_rx);
 		if (ret != num_rx)
@@ -811,6 +1350,56 @@ static void pktout_config(const char *dev, int if_idx, odp_pktio_t pktio,
 	pktio_tx_buffering_create(if_idx);
 }
 
+/*
+ * Helper to pktio_create(): the parser layer for the input pkts
+ */
+static odp_proto_layer_t
+pktin_parse_layer(const char *dev, const odp_pktio_capability_t *pktio_capa,
+		  bool cls)
+{
+	odp_proto_layer_t layer = pktio_shm->pktin.parse_layer;
+
+	if (cls && layer < ODP_PROTO_LAYER_L4)
+		layer = ODP_PROTO_LAYER_L4;
+
+	if (layer > pktio_capa->config.parser.layer) {
+		APPL_PRINT("\nWarning: dev:'%s' parses only up to %s, not %s\n\n",
+			   dev, pktin_parse_str(pktio_capa->config.parser.layer),
+			   pktin_parse_str(layer));
+		layer = pktio_capa->config.parser.layer;
+		/* pktin_lookup_enqueue() relies only on what all ifs parse */
+		if (layer < pktio_shm->pktin.parse_layer)
+			pktio_shm->pktin.parse_layer = layer;
+	}
+
+	return layer;
+}
+
+/*
+ * Helper to pktio_create(): enable the checksum insertion offloads the
+ * interface supports. The checksums are not inserted by default, only for
+ * the pkts requested with pktio_tx_chksum().
+ */
+static void
+pktout_chksum_config(const char *dev, int if_idx,
+		     const odp_pktio_capability_t *pktio_capa,
+		     odp_pktio_config_t *pktio_config /*in/out*/)
+{
+	const odp_pktout_config_opt_t *capa = &pktio_capa->config.pktout;
+	const bool l3 = capa->bit.ipv4_chksum_ena;
+	const bool l4 = capa->bit.udp_chksum_ena && capa->bit.tcp_chksum_ena;
+
+	pktio_config->pktout.bit.ipv4_chksum_ena = l3;
+	pktio_config->pktout.bit.udp_chksum_ena = l4;
+	pktio_config->pktout.bit.tcp_chksum_ena = l4;
+
+	pktio_shm->pktout.l3_chksum[if_idx] = l3;
+	pktio_shm->pktout.l4_chksum[if_idx] = l4;
+
+	APPL_PRINT("\tdev:'%s' checksum offload - IPv4:%s UDP/TCP:%s\n", dev,
+		   l3 ? "yes" : "no (sw)", l4 ? "yes" : "no (sw)");
+}
+
 int /* if_id */
 pktio_create(const char *dev, pktin_mode_t in_mode, bool pktin_vector,
 	     int if_count, int num_workers)
@@ -860,10 +1449,20 @@ pktio_create(const char *dev, pktin_mode_t in_mode, bool pktin_vector,
 		APPL_EXIT_FAILURE("pktio capability query failed: dev:'%s' (%d)",
 				  dev, ret);
 
+	/* Classifier rules, only supported in PLAIN_QUEUE-mode (see pktio_init()) */
+	const bool cls = pktio_shm->cls.enable && pktin_cls_supported(dev);
+
 	odp_pktio_config_init(&pktio_config);
-	pktio_config.parser.layer = ODP_PROTO_LAYER_NONE;
+	/* Parse once at input, the classifier needs the pkts parsed up to L4 */
+	pktio_config.parser.layer = pktin_parse_layer(dev, &pktio_capa, cls);
 	/* Provide hint to pktio that packet references are not used */
 	pktio_config.pktout.bit.no_packet_refs = 1;
+	/* Checksum insertion offload, requested per pkt: pktio_tx_chksum() */
+	if (pktio_shm->pktout.chksum)
+		pktout_chksum_config(dev, if_idx, &pktio_capa, &pktio_config);
+	/* Adaptive polling: rx timestamps to measure the wake-up latency */
+	if (pktio_shm->pktin.adaptive_ns && pktio_capa.config.pktin.bit.ts_all)
+		pktio_config.pktin.bit.ts_all = 1;
 
 	ret = odp_pktio_config(pktio, &pktio_config);
 	if (ret != 0)
@@ -872,7 +1471,7 @@ pktio_create(const char *dev, pktin_mode_t in_mode, bool pktin_vector,
 
 	/* Pktin (Rx) config */
 	pktin_config(dev, if_idx, pktio, &pktio_capa,
-		     if_count, num_workers, in_mode, pktin_vector);
+		     if_count, num_workers, in_mode, pktin_vector, cls);
 
 	/* Pktout (Tx) config */
 	pktout_config(dev, if_idx, pktio, &pktio_capa, num_workers);
@@ -905,6 +1504,11 @@ pktio_start(void)
 		APPL_PRINT("%s(): if:%d\n", __func__, if_idx);
 	}
 
+	if (pktio_shm->replay.enable)
+		pktio_shm->replay.start_ns = odp_time_global_ns();
+	if (pktio_shm->pktin.adaptive_ns)
+		pktio_shm->pktin.adaptive_start_ns = odp_time_global_ns();
+
 	odp_mb_full();
 	pktio_shm->pktio_started = 1;
 }
@@ -913,11 +1517,23 @@ void pktio_halt(void)
 {
 	pktio_shm->pktio_started = 0;
 	odp_mb_full();
+
+	/* Stop the classifier delivering into EM queues about to be deleted */
+	if (pktio_shm->cls.enable) {
+		APPL_PRINT("\n%s(): destroying %d classifier rules\n",
+			   __func__, pktio_shm->cls.num_pmr);
+		pktin_cls_rules_destroy();
+	}
 	APPL_PRINT("\n%s() on EM-core %d\n", __func__, em_core_id());
 }
 
 void pktio_stop(void)
 {
+	if (pktio_shm->replay.enable)
+		pktio_replay_print();
+	if (pktio_shm->pktin.adaptive_ns)
+		pktin_adaptive_print();
+
 	for (int i = 0; i < pktio_shm->ifs.count; i++) {
 		int if_idx = pktio_shm->ifs.idx[i];
 		odp_pktio_t pktio = pktio_shm->ifs.pktio_hdl[if_idx];
@@ -934,7 +1550,15 @@ void pktio_close(void)
 	for (int i = 0; i < pktio_shm->ifs.count; i++) {
 		int if_idx = pktio_shm->ifs.idx[i];
 		odp_pktio_t pktio = pktio_shm->ifs.pktio_hdl[if_idx];
-		int ret = odp_pktio_close(pktio);
+		int ret;
+
+		if (pktio_shm->cls.if_enabled[if_idx]) {
+			odp_pktio_default_cos_set(pktio, ODP_COS_INVALID);
+			odp_cls_cos_destroy(pktio_shm->cls.default_cos[if_idx]);
+			pktio_shm->cls.default_cos[if_idx] = ODP_COS_INVALID;
+		}
+
+		ret = odp_pktio_close(pktio);
 
 		if (unlikely(ret != 0))
 			APPL_EXIT_FAILURE("pktio close failed for if:%d", if_idx);
@@ -945,6 +1569,20 @@ void pktio_close(void)
 	if (pktin_polled_mode(pktio_shm->pktin.in_mode))
 		pktin_queue_queueing_destroy();
 	pktio_tx_buffering_destroy();
+
+	/* The default CoS queues are created by cm_pktio, not by the pktio */
+	for (int i = 0; i < IF_MAX_NUM; i++) {
+		odp_queue_t queue = pktio_shm->cls.default_queue[i];
+		odp_event_t ev;
+
+		if (queue == ODP_QUEUE_INVALID)
+			continue;
+		while ((ev = odp_queue_deq(queue)) != ODP_EVENT_INVALID)
+			odp_event_free(ev);
+		odp_queue_destroy(queue);
+		pktio_shm->cls.default_queue[i] = ODP_QUEUE_INVALID;
+		pktio_shm->cls.if_enabled[i] = false;
+	}
 }
 
 static inline int
@@ -1009,6 +1647,127 @@ plain_queue_release(odp_queue_t queue)
 		APPL_EXIT_FAILURE("stash-put fails:%d", ret);
 }
 
+/*
+ * Helper to pktin_lookup_enqueue(): send a run of pkts going to the same
+ * queue as vector events, '--pktin-coalesce'.
+ * The contained pkts are left uninitialized, EM inits them when the vector
+ * table is first accessed (em_event_vector_tbl(), em_free() etc.).
+ *
+ * Returns the number of pkts consumed, the rest are left to the caller.
+ * The pkts actually sent are added to 'num_sent'.
+ */
+static inline int
+pktin_coalesce_send(const odp_packet_t pkts[], int num, em_queue_t queue,
+		    int *num_sent /*in/out*/)
+{
+	int done = 0;
+
+	while (num - done >= 2) {
+		const int vec_num = MIN(num - done, PKTIO_VEC_POOL_VEC_SIZE);
+		em_event_t vec_ev = em_alloc(vec_num, EM_EVENT_TYPE_VECTOR,
+					     pktio_shm->pools.vecpool_em);
+		if (unlikely(vec_ev == EM_EVENT_UNDEF))
+			break; /* send the rest as separate pkts */
+
+		odp_event_t odp_vec = em_odp_event2odp(vec_ev);
+		odp_packet_vector_t pkt_vec = odp_packet_vector_from_event(odp_vec);
+		odp_packet_t *vec_tbl = NULL;
+
+		(void)odp_packet_vector_tbl(pkt_vec, &vec_tbl /*out*/);
+		for (int i = 0; i < vec_num; i++)
+			vec_tbl[i] = pkts[done + i];
+		odp_packet_vector_size_set(pkt_vec, vec_num);
+
+		/* em_free() of a vector also frees the pkts in it */
+		if (likely(em_send(vec_ev, queue) == EM_OK))
+			*num_sent += vec_num;
+		else
+			em_free(vec_ev);
+
+		done += vec_num;
+	}
+
+	return done;
+}
+
+static inline uint32_t proc_tbl_slot(const pkt_q_hash_key_t *key)
+{
+	return odp_hash_crc32c(key, sizeof(*key), 0) & (PROC_TBL_SIZE - 1);
+}
+
+/*
+ * Process-per-core mode: copy the entries added by pktio_add_queue() since
+ * the last call into the private replica of the lookup table. The entries
+ * are never removed, one shared read per poll when nothing changed.
+ */
+static inline void proc_tbl_sync(void)
+{
+	pktio_proc_t *const proc = &pktio_locm.proc;
+	const uint32_t num_pub = odp_atomic_load_acq_u32(&pktio_shm->tbl_lookup.num_pub);
+
+	for (; proc->tbl_num < num_pub; proc->tbl_num++) {
+		const pkt_q_hash_key_t *key = &pktio_shm->tbl_lookup.keys[proc->tbl_num];
+		uint32_t slot = proc_tbl_slot(key);
+
+		while (proc->tbl[slot].used)
+			slot = (slot + 1) & (PROC_TBL_SIZE - 1);
+
+		proc->tbl[slot].key = *key;
+		proc->tbl[slot].pos = proc->tbl_num;
+		proc->tbl[slot].used = true;
+	}
+}
+
+static inline int
+proc_tbl_get(const pkt_q_hash_key_t *key, rx_pkt_queue_t *rx_pkt_queue /*out*/)
+{
+	const pktio_proc_t *const proc = &pktio_locm.proc;
+	uint32_t slot = proc_tbl_slot(key);
+
+	while (proc->tbl[slot].used) {
+		if (memcmp(&proc->tbl[slot].key, key, sizeof(*key)) == 0) {
+			*rx_pkt_queue = pktio_shm->rx_pkt_queues[proc->tbl[slot].pos];
+			return 0;
+		}
+		slot = (slot + 1) & (PROC_TBL_SIZE - 1);
+	}
+
+	return -1;
+}
+
+/*
+ * Process-per-core mode: the next pktin queue owned by this process,
+ * round-robin. Replaces pktin_queue_acquire/release()
+ */
+static inline odp_pktin_queue_t *proc_pktin_queue_next(void)
+{
+	pktio_proc_t *const proc = &pktio_locm.proc;
+
+	if (unlikely(proc->num_pktin == 0))
+		return NULL;
+
+	const int i = proc->next_pktin;
+
+	proc->next_pktin = i + 1 < proc->num_pktin ? i + 1 : 0;
+
+	return &pktio_shm->pktin.pktin_queues[proc->pktin[i].if_idx][proc->pktin[i].q];
+}
+
+/* Process-per-core mode: as above for PLAIN_QUEUE-mode */
+static inline odp_queue_t proc_plain_queue_next(void)
+{
+	pktio_proc_t *const proc = &pktio_locm.proc;
+
+	if (unlikely(proc->num_pktin == 0))
+		return ODP_QUEUE_INVALID;
+
+	const int i = proc->next_pktin;
+
+	proc->next_pktin = i + 1 < proc->num_pktin ? i + 1 : 0;
+
+	return pktio_shm->pktin.plain_queues[proc->pktin[i].if_idx][proc->pktin[i].q];
+}
+
 /*
  * Helper to the pktin_pollfn_...() functions.
  */
@@ -1017,34 +1776,32 @@ pktin_lookup_enqueue(odp_packet_t pkt_tbl[], int pkts)
 {
 	const odph_table_get_value f_get = pktio_shm->tbl_lookup.ops.f_get;
 	rx_queue_burst_t *const rx_qbursts = pktio_locm.rx_qbursts;
-	int pkts_enqueued = 0; /* return value */
+	odp_packet_t enq_pkts[MAX_PKT_BURST_RX];
+	em_queue_t enq_queues[MAX_PKT_BURST_RX];
+	int num_enq = 0;
+	int num_vec_pkts = 0;
 	int valid_pkts = 0;
 
+	const bool parsed_l3 = pktio_shm->pktin.parse_layer >= ODP_PROTO_LAYER_L3;
+
 	for (int i = 0; i < pkts; i++) {
 		const odp_packet_t pkt = pkt_tbl[i];
-		void *const pkt_data = odp_packet_data(pkt);
+
+		/* Pkts parsed by pktio ('--pktin-parse'): non-IPv4 to default */
+		if (parsed_l3 && unlikely(!odp_packet_has_ipv4(pkt))) {
+			pktio_locm.keys[i].ip_dst = 0;
+			pktio_locm.keys[i].proto = 0;
+			pktio_locm.keys[i].port_dst = 0;
+			continue;
+		}
 
 		/*
-		 * If 'pktio_config.parser.layer =
-		 *     ODP_PKTIO_PARSER_LAYER_L4;' then the following
-		 *     better checks can be used (is slower though).
-		 * if (unlikely(!odp_packet_has_udp(pkt))) {
-		 *	odp_packet_free(pkt);
-		 *	continue;
-		 * }
-		 *
-		 * pkt_data = odp_packet_data(pkt);
-		 * ip = (odph_ipv4hdr_t *)((uintptr_t)pkt_data +
-		 *			odp_packet_l3_offset(pkt));
-		 * udp = (odph_udphdr_t *)((uintptr_t)pkt_data +
-		 *			odp_packet_l4_offset(pkt));
+		 * The parsed L3/L4 offsets are used if set, otherwise fixed
+		 * offsets for Eth + IPv4 + UDP/TCP.
+		 * Note: no actual checks if the headers are present
 		 */
-
-		/* Note: no actual checks if the headers are present */
-		odph_ipv4hdr_t *const ip = (odph_ipv4hdr_t *)
-			((uintptr_t)pkt_data + sizeof(odph_ethhdr_t));
-		odph_udphdr_t *const udp = (odph_udphdr_t *)
-			((uintptr_t)ip + sizeof(odph_ipv4hdr_t));
+		const odph_ipv4hdr_t *const ip = pktio_pkt_ipv4(pkt);
+		const odph_udphdr_t *const udp = pktio_pkt_l4(pkt);
 		/*
 		 * NOTE! network-to-CPU conversion not needed here.
 		 * Setup stores network-order in hash to avoid
@@ -1064,8 +1821,10 @@ pktin_lookup_enqueue(odp_packet_t pkt_tbl[], int pkts)
 		em_queue_t queue;
 		int pos;
 
-		/* table(hash) lookup to find queue */
-		int ret = f_get(pktio_shm->tbl_lookup.tbl,
+		/* table(hash) lookup to find queue, private replica if owned */
+		int ret = pktio_locm.proc.enable ?
+			  proc_tbl_get(&pktio_locm.keys[i], &rx_pkt_queue) :
+			  f_get(pktio_shm->tbl_lookup.tbl,
 				&pktio_locm.keys[i],
 				&rx_pkt_queue, sizeof(rx_pkt_queue_t));
 		if (likely(ret == 0)) {
@@ -1088,6 +1847,7 @@ pktin_lookup_enqueue(odp_packet_t pkt_tbl[], int pkts)
 		rx_qbursts[pos].pkt_tbl[rx_qbursts[pos].pkt_cnt++] = pkt;
 	}
 
+	/* Order the pkts by destination queue, one run per queue */
 	for (int i = 0; i < valid_pkts; i++) {
 		const int pos = pktio_locm.positions[i];
 
@@ -1096,15 +1856,144 @@ pktin_lookup_enqueue(odp_packet_t pkt_tbl[], int pkts)
 
 		const int num = rx_qbursts[pos].pkt_cnt;
 		const em_queue_t queue = rx_qbursts[pos].queue;
+		int j = 0;
+
+		if (pktio_shm->pktin.coalesce && num > 1) {
+			j = pktin_coalesce_send(rx_qbursts[pos].pkt_tbl, num,
+						queue, &num_vec_pkts);
+		}
 
-		/* Enqueue pkts into em-odp */
-		pkts_enqueued += em_odp_pkt_enqueue(rx_qbursts[pos].pkt_tbl,
-						    num, queue);
+		for (; j < num; j++) {
+			enq_pkts[num_enq] = rx_qbursts[pos].pkt_tbl[j];
+			enq_queues[num_enq] = queue;
+			num_enq++;
+		}
 		rx_qbursts[pos].sent = 1;
 		rx_qbursts[pos].pkt_cnt = 0;
 	}
 
-	return pkts_enqueued;
+	if (num_enq == 0)
+		return num_vec_pkts;
+
+	/* Enqueue all pkts into em-odp at once */
+	return num_vec_pkts + em_odp_pkt_enqueue_multi(enq_pkts, enq_queues, num_enq);
+}
+
+/*
+ * Adaptive pktin polling ('--pktin-adaptive'):
+ * After ADAPTIVE_IDLE_POLLS consecutive empty polls the core starts skipping
+ * polls, doubling the back-off for every further empty poll up to the max
+ * wake-up latency. At the max back-off the core waits for pkts in the poll
+ * itself (odp_pktin_recv_tmo() or sleep) instead of spinning. Any received
+ * pkt resets the back-off. Note that the wait also delays the scheduled
+ * events on the core by up to the max back-off. The scheduler side of the
+ * idling is handled by EM, see EM_SCHED_WAIT_ENABLE ('dispatch.sched_wait_ns').
+ *
+ * @param[out] wait_ns  Time to wait for pkts in this poll, 0: don't wait
+ *
+ * @return true if the poll should be skipped
+ */
+static inline bool pktin_adaptive_skip(uint64_t *wait_ns /*out*/)
+{
+	const uint64_t backoff_ns = pktio_locm.adaptive.backoff_ns;
+
+	*wait_ns = 0;
+	if (likely(backoff_ns == 0))
+		return false;
+
+	if (odp_time_local_ns() < pktio_locm.adaptive.next_poll_ns) {
+		pktio_shm->adaptive_stat[em_core_id()].skipped++;
+		return true;
+	}
+
+	if (backoff_ns >= pktio_shm->pktin.adaptive_ns)
+		*wait_ns = backoff_ns;
+
+	return false;
+}
+
+static inline void
+pktin_adaptive_update(int pkts, uint64_t wait_ns, uint64_t wait_start_ns)
+{
+	pktin_adaptive_stat_t *const stat = &pktio_shm->adaptive_stat[em_core_id()];
+	const uint64_t max_ns = pktio_shm->pktin.adaptive_ns;
+	const uint64_t now_ns = odp_time_local_ns();
+
+	stat->polls++;
+	if (wait_ns) {
+		stat->sleeps++;
+		stat->sleep_ns += now_ns - wait_start_ns;
+	}
+
+	if (pkts > 0) {
+		pktio_locm.adaptive.empty_polls = 0;
+		pktio_locm.adaptive.backoff_ns = 0;
+		return;
+	}
+
+	stat->empty_polls++;
+	if (++pktio_locm.adaptive.empty_polls < ADAPTIVE_IDLE_POLLS)
+		return;
+
+	uint64_t backoff_ns = pktio_locm.adaptive.backoff_ns;
+
+	backoff_ns = backoff_ns ? MIN(2 * backoff_ns, max_ns) :
+				  MIN((uint64_t)ADAPTIVE_MIN_BACKOFF_NS, max_ns);
+	pktio_locm.adaptive.backoff_ns = backoff_ns;
+	/* At the max back-off the wait in the poll paces the polling */
+	pktio_locm.adaptive.next_poll_ns = backoff_ns >= max_ns ?
+					   now_ns : now_ns + backoff_ns;
+}
+
+/*
+ * Wake-up latency sample: pktio rx timestamp of the first pkt of the burst
+ * to the poll that received it, only if the pktio timestamps the pkts.
+ */
+static inline void pktin_adaptive_latency(odp_packet_t pkt)
+{
+	if (!odp_packet_has_ts(pkt))
+		return;
+
+	pktin_adaptive_stat_t *const stat = &pktio_shm->adaptive_stat[em_core_id()];
+	const odp_pktio_t pktio = odp_packet_input(pkt);
+	const odp_time_t now = odp_pktio_time(pktio, NULL);
+	const uint64_t ns = odp_time_diff_ns(now, odp_packet_ts(pkt));
+
+	stat->lat_cnt++;
+	stat->lat_sum_ns += ns;
+	stat->lat_max_ns = MAX(stat->lat_max_ns, ns);
+}
+
+void pktin_adaptive_print(void)
+{
+	const uint64_t run_ns = odp_time_global_ns() - pktio_shm->pktin.adaptive_start_ns;
+	pktin_adaptive_stat_t tot = {0};
+
+	for (int i = 0; i < MAX_THREADS; i++) {
+		const pktin_adaptive_stat_t *stat = &pktio_shm->adaptive_stat[i];
+
+		tot.polls += stat->polls;
+		tot.empty_polls += stat->empty_polls;
+		tot.skipped += stat->skipped;
+		tot.sleeps += stat->sleeps;
+		tot.sleep_ns += stat->sleep_ns;
+		tot.lat_cnt += stat->lat_cnt;
+		tot.lat_sum_ns += stat->lat_sum_ns;
+		tot.lat_max_ns = MAX(tot.lat_max_ns, stat->lat_max_ns);
+	}
+
+	const double core_ns = (double)run_ns * em_core_count();
+
+	APPL_PRINT("\nAdaptive pktin polling, max wake-up latency:%" PRIu64 " us\n"
+		   "  Polls:   %" PRIu64 " (empty:%.1f%%), skipped:%" PRIu64 "\n"
+		   "  Waits:   %" PRIu64 ", %.3f s (%.1f%% of the EM-core time)\n"
+		   "  Latency, pktio rx to poll: avg:%" PRIu64 " ns max:%" PRIu64 " ns (%" PRIu64 " samples%s)\n\n",
+		   pktio_shm->pktin.adaptive_ns / ODP_TIME_USEC_IN_NS,
+		   tot.polls, tot.polls ? 100.0 * tot.empty_polls / tot.polls : 0.0,
+		   tot.skipped, tot.sleeps, (double)tot.sleep_ns / ODP_TIME_SEC_IN_NS,
+		   core_ns > 0 ? 100.0 * tot.sleep_ns / core_ns : 0.0,
+		   tot.lat_cnt ? tot.lat_sum_ns / tot.lat_cnt : 0, tot.lat_max_ns, tot.lat_cnt,
+		   tot.lat_cnt ? "" : ", no pktin timestamps");
 }
 
 /*
@@ -1119,14 +2008,46 @@ int pktin_pollfn_direct(void)
 	int ret, pkts;
 	int poll_rounds = 0;
 	int pkts_enqueued = 0; /* return value */
+	const bool adaptive = pktio_shm->pktin.adaptive_ns != 0;
+	const bool proc = pktio_locm.proc.enable;
+	uint64_t wait_ns = 0;
 
 	if (unlikely(!pktio_shm->pktio_started))
 		return 0;
 
-	ret = pktin_queue_acquire(&pktin_queue_ptr /*out*/);
-	if (unlikely(ret != 0))
+	if (adaptive && pktin_adaptive_skip(&wait_ns /*out*/))
 		return 0;
 
+	if (proc) {
+		proc_tbl_sync();
+		pktin_queue_ptr = proc_pktin_queue_next();
+		if (unlikely(!pktin_queue_ptr))
+			return 0;
+	} else {
+		ret = pktin_queue_acquire(&pktin_queue_ptr /*out*/);
+		if (unlikely(ret != 0))
+			return 0;
+	}
+
+	if (adaptive) {
+		const uint64_t start_ns = wait_ns ? odp_time_local_ns() : 0;
+
+		if (wait_ns)
+			pkts = odp_pktin_recv_tmo(*pktin_queue_ptr, pkt_tbl, MAX_PKT_BURST_RX,
+						  odp_pktin_wait_time(wait_ns));
+		else
+			pkts = odp_pktin_recv(*pktin_queue_ptr, pkt_tbl, MAX_PKT_BURST_RX);
+
+		pktin_adaptive_update(pkts, wait_ns, start_ns);
+		if (pkts <= 0)
+			goto pktin_poll_end;
+		pktin_adaptive_latency(pkt_tbl[0]);
+		pkts_enqueued += pktin_lookup_enqueue(pkt_tbl, pkts);
+		if (pkts < MAX_PKT_BURST_RX)
+			goto pktin_poll_end;
+		poll_rounds++;
+	}
+
 	do {
 		pkts = odp_pktin_recv(*pktin_queue_ptr, pkt_tbl, MAX_PKT_BURST_RX);
 		if (unlikely(pkts <= 0))
@@ -1138,7 +2059,8 @@ int pktin_pollfn_direct(void)
 		 ++poll_rounds < MAX_RX_POLL_ROUNDS);
 
 pktin_poll_end:
-	pktin_queue_release(pktin_queue_ptr);
+	if (!proc)
+		pktin_queue_release(pktin_queue_ptr);
 
 	return pkts_enqueued;
 }
@@ -1156,14 +2078,47 @@ int pktin_pollfn_plainqueue(void)
 	int pkts;
 	int poll_rounds = 0;
 	int pkts_enqueued = 0; /* return value */
+	const bool adaptive = pktio_shm->pktin.adaptive_ns != 0;
+	const bool proc = pktio_locm.proc.enable;
+	uint64_t wait_ns = 0;
 
 	if (unlikely(!pktio_shm->pktio_started))
 		return 0;
 
-	plain_queue = plain_queue_acquire();
+	if (adaptive && pktin_adaptive_skip(&wait_ns /*out*/))
+		return 0;
+
+	if (proc) {
+		proc_tbl_sync();
+		plain_queue = proc_plain_queue_next();
+	} else {
+		plain_queue = plain_queue_acquire();
+	}
 	if (unlikely(plain_queue == ODP_QUEUE_INVALID))
 		return 0;
 
+	if (adaptive) {
+		const uint64_t start_ns = wait_ns ? odp_time_local_ns() : 0;
+
+		/* No timed dequeue for plain queues: sleep, then poll */
+		if (wait_ns) {
+			const struct timespec ts = {.tv_sec = wait_ns / ODP_TIME_SEC_IN_NS,
+						    .tv_nsec = wait_ns % ODP_TIME_SEC_IN_NS};
+			nanosleep(&ts, NULL);
+		}
+		pkts = odp_queue_deq_multi(plain_queue, ev_tbl, MAX_PKT_BURST_RX);
+
+		pktin_adaptive_update(pkts, wait_ns, start_ns);
+		if (pkts <= 0)
+			goto pktin_poll_end;
+		odp_packet_from_event_multi(pkt_tbl, ev_tbl, pkts);
+		pktin_adaptive_latency(pkt_tbl[0]);
+		pkts_enqueued += pktin_lookup_enqueue(pkt_tbl, pkts);
+		if (pkts < MAX_PKT_BURST_RX)
+			goto pktin_poll_end;
+		poll_rounds++;
+	}
+
 	do {
 		pkts = odp_queue_deq_multi(plain_queue, ev_tbl, MAX_PKT_BURST_RX);
 		if (unlikely(pkts <= 0))
@@ -1177,11 +2132,190 @@ int pktin_pollfn_plainqueue(void)
 		 ++poll_rounds < MAX_RX_POLL_ROUNDS);
 
 pktin_poll_end:
-	plain_queue_release(plain_queue);
+	if (!proc)
+		plain_queue_release(plain_queue);
 
 	return pkts_enqueued;
 }
 
+int pktio_replay_parse(const char *str, pktio_replay_conf_t *conf /* out */)
+{
+	char file[REPLAY_PATH_LEN];
+	char tx_file[REPLAY_PATH_LEN] = "";
+	unsigned long long rate = 0;
+	unsigned int loops = 0;
+	int num;
+
+	/* Field widths: REPLAY_PATH_LEN - 1 */
+	ODP_STATIC_ASSERT(REPLAY_PATH_LEN == 256, "REPLAY_PATH_LEN__SCANF_WIDTH_ERROR");
+
+	num = sscanf(str, "%255[^,],%llu,%u,%255s", file, &rate, &loops, tx_file);
+	if (num < 1)
+		return -1;
+
+	if (!strcmp(tx_file, "null"))
+		tx_file[0] = '\0';
+
+	conf->enable = true;
+	conf->rate = rate;
+	conf->loops = loops;
+	strcpy(conf->file, file);
+	strcpy(conf->tx_file, tx_file);
+
+	return 0;
+}
+
+const char *pktio_replay_dev(void)
+{
+	return pktio_shm->replay.tx_dev;
+}
+
+/* All pkts injected: let the application exit once the output has drained */
+static inline void replay_done(uint64_t now_ns)
+{
+	const uint64_t done_ns = odp_atomic_load_u64(&pktio_shm->replay.done_ns);
+
+	if (done_ns && now_ns > done_ns + REPLAY_DRAIN_NS && !appl_shm->exit_flag)
+		appl_shm->exit_flag = 1;
+}
+
+/*
+ * User provided function to inject pkts from the pcap file in replay mode,
+ * given to EM via 'em_conf.input.input_poll_fn = pktin_pollfn_replay;'
+ * The function is of type 'em_input_poll_func_t'. See .h file.
+ */
+int pktin_pollfn_replay(void)
+{
+	pktio_replay_t *const replay = &pktio_shm->replay;
+	odp_packet_t pkt_tbl[MAX_PKT_BURST_RX];
+	uint64_t limit = replay->total;
+	uint64_t seq, num;
+	int pkts = 0;
+
+	if (unlikely(!pktio_shm->pktio_started))
+		return 0;
+
+	const odp_time_t now = odp_time_global();
+	const uint64_t now_ns = odp_time_to_ns(now);
+
+	if (replay->rate) {
+		/* Pkts due by now, split to not overflow the multiplication */
+		const uint64_t elapsed_ns = now_ns - replay->start_ns;
+		const uint64_t due =
+			elapsed_ns / ODP_TIME_SEC_IN_NS * replay->rate +
+			elapsed_ns % ODP_TIME_SEC_IN_NS * replay->rate / ODP_TIME_SEC_IN_NS;
+
+		limit = MIN(limit, due);
+	}
+
+	/* Reserve the next burst of the sequence, shared by all EM-cores */
+	seq = odp_atomic_load_u64(&replay->seq);
+	do {
+		if (seq >= limit) {
+			if (seq >= replay->total)
+				replay_done(now_ns);
+			return 0;
+		}
+		num = MIN(limit - seq, (uint64_t)MAX_PKT_BURST_RX);
+	} while (!odp_atomic_cas_u64(&replay->seq, &seq, seq + num));
+
+	for (uint64_t i = 0; i < num; i++) {
+		const odp_packet_t tmpl = replay->pkts[(seq + i) % replay->num_pkts];
+		const odp_packet_t pkt = odp_packet_copy(tmpl, pktio_shm->pools.pktpool_odp);
+
+		if (unlikely(pkt == ODP_PACKET_INVALID))
+			continue;
+		/* Injection time, the latency is measured in pktio_tx() */
+		odp_packet_ts_set(pkt, now);
+		pkt_tbl[pkts++] = pkt;
+	}
+
+	if (unlikely(pkts < (int)num))
+		odp_atomic_add_u64(&replay->drops, num - pkts);
+	if (seq + num == replay->total)
+		odp_atomic_store_u64(&replay->done_ns, now_ns);
+
+	if (unlikely(pkts == 0))
+		return 0;
+
+	if (pktio_locm.proc.enable)
+		proc_tbl_sync();
+
+	return pktin_lookup_enqueue(pkt_tbl, pkts);
+}
+
+/*
+ * Helper to pktio_tx() in replay mode: count the Tx pkts and collect the
+ * latency from injection to Tx.
+ */
+static inline void replay_tx_stat(const odp_event_t odp_events[], int num)
+{
+	replay_core_stat_t *const stat = &pktio_shm->replay.core_stat[em_core_id()];
+	const odp_time_t now = odp_time_global();
+	uint64_t sum = 0;
+	uint64_t max = stat->lat_max_ns;
+	uint64_t cnt = 0;
+
+	for (int i = 0; i < num; i++) {
+		const odp_packet_t pkt = odp_packet_from_event(odp_events[i]);
+
+		/* Pkts created by the application carry no injection time */
+		if (!odp_packet_has_ts(pkt))
+			continue;
+
+		const uint64_t ns = odp_time_diff_ns(now, odp_packet_ts(pkt));
+
+		sum += ns;
+		max = MAX(max, ns);
+		cnt++;
+	}
+
+	stat->tx += num;
+	stat->lat_cnt += cnt;
+	stat->lat_sum_ns += sum;
+	stat->lat_max_ns = max;
+	stat->last_tx_ns = odp_time_to_ns(now);
+}
+
+void pktio_replay_print(void)
+{
+	const pktio_replay_t *replay = &pktio_shm->replay;
+	const uint64_t drops = odp_atomic_load_u64(&replay->drops);
+	const uint64_t injected = odp_atomic_load_u64(&replay->seq) - drops;
+	uint64_t done_ns = odp_atomic_load_u64(&replay->done_ns);
+	uint64_t last_tx_ns = replay->start_ns;
+	uint64_t tx = 0;
+	uint64_t lat_cnt = 0;
+	uint64_t lat_sum_ns = 0;
+	uint64_t lat_max_ns = 0;
+
+	for (int i = 0; i < MAX_THREADS; i++) {
+		const replay_core_stat_t *stat = &replay->core_stat[i];
+
+		tx += stat->tx;
+		lat_cnt += stat->lat_cnt;
+		lat_sum_ns += stat->lat_sum_ns;
+		lat_max_ns = MAX(lat_max_ns, stat->lat_max_ns);
+		last_tx_ns = MAX(last_tx_ns, stat->last_tx_ns);
+	}
+
+	/* Still injecting (loops:0 or stopped early): use the stop time */
+	if (done_ns == 0)
+		done_ns = odp_time_global_ns();
+
+	const double inj_sec = (double)(done_ns - replay->start_ns) / ODP_TIME_SEC_IN_NS;
+	const double tx_sec = (double)(last_tx_ns - replay->start_ns) / ODP_TIME_SEC_IN_NS;
+
+	APPL_PRINT("\nPcap replay results: %s, %u pkts, loops:%u, rate:%" PRIu64 " pkts/s (0=max)\n"
+		   "  Injected:    %" PRIu64 " pkts in %.3f s: %.3f Mpps (copy failures:%" PRIu64 ")\n"
+		   "  Transmitted: %" PRIu64 " pkts in %.3f s: %.3f Mpps (%s)\n"
+		   "  Latency, injection to pktio_tx(): avg:%" PRIu64 " ns max:%" PRIu64 " ns (%" PRIu64 " samples)\n\n",
+		   replay->file, replay->num_pkts, replay->loops, replay->rate,
+		   injected, inj_sec, inj_sec > 0 ? (double)injected / inj_sec / 1e6 : 0.0, drops,
+		   tx, tx_sec, tx_sec > 0 ? (double)tx / tx_sec / 1e6 : 0.0, replay->tx_dev,
+		   lat_cnt ? lat_sum_ns / lat_cnt : 0, lat_max_ns, lat_cnt);
+}
+
 static inline int
 pktio_tx_burst(tx_burst_t *const tx_burst)
 {
@@ -1214,10 +2348,88 @@ pktio_tx_burst(tx_burst_t *const tx_burst)
 	return ret;
 }
 
+void pktio_tx_chksum(em_event_t event, int out_port)
+{
+	odp_packet_t pkt = pktio_odp_packet_get(event);
+	const int if_idx = out_port % IF_MAX_NUM;
+
+	/* The offloads and the sw checksums need the L3/L4 offsets and types */
+	if (odp_packet_l3_offset(pkt) == ODP_PACKET_OFFSET_INVALID) {
+		odp_packet_l3_offset_set(pkt, ODPH_ETHHDR_LEN);
+		odp_packet_has_ipv4_set(pkt, 1);
+	}
+	if (odp_packet_l4_offset(pkt) == ODP_PACKET_OFFSET_INVALID) {
+		const odph_ipv4hdr_t *ip = pktio_pkt_ipv4(pkt);
+
+		odp_packet_l4_offset_set(pkt, odp_packet_l3_offset(pkt) +
+					 ODPH_IPV4HDR_IHL(ip->ver_ihl) * 4);
+		if (ip->proto == ODPH_IPPROTO_UDP)
+			odp_packet_has_udp_set(pkt, 1);
+		else if (ip->proto == ODPH_IPPROTO_TCP)
+			odp_packet_has_tcp_set(pkt, 1);
+	}
+
+	if (pktio_shm->pktout.l3_chksum[if_idx])
+		odp_packet_l3_chksum_insert(pkt, true);
+	else
+		(void)odph_ipv4_csum_update(pkt);
+
+	if (pktio_shm->pktout.l4_chksum[if_idx])
+		odp_packet_l4_chksum_insert(pkt, true);
+	else if (odp_packet_has_udp(pkt) || odp_packet_has_tcp(pkt))
+		(void)odph_udp_tcp_chksum(pkt, ODPH_CHKSUM_GENERATE, NULL);
+}
+
+/*
+ * Helper to pktio_tx() with '--pktin-coalesce': count the pkts to transmit,
+ * the pkts carried by vectors are transmitted one by one.
+ */
+static inline uint32_t
+pktio_tx_num_pkts(const em_event_t events[], unsigned int num)
+{
+	uint32_t num_pkts = 0;
+
+	for (unsigned int i = 0; i < num; i++) {
+		if (em_event_type_major(em_event_get_type(events[i])) ==
+		    EM_EVENT_TYPE_VECTOR)
+			num_pkts += em_event_vector_size(events[i]);
+		else
+			num_pkts++;
+	}
+
+	return num_pkts;
+}
+
+/*
+ * Helper to pktio_tx() with '--pktin-coalesce': split the vectors back into
+ * pkts and mark all pkts as "free" from EM point of view, the vectors
+ * themselves are freed.
+ */
+static inline void
+pktio_tx_split(const em_event_t events[], unsigned int num,
+	       odp_event_t odp_events[] /*out*/)
+{
+	uint32_t cnt = 0;
+
+	for (unsigned int i = 0; i < num; i++) {
+		em_event_t event = events[i];
+		em_event_t *pkt_tbl;
+		const uint32_t pkts = pktio_pkt_tbl(&event, &pkt_tbl /*out*/);
+
+		em_odp_events2odp(pkt_tbl, &odp_events[cnt], pkts);
+		em_event_mark_free_multi(pkt_tbl, pkts);
+		if (pkt_tbl != &event)
+			em_event_vector_free(event);
+		cnt += pkts;
+	}
+}
+
 /**
  * @brief User provided output-queue callback function (em_output_func_t).
  *
  * Transmit events(pkts) via Eth Tx queues.
+ * With '--pktin-coalesce' the pkts of vector events are transmitted one by
+ * one and all events are always consumed, pkts not transmitted are dropped.
  *
  * @return The number of events actually transmitted (<= num)
  */
@@ -1237,16 +2449,28 @@ int pktio_tx(const em_event_t events[], const unsigned int num,
 	if (unlikely(num == 0 || !pktio_shm->pktio_started))
 		return 0;
 
-	/* Convert into ODP-events */
-	odp_event_t odp_events[num];
+	const bool split = pktio_shm->pktin.coalesce;
+	const uint32_t num_pkts = unlikely(split) ?
+				  pktio_tx_num_pkts(events, num) : num;
 
-	em_odp_events2odp(events, odp_events, num);
+	if (unlikely(num_pkts == 0)) {
+		pktio_tx_split(events, num, NULL); /* only empty vectors */
+		return num;
+	}
+
+	/* Convert into ODP-events */
+	odp_event_t odp_events[num_pkts];
 
 	/*
 	 * Mark all events as "free" from EM point of view - ODP will transmit
 	 * and free the events (=odp-pkts).
 	 */
-	em_event_mark_free_multi(events, num);
+	if (unlikely(split)) {
+		pktio_tx_split(events, num, odp_events);
+	} else {
+		em_odp_events2odp(events, odp_events, num);
+		em_event_mark_free_multi(events, num);
+	}
 
 	/*
 	 * 'sched_ctx_type = em_sched_context_type_current(&src_sched_queue)'
@@ -1254,19 +2478,47 @@ int pktio_tx(const em_event_t events[], const unsigned int num,
 	 * output. Also em_queue_get_type(src_sched_queue) could further be used
 	 * if not caring about a potentially ended sched-context caused by an
 	 * earlier call to em_atomic/ordered_processing_end().
-	 * Here, none of this is done, since every event will be buffered and
-	 * sent out in order regardless of sched context type or queue type.
+	 * Here, every event will be buffered and sent out in order regardless of
+	 * sched context type or queue type - except with '--pktout-order-lock'
+	 * in an ordered context: EM then calls this function in the order of
+	 * the source queue, serialized either by the ODP ordered lock of the
+	 * source queue (EM_QUEUE_FLAG_ORDER_LOCK) or by EM reordering and
+	 * draining the output queue. The pkts are sent directly to the pktout
+	 * queue with no shared tx-burst buffering.
 	 */
 
-	ret = odp_queue_enq_multi(tx_burst->queue, odp_events, num);
-	if (unlikely(ret < 0)) {
-		/* failure: don't return, see if a burst can be Tx anyway */
-		ret = 0;
+	if (unlikely(pktio_shm->replay.enable))
+		replay_tx_stat(odp_events, num_pkts);
+
+	if (pktio_locm.proc.enable) {
+		/* Process-per-core mode: own pktout queue, no shared buffering */
+		ret = odp_queue_enq_multi(pktio_locm.proc.pktout[if_port],
+					  odp_events, num_pkts);
+		if (unlikely(ret < 0))
+			ret = 0;
+	} else if (pktio_shm->pktout.order_lock &&
+		   em_sched_context_type_current(NULL) == EM_SCHED_CONTEXT_TYPE_ORDERED) {
+		ret = odp_queue_enq_multi(tx_burst->pktout_queue, odp_events, num_pkts);
+		if (unlikely(ret < 0))
+			ret = 0;
+	} else {
+		ret = odp_queue_enq_multi(tx_burst->queue, odp_events, num_pkts);
+		if (unlikely(ret < 0)) {
+			/* failure: don't return, see if a burst can be Tx anyway */
+			ret = 0;
+		}
+
+		prev_cnt = odp_atomic_fetch_add_u64(&tx_burst->cnt, ret);
+		if (prev_cnt >= MAX_PKT_BURST_TX - 1)
+			(void)pktio_tx_burst(tx_burst);
 	}
 
-	prev_cnt = odp_atomic_fetch_add_u64(&tx_burst->cnt, ret);
-	if (prev_cnt >= MAX_PKT_BURST_TX - 1)
-		(void)pktio_tx_burst(tx_burst);
+	if (unlikely(split)) {
+		/* the vectors are gone, drop the pkts that were not buffered */
+		if (unlikely(ret < (int)num_pkts))
+			odp_event_free_multi(&odp_events[ret], num_pkts - ret);
+		return num;
+	}
 
 	if (unlikely(ret < (int)num))
 		em_event_unmark_free_multi(&events[ret], num - ret);
@@ -1312,6 +2564,10 @@ int pktout_drainfn(void)
 		curr - prev : UINT64_MAX - prev + curr + 1;
 	int ret = 0;
 
+	/* Process-per-core mode: nothing buffered, see pktio_tx() */
+	if (pktio_locm.proc.enable)
+		return 0;
+
 	/* TX burst queue drain */
 	if (unlikely(diff > BURST_TX_DRAIN)) {
 		tx_burst_t *tx_drain_burst = tx_drain_burst_acquire();
@@ -1358,8 +2614,16 @@ void pktio_add_queue(uint8_t proto, uint32_t ipv4_dst, uint16_t port_dst,
 
 	ret = pktio_shm->tbl_lookup.ops.f_put(pktio_shm->tbl_lookup.tbl, &key,
 					      &pktio_shm->rx_pkt_queues[idx]);
-	if (likely(ret == 0))
+	if (likely(ret == 0)) {
+		pktio_shm->tbl_lookup.keys[idx] = key;
 		pktio_shm->tbl_lookup.tbl_idx++;
+		/* Entry complete: the per-process replicas may copy it */
+		odp_atomic_store_rel_u32(&pktio_shm->tbl_lookup.num_pub,
+					 pktio_shm->tbl_lookup.tbl_idx);
+		/* The sw lookup entry stays as the fallback */
+		if (pktio_shm->cls.enable)
+			pktin_cls_add(proto, key.ip_dst, key.port_dst, queue, idx);
+	}
 
 	odp_ticketlock_unlock(&pktio_shm->tbl_lookup.lock);
 
@@ -99,6 +99,18 @@ extern "C" {
  */
 #define BURST_TX_DRAIN (400000ULL)  /* around 200us at 2 Ghz */
 
+/**
+ * @def PKTIO_REPLAY_MAX_PKTS
+ * @brief Maximum number of pkts read from the pcap file in replay mode
+ */
+#define PKTIO_REPLAY_MAX_PKTS  (8 * 1024)
+
+/**
+ * @def PKTIO_REPLAY_DEV_LEN
+ * @brief Maximum length of the Tx device name used in replay mode
+ */
+#define PKTIO_REPLAY_DEV_LEN  (REPLAY_PATH_LEN + 16)
+
 /** Ethernet MAC address */
 typedef union {
 	uint8_t u8[6];
@@ -176,6 +188,82 @@ typedef struct {
 	odp_packet_t pkt_tbl[MAX_PKT_BURST_RX];
 } rx_queue_burst_t;
 
+/**
+ * @brief Pcap replay statistics of one EM-core, only written by that core
+ */
+typedef struct {
+	/** Pkts given to pktio_tx() */
+	uint64_t tx;
+	/** Replayed pkts with a latency sample */
+	uint64_t lat_cnt;
+	uint64_t lat_sum_ns;
+	uint64_t lat_max_ns;
+	/** Time of the last pktio_tx() call */
+	uint64_t last_tx_ns;
+} ODP_ALIGNED_CACHE replay_core_stat_t;
+
+/**
+ * @brief Pcap replay state
+ *
+ * The pkts of the pcap file are read into 'pkts[]' from a dedicated pool at
+ * startup. The input poll function injects copies of them into EM in file
+ * order, the copies are timestamped with the injection time.
+ */
+typedef struct {
+	/** Replay mode enabled, the other fields are only valid if set */
+	bool enable;
+	/** Injection rate in pkts/s, 0: as fast as possible */
+	uint64_t rate;
+	/** Number of times the file is injected, 0: forever */
+	uint32_t loops;
+	/** Total number of pkts to inject, UINT64_MAX: forever */
+	uint64_t total;
+	/** Pcap file name, for printing */
+	char file[REPLAY_PATH_LEN];
+	/** ODP pktio device used for Tx: a pcap dumper or a null device */
+	char tx_dev[PKTIO_REPLAY_DEV_LEN];
+
+	/** Pool of the template pkts */
+	odp_pool_t pool;
+	/** Template pkts in file order */
+	odp_packet_t pkts[PKTIO_REPLAY_MAX_PKTS];
+	/** Number of entries in 'pkts[]' */
+	uint32_t num_pkts;
+
+	/** Injection start time, set in pktio_start() */
+	uint64_t start_ns;
+	/** Sequence number of the next pkt to inject */
+	odp_atomic_u64_t seq;
+	/** Pkts that could not be copied */
+	odp_atomic_u64_t drops;
+	/** Time when the last pkt was injected, 0 if not yet */
+	odp_atomic_u64_t done_ns;
+
+	replay_core_stat_t core_stat[MAX_THREADS];
+} pktio_replay_t;
+
+/**
+ * @brief Adaptive pktin polling statistics, per EM-core
+ *
+ * @see '--pktin-adaptive'
+ */
+typedef struct {
+	/** Polls of the pktin queues */
+	uint64_t polls;
+	/** Polls that got no pkts */
+	uint64_t empty_polls;
+	/** Polls skipped while backing off */
+	uint64_t skipped;
+	/** Polls that waited for pkts (odp_pktin_recv_tmo() or sleep) */
+	uint64_t sleeps;
+	/** Time spent waiting */
+	uint64_t sleep_ns;
+	/** Pkt rx timestamp to poll latency samples, sum and max */
+	uint64_t lat_cnt;
+	uint64_t lat_sum_ns;
+	uint64_t lat_max_ns;
+} ODP_ALIGNED_CACHE pktin_adaptive_stat_t;
+
 /**
  * @brief Pktio shared memory
  *
@@ -226,6 +314,22 @@ typedef struct {
 		/* Packet input mode */
 		pktin_mode_t in_mode;
 
+		/** Sched pktin queues bound to single-core queue groups */
+		bool flow_affine;
+		/** Flow-affine: core for the next pktin queue, round-robin */
+		int affine_next_core;
+
+		/** Polled pktin: same-queue pkts of a burst sent as one vector */
+		bool coalesce;
+
+		/** Parser layer requested for the input pkts ('--pktin-parse') */
+		odp_proto_layer_t parse_layer;
+
+		/** Adaptive polling: max wake-up latency (ns), 0=disabled */
+		uint64_t adaptive_ns;
+		/** Adaptive polling: start time for the statistics */
+		uint64_t adaptive_start_ns;
+
 		/** Number of input queues per interface */
 		int num_queues[IF_MAX_NUM];
 
@@ -261,6 +365,15 @@ typedef struct {
 		 *  Used when draining the available tx-burst buffers
 		 */
 		odp_stash_t tx_burst_stash;
+
+		/** Checksum insertion offload requested ('--pktout-chksum') */
+		bool chksum;
+		/** Ordered output via ordered locks ('--pktout-order-lock') */
+		bool order_lock;
+		/** IPv4 header checksum offload enabled, per interface */
+		bool l3_chksum[IF_MAX_NUM];
+		/** UDP and TCP checksum offload enabled, per interface */
+		bool l4_chksum[IF_MAX_NUM];
 	} pktout;
 
 	/** Info about the em-odp queues configured for pktio, store in hash */
@@ -272,12 +385,77 @@ typedef struct {
 		odph_table_t tbl;
 		int tbl_idx;
 		odp_ticketlock_t lock;
+		/** Keys of the entries, idx as in rx_pkt_queues[], for the replicas */
+		pkt_q_hash_key_t keys[MAX_RX_PKT_QUEUES];
+		/** Number of entries published to the per-process replicas */
+		odp_atomic_u32_t num_pub;
 	} tbl_lookup;
 
+	/** ODP classifier for the pktio_add_queue() rules, '--pktin-classifier' */
+	struct {
+		/** Classifier requested and supported */
+		bool enable;
+		/** Interfaces using the classifier */
+		bool if_enabled[IF_MAX_NUM];
+		/** Default CoS per interface, pkts not matching any PMR */
+		odp_cos_t default_cos[IF_MAX_NUM];
+		/** Plain queue of the default CoS, polled as the pktin queue */
+		odp_queue_t default_queue[IF_MAX_NUM];
+		/** CoS and PMR per interface and rule, idx as in rx_pkt_queues[] */
+		odp_cos_t cos[IF_MAX_NUM][MAX_RX_PKT_QUEUES];
+		odp_pmr_t pmr[IF_MAX_NUM][MAX_RX_PKT_QUEUES];
+		/** Number of PMRs installed */
+		int num_pmr;
+	} cls;
+
 	/** Tx burst buffers per interface  */
 	tx_burst_t tx_burst[IF_MAX_NUM][MAX_TX_BURST_BUFS] ODP_ALIGNED_CACHE;
+
+	/** Pcap replay, only used with the '--pktio-replay' option */
+	pktio_replay_t replay ODP_ALIGNED_CACHE;
+
+	/** Adaptive pktin polling statistics per EM-core, '--pktin-adaptive' */
+	pktin_adaptive_stat_t adaptive_stat[MAX_THREADS];
 } pktio_shm_t;
 
+/**
+ * @def PROC_TBL_SIZE
+ * @brief Size of the per-process replica of the Rx lookup table (power of 2)
+ */
+#define PROC_TBL_SIZE (2 * MAX_RX_PKT_QUEUES)
+
+/**
+ * @brief Pktio resources owned by one process in process-per-core mode
+ *
+ * Each EM-core process polls its own share of the pktin queues, transmits
+ * via its own pktout queue and looks up the destination queues from a
+ * private replica of the shared Rx lookup table. The shared pktio memory is
+ * then only read in the fast path, apart from the per-core statistics.
+ */
+typedef struct {
+	/** Process-per-core mode: use the owned resources below */
+	bool enable;
+	/** Number of owned pktin queues */
+	int num_pktin;
+	/** Next owned pktin queue to poll */
+	int next_pktin;
+	/** Owned pktin queues: interface index and queue index */
+	struct {
+		int if_idx;
+		int q;
+	} pktin[IF_MAX_NUM * PKTIO_MAX_IN_QUEUES];
+	/** Owned pktout queue per interface */
+	odp_queue_t pktout[IF_MAX_NUM];
+	/** Number of entries copied from the shared lookup table */
+	uint32_t tbl_num;
+	/** Replica of the lookup table, open addressing, value: rx_pkt_queues[pos] */
+	struct {
+		pkt_q_hash_key_t key;
+		int pos;
+		bool used;
+	} tbl[PROC_TBL_SIZE];
+} pktio_proc_t;
+
 /**
  * @brief Pktio core-local memory
  *
@@ -296,6 +474,17 @@ typedef struct {
 	rx_queue_burst_t rx_qbursts[MAX_RX_PKT_QUEUES + 1]; /* +1=default Q */
 	/** Temporary storage of Tx pkt burst */
 	odp_event_t ev_burst[MAX_PKT_BURST_TX];
+	/** Adaptive pktin polling state, '--pktin-adaptive' */
+	struct {
+		/** Consecutive empty polls */
+		uint32_t empty_polls;
+		/** Current back-off, 0: poll every round */
+		uint64_t backoff_ns;
+		/** Skip the polls until this time */
+		uint64_t next_poll_ns;
+	} adaptive;
+	/** Owned pktio resources in process-per-core mode */
+	pktio_proc_t proc;
 } pktio_locm_t;
 
 /**
@@ -310,6 +499,9 @@ void pktio_mem_reserve(void);
  * Lookup shared memory for pktio
  *
  * Must be called once by each EM-core before using any further pktio resources.
+ * In process-per-core mode the EM-core process also takes its share of the
+ * pktio resources into exclusive use, see pktio_proc_t. Call after the pktio
+ * interfaces have been created.
  *
  * @param is_thread_per_core  true:  EM running in thread-per-core mode
  *                            false: EM running in process-per-core mode
@@ -332,7 +524,23 @@ void pktio_halt(void);
 void pktio_stop(void);
 void pktio_close(void);
 
+/**
+ * @brief EM queue flags for the queues whose events are sent to pktout
+ *
+ * With the '--pktout-order-lock' option the ordered queues are created with
+ * EM_QUEUE_FLAG_ORDER_LOCK: EM then outputs the events sent from the ordered
+ * context in order at the end of the context using an ODP ordered lock, and
+ * pktio_tx() transmits them without the shared tx-burst buffers.
+ * Otherwise returns EM_QUEUE_FLAG_DEFAULT.
+ *
+ * @param type  Type of the EM queue to create
+ */
+em_queue_flag_t pktio_queue_flags(em_queue_type_t type);
+
 const char *pktin_mode_str(pktin_mode_t in_mode);
+const char *pktin_parse_str(odp_proto_layer_t layer);
+/** Print the adaptive pktin polling statistics, '--pktin-adaptive' */
+void pktin_adaptive_print(void);
 bool pktin_polled_mode(pktin_mode_t in_mode);
 bool pktin_sched_mode(pktin_mode_t in_mode);
 
@@ -360,6 +568,44 @@ int pktin_pollfn_direct(void);
  */
 int pktin_pollfn_plainqueue(void);
 
+/**
+ * @brief Inject pkts from the pcap file into EM queues in replay mode.
+ *
+ * Given to EM via 'em_conf.input.input_poll_fn' instead of the pktin poll
+ * functions when the '--pktio-replay' option is used. Copies of the pcap pkts
+ * are timestamped and enqueued into the EM queues set up with
+ * pktio_add_queue() or pktio_default_queue(), like received pkts.
+ * Once all loops of the file have been injected and the output has drained,
+ * the application is told to exit.
+ * The function is of type 'em_input_poll_func_t'
+ *
+ * @return number of pkts injected and enqueued into EM
+ */
+int pktin_pollfn_replay(void);
+
+/**
+ * Parse the '--pktio-replay' option value
+ * '<pcap-file>[,<rate>[,<loops>[,<tx-pcap-file>]]]'
+ *
+ * @return 0 on success, -1 on error
+ */
+int pktio_replay_parse(const char *str, pktio_replay_conf_t *conf /* out */);
+
+/**
+ * @brief Name of the ODP pktio device to use for Tx in replay mode
+ *
+ * 'pcap:out=<tx-pcap-file>' if a Tx file was given, otherwise the ODP null
+ * device. Valid after pktio_init().
+ */
+const char *pktio_replay_dev(void);
+
+/**
+ * @brief Print the replay results: pkt rates and injection-to-Tx latency
+ *
+ * Called by pktio_stop() in replay mode.
+ */
+void pktio_replay_print(void);
+
 /**
  * @brief Drain buffered output - ensure low rate flows are also sent out.
  *
@@ -409,6 +655,12 @@ typedef struct {
  *
  * Received packets matching the set destination IP-addr/port
  * will end up in the EM-queue 'queue'.
+ *
+ * With the '--pktin-classifier' option the rule is also installed as an ODP
+ * classifier PMR if 'queue' is a scheduled EM queue: matching pkts are then
+ * delivered by the classifier directly into the ODP queue of 'queue'.
+ * The sw lookup is kept as the fallback for pkts the classifier did not
+ * steer (e.g. PMR creation failed).
  */
 void pktio_add_queue(uint8_t proto, uint32_t ipv4_dst, uint16_t l4_port_dst,
 		     em_queue_t queue);
@@ -462,6 +714,75 @@ pktio_get_frame_len(em_event_t event)
 	return odp_packet_len(pkt);
 }
 
+/**
+ * Get the IPv4 header of a pkt: at the L3 offset set by the pktin parser
+ * ('--pktin-parse' L3 or higher), otherwise right after the Eth header.
+ * Note: no actual checks if the headers are present
+ */
+static inline odph_ipv4hdr_t *
+pktio_pkt_ipv4(odp_packet_t pkt)
+{
+	uint32_t offset = odp_packet_l3_offset(pkt);
+
+	if (offset == ODP_PACKET_OFFSET_INVALID)
+		offset = ODPH_ETHHDR_LEN;
+
+	return (odph_ipv4hdr_t *)((uintptr_t)odp_packet_data(pkt) + offset);
+}
+
+/**
+ * Get the UDP header (or the TCP ports) of a pkt: at the L4 offset set by
+ * the pktin parser ('--pktin-parse' L4 or higher), otherwise right after an
+ * IPv4 header without options.
+ * Note: no actual checks if the headers are present
+ */
+static inline odph_udphdr_t *
+pktio_pkt_l4(odp_packet_t pkt)
+{
+	uint32_t offset = odp_packet_l4_offset(pkt);
+
+	if (offset == ODP_PACKET_OFFSET_INVALID)
+		offset = ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN;
+
+	return (odph_udphdr_t *)((uintptr_t)odp_packet_data(pkt) + offset);
+}
+
+/**
+ * Get the flow hash of a packet-event.
+ *
+ * The hash set at pktin (e.g. by the NIC) is used if present, otherwise the
+ * hash is calculated from the IPv4 5-tuple once and stored into the pkt for
+ * the later processing stages.
+ */
+static inline uint32_t
+pktio_flow_hash(em_event_t event)
+{
+	odp_packet_t pkt = pktio_odp_packet_get(event);
+
+	if (odp_packet_has_flow_hash(pkt))
+		return odp_packet_flow_hash(pkt);
+
+	const odph_ipv4hdr_t *ip = pktio_pkt_ipv4(pkt);
+	const odph_udphdr_t *l4 = pktio_pkt_l4(pkt);
+	const uint32_t tuple[4] = {ip->src_addr, ip->dst_addr,
+				   ((uint32_t)l4->src_port << 16) | l4->dst_port,
+				   ip->proto};
+	const uint32_t hash = odp_hash_crc32c(tuple, sizeof(tuple), 0);
+
+	odp_packet_flow_hash_set(pkt, hash);
+
+	return hash;
+}
+
+/**
+ * Update the IPv4 and UDP/TCP checksums of a packet-event before sending it
+ * out via 'out_port' with pktio_tx(): the checksum insertion is requested
+ * from the interface if offloaded ('--pktout-chksum'), otherwise the
+ * checksums are calculated here. The request is pkt metadata and passes
+ * through the pktio_tx() buffering into the interface unchanged.
+ */
+void pktio_tx_chksum(em_event_t event, int out_port);
+
 static inline int
 pktio_input_port(em_event_t event)
 {
@@ -474,6 +795,25 @@ pktio_input_port(em_event_t event)
 	return input_port;
 }
 
+/**
+ * Get the packet-events carried by an event: the pkts of a vector
+ * (see '--pktin-coalesce') or the event itself.
+ *
+ * @param event         Packet or vector event, pointer must stay valid
+ * @param[out] pkt_tbl  Points to the packet-events
+ *
+ * @return The number of packet-events in 'pkt_tbl'
+ */
+static inline uint32_t
+pktio_pkt_tbl(em_event_t *event, em_event_t **pkt_tbl /*out*/)
+{
+	if (em_event_type_major(em_event_get_type(*event)) == EM_EVENT_TYPE_VECTOR)
+		return em_event_vector_tbl(*event, pkt_tbl);
+
+	*pkt_tbl = event;
+	return 1;
+}
+
 /**
  * Get the protocol, IPv4 destination address and destination L4 port the
  * packet-event was sent to.
@@ -483,33 +823,9 @@ pktio_get_dst(em_event_t event, uint8_t *proto__out,
 	      uint32_t *ipv4_dst__out, uint16_t *l4_port_dst__out)
 {
 	odp_packet_t pkt = pktio_odp_packet_get(event);
-	void *pkt_data;
-	odph_ipv4hdr_t *ip;
-	odph_udphdr_t *udp;
-
-	/* if (odp_packet_has_ipv4(pkt)) {
-	 *	ip = (odph_ipv4hdr_t *)odp_packet_l3_ptr(pkt, NULL);
-	 *	*proto__out = ip->proto;
-	 *	*ipv4_dst__out = ntohl(ip->dst_addr);
-	 * } else {
-	 *	*proto__out = 0;
-	 *	*ipv4_dst__out = 0;
-	 * }
-	 *
-	 * if (odp_packet_has_udp(pkt)) {
-	 *	udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
-	 *	*port_dst__out = ntohs(udp->dst_port);
-	 * } else {
-	 *	*port_dst__out = 0;
-	 * }
-	 */
-
-	/* Note: no actual checks if the headers are present */
-	pkt_data = odp_packet_data(pkt);
-	ip = (odph_ipv4hdr_t *)((uintptr_t)pkt_data +
-				sizeof(odph_ethhdr_t));
-	udp = (odph_udphdr_t *)((uintptr_t)ip +
-				sizeof(odph_ipv4hdr_t));
+	/* Parsed header offsets used if available ('--pktin-parse') */
+	const odph_ipv4hdr_t *ip = pktio_pkt_ipv4(pkt);
+	const odph_udphdr_t *udp = pktio_pkt_l4(pkt);
 
 	*proto__out = ip->proto;
 	*ipv4_dst__out = ntohl(ip->dst_addr);
@@ -532,7 +848,6 @@ static inline void
 pktio_swap_addrs(em_event_t event)
 {
 	odp_packet_t pkt = pktio_odp_packet_get(event);
-	void *pkt_data;
 	odph_ethhdr_t *eth;
 	odph_ethaddr_t eth_tmp_addr;
 	odph_ipv4hdr_t *ip;
@@ -541,38 +856,14 @@ pktio_swap_addrs(em_event_t event)
 	odp_u16be_t udp_tmp_port;
 
 	/*
-	 * Needs odp_pktio_config_t::parser.layer = ODP_PROTO_LAYER_L2
-	 * if (odp_packet_has_eth(pkt)) {
-	 *	eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
-	 *	eth_tmp_addr = eth->dst;
-	 *	eth->dst = eth->src;
-	 *	eth->src = eth_tmp_addr;
-	 * }
-	 *
-	 * Needs odp_pktio_config_t::parser.layer = ODP_PROTO_LAYER_L3
-	 * if (odp_packet_has_ipv4(pkt)) {
-	 *	ip = (odph_ipv4hdr_t *)odp_packet_l3_ptr(pkt, NULL);
-	 *	ip_tmp_addr = ip->src_addr;
-	 *	ip->src_addr = ip->dst_addr;
-	 *	ip->dst_addr = ip_tmp_addr;
-	 * }
-	 *
-	 * Needs odp_pktio_config_t::parser.layer = ODP_PROTO_LAYER_L4
-	 * if (odp_packet_has_udp(pkt)) {
-	 *	udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
-	 *	udp_tmp_port = udp->src_port;
-	 *	udp->src_port = udp->dst_port;
-	 *	udp->dst_port = udp_tmp_port;
-	 * }
+	 * Swapping the src and dst keeps the IPv4 and UDP checksums valid.
+	 * Parsed header offsets used if available ('--pktin-parse'),
+	 * note: no actual checks if headers are present
 	 */
+	eth = (odph_ethhdr_t *)odp_packet_data(pkt);
+	ip = pktio_pkt_ipv4(pkt);
+	udp = pktio_pkt_l4(pkt);
 
-	/* Note: no actual checks if headers are present */
-	pkt_data = odp_packet_data(pkt);
-	eth = (odph_ethhdr_t *)pkt_data;
-	ip = (odph_ipv4hdr_t *)((uintptr_t)pkt_data +
-				sizeof(odph_ethhdr_t));
-	udp = (odph_udphdr_t *)((uintptr_t)ip +
-				sizeof(odph_ipv4hdr_t));
 	eth_tmp_addr = eth->dst;
 	eth->dst = eth->src;
 	eth->src = eth_tmp_addr;
@@ -57,6 +57,7 @@
 #include "cm_pool_config.h"
 #include "cm_pktio.h"
 #include "cm_error_handler.h"
+#include "cm_loadgen.h"
 
 /**
  * @def USAGE_FMT
@@ -94,12 +95,58 @@
 "                                   PKTIN_MODE_SCHED + SCHED_SYNC_ORDERED\n"	\
 "  -v, --pktin-vector            Enable vector-mode for packet-input (default: disabled)\n"\
 "                                Supported with --pktin-mode:s 2, 3, 4\n"	\
+"  -f, --pktin-flow-affine       Bind each pktin hash queue to the queue group of\n" \
+"                                one EM-core, flows stay on one core (default: disabled)\n" \
+"                                Supported with --pktin-mode:s 2, 3, 4, needs\n" \
+"                                'queue_group.create_core_queue_groups = true'\n" \
+"  -C, --pktin-classifier        Install the pktio_add_queue() rules as ODP classifier\n" \
+"                                rules, pkts are then delivered directly into the\n" \
+"                                EM queues (default: disabled, sw lookup)\n"	\
+"                                Supported with --pktin-mode 1, the sw lookup is\n" \
+"                                used for rules the classifier can't take\n"	\
+"  -g, --pktin-coalesce          Coalesce the pkts of one pktin burst going to the same\n" \
+"                                queue into one vector event, split again in pktio_tx()\n" \
+"                                (default: disabled)\n"				\
+"                                Supported with --pktin-mode:s 0, 1, the EOs must\n" \
+"                                handle EM_EVENT_TYPE_VECTOR events\n"		\
+"  -a, --pktin-adaptive <arg>    Adaptive pktin polling: back off the polling when\n" \
+"                                idle and wait for pkts (odp_pktin_recv_tmo() or sleep),\n" \
+"                                <arg>: max wake-up latency in us (default: 0=disabled)\n" \
+"                                Supported with --pktin-mode:s 0, 1, the dispatcher\n" \
+"                                is blocked while waiting, see cm_pktio.c\n"	\
+"  -O, --pktout-order-lock       Keep the order of pkts sent from ordered queues\n" \
+"                                with ODP ordered locks instead of shared tx-burst\n" \
+"                                buffers, the application creates the ordered\n"	\
+"                                queues with the flags from pktio_queue_flags()\n" \
+"  -P, --pktin-parse <arg>       Parse the input pkts once in pktio up to the layer:\n" \
+"                                0: none (default), 1: L2, 2: L3, 3: L4, 4: all\n" \
+"                                The EOs then use the parsed header offsets and\n" \
+"                                flow hash instead of re-parsing, see cm_pktio.h\n" \
+"  -k, --pktout-chksum           Enable the IPv4/UDP/TCP checksum insertion offload\n" \
+"                                at pktout, requested per pkt with pktio_tx_chksum()\n" \
+"                                (default: disabled, sw checksum)\n"		\
 "  -i, --eth-interface <arg(s)>  Select the ethernet interface(s) to use\n"	\
 "  -e, --pktpool-em              Packet-io pool is an EM-pool (default)\n"	\
 "  -o, --pktpool-odp             Packet-io pool is an ODP-pool\n"		\
 "  -x, --vecpool-em              Packet-io vector pool is an EM-pool (default)\n" \
 "  -y, --vecpool-odp             Packet-io vector pool is an ODP-pool\n"	  \
 "    Select EITHER -e OR -o, but not both!\n" \
+"  -R, --pktio-replay <file>[,<rate>[,<loops>[,<tx-file>]]]\n"		\
+"                                Inject the pkts of a pcap file instead of using\n" \
+"                                interfaces (no -i), for benchmarks without NICs:\n" \
+"                                rate:    pkts/s (default: 0=as fast as possible)\n" \
+"                                loops:   times to inject the file, exit when done\n" \
+"                                         (default: 0=forever)\n"		\
+"                                tx-file: capture Tx pkts into a pcap file\n"	\
+"                                         (default: null=drop)\n"		\
+"                                E.g. -R traffic.pcap,1000000,10\n"		\
+"Load generator (performance tests)\n"					\
+"  -l, --loadgen <mode>,<rate>[,<burst>]\n"					\
+"                                Open-loop load from the last EM-core, rate in events/s:\n" \
+"                                const:   constant rate\n"			\
+"                                poisson: Poisson arrivals\n"			\
+"                                burst:   <burst> events back-to-back, same average rate\n" \
+"                                E.g. -l poisson,1000000 or -l burst,1000000,32\n" \
 "Help\n" \
 "  -h, --help              Display help and exit.\n" \
 "\n"
@@ -138,6 +185,20 @@ typedef struct {
 			pktin_mode_t in_mode;
 			/** Packet input vectors enabled (true/false) */
 			bool pktin_vector;
+			/** Pktin queues bound to single-core queue groups (true/false) */
+			bool pktin_flow_affine;
+			/** Pktio rules installed into the ODP classifier (true/false) */
+			bool pktin_cls;
+			/** Same-queue pkts of a pktin burst coalesced into vectors */
+			bool pktin_coalesce;
+			/** Parser layer for the input pkts */
+			odp_proto_layer_t pktin_parse;
+			/** Checksum insertion offload at pktout (true/false) */
+			bool pktout_chksum;
+			/** Adaptive pktin polling max wake-up latency (us), 0=off */
+			uint32_t pktin_adaptive_us;
+			/** Ordered pktout via ordered locks (true/false) */
+			bool pktout_order_lock;
 			/** Interface count */
 			int if_count;
 			/** Interface names + placeholder for '\0' */
@@ -150,7 +211,11 @@ typedef struct {
 			bool vecpool_em;
 			/** Pktio is setup with an ODP vector pool (if pkt-input vectors enabled) */
 			bool vecpool_odp;
+			/** Pcap replay instead of interfaces */
+			pktio_replay_conf_t replay;
 		} pktio;
+		/** Open-loop load generator */
+		loadgen_conf_t loadgen;
 	} args_appl;
 } parse_args_t;
 
@@ -329,6 +394,12 @@ int cm_setup(int argc, char *argv[])
 
 	init_appl_conf(&parsed, appl_conf);
 
+	/*
+	 * Reserve shared memory for the load generator, if requested
+	 */
+	if (appl_conf->loadgen.mode != LOADGEN_DISABLED)
+		loadgen_mem_reserve();
+
 	/*
 	 * Create and start packet-I/O, if requested
 	 */
@@ -389,6 +460,9 @@ int cm_setup(int argc, char *argv[])
 	if (appl_conf->pktio.if_count > 0)
 		term_pktio(appl_conf);
 
+	if (appl_conf->loadgen.mode != LOADGEN_DISABLED)
+		loadgen_mem_free();
+
 	/*
 	 * Terminate EM
 	 *
@@ -446,7 +520,8 @@ init_odp(const parse_args_t *parsed, const cpu_conf_t *cpu_conf)
 	 * List odp features not to be used in the examples. This may optimize
 	 * performance. Note that a real application might need to change this!
 	 */
-	init_params.not_used.feat.cls = 1; /* don't use the odp classifier */
+	/* don't use the odp classifier unless requested */
+	init_params.not_used.feat.cls = parsed->args_appl.pktio.pktin_cls ? 0 : 1;
 	init_params.not_used.feat.compress = 1; /* don't use the odp compress */
 	init_params.not_used.feat.crypto = 1; /* don't use odp crypto */
 	init_params.not_used.feat.ipsec = 1; /* don't use odp ipsec */
@@ -550,6 +625,10 @@ init_em(const parse_args_t *parsed, em_conf_t *em_conf /* out */)
 	em_conf->log.log_fn = NULL;
 	em_conf->log.vlog_fn = NULL;
 
+	/* Open-loop load generator, sends from the input poll function */
+	if (parsed->args_appl.loadgen.mode != LOADGEN_DISABLED)
+		em_conf->input.input_poll_fn = loadgen_pollfn;
+
 	/* Packet-I/O */
 	if (parsed->args_appl.pktio.if_count > 0) {
 		/*
@@ -557,7 +636,9 @@ init_em(const parse_args_t *parsed, em_conf_t *em_conf /* out */)
 		 */
 		pktin_mode_t in_mode = parsed->args_appl.pktio.in_mode;
 
-		if (in_mode == DIRECT_RECV)
+		if (parsed->args_appl.pktio.replay.enable)
+			em_conf->input.input_poll_fn = pktin_pollfn_replay;
+		else if (in_mode == DIRECT_RECV)
 			em_conf->input.input_poll_fn = pktin_pollfn_direct;
 		else if (in_mode == PLAIN_QUEUE)
 			em_conf->input.input_poll_fn = pktin_pollfn_plainqueue;
@@ -641,21 +722,36 @@ init_appl_conf(const parse_args_t *parsed, appl_conf_t *appl_conf /* out */)
 
 	appl_conf->pktio.pktpool_em = parsed->args_appl.pktio.pktpool_em;
 	appl_conf->pktio.pktin_vector = parsed->args_appl.pktio.pktin_vector;
+	appl_conf->pktio.pktin_flow_affine = parsed->args_appl.pktio.pktin_flow_affine;
+	appl_conf->pktio.pktin_cls = parsed->args_appl.pktio.pktin_cls;
+	appl_conf->pktio.pktin_coalesce = parsed->args_appl.pktio.pktin_coalesce;
+	appl_conf->pktio.pktin_parse = parsed->args_appl.pktio.pktin_parse;
+	appl_conf->pktio.pktout_chksum = parsed->args_appl.pktio.pktout_chksum;
+	appl_conf->pktio.pktin_adaptive_us = parsed->args_appl.pktio.pktin_adaptive_us;
+	appl_conf->pktio.pktout_order_lock = parsed->args_appl.pktio.pktout_order_lock;
 	appl_conf->pktio.vecpool_em = parsed->args_appl.pktio.vecpool_em;
+	appl_conf->pktio.replay = parsed->args_appl.pktio.replay;
+
+	appl_conf->loadgen = parsed->args_appl.loadgen;
 }
 
 static void
 create_pktio(appl_conf_t *appl_conf/*in/out*/, const cpu_conf_t *cpu_conf)
 {
 	pktio_mem_reserve();
+	/* Coalescing allocates its vectors from the EM vector-pool */
 	pktio_pool_create(appl_conf->pktio.if_count,
 			  appl_conf->pktio.pktpool_em,
-			  appl_conf->pktio.pktin_vector,
+			  appl_conf->pktio.pktin_vector ||
+			  appl_conf->pktio.pktin_coalesce,
 			  appl_conf->pktio.vecpool_em);
 	pktio_init(appl_conf);
 	/* Create a pktio instance for each interface */
 	for (int i = 0; i < appl_conf->pktio.if_count; i++) {
-		int if_id = pktio_create(appl_conf->pktio.if_name[i],
+		/* Replay: the Tx device (pcap dumper or null) is the interface */
+		const char *dev = appl_conf->pktio.replay.enable ?
+				  pktio_replay_dev() : appl_conf->pktio.if_name[i];
+		int if_id = pktio_create(dev,
 					 appl_conf->pktio.in_mode,
 					 appl_conf->pktio.pktin_vector,
 					 appl_conf->pktio.if_count,
@@ -676,7 +772,8 @@ term_pktio(const appl_conf_t *appl_conf)
 	pktio_close();
 	pktio_deinit(appl_conf);
 	pktio_pool_destroy(appl_conf->pktio.pktpool_em,
-			   appl_conf->pktio.pktin_vector,
+			   appl_conf->pktio.pktin_vector ||
+			   appl_conf->pktio.pktin_coalesce,
 			   appl_conf->pktio.vecpool_em);
 	pktio_mem_free();
 }
@@ -756,6 +853,8 @@ static void startup_all_cores(sync_t *sync, appl_conf_t *appl_conf,
 
 	if (appl_conf->pktio.if_count > 0)
 		pktio_mem_lookup(is_thread_per_core);
+	if (appl_conf->loadgen.mode != LOADGEN_DISABLED)
+		loadgen_mem_lookup(is_thread_per_core);
 
 	odp_barrier_wait(&sync->start_barrier);
 
@@ -850,6 +949,8 @@ static void startup_one_core_first(sync_t *sync, appl_conf_t *appl_conf,
 					  stat, em_core_id());
 		if (appl_conf->pktio.if_count > 0)
 			pktio_mem_lookup(is_thread_per_core);
+		if (appl_conf->loadgen.mode != LOADGEN_DISABLED)
+			loadgen_mem_lookup(is_thread_per_core);
 
 		/* Ensure all EM cores can find the default event pool */
 		if (em_pool_find(EM_POOL_DEFAULT_NAME) != EM_POOL_DEFAULT)
@@ -896,6 +997,8 @@ static void startup_one_core_first(sync_t *sync, appl_conf_t *appl_conf,
 
 		if (appl_conf->pktio.if_count > 0)
 			pktio_mem_lookup(is_thread_per_core);
+		if (appl_conf->loadgen.mode != LOADGEN_DISABLED)
+			loadgen_mem_lookup(is_thread_per_core);
 
 		/*
 		 * EM is ready on this EM-core (= proc, thread or core)
@@ -1057,10 +1160,14 @@ run_core_fn(void *arg)
 			/* dispatch with pktio stopped before test_stop()*/
 			em_dispatch(TERM_DISPATCH_ROUNDS);
 		}
+		/* stop the load generator, prints the final latency results */
+		loadgen_stop();
 		/*
 		 * Stop and delete created application EOs
 		 */
 		test_stop(appl_conf);
+		/* delete the load generator queue group, if created */
+		loadgen_term();
 	}
 
 	/*
@@ -1144,13 +1251,22 @@ parse_args(int argc, char *argv[], parse_args_t *parsed /* out param */)
 		{"pktpool-odp",      no_argument,       NULL, 'o'},
 		{"pktin-mode",       required_argument, NULL, 'm'},
 		{"pktin-vector",     no_argument,       NULL, 'v'},
+		{"pktin-flow-affine", no_argument,      NULL, 'f'},
+		{"pktin-classifier", no_argument,       NULL, 'C'},
+		{"pktin-coalesce",   no_argument,       NULL, 'g'},
+		{"pktin-parse",      required_argument, NULL, 'P'},
+		{"pktout-chksum",    no_argument,       NULL, 'k'},
+		{"pktin-adaptive",   required_argument, NULL, 'a'},
+		{"pktout-order-lock", no_argument,      NULL, 'O'},
 		{"startup-mode",     required_argument, NULL, 's'},
 		{"vecpool-em",       no_argument,       NULL, 'x'},
 		{"vecpool-odp",      no_argument,       NULL, 'y'},
+		{"loadgen",          required_argument, NULL, 'l'},
+		{"pktio-replay",     required_argument, NULL, 'R'},
 		{"help",             no_argument,       NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
-	static const char *shortopts = "+c:ptd:r:i:oem:vs:xyh";
+	static const char *shortopts = "+c:ptd:r:i:oem:vfCgP:ka:Os:xyl:R:h";
 	long device_id = -1;
 
 	/* set defaults: */
@@ -1305,6 +1421,52 @@ parse_args(int argc, char *argv[], parse_args_t *parsed /* out param */)
 		}
 		break;
 
+		case 'f': /* --pktin-flow-affine */
+			parsed->args_appl.pktio.pktin_flow_affine = true;
+			break;
+
+		case 'C': /* --pktin-classifier */
+			parsed->args_appl.pktio.pktin_cls = true;
+			break;
+
+		case 'g': /* --pktin-coalesce */
+			parsed->args_appl.pktio.pktin_coalesce = true;
+			break;
+
+		case 'P': { /* --pktin-parse */
+			static const odp_proto_layer_t layers[] = {
+				ODP_PROTO_LAYER_NONE, ODP_PROTO_LAYER_L2,
+				ODP_PROTO_LAYER_L3, ODP_PROTO_LAYER_L4,
+				ODP_PROTO_LAYER_ALL};
+			int layer = atoi(optarg);
+
+			if (layer < 0 || layer > 4) {
+				usage(argv[0]);
+				APPL_EXIT_FAILURE("Unknown value: -P, --pktin-parse = %d", layer);
+			}
+			parsed->args_appl.pktio.pktin_parse = layers[layer];
+		}
+		break;
+
+		case 'k': /* --pktout-chksum */
+			parsed->args_appl.pktio.pktout_chksum = true;
+			break;
+
+		case 'a': { /* --pktin-adaptive */
+			int max_us = atoi(optarg);
+
+			if (max_us < 0) {
+				usage(argv[0]);
+				APPL_EXIT_FAILURE("Invalid value: -a, --pktin-adaptive = %d", max_us);
+			}
+			parsed->args_appl.pktio.pktin_adaptive_us = max_us;
+		}
+		break;
+
+		case 'O': /* --pktout-order-lock */
+			parsed->args_appl.pktio.pktout_order_lock = true;
+			break;
+
 		case 'x': /* --vecpool-em, only used if --pktin-vector given */
 			parsed->args_appl.pktio.vecpool_em = true;
 			break;
@@ -1313,6 +1475,20 @@ parse_args(int argc, char *argv[], parse_args_t *parsed /* out param */)
 			parsed->args_appl.pktio.vecpool_odp = true;
 			break;
 
+		case 'l': /* --loadgen */
+			if (loadgen_parse(optarg, &parsed->args_appl.loadgen) != 0) {
+				usage(argv[0]);
+				APPL_EXIT_FAILURE("Invalid value: -l, --loadgen = %s", optarg);
+			}
+			break;
+
+		case 'R': /* --pktio-replay */
+			if (pktio_replay_parse(optarg, &parsed->args_appl.pktio.replay) != 0) {
+				usage(argv[0]);
+				APPL_EXIT_FAILURE("Invalid value: -R, --pktio-replay = %s", optarg);
+			}
+			break;
+
 		case 'h': /* --help */
 			usage(argv[0]);
 			exit(EXIT_SUCCESS);
@@ -1366,6 +1542,18 @@ parse_args(int argc, char *argv[], parse_args_t *parsed /* out param */)
 	strncpy(parsed->args_appl.name, NO_PATH(argv[0]), len);
 	parsed->args_appl.name[len - 1] = '\0';
 
+	/* Pcap replay: uses one interface for Tx, set up by cm_pktio */
+	if (parsed->args_appl.pktio.replay.enable) {
+		if (parsed->args_appl.pktio.if_count > 0) {
+			usage(argv[0]);
+			APPL_EXIT_FAILURE("Select EITHER:\n"
+					  "eth-interface(-i) OR pktio-replay(-R)!");
+		}
+		parsed->args_appl.pktio.if_count = 1;
+		strcpy(parsed->args_appl.pktio.if_name[0], "replay");
+		APPL_PRINT("  Pktio replay: %s\n", parsed->args_appl.pktio.replay.file);
+	}
+
 	/* Packet I/O */
 	if (parsed->args_appl.pktio.if_count > 0) {
 		if (parsed->args_appl.pktio.pktpool_em && parsed->args_appl.pktio.pktpool_odp) {
@@ -1384,6 +1572,53 @@ parse_args(int argc, char *argv[], parse_args_t *parsed /* out param */)
 		APPL_PRINT("  Pktin-mode:   %s\n",
 			   pktin_mode_str(parsed->args_appl.pktio.in_mode));
 
+		if (parsed->args_appl.pktio.pktin_flow_affine) {
+			if (!pktin_sched_mode(parsed->args_appl.pktio.in_mode)) {
+				usage(argv[0]);
+				APPL_EXIT_FAILURE("pktin-flow-affine(-f) needs a scheduled pktin-mode(-m 2,3,4)!");
+			}
+			APPL_PRINT("  Pktin-affine: Enabled\n");
+		}
+
+		if (parsed->args_appl.pktio.pktin_cls) {
+			if (parsed->args_appl.pktio.in_mode != PLAIN_QUEUE) {
+				usage(argv[0]);
+				APPL_EXIT_FAILURE("pktin-classifier(-C) needs pktin-mode(-m) 1!");
+			}
+			APPL_PRINT("  Pktin-cls:    Enabled\n");
+		}
+
+		if (parsed->args_appl.pktio.pktin_coalesce) {
+			if (!pktin_polled_mode(parsed->args_appl.pktio.in_mode)) {
+				usage(argv[0]);
+				APPL_EXIT_FAILURE("pktin-coalesce(-g) needs pktin-mode(-m) 0 or 1!");
+			}
+			if (parsed->args_appl.pktio.vecpool_odp) {
+				usage(argv[0]);
+				APPL_EXIT_FAILURE("pktin-coalesce(-g) needs vecpool-em(-x)!");
+			}
+			parsed->args_appl.pktio.vecpool_em = true;
+			APPL_PRINT("  Pktin-coal:   Enabled\n");
+		}
+
+		if (parsed->args_appl.pktio.pktin_parse != ODP_PROTO_LAYER_NONE)
+			APPL_PRINT("  Pktin-parse:  %s\n",
+				   pktin_parse_str(parsed->args_appl.pktio.pktin_parse));
+		if (parsed->args_appl.pktio.pktout_chksum)
+			APPL_PRINT("  Pktout-csum:  Offload\n");
+
+		if (parsed->args_appl.pktio.pktout_order_lock)
+			APPL_PRINT("  Pktout-order: Ordered lock\n");
+
+		if (parsed->args_appl.pktio.pktin_adaptive_us) {
+			if (!pktin_polled_mode(parsed->args_appl.pktio.in_mode)) {
+				usage(argv[0]);
+				APPL_EXIT_FAILURE("pktin-adaptive(-a) needs pktin-mode(-m) 0 or 1!");
+			}
+			APPL_PRINT("  Pktin-poll:   Adaptive, max wake-up latency %u us\n",
+				   parsed->args_appl.pktio.pktin_adaptive_us);
+		}
+
 		if (parsed->args_appl.pktio.pktin_vector) {
 			APPL_PRINT("  Pktin-vector: Enabled\n");
 			if (parsed->args_appl.pktio.vecpool_em &&
@@ -1402,7 +1637,8 @@ parse_args(int argc, char *argv[], parse_args_t *parsed /* out param */)
 				APPL_PRINT("  Vector pool:  ODP vector-pool\n");
 		} else {
 			APPL_PRINT("  Pktin-vector: Disabled\n");
-			parsed->args_appl.pktio.vecpool_em = false;
+			parsed->args_appl.pktio.vecpool_em =
+				parsed->args_appl.pktio.pktin_coalesce;
 			parsed->args_appl.pktio.vecpool_odp = false;
 		}
 	} else {
@@ -1412,6 +1648,26 @@ parse_args(int argc, char *argv[], parse_args_t *parsed /* out param */)
 		parsed->args_appl.pktio.vecpool_em = false;
 		parsed->args_appl.pktio.vecpool_odp = false;
 	}
+
+	/* Open-loop load generator */
+	const loadgen_conf_t *loadgen = &parsed->args_appl.loadgen;
+
+	if (loadgen->mode != LOADGEN_DISABLED) {
+		if (parsed->args_appl.pktio.if_count > 0) {
+			usage(argv[0]);
+			APPL_EXIT_FAILURE("Select EITHER:\n"
+					  "loadgen(-l) OR eth-interface(-i)!");
+		}
+		if (parsed->args_em.core_count < 2) {
+			usage(argv[0]);
+			APPL_EXIT_FAILURE("loadgen(-l) needs at least 2 EM-cores");
+		}
+		APPL_PRINT("  Loadgen:      %s, %" PRIu64 " events/s",
+			   loadgen_mode_str(loadgen->mode), loadgen->rate);
+		if (loadgen->mode == LOADGEN_BURSTY)
+			APPL_PRINT(", burst %u", loadgen->burst);
+		APPL_PRINT("\n");
+	}
 }
 
 /**
@@ -57,6 +57,8 @@ extern "C" {
 
 #define IF_MAX_NUM  (8)
 
+#define REPLAY_PATH_LEN  (256)
+
 /** Get rid of path in filename - only for unix-type paths using '/' */
 #define NO_PATH(file_name) (strrchr((file_name), '/') ? \
 			    strrchr((file_name), '/') + 1 : (file_name))
@@ -132,6 +134,24 @@ typedef enum pktin_mode_t {
 	SCHED_ORDERED
 } pktin_mode_t;
 
+/**
+ * @brief Pcap replay configuration
+ *
+ * @see cm_pktio.h
+ */
+typedef struct {
+	/** Replay packets from 'file' instead of receiving from interfaces */
+	bool enable;
+	/** Injection rate in pkts/s, 0: as fast as the EM-cores can inject */
+	uint64_t rate;
+	/** Number of times the file is injected, 0: forever */
+	uint32_t loops;
+	/** Pcap file to replay */
+	char file[REPLAY_PATH_LEN];
+	/** Pcap file to capture the Tx pkts into, empty: drop (null sink) */
+	char tx_file[REPLAY_PATH_LEN];
+} pktio_replay_conf_t;
+
 /**
  * @brief Application packet I/O configuration
  */
@@ -153,13 +173,73 @@ typedef struct {
 	/** Packet input vectors enabled (true/false) */
 	bool pktin_vector;
 	/**
-	 * If pktin_vector:
+	 * Scheduled pktin queues bound to single-core queue groups (true/false),
+	 * the EM pktin queues 'pktin.sched_em_queues[][]' are in these groups
+	 */
+	bool pktin_flow_affine;
+	/**
+	 * pktio_add_queue() rules installed as ODP classifier PMRs (true/false)
+	 * @see pktio_add_queue()
+	 */
+	bool pktin_cls;
+	/**
+	 * Same-queue pkts of a polled pktin burst coalesced into one vector
+	 * event, split again in pktio_tx() (true/false)
+	 */
+	bool pktin_coalesce;
+	/**
+	 * Parser layer for the input pkts, ODP_PROTO_LAYER_NONE: not parsed.
+	 * The classifier ('pktin_cls') needs and sets at least L4.
+	 */
+	odp_proto_layer_t pktin_parse;
+	/** IPv4/UDP/TCP checksum insertion offload at pktout (true/false) */
+	bool pktout_chksum;
+	/**
+	 * Adaptive polled pktin: max wake-up latency in us, 0: poll every
+	 * dispatch round (default)
+	 */
+	uint32_t pktin_adaptive_us;
+	/** Ordered pktout via ODP ordered locks, see pktio_queue_flags() */
+	bool pktout_order_lock;
+	/**
+	 * If pktin_vector or pktin_coalesce:
 	 * Pktio is setup with an EM vector-pool:  'true'
 	 * Pktio is setup with an ODP vector-pool: 'false'
 	 */
 	bool vecpool_em;
+
+	/** Pcap replay, replaces the interfaces if enabled */
+	pktio_replay_conf_t replay;
 } pktio_conf_t;
 
+/**
+ * @brief Open-loop load generator event rate mode
+ *
+ * @see cm_loadgen.h
+ */
+typedef enum loadgen_mode_t {
+	/** Load generator not used, the application sends its own events */
+	LOADGEN_DISABLED = 0,
+	/** Constant interval between the events */
+	LOADGEN_CONSTANT,
+	/** Exponentially distributed intervals, i.e. Poisson arrivals */
+	LOADGEN_POISSON,
+	/** Bursts of 'burst' events at a constant interval */
+	LOADGEN_BURSTY
+} loadgen_mode_t;
+
+/**
+ * @brief Application load generator configuration
+ */
+typedef struct {
+	/** Event rate mode */
+	loadgen_mode_t mode;
+	/** Offered load: average events per second */
+	uint64_t rate;
+	/** Events per burst in LOADGEN_BURSTY mode */
+	uint32_t burst;
+} loadgen_conf_t;
+
 /**
  * @brief  Application configuration
  */
@@ -182,6 +262,9 @@ typedef struct {
 
 	/** Packet I/O parameters */
 	pktio_conf_t pktio;
+
+	/** Open-loop load generator parameters */
+	loadgen_conf_t loadgen;
 } appl_conf_t;
 
 /** Application shared memory - allocate in single chunk */
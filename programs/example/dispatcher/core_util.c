@@ -0,0 +1,389 @@
+/*
+ *   Copyright (c) 2023, Nokia Solutions and Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Event Machine core utilization example.
+ *
+ * One EO processes a few events circulating through its atomic queue, each
+ * event takes about EVENT_WORK_US to process. The atomic queue is processed by
+ * one core at a time, so of all the EM-cores about one is busy and the others
+ * are idle. Every PRINT_EVENTS events the utilization of each core over the
+ * last period is computed from em_core_util() and printed, followed by the
+ * cumulative counters from em_core_util_print().
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <event_machine.h>
+#include <event_machine/platform/env/environment.h>
+
+#include "cm_setup.h"
+#include "cm_error_handler.h"
+
+/* Number of events circulating through the queue */
+#define NUM_EVENTS  8
+/* Processing time per event (us) */
+#define EVENT_WORK_US  100
+/* Print the core utilization every PRINT_EVENTS received events */
+#define PRINT_EVENTS  (2 * 1000000 / EVENT_WORK_US)
+
+/**
+ * Core utilization example shared memory
+ */
+typedef struct {
+	/* Event pool used by this application */
+	em_pool_t pool;
+	/* The EO and its atomic queue */
+	em_eo_t eo;
+	em_queue_t queue;
+	/* Events received, only updated in the atomic context of 'queue' */
+	uint64_t count;
+	/* Core counters at the previous print */
+	em_core_util_t prev[EM_MAX_CORES];
+	/* Pad to cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} util_shm_t;
+
+COMPILE_TIME_ASSERT((sizeof(util_shm_t) % ENV_CACHE_LINE_SIZE) == 0,
+		    UTIL_SHM_T__SIZE_ERROR);
+
+/* EM-core local pointer to shared memory */
+static ENV_LOCAL util_shm_t *util_shm;
+
+/*
+ * Local function prototypes
+ */
+static em_status_t
+util_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf);
+
+static em_status_t
+util_stop(void *eo_ctx, em_eo_t eo);
+
+static void
+util_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	     em_queue_t queue, void *q_ctx);
+
+/**
+ * Main function
+ *
+ * Call cm_setup() to perform test & EM setup common for all the
+ * test applications.
+ *
+ * cm_setup() will call test_init() and test_start() and launch
+ * the EM dispatch loop on every EM-core.
+ */
+int main(int argc, char *argv[])
+{
+	return cm_setup(argc, argv);
+}
+
+/**
+ * Init of the core utilization example.
+ *
+ * @attention Run on all cores.
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_init(void)
+{
+	int core = em_core_id();
+
+	if (core == 0) {
+		util_shm = env_shared_reserve("CoreUtilSharedMem",
+					      sizeof(util_shm_t));
+		em_register_error_handler(test_error_handler);
+	} else {
+		util_shm = env_shared_lookup("CoreUtilSharedMem");
+	}
+
+	if (util_shm == NULL) {
+		test_error(EM_ERROR_SET_FATAL(0xec0de), 0xdead,
+			   "Core util init failed on EM-core: %u",
+			   em_core_id());
+	} else if (core == 0) {
+		memset(util_shm, 0, sizeof(util_shm_t));
+	}
+}
+
+/**
+ * Startup of the core utilization example.
+ *
+ * @attention Run only on EM core 0.
+ *
+ * @param appl_conf Application configuration
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_start(appl_conf_t *const appl_conf)
+{
+	em_eo_t eo;
+	em_status_t ret, start_ret = EM_ERROR;
+
+	if (appl_conf->num_pools >= 1)
+		util_shm->pool = appl_conf->pools[0];
+	else
+		util_shm->pool = EM_POOL_DEFAULT;
+
+	APPL_PRINT("\n"
+		   "***********************************************************\n"
+		   "EM APPLICATION: '%s' initializing:\n"
+		   "  %s: %s() - EM-core:%i\n"
+		   "  Application running on %d EM-cores (procs:%d, threads:%d)\n"
+		   "  using event pool:%" PRI_POOL "\n"
+		   "***********************************************************\n"
+		   "\n",
+		   appl_conf->name, NO_PATH(__FILE__), __func__, em_core_id(),
+		   em_core_count(),
+		   appl_conf->num_procs, appl_conf->num_threads,
+		   util_shm->pool);
+
+	test_fatal_if(util_shm->pool == EM_POOL_UNDEF,
+		      "Undefined application event pool!");
+
+	/* Start the measurement from the counters at startup */
+	for (int i = 0; i < em_core_count(); i++) {
+		ret = em_core_util(i, &util_shm->prev[i]);
+		test_fatal_if(ret != EM_OK, "em_core_util(%d):%" PRI_STAT "",
+			      i, ret);
+	}
+
+	eo = em_eo_create("core-util-eo", util_start, NULL,
+			  util_stop, NULL, util_receive, NULL);
+	test_fatal_if(eo == EM_EO_UNDEF, "EO creation failed!");
+	util_shm->eo = eo;
+
+	ret = em_eo_start_sync(eo, &start_ret, NULL);
+	test_fatal_if(ret != EM_OK || start_ret != EM_OK,
+		      "EO start:%" PRI_STAT " %" PRI_STAT "",
+		      ret, start_ret);
+}
+
+void
+test_stop(appl_conf_t *const appl_conf)
+{
+	const int core = em_core_id();
+	em_status_t stat;
+
+	(void)appl_conf;
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	stat = em_eo_stop_sync(util_shm->eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO stop failed!");
+}
+
+void
+test_term(void)
+{
+	int core = em_core_id();
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	if (core == 0) {
+		env_shared_free(util_shm);
+		em_unregister_error_handler();
+	}
+}
+
+/**
+ * @private
+ *
+ * EO start function.
+ *
+ * Creates the atomic queue and sends NUM_EVENTS events into it.
+ */
+static em_status_t
+util_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf)
+{
+	em_queue_t queue;
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)conf;
+
+	queue = em_queue_create("core-util", EM_QUEUE_TYPE_ATOMIC,
+				EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_DEFAULT,
+				NULL);
+	test_fatal_if(queue == EM_QUEUE_UNDEF, "Queue creation failed!");
+	util_shm->queue = queue;
+
+	status = em_eo_add_queue_sync(eo, queue);
+	test_fatal_if(status != EM_OK, "EO add queue:%" PRI_STAT "\n"
+		      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "", status, eo, queue);
+
+	for (int i = 0; i < NUM_EVENTS; i++) {
+		em_event_t event = em_alloc(sizeof(uint64_t), EM_EVENT_TYPE_SW,
+					    util_shm->pool);
+
+		test_fatal_if(event == EM_EVENT_UNDEF,
+			      "Event allocation failed!");
+
+		status = em_send(event, queue);
+		test_fatal_if(status != EM_OK, "em_send():%" PRI_STAT "\n"
+			      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "",
+			      status, eo, queue);
+	}
+
+	APPL_PRINT("Core utilization example started, one atomic queue on %d EM-cores\n",
+		   em_core_count());
+
+	return EM_OK;
+}
+
+/**
+ * @private
+ *
+ * EO stop function.
+ */
+static em_status_t
+util_stop(void *eo_ctx, em_eo_t eo)
+{
+	em_status_t stat;
+
+	(void)eo_ctx;
+
+	APPL_PRINT("Core utilization example stop on EM-core %d\n", em_core_id());
+
+	stat = em_eo_remove_queue_sync(eo, util_shm->queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO remove queue failed!");
+
+	stat = em_queue_delete(util_shm->queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("Queue delete failed!");
+
+	stat = em_eo_delete(eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO delete failed!");
+
+	return stat;
+}
+
+/**
+ * @private
+ *
+ * Print the utilization of each core since the previous print.
+ */
+static void
+print_util(void)
+{
+	const int core_count = em_core_count();
+	double busy_cores = 0.0;
+	em_core_util_t util;
+	em_status_t stat;
+
+	APPL_PRINT("\n");
+
+	for (int i = 0; i < core_count; i++) {
+		em_core_util_t *prev = &util_shm->prev[i];
+
+		stat = em_core_util(i, &util);
+		test_fatal_if(stat != EM_OK, "em_core_util(%d):%" PRI_STAT "",
+			      i, stat);
+
+		const uint64_t busy_ns = util.busy_ns - prev->busy_ns;
+		const uint64_t total_ns = busy_ns + util.idle_ns - prev->idle_ns;
+		const uint64_t rounds = util.rounds - prev->rounds;
+		const uint64_t events = util.events - prev->events;
+		const double busy = total_ns ? (double)busy_ns / (double)total_ns : 0.0;
+
+		APPL_PRINT("Core %02d: busy %5.1f%% events %" PRIu64 " rounds %" PRIu64 ""
+			   " avg burst %.1f\n", i, 100.0 * busy, events, rounds,
+			   rounds ? (double)events / (double)rounds : 0.0);
+
+		busy_cores += busy;
+		*prev = util;
+	}
+
+	APPL_PRINT("Busy cores: %.2f of %d\n", busy_cores, core_count);
+
+	em_core_util_print();
+}
+
+/**
+ * @private
+ *
+ * Busy loop for EVENT_WORK_US to simulate event processing.
+ */
+static void
+work(void)
+{
+	const env_time_t start = env_time_global();
+
+	while (env_time_diff_ns(env_time_global(), start) < EVENT_WORK_US * 1000 &&
+	       !appl_shm->exit_flag)
+		;
+}
+
+/**
+ * @private
+ *
+ * EO receive function.
+ *
+ * Simulates EVENT_WORK_US of processing and sends the event back into the
+ * same queue, prints the core utilization every PRINT_EVENTS events.
+ */
+static void
+util_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	     em_queue_t queue, void *q_ctx)
+{
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)type;
+	(void)q_ctx;
+
+	if (unlikely(appl_shm->exit_flag)) {
+		em_free(event);
+		return;
+	}
+
+	work();
+
+	/* Atomic queue: one core at a time updates the count */
+	if (++util_shm->count % PRINT_EVENTS == 0)
+		print_util();
+
+	status = em_send(event, queue);
+	if (unlikely(status != EM_OK)) {
+		em_free(event);
+		test_fatal_if(!appl_shm->exit_flag,
+			      "em_send():%" PRI_STAT " Queue:%" PRI_QUEUE "",
+			      status, queue);
+	}
+}
@@ -0,0 +1,590 @@
+/*
+ *   Copyright (c) 2023, Nokia Solutions and Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ *
+ * Event Machine coroutine EO example.
+ *
+ * The receive function of the coroutine EO, enabled with em_eo_coro_enable(),
+ * runs NUM_JOBS jobs. Each job sends a request to a server EO and waits for
+ * the reply in its own unscheduled reply queue with em_yield_until(), then
+ * sleeps SLEEP_US with em_yield_until(EM_QUEUE_UNDEF, ...) and starts over.
+ * The EM-core is not blocked while a job waits: the dispatcher continues with
+ * the other jobs and the server EO and resumes the parked coroutines on the
+ * same core.
+ *
+ * Every PRINT_ROUNDS rounds of job 0 the number of finished job rounds and
+ * the max time the sleeping jobs overslept are printed.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <event_machine.h>
+#include <event_machine/platform/env/environment.h>
+
+#include "cm_setup.h"
+#include "cm_error_handler.h"
+
+/* Number of jobs run concurrently by the coroutine EO */
+#define NUM_JOBS  4
+/* Max time to wait for a reply from the server EO */
+#define REPLY_TMO_NS  (100 * 1000 * 1000ULL)
+/* Sleep time of a job per round */
+#define SLEEP_US  100
+/* Print every PRINT_ROUNDS rounds of job 0 */
+#define PRINT_ROUNDS  5000
+
+/**
+ * Job event, circulates through the atomic job queue
+ */
+typedef struct {
+	int job;
+	uint64_t seq;
+} job_event_t;
+
+/**
+ * Request to the server EO, sent back as the reply
+ */
+typedef struct {
+	int job;
+	uint64_t seq;
+} request_event_t;
+
+/**
+ * Per job statistics, only updated by the coroutine running the job
+ */
+typedef struct {
+	uint64_t rounds;
+	uint64_t max_oversleep_ns;
+	/* Pad to cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} job_stat_t;
+
+/**
+ * Coroutine example shared memory
+ */
+typedef struct {
+	/* Event pool used by this application */
+	em_pool_t pool;
+	/* The coroutine EO and its atomic job queue */
+	em_eo_t coro_eo;
+	em_queue_t job_queue;
+	/* The server EO and its parallel request queue */
+	em_eo_t server_eo;
+	em_queue_t server_queue;
+	/* Unscheduled reply queue of each job */
+	em_queue_t reply_queue[NUM_JOBS];
+	/* Statistics of each job */
+	job_stat_t stat[NUM_JOBS] ENV_CACHE_LINE_ALIGNED;
+	/* Pad to cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} coro_shm_t;
+
+COMPILE_TIME_ASSERT((sizeof(coro_shm_t) % ENV_CACHE_LINE_SIZE) == 0,
+		    CORO_SHM_T__SIZE_ERROR);
+
+/* EM-core local pointer to shared memory */
+static ENV_LOCAL coro_shm_t *coro_shm;
+
+/*
+ * Local function prototypes
+ */
+static em_status_t
+coro_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf);
+
+static em_status_t
+coro_stop(void *eo_ctx, em_eo_t eo);
+
+static void
+coro_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	     em_queue_t queue, void *q_ctx);
+
+static em_status_t
+server_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf);
+
+static em_status_t
+server_stop(void *eo_ctx, em_eo_t eo);
+
+static void
+server_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	       em_queue_t queue, void *q_ctx);
+
+/**
+ * Main function
+ *
+ * Call cm_setup() to perform test & EM setup common for all the
+ * test applications.
+ *
+ * cm_setup() will call test_init() and test_start() and launch
+ * the EM dispatch loop on every EM-core.
+ */
+int main(int argc, char *argv[])
+{
+	return cm_setup(argc, argv);
+}
+
+/**
+ * Init of the coroutine example.
+ *
+ * @attention Run on all cores.
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_init(void)
+{
+	int core = em_core_id();
+
+	if (core == 0) {
+		coro_shm = env_shared_reserve("CoroSharedMem",
+					      sizeof(coro_shm_t));
+		em_register_error_handler(test_error_handler);
+	} else {
+		coro_shm = env_shared_lookup("CoroSharedMem");
+	}
+
+	if (coro_shm == NULL) {
+		test_error(EM_ERROR_SET_FATAL(0xec0de), 0xdead,
+			   "Coroutine init failed on EM-core: %u",
+			   em_core_id());
+	} else if (core == 0) {
+		memset(coro_shm, 0, sizeof(coro_shm_t));
+	}
+}
+
+/**
+ * Startup of the coroutine example.
+ *
+ * @attention Run only on EM core 0.
+ *
+ * @param appl_conf Application configuration
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_start(appl_conf_t *const appl_conf)
+{
+	em_eo_t eo;
+	em_status_t ret, start_ret = EM_ERROR;
+
+	if (appl_conf->num_pools >= 1)
+		coro_shm->pool = appl_conf->pools[0];
+	else
+		coro_shm->pool = EM_POOL_DEFAULT;
+
+	APPL_PRINT("\n"
+		   "***********************************************************\n"
+		   "EM APPLICATION: '%s' initializing:\n"
+		   "  %s: %s() - EM-core:%i\n"
+		   "  Application running on %d EM-cores (procs:%d, threads:%d)\n"
+		   "  using event pool:%" PRI_POOL "\n"
+		   "***********************************************************\n"
+		   "\n",
+		   appl_conf->name, NO_PATH(__FILE__), __func__, em_core_id(),
+		   em_core_count(),
+		   appl_conf->num_procs, appl_conf->num_threads,
+		   coro_shm->pool);
+
+	test_fatal_if(coro_shm->pool == EM_POOL_UNDEF,
+		      "Undefined application event pool!");
+
+	for (int i = 0; i < NUM_JOBS; i++) {
+		char name[EM_QUEUE_NAME_LEN];
+
+		snprintf(name, sizeof(name), "coro-reply-%d", i);
+		coro_shm->reply_queue[i] =
+			em_queue_create(name, EM_QUEUE_TYPE_UNSCHEDULED,
+					EM_QUEUE_PRIO_UNDEF,
+					EM_QUEUE_GROUP_UNDEF, NULL);
+		test_fatal_if(coro_shm->reply_queue[i] == EM_QUEUE_UNDEF,
+			      "Reply queue creation failed!");
+	}
+
+	eo = em_eo_create("coro-server-eo", server_start, NULL,
+			  server_stop, NULL, server_receive, NULL);
+	test_fatal_if(eo == EM_EO_UNDEF, "Server EO creation failed!");
+	coro_shm->server_eo = eo;
+
+	ret = em_eo_start_sync(eo, &start_ret, NULL);
+	test_fatal_if(ret != EM_OK || start_ret != EM_OK,
+		      "Server EO start:%" PRI_STAT " %" PRI_STAT "",
+		      ret, start_ret);
+
+	eo = em_eo_create("coro-eo", coro_start, NULL,
+			  coro_stop, NULL, coro_receive, NULL);
+	test_fatal_if(eo == EM_EO_UNDEF, "Coroutine EO creation failed!");
+	coro_shm->coro_eo = eo;
+
+	/* Before the EO is started and has queues */
+	ret = em_eo_coro_enable(eo);
+	test_fatal_if(ret != EM_OK, "em_eo_coro_enable():%" PRI_STAT "", ret);
+
+	ret = em_eo_start_sync(eo, &start_ret, NULL);
+	test_fatal_if(ret != EM_OK || start_ret != EM_OK,
+		      "Coroutine EO start:%" PRI_STAT " %" PRI_STAT "",
+		      ret, start_ret);
+}
+
+void
+test_stop(appl_conf_t *const appl_conf)
+{
+	const int core = em_core_id();
+	em_status_t stat;
+
+	(void)appl_conf;
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	stat = em_eo_stop_sync(coro_shm->coro_eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("Coroutine EO stop failed!");
+
+	stat = em_eo_stop_sync(coro_shm->server_eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("Server EO stop failed!");
+}
+
+void
+test_term(void)
+{
+	int core = em_core_id();
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	if (core == 0) {
+		for (int i = 0; i < NUM_JOBS; i++) {
+			em_queue_t queue = coro_shm->reply_queue[i];
+			em_event_t event;
+
+			/* Replies that arrived after the job gave up */
+			while ((event = em_queue_dequeue(queue)) != EM_EVENT_UNDEF)
+				em_free(event);
+
+			if (em_queue_delete(queue) != EM_OK)
+				APPL_EXIT_FAILURE("Reply queue delete failed!");
+		}
+
+		env_shared_free(coro_shm);
+		em_unregister_error_handler();
+	}
+}
+
+/**
+ * @private
+ *
+ * Coroutine EO start function.
+ *
+ * Creates the atomic job queue and sends the NUM_JOBS job events into it.
+ */
+static em_status_t
+coro_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf)
+{
+	em_queue_t queue;
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)conf;
+
+	queue = em_queue_create("coro-jobs", EM_QUEUE_TYPE_ATOMIC,
+				EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_DEFAULT,
+				NULL);
+	test_fatal_if(queue == EM_QUEUE_UNDEF, "Queue creation failed!");
+	coro_shm->job_queue = queue;
+
+	status = em_eo_add_queue_sync(eo, queue);
+	test_fatal_if(status != EM_OK, "EO add queue:%" PRI_STAT "\n"
+		      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "", status, eo, queue);
+
+	for (int i = 0; i < NUM_JOBS; i++) {
+		em_event_t event = em_alloc(sizeof(job_event_t),
+					    EM_EVENT_TYPE_SW, coro_shm->pool);
+		job_event_t *job_ev;
+
+		test_fatal_if(event == EM_EVENT_UNDEF,
+			      "Event allocation failed!");
+		job_ev = em_event_pointer(event);
+		job_ev->job = i;
+		job_ev->seq = 0;
+
+		status = em_send(event, queue);
+		test_fatal_if(status != EM_OK, "em_send():%" PRI_STAT "\n"
+			      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "",
+			      status, eo, queue);
+	}
+
+	APPL_PRINT("Coroutine example started, %d jobs, sleep %dus\n",
+		   NUM_JOBS, SLEEP_US);
+
+	return EM_OK;
+}
+
+/**
+ * @private
+ *
+ * Coroutine EO stop function.
+ */
+static em_status_t
+coro_stop(void *eo_ctx, em_eo_t eo)
+{
+	em_status_t stat;
+
+	(void)eo_ctx;
+
+	APPL_PRINT("Coroutine example stop on EM-core %d\n", em_core_id());
+
+	stat = em_eo_remove_queue_sync(eo, coro_shm->job_queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO remove queue failed!");
+
+	stat = em_queue_delete(coro_shm->job_queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("Queue delete failed!");
+
+	stat = em_eo_delete(eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO delete failed!");
+
+	return stat;
+}
+
+/**
+ * @private
+ *
+ * Send a request to the server EO and park until the reply has arrived.
+ *
+ * @return true if the reply was received
+ */
+static bool
+job_request(const job_event_t *job_ev)
+{
+	em_event_t event = em_alloc(sizeof(request_event_t), EM_EVENT_TYPE_SW,
+				    coro_shm->pool);
+	request_event_t *req;
+	em_status_t status;
+
+	test_fatal_if(event == EM_EVENT_UNDEF, "Event allocation failed!");
+	req = em_event_pointer(event);
+	req->job = job_ev->job;
+	req->seq = job_ev->seq;
+
+	status = em_send(event, coro_shm->server_queue);
+	if (unlikely(status != EM_OK)) {
+		em_free(event);
+		test_fatal_if(!appl_shm->exit_flag,
+			      "em_send():%" PRI_STAT "", status);
+		return false;
+	}
+
+	/* Park until the reply arrives, the core continues with other work */
+	event = em_yield_until(coro_shm->reply_queue[job_ev->job],
+			       REPLY_TMO_NS);
+	if (event == EM_EVENT_UNDEF) {
+		test_fatal_if(!appl_shm->exit_flag,
+			      "Job %d: no reply in %" PRIu64 "ns",
+			      job_ev->job, REPLY_TMO_NS);
+		return false;
+	}
+
+	req = em_event_pointer(event);
+	test_fatal_if(req->job != job_ev->job || req->seq != job_ev->seq,
+		      "Job %d seq:%" PRIu64 ": bad reply job:%d seq:%" PRIu64 "",
+		      job_ev->job, job_ev->seq, req->job, req->seq);
+	em_free(event);
+
+	return true;
+}
+
+/**
+ * @private
+ *
+ * Park the coroutine for SLEEP_US, record how much longer it took.
+ */
+static void
+job_sleep(job_stat_t *stat)
+{
+	const env_time_t start = env_time_global();
+	em_event_t event = em_yield_until(EM_QUEUE_UNDEF, SLEEP_US * 1000);
+	const uint64_t slept_ns = env_time_diff_ns(env_time_global(), start);
+
+	test_fatal_if(event != EM_EVENT_UNDEF, "Unexpected event");
+
+	if (slept_ns > SLEEP_US * 1000 &&
+	    slept_ns - SLEEP_US * 1000 > stat->max_oversleep_ns)
+		stat->max_oversleep_ns = slept_ns - SLEEP_US * 1000;
+}
+
+/**
+ * @private
+ *
+ * Coroutine EO receive function, runs one round of a job.
+ *
+ * Parks twice: waiting for the server reply and sleeping. The scheduling
+ * context of the job queue is released when parking, the resumed coroutine
+ * runs without it.
+ */
+static void
+coro_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	     em_queue_t queue, void *q_ctx)
+{
+	job_event_t *const job_ev = em_event_pointer(event);
+	job_stat_t *const stat = &coro_shm->stat[job_ev->job];
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)type;
+	(void)q_ctx;
+
+	if (unlikely(appl_shm->exit_flag) || !job_request(job_ev)) {
+		em_free(event);
+		return;
+	}
+
+	job_sleep(stat);
+
+	if (unlikely(appl_shm->exit_flag)) {
+		em_free(event);
+		return;
+	}
+
+	job_ev->seq++;
+	stat->rounds++;
+
+	if (job_ev->job == 0 && stat->rounds % PRINT_ROUNDS == 0) {
+		uint64_t rounds = 0;
+		uint64_t max_oversleep_ns = 0;
+
+		for (int i = 0; i < NUM_JOBS; i++) {
+			rounds += coro_shm->stat[i].rounds;
+			if (coro_shm->stat[i].max_oversleep_ns > max_oversleep_ns)
+				max_oversleep_ns = coro_shm->stat[i].max_oversleep_ns;
+		}
+		APPL_PRINT("Job rounds:%" PRIu64 " sleep overshoot max:%" PRIu64 "us (EM-core:%d)\n",
+			   rounds, max_oversleep_ns / 1000, em_core_id());
+	}
+
+	status = em_send(event, queue);
+	if (unlikely(status != EM_OK)) {
+		em_free(event);
+		test_fatal_if(!appl_shm->exit_flag,
+			      "em_send():%" PRI_STAT " Queue:%" PRI_QUEUE "",
+			      status, queue);
+	}
+}
+
+/**
+ * @private
+ *
+ * Server EO start function.
+ *
+ * Creates the parallel request queue.
+ */
+static em_status_t
+server_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf)
+{
+	em_queue_t queue;
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)conf;
+
+	queue = em_queue_create("coro-server", EM_QUEUE_TYPE_PARALLEL,
+				EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_DEFAULT,
+				NULL);
+	test_fatal_if(queue == EM_QUEUE_UNDEF, "Queue creation failed!");
+	coro_shm->server_queue = queue;
+
+	status = em_eo_add_queue_sync(eo, queue);
+	test_fatal_if(status != EM_OK, "EO add queue:%" PRI_STAT "\n"
+		      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "", status, eo, queue);
+
+	return EM_OK;
+}
+
+/**
+ * @private
+ *
+ * Server EO stop function.
+ */
+static em_status_t
+server_stop(void *eo_ctx, em_eo_t eo)
+{
+	em_status_t stat;
+
+	(void)eo_ctx;
+
+	stat = em_eo_remove_queue_sync(eo, coro_shm->server_queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO remove queue failed!");
+
+	stat = em_queue_delete(coro_shm->server_queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("Queue delete failed!");
+
+	stat = em_eo_delete(eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO delete failed!");
+
+	return stat;
+}
+
+/**
+ * @private
+ *
+ * Server EO receive function, sends the request back as the reply.
+ */
+static void
+server_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	       em_queue_t queue, void *q_ctx)
+{
+	const request_event_t *const req = em_event_pointer(event);
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)type;
+	(void)queue;
+	(void)q_ctx;
+
+	if (unlikely(appl_shm->exit_flag)) {
+		em_free(event);
+		return;
+	}
+
+	status = em_send(event, coro_shm->reply_queue[req->job]);
+	if (unlikely(status != EM_OK)) {
+		em_free(event);
+		test_fatal_if(!appl_shm->exit_flag,
+			      "em_send():%" PRI_STAT "", status);
+	}
+}
@@ -0,0 +1,321 @@
+/*
+ *   Copyright (c) 2023, Nokia Solutions and Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Event Machine deferred call example.
+ *
+ * EM-core 0 defers NUM_CALLS calls for each of the priorities
+ * EM_QUEUE_PRIO_LOW, EM_QUEUE_PRIO_NORMAL and EM_QUEUE_PRIO_HIGH, interleaved,
+ * plus one lowest priority call that defers itself again CHAIN_LEN times.
+ * It then dispatches one round at a time with em_dispatch_rounds():
+ * the first round must run the calls highest priority first, in the order
+ * they were deferred, and each round must advance the self-deferring chain
+ * by exactly one call - a call deferred by a deferred function runs in the
+ * next round.
+ *
+ * No events are used, the deferred calls run on EM-core 0 only.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <event_machine.h>
+#include <event_machine/platform/env/environment.h>
+
+#include "cm_setup.h"
+#include "cm_error_handler.h"
+
+/* Number of deferred calls per priority per cycle */
+#define NUM_CALLS  16
+/* Number of calls in the self-deferring chain per cycle */
+#define CHAIN_LEN  10
+/* Number of cycles */
+#define NUM_CYCLES  3
+/* Number of deferred calls recorded per cycle */
+#define NUM_LOG  (3 * NUM_CALLS)
+
+/* Deferred call argument: priority and sequence number */
+#define CALL_ARG(prio, seq)  ((void *)(uintptr_t)(((prio) << 16) | (seq)))
+#define CALL_PRIO(arg)  ((int)((uintptr_t)(arg) >> 16))
+#define CALL_SEQ(arg)  ((int)((uintptr_t)(arg) & 0xffff))
+
+/**
+ * Deferred call example shared memory
+ */
+typedef struct {
+	/* Deferred calls run in this cycle, in call order */
+	void *log[NUM_LOG];
+	int num_log;
+	/* Calls run in the self-deferring chain in this cycle */
+	int chain;
+	/* Pad to cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} defer_shm_t;
+
+COMPILE_TIME_ASSERT((sizeof(defer_shm_t) % ENV_CACHE_LINE_SIZE) == 0,
+		    DEFER_SHM_T__SIZE_ERROR);
+COMPILE_TIME_ASSERT(NUM_CALLS <= EM_DEFER_RING_SIZE,
+		    DEFER_NUM_CALLS__SIZE_ERROR);
+
+/* EM-core local pointer to shared memory */
+static ENV_LOCAL defer_shm_t *defer_shm;
+
+/*
+ * Local function prototypes
+ */
+static void
+deferred_call(void *arg);
+
+static void
+deferred_chain(void *arg);
+
+static void
+run_cycle(int cycle);
+
+/**
+ * Main function
+ *
+ * Call cm_setup() to perform test & EM setup common for all the
+ * test applications.
+ *
+ * cm_setup() will call test_init() and test_start() and launch
+ * the EM dispatch loop on every EM-core.
+ */
+int main(int argc, char *argv[])
+{
+	return cm_setup(argc, argv);
+}
+
+/**
+ * Init of the deferred call example.
+ *
+ * @attention Run on all cores.
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_init(void)
+{
+	int core = em_core_id();
+
+	if (core == 0) {
+		defer_shm = env_shared_reserve("DispatchDeferSharedMem",
+					       sizeof(defer_shm_t));
+		em_register_error_handler(test_error_handler);
+	} else {
+		defer_shm = env_shared_lookup("DispatchDeferSharedMem");
+	}
+
+	if (defer_shm == NULL) {
+		test_error(EM_ERROR_SET_FATAL(0xec0de), 0xdead,
+			   "Dispatch defer init failed on EM-core: %u",
+			   em_core_id());
+	} else if (core == 0) {
+		memset(defer_shm, 0, sizeof(defer_shm_t));
+	}
+}
+
+/**
+ * Startup of the deferred call example.
+ *
+ * @attention Run only on EM core 0.
+ *
+ * @param appl_conf Application configuration
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_start(appl_conf_t *const appl_conf)
+{
+	APPL_PRINT("\n"
+		   "***********************************************************\n"
+		   "EM APPLICATION: '%s' initializing:\n"
+		   "  %s: %s() - EM-core:%i\n"
+		   "  Application running on %d EM-cores (procs:%d, threads:%d)\n"
+		   "***********************************************************\n"
+		   "\n",
+		   appl_conf->name, NO_PATH(__FILE__), __func__, em_core_id(),
+		   em_core_count(),
+		   appl_conf->num_procs, appl_conf->num_threads);
+
+	/* Dispatch on this core only, before entering the main dispatch loop */
+	for (int i = 0; i < NUM_CYCLES; i++)
+		run_cycle(i);
+}
+
+void
+test_stop(appl_conf_t *const appl_conf)
+{
+	(void)appl_conf;
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, em_core_id());
+}
+
+void
+test_term(void)
+{
+	int core = em_core_id();
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	if (core == 0) {
+		env_shared_free(defer_shm);
+		em_unregister_error_handler();
+	}
+}
+
+/**
+ * @private
+ *
+ * Deferred call, records its argument.
+ */
+static void
+deferred_call(void *arg)
+{
+	test_fatal_if(defer_shm->num_log >= NUM_LOG,
+		      "Too many deferred calls:%d", defer_shm->num_log);
+
+	defer_shm->log[defer_shm->num_log++] = arg;
+}
+
+/**
+ * @private
+ *
+ * Self-deferring call, defers itself again until CHAIN_LEN calls have run.
+ */
+static void
+deferred_chain(void *arg)
+{
+	em_status_t status;
+
+	(void)arg;
+
+	if (++defer_shm->chain >= CHAIN_LEN)
+		return;
+
+	status = em_defer_prio(deferred_chain, NULL, EM_QUEUE_PRIO_LOWEST);
+	test_fatal_if(status != EM_OK, "em_defer_prio():%" PRI_STAT "", status);
+}
+
+/**
+ * @private
+ *
+ * Check that the first round ran the deferred calls highest priority first,
+ * in the order they were deferred.
+ */
+static void
+check_log(void)
+{
+	static const int prio_order[] = {EM_QUEUE_PRIO_HIGH,
+					 EM_QUEUE_PRIO_NORMAL,
+					 EM_QUEUE_PRIO_LOW};
+
+	test_fatal_if(defer_shm->num_log != NUM_LOG,
+		      "Deferred calls run:%d, expected:%d",
+		      defer_shm->num_log, NUM_LOG);
+
+	for (int i = 0; i < NUM_LOG; i++) {
+		const void *arg = defer_shm->log[i];
+		const int prio = prio_order[i / NUM_CALLS];
+		const int seq = i % NUM_CALLS;
+
+		test_fatal_if(CALL_PRIO(arg) != prio || CALL_SEQ(arg) != seq,
+			      "Call %d: prio:%d seq:%d, expected prio:%d seq:%d",
+			      i, CALL_PRIO(arg), CALL_SEQ(arg), prio, seq);
+	}
+}
+
+/**
+ * @private
+ *
+ * Defer the calls and dispatch one round at a time until the self-deferring
+ * chain has ended.
+ */
+static void
+run_cycle(int cycle)
+{
+	em_dispatch_opt_t opt;
+	em_dispatch_results_t results;
+	em_status_t status;
+	int rounds = 0;
+
+	defer_shm->num_log = 0;
+	defer_shm->chain = 0;
+
+	for (int i = 0; i < NUM_CALLS; i++) {
+		status = em_defer_prio(deferred_call,
+				       CALL_ARG(EM_QUEUE_PRIO_LOW, i),
+				       EM_QUEUE_PRIO_LOW);
+		test_fatal_if(status != EM_OK, "em_defer_prio():%" PRI_STAT "", status);
+		status = em_defer(deferred_call, CALL_ARG(EM_QUEUE_PRIO_NORMAL, i));
+		test_fatal_if(status != EM_OK, "em_defer():%" PRI_STAT "", status);
+		status = em_defer_prio(deferred_call,
+				       CALL_ARG(EM_QUEUE_PRIO_HIGH, i),
+				       EM_QUEUE_PRIO_HIGH);
+		test_fatal_if(status != EM_OK, "em_defer_prio():%" PRI_STAT "", status);
+	}
+	status = em_defer_prio(deferred_chain, NULL, EM_QUEUE_PRIO_LOWEST);
+	test_fatal_if(status != EM_OK, "em_defer_prio():%" PRI_STAT "", status);
+
+	em_dispatch_opt_init(&opt);
+
+	/* First round: all calls deferred above, the chain only once */
+	status = em_dispatch_rounds(1, &opt, &results);
+	test_fatal_if(status != EM_OK, "em_dispatch_rounds():%" PRI_STAT "",
+		      status);
+	rounds++;
+	check_log();
+	test_fatal_if(defer_shm->chain != 1, "Round 1: chain:%d, expected:1",
+		      defer_shm->chain);
+
+	APPL_PRINT("Cycle %d: round 1 ran %d deferred calls in priority order,"
+		   " events:%" PRIu64 " prio_events high:%" PRIu64 " lowest:%" PRIu64 "\n",
+		   cycle, defer_shm->num_log, results.events,
+		   results.prio_events[EM_QUEUE_PRIO_HIGH],
+		   results.prio_events[EM_QUEUE_PRIO_LOWEST]);
+
+	/* Then one chain call per round */
+	while (defer_shm->chain < CHAIN_LEN) {
+		status = em_dispatch_rounds(1, &opt, NULL);
+		test_fatal_if(status != EM_OK, "em_dispatch_rounds():%" PRI_STAT "",
+			      status);
+		rounds++;
+		test_fatal_if(defer_shm->chain != rounds,
+			      "Round %d: chain:%d, expected:%d",
+			      rounds, defer_shm->chain, rounds);
+	}
+
+	APPL_PRINT("Cycle %d done: chain:%d rounds:%d\n",
+		   cycle, defer_shm->chain, rounds);
+}
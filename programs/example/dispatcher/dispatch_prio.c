@@ -0,0 +1,445 @@
+/*
+ *   Copyright (c) 2023, Nokia Solutions and Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ *
+ * Event Machine dispatch stop priority example.
+ *
+ * EM-core 0 emulates a polled input: it sends NUM_INPUT events into a local
+ * queue and then runs em_dispatch_duration() with
+ * em_dispatch_opt_t::stop_prio = EM_QUEUE_PRIO_HIGH. The local queue receive
+ * function classifies the input into a highest and a lowest priority queue.
+ * Dispatch must continue after the first round, which only dispatched the
+ * local queue events, serve the high priority events and end in the round
+ * that got low priority events. The rest of the low priority events are
+ * dispatched afterwards.
+ *
+ * The scheduled queues belong to a queue group of EM-core 0 only, the other
+ * EM-cores do not take events from them.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <event_machine.h>
+#include <event_machine/platform/env/environment.h>
+
+#include "cm_setup.h"
+#include "cm_error_handler.h"
+
+/* Number of input events per cycle, every other one is high priority */
+#define NUM_INPUT  64
+/* Number of input cycles */
+#define NUM_CYCLES  3
+/* Priority of the local input queue and the stop priority */
+#define INPUT_PRIO  EM_QUEUE_PRIO_HIGH
+
+/**
+ * Input event
+ */
+typedef struct {
+	int seq;
+} input_event_t;
+
+/**
+ * Dispatch priority example shared memory
+ */
+typedef struct {
+	/* Event pool used by this application */
+	em_pool_t pool;
+	/* Queue group of EM-core 0 */
+	em_queue_group_t qgrp;
+	/* The EO and its queues */
+	em_eo_t eo;
+	em_queue_t input_queue;
+	em_queue_t high_queue;
+	em_queue_t low_queue;
+	/* Received events per queue, only updated on EM-core 0 */
+	int input;
+	int high;
+	int low;
+	/* Pad to cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} dprio_shm_t;
+
+COMPILE_TIME_ASSERT((sizeof(dprio_shm_t) % ENV_CACHE_LINE_SIZE) == 0,
+		    DPRIO_SHM_T__SIZE_ERROR);
+
+/* EM-core local pointer to shared memory */
+static ENV_LOCAL dprio_shm_t *dprio_shm;
+
+/*
+ * Local function prototypes
+ */
+static em_status_t
+dprio_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf);
+
+static em_status_t
+dprio_stop(void *eo_ctx, em_eo_t eo);
+
+static void
+dprio_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	      em_queue_t queue, void *q_ctx);
+
+static void
+run_cycle(int cycle);
+
+/**
+ * Main function
+ *
+ * Call cm_setup() to perform test & EM setup common for all the
+ * test applications.
+ *
+ * cm_setup() will call test_init() and test_start() and launch
+ * the EM dispatch loop on every EM-core.
+ */
+int main(int argc, char *argv[])
+{
+	return cm_setup(argc, argv);
+}
+
+/**
+ * Init of the dispatch priority example.
+ *
+ * @attention Run on all cores.
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_init(void)
+{
+	int core = em_core_id();
+
+	if (core == 0) {
+		dprio_shm = env_shared_reserve("DispatchPrioSharedMem",
+					       sizeof(dprio_shm_t));
+		em_register_error_handler(test_error_handler);
+	} else {
+		dprio_shm = env_shared_lookup("DispatchPrioSharedMem");
+	}
+
+	if (dprio_shm == NULL) {
+		test_error(EM_ERROR_SET_FATAL(0xec0de), 0xdead,
+			   "Dispatch prio init failed on EM-core: %u",
+			   em_core_id());
+	} else if (core == 0) {
+		memset(dprio_shm, 0, sizeof(dprio_shm_t));
+	}
+}
+
+/**
+ * Startup of the dispatch priority example.
+ *
+ * @attention Run only on EM core 0.
+ *
+ * @param appl_conf Application configuration
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_start(appl_conf_t *const appl_conf)
+{
+	em_core_mask_t core_mask;
+	em_eo_t eo;
+	em_status_t ret, start_ret = EM_ERROR;
+
+	if (appl_conf->num_pools >= 1)
+		dprio_shm->pool = appl_conf->pools[0];
+	else
+		dprio_shm->pool = EM_POOL_DEFAULT;
+
+	APPL_PRINT("\n"
+		   "***********************************************************\n"
+		   "EM APPLICATION: '%s' initializing:\n"
+		   "  %s: %s() - EM-core:%i\n"
+		   "  Application running on %d EM-cores (procs:%d, threads:%d)\n"
+		   "  using event pool:%" PRI_POOL "\n"
+		   "***********************************************************\n"
+		   "\n",
+		   appl_conf->name, NO_PATH(__FILE__), __func__, em_core_id(),
+		   em_core_count(),
+		   appl_conf->num_procs, appl_conf->num_threads,
+		   dprio_shm->pool);
+
+	test_fatal_if(dprio_shm->pool == EM_POOL_UNDEF,
+		      "Undefined application event pool!");
+
+	em_core_mask_zero(&core_mask);
+	em_core_mask_set(0, &core_mask);
+	dprio_shm->qgrp = em_queue_group_create_sync("dprio-core0", &core_mask);
+	test_fatal_if(dprio_shm->qgrp == EM_QUEUE_GROUP_UNDEF,
+		      "Queue group creation failed!");
+
+	eo = em_eo_create("dispatch-prio-eo", dprio_start, NULL,
+			  dprio_stop, NULL, dprio_receive, NULL);
+	test_fatal_if(eo == EM_EO_UNDEF, "EO creation failed!");
+	dprio_shm->eo = eo;
+
+	ret = em_eo_start_sync(eo, &start_ret, NULL);
+	test_fatal_if(ret != EM_OK || start_ret != EM_OK,
+		      "EO start:%" PRI_STAT " %" PRI_STAT "",
+		      ret, start_ret);
+
+	/* Dispatch on this core only, before entering the main dispatch loop */
+	for (int i = 0; i < NUM_CYCLES; i++)
+		run_cycle(i);
+}
+
+void
+test_stop(appl_conf_t *const appl_conf)
+{
+	const int core = em_core_id();
+	em_status_t stat;
+
+	(void)appl_conf;
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	stat = em_eo_stop_sync(dprio_shm->eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO stop failed!");
+
+	stat = em_queue_group_delete_sync(dprio_shm->qgrp);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("Queue group delete failed!");
+}
+
+void
+test_term(void)
+{
+	int core = em_core_id();
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	if (core == 0) {
+		env_shared_free(dprio_shm);
+		em_unregister_error_handler();
+	}
+}
+
+/**
+ * @private
+ *
+ * EO start function.
+ *
+ * Creates the local input queue and the highest and lowest priority queues.
+ */
+static em_status_t
+dprio_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf)
+{
+	em_queue_t queue;
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)conf;
+
+	queue = em_queue_create("dprio-input", EM_QUEUE_TYPE_LOCAL,
+				INPUT_PRIO, EM_QUEUE_GROUP_UNDEF, NULL);
+	test_fatal_if(queue == EM_QUEUE_UNDEF, "Queue creation failed!");
+	dprio_shm->input_queue = queue;
+
+	queue = em_queue_create("dprio-high", EM_QUEUE_TYPE_ATOMIC,
+				EM_QUEUE_PRIO_HIGHEST, dprio_shm->qgrp, NULL);
+	test_fatal_if(queue == EM_QUEUE_UNDEF, "Queue creation failed!");
+	dprio_shm->high_queue = queue;
+
+	queue = em_queue_create("dprio-low", EM_QUEUE_TYPE_ATOMIC,
+				EM_QUEUE_PRIO_LOWEST, dprio_shm->qgrp, NULL);
+	test_fatal_if(queue == EM_QUEUE_UNDEF, "Queue creation failed!");
+	dprio_shm->low_queue = queue;
+
+	status = em_eo_add_queue_sync(eo, dprio_shm->input_queue);
+	test_fatal_if(status != EM_OK, "EO add queue:%" PRI_STAT "", status);
+	status = em_eo_add_queue_sync(eo, dprio_shm->high_queue);
+	test_fatal_if(status != EM_OK, "EO add queue:%" PRI_STAT "", status);
+	status = em_eo_add_queue_sync(eo, dprio_shm->low_queue);
+	test_fatal_if(status != EM_OK, "EO add queue:%" PRI_STAT "", status);
+
+	return EM_OK;
+}
+
+/**
+ * @private
+ *
+ * EO stop function.
+ */
+static em_status_t
+dprio_stop(void *eo_ctx, em_eo_t eo)
+{
+	em_status_t stat;
+
+	(void)eo_ctx;
+
+	APPL_PRINT("Dispatch prio example stop on EM-core %d\n", em_core_id());
+
+	stat = em_eo_remove_queue_all_sync(eo, EM_TRUE);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO remove queues failed!");
+
+	stat = em_eo_delete(eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO delete failed!");
+
+	return stat;
+}
+
+/**
+ * @private
+ *
+ * Send NUM_INPUT events to the local input queue and dispatch with
+ * 'stop_prio' until only low priority events remain.
+ */
+static void
+run_cycle(int cycle)
+{
+	em_dispatch_duration_t duration;
+	em_dispatch_opt_t opt;
+	em_dispatch_results_t results;
+	em_status_t status;
+	int stop_low;
+
+	dprio_shm->input = 0;
+	dprio_shm->high = 0;
+	dprio_shm->low = 0;
+
+	/* Emulated polled input, outside of any dispatch round */
+	for (int i = 0; i < NUM_INPUT; i++) {
+		em_event_t event = em_alloc(sizeof(input_event_t),
+					    EM_EVENT_TYPE_SW, dprio_shm->pool);
+		input_event_t *input;
+
+		test_fatal_if(event == EM_EVENT_UNDEF,
+			      "Event allocation failed!");
+		input = em_event_pointer(event);
+		input->seq = i;
+
+		status = em_send(event, dprio_shm->input_queue);
+		test_fatal_if(status != EM_OK, "em_send():%" PRI_STAT "", status);
+	}
+
+	em_dispatch_opt_init(&opt);
+	opt.stop_prio = INPUT_PRIO;
+
+	/* Bound the dispatch in case it would not stop */
+	memset(&duration, 0, sizeof(duration));
+	duration.select = EM_DISPATCH_DURATION_ROUNDS;
+	duration.rounds = 100 * NUM_INPUT;
+
+	status = em_dispatch_duration(&duration, &opt, &results);
+	test_fatal_if(status != EM_OK, "em_dispatch_duration():%" PRI_STAT "",
+		      status);
+	stop_low = dprio_shm->low;
+
+	APPL_PRINT("Cycle %d: stop_prio dispatch rounds:%" PRIu64 " events:%" PRIu64 ""
+		   " - input:%d high:%d low:%d, prio_events input:%" PRIu64 " high:%" PRIu64 "\n",
+		   cycle, results.rounds, results.events,
+		   dprio_shm->input, dprio_shm->high, stop_low,
+		   results.prio_events[INPUT_PRIO],
+		   results.prio_events[EM_QUEUE_PRIO_HIGHEST]);
+
+	/*
+	 * The first round only dispatched the local input queue, dispatch must
+	 * have continued to the high priority events.
+	 */
+	test_fatal_if(dprio_shm->input != NUM_INPUT || dprio_shm->high == 0,
+		      "Dispatch stopped early: input:%d high:%d",
+		      dprio_shm->input, dprio_shm->high);
+	test_fatal_if(results.events < (uint64_t)(dprio_shm->input +
+						  dprio_shm->high + stop_low) ||
+		      results.prio_events[INPUT_PRIO] != NUM_INPUT,
+		      "Local queue events not counted: events:%" PRIu64 "",
+		      results.events);
+
+	/* Dispatch the rest of the low priority events */
+	memset(&duration, 0, sizeof(duration));
+	duration.select = EM_DISPATCH_DURATION_NO_EVENTS_ROUNDS;
+	duration.no_events.rounds = 100;
+	em_dispatch_opt_init(&opt);
+
+	status = em_dispatch_duration(&duration, &opt, NULL);
+	test_fatal_if(status != EM_OK, "em_dispatch_duration():%" PRI_STAT "",
+		      status);
+
+	APPL_PRINT("Cycle %d done: high:%d low:%d\n",
+		   cycle, dprio_shm->high, dprio_shm->low);
+}
+
+/**
+ * @private
+ *
+ * EO receive function.
+ *
+ * Classifies the input events into the high and low priority queues.
+ */
+static void
+dprio_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	      em_queue_t queue, void *q_ctx)
+{
+	const input_event_t *const input = em_event_pointer(event);
+	em_queue_t dst;
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)type;
+	(void)q_ctx;
+
+	if (queue == dprio_shm->high_queue) {
+		dprio_shm->high++;
+		em_free(event);
+		return;
+	}
+
+	if (queue == dprio_shm->low_queue) {
+		dprio_shm->low++;
+		em_free(event);
+		return;
+	}
+
+	/* Input queue */
+	dprio_shm->input++;
+
+	if (unlikely(appl_shm->exit_flag)) {
+		em_free(event);
+		return;
+	}
+
+	dst = input->seq % 2 ? dprio_shm->low_queue : dprio_shm->high_queue;
+	status = em_send(event, dst);
+	if (unlikely(status != EM_OK)) {
+		em_free(event);
+		test_fatal_if(!appl_shm->exit_flag,
+			      "em_send():%" PRI_STAT " Queue:%" PRI_QUEUE "",
+			      status, dst);
+	}
+}
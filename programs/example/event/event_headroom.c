@@ -0,0 +1,437 @@
+/*
+ *   Copyright (c) 2023, Nokia Solutions and Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ *
+ * Event Machine packet headroom example.
+ *
+ * One EO circulates a packet event through its atomic queue. On every receive
+ * the EO prepends an encapsulation header into the headroom with
+ * em_event_push_head(), strips it again with em_event_pull_head() and checks
+ * that the payload is intact. A second packet is extended beyond its headroom
+ * with em_event_extend_head() and freed.
+ *
+ * The packet pool is created with a pool-specific headroom of POOL_HEADROOM
+ * bytes, see em_pool_cfg_t::pkt.headroom.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <event_machine.h>
+#include <event_machine/platform/env/environment.h>
+
+#include "cm_setup.h"
+#include "cm_error_handler.h"
+
+/* Pool-specific packet headroom */
+#define POOL_HEADROOM  128
+/* Packet payload size */
+#define PAYLOAD_LEN  64
+/* Print every PRINT_ROUNDS rounds */
+#define PRINT_ROUNDS  (256 * 1024)
+
+/**
+ * Encapsulation header pushed into the headroom
+ */
+typedef struct {
+	uint64_t seq;
+	uint32_t magic;
+	uint32_t len;
+} encap_hdr_t;
+
+#define ENCAP_MAGIC  0xcafe0123
+
+/**
+ * Headroom example shared memory
+ */
+typedef struct {
+	/* Packet pool with POOL_HEADROOM bytes of headroom */
+	em_pool_t pkt_pool;
+	/* The EO and its atomic queue */
+	em_eo_t eo;
+	em_queue_t queue;
+	/* Rounds done, only updated in the atomic context of 'queue' */
+	uint64_t rounds;
+	/* Packets extended by prepending segments */
+	uint64_t seg_prepends;
+	/* Pad to cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} headroom_shm_t;
+
+COMPILE_TIME_ASSERT((sizeof(headroom_shm_t) % ENV_CACHE_LINE_SIZE) == 0,
+		    HEADROOM_SHM_T__SIZE_ERROR);
+
+/* EM-core local pointer to shared memory */
+static ENV_LOCAL headroom_shm_t *headroom_shm;
+
+/*
+ * Local function prototypes
+ */
+static em_status_t
+headroom_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf);
+
+static em_status_t
+headroom_stop(void *eo_ctx, em_eo_t eo);
+
+static void
+headroom_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+		 em_queue_t queue, void *q_ctx);
+
+/**
+ * Main function
+ *
+ * Call cm_setup() to perform test & EM setup common for all the
+ * test applications.
+ *
+ * cm_setup() will call test_init() and test_start() and launch
+ * the EM dispatch loop on every EM-core.
+ */
+int main(int argc, char *argv[])
+{
+	return cm_setup(argc, argv);
+}
+
+/**
+ * Init of the headroom example.
+ *
+ * @attention Run on all cores.
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_init(void)
+{
+	int core = em_core_id();
+
+	if (core == 0) {
+		headroom_shm = env_shared_reserve("HeadroomSharedMem",
+						  sizeof(headroom_shm_t));
+		em_register_error_handler(test_error_handler);
+	} else {
+		headroom_shm = env_shared_lookup("HeadroomSharedMem");
+	}
+
+	if (headroom_shm == NULL) {
+		test_error(EM_ERROR_SET_FATAL(0xec0de), 0xdead,
+			   "Headroom init failed on EM-core: %u",
+			   em_core_id());
+	} else if (core == 0) {
+		memset(headroom_shm, 0, sizeof(headroom_shm_t));
+	}
+}
+
+/**
+ * Startup of the headroom example.
+ *
+ * @attention Run only on EM core 0.
+ *
+ * @param appl_conf Application configuration
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_start(appl_conf_t *const appl_conf)
+{
+	em_pool_cfg_t pool_cfg;
+	em_eo_t eo;
+	em_status_t ret, start_ret = EM_ERROR;
+
+	APPL_PRINT("\n"
+		   "***********************************************************\n"
+		   "EM APPLICATION: '%s' initializing:\n"
+		   "  %s: %s() - EM-core:%i\n"
+		   "  Application running on %d EM-cores (procs:%d, threads:%d)\n"
+		   "***********************************************************\n"
+		   "\n",
+		   appl_conf->name, NO_PATH(__FILE__), __func__, em_core_id(),
+		   em_core_count(),
+		   appl_conf->num_procs, appl_conf->num_threads);
+
+	em_pool_cfg_init(&pool_cfg);
+	pool_cfg.event_type = EM_EVENT_TYPE_PACKET;
+	pool_cfg.num_subpools = 1;
+	pool_cfg.subpool[0].size = 256;
+	pool_cfg.subpool[0].num = 1024;
+	pool_cfg.pkt.headroom.in_use = true;
+	pool_cfg.pkt.headroom.value = POOL_HEADROOM;
+
+	headroom_shm->pkt_pool = em_pool_create("pool:headroom", EM_POOL_UNDEF,
+						&pool_cfg);
+	test_fatal_if(headroom_shm->pkt_pool == EM_POOL_UNDEF,
+		      "pool create failed");
+
+	eo = em_eo_create("headroom-eo", headroom_start, NULL,
+			  headroom_stop, NULL, headroom_receive, NULL);
+	test_fatal_if(eo == EM_EO_UNDEF, "EO creation failed!");
+	headroom_shm->eo = eo;
+
+	ret = em_eo_start_sync(eo, &start_ret, NULL);
+	test_fatal_if(ret != EM_OK || start_ret != EM_OK,
+		      "EO start:%" PRI_STAT " %" PRI_STAT "",
+		      ret, start_ret);
+}
+
+void
+test_stop(appl_conf_t *const appl_conf)
+{
+	const int core = em_core_id();
+	em_status_t stat;
+
+	(void)appl_conf;
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	stat = em_eo_stop_sync(headroom_shm->eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO stop failed!");
+}
+
+void
+test_term(void)
+{
+	int core = em_core_id();
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	if (core == 0) {
+		em_status_t ret = em_pool_delete(headroom_shm->pkt_pool);
+
+		test_fatal_if(ret != EM_OK,
+			      "em_pool_delete(%" PRI_POOL "):%" PRI_STAT "",
+			      headroom_shm->pkt_pool, ret);
+
+		env_shared_free(headroom_shm);
+		em_unregister_error_handler();
+	}
+}
+
+/**
+ * @private
+ *
+ * EO start function.
+ *
+ * Creates the atomic queue and sends the packet event into it.
+ */
+static em_status_t
+headroom_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf)
+{
+	em_queue_t queue;
+	em_event_t event;
+	em_status_t status;
+	uint8_t *payload;
+
+	(void)eo_ctx;
+	(void)conf;
+
+	queue = em_queue_create("headroom", EM_QUEUE_TYPE_ATOMIC,
+				EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_DEFAULT,
+				NULL);
+	test_fatal_if(queue == EM_QUEUE_UNDEF, "Queue creation failed!");
+	headroom_shm->queue = queue;
+
+	status = em_eo_add_queue_sync(eo, queue);
+	test_fatal_if(status != EM_OK, "EO add queue:%" PRI_STAT "\n"
+		      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "", status, eo, queue);
+
+	event = em_alloc(PAYLOAD_LEN, EM_EVENT_TYPE_PACKET,
+			 headroom_shm->pkt_pool);
+	test_fatal_if(event == EM_EVENT_UNDEF, "Event allocation failed!");
+
+	payload = em_event_pointer(event);
+	for (int i = 0; i < PAYLOAD_LEN; i++)
+		payload[i] = (uint8_t)i;
+
+	APPL_PRINT("Headroom example started, headroom:%" PRIu32 " B payload:%" PRIu32 " B\n",
+		   em_event_headroom(event), em_event_get_size(event));
+
+	status = em_send(event, queue);
+	test_fatal_if(status != EM_OK, "em_send():%" PRI_STAT "\n"
+		      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "",
+		      status, eo, queue);
+
+	return EM_OK;
+}
+
+/**
+ * @private
+ *
+ * EO stop function.
+ */
+static em_status_t
+headroom_stop(void *eo_ctx, em_eo_t eo)
+{
+	em_status_t stat;
+
+	(void)eo_ctx;
+
+	APPL_PRINT("Headroom example stop on EM-core %d\n", em_core_id());
+
+	stat = em_eo_remove_queue_sync(eo, headroom_shm->queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO remove queue failed!");
+
+	stat = em_queue_delete(headroom_shm->queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("Queue delete failed!");
+
+	stat = em_eo_delete(eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO delete failed!");
+
+	return stat;
+}
+
+/**
+ * @private
+ *
+ * Encapsulate the payload of 'event' into the headroom and decapsulate it
+ * again, check that the payload is intact.
+ */
+static void
+encap_decap(em_event_t event, uint64_t seq)
+{
+	const uint32_t headroom = em_event_headroom(event);
+	const uint32_t len = em_event_get_size(event);
+	encap_hdr_t *hdr;
+	const uint8_t *payload;
+
+	test_fatal_if(headroom < POOL_HEADROOM || len != PAYLOAD_LEN,
+		      "headroom:%" PRIu32 " len:%" PRIu32 "", headroom, len);
+
+	hdr = em_event_push_head(event, sizeof(encap_hdr_t));
+	test_fatal_if(hdr == NULL || hdr != em_event_pointer(event),
+		      "em_event_push_head() failed");
+	test_fatal_if(em_event_headroom(event) != headroom - sizeof(encap_hdr_t) ||
+		      em_event_get_size(event) != len + sizeof(encap_hdr_t),
+		      "push: headroom:%" PRIu32 " len:%" PRIu32 "",
+		      em_event_headroom(event), em_event_get_size(event));
+
+	hdr->seq = seq;
+	hdr->magic = ENCAP_MAGIC;
+	hdr->len = len;
+
+	/* ... the receiver of the encapsulated packet strips the header */
+	test_fatal_if(hdr->magic != ENCAP_MAGIC || hdr->seq != seq,
+		      "bad encapsulation header");
+
+	payload = em_event_pull_head(event, sizeof(encap_hdr_t));
+	test_fatal_if(payload == NULL || payload != em_event_pointer(event),
+		      "em_event_pull_head() failed");
+	test_fatal_if(em_event_headroom(event) != headroom ||
+		      em_event_get_size(event) != len,
+		      "pull: headroom:%" PRIu32 " len:%" PRIu32 "",
+		      em_event_headroom(event), em_event_get_size(event));
+
+	for (uint32_t i = 0; i < len; i++)
+		test_fatal_if(payload[i] != (uint8_t)i,
+			      "payload[%" PRIu32 "]:%u corrupted", i, payload[i]);
+}
+
+/**
+ * @private
+ *
+ * Extend a new packet beyond its headroom, i.e. with prepended segment(s).
+ */
+static void
+extend_beyond_headroom(void)
+{
+	em_event_t event = em_alloc(PAYLOAD_LEN, EM_EVENT_TYPE_PACKET,
+				    headroom_shm->pkt_pool);
+	em_event_t orig_event = event;
+	uint32_t len;
+	void *ptr;
+
+	test_fatal_if(event == EM_EVENT_UNDEF, "Event allocation failed!");
+
+	len = em_event_headroom(event) + sizeof(encap_hdr_t);
+
+	ptr = em_event_extend_head(&event, len);
+	test_fatal_if(ptr == NULL || ptr != em_event_pointer(event),
+		      "em_event_extend_head(%" PRIu32 ") failed", len);
+	test_fatal_if(em_event_get_size(event) < len,
+		      "extend: first segment:%" PRIu32 " < %" PRIu32 "",
+		      em_event_get_size(event), len);
+
+	memset(ptr, 0, len);
+
+	if (event != orig_event)
+		headroom_shm->seg_prepends++;
+
+	em_free(event);
+}
+
+/**
+ * @private
+ *
+ * EO receive function.
+ *
+ * Encapsulates and decapsulates the packet, sends it back into the same
+ * queue.
+ */
+static void
+headroom_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+		 em_queue_t queue, void *q_ctx)
+{
+	em_status_t status;
+	uint64_t rounds;
+
+	(void)eo_ctx;
+	(void)type;
+	(void)q_ctx;
+
+	if (unlikely(appl_shm->exit_flag)) {
+		em_free(event);
+		return;
+	}
+
+	/* Atomic queue: one core at a time updates the count */
+	rounds = ++headroom_shm->rounds;
+
+	encap_decap(event, rounds);
+	extend_beyond_headroom();
+
+	if (rounds % PRINT_ROUNDS == 0)
+		APPL_PRINT("Round %" PRIu64 " done: headroom:%" PRIu32 " B, %" PRIu64 " segment prepends\n",
+			   rounds, em_event_headroom(event),
+			   headroom_shm->seg_prepends);
+
+	status = em_send(event, queue);
+	if (unlikely(status != EM_OK)) {
+		em_free(event);
+		test_fatal_if(!appl_shm->exit_flag,
+			      "em_send():%" PRI_STAT " Queue:%" PRI_QUEUE "",
+			      status, queue);
+	}
+}
@@ -0,0 +1,397 @@
+/*
+ *   Copyright (c) 2023, Nokia Solutions and Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Event Machine immediate event example.
+ *
+ * EM-core 0 sends NUM_SEND events per cycle into a local queue: every
+ * NORMAL_EVERY:th is a normal event, the rest are immediate events sent with
+ * em_send_imm(). The payload of an immediate event uses all of its 47 bits:
+ * the cycle in the high bits and the sequence number in the low bits, the
+ * last one is EM_EVENT_IMM_DATA_MAX. The local queue is then dispatched with
+ * em_dispatch_duration(): the EO receive function reads the payloads with
+ * em_event_imm_data() and checks that the immediate and normal events arrive
+ * in the order they were sent.
+ *
+ * Immediate events are only supported for local queues.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <event_machine.h>
+#include <event_machine/platform/env/environment.h>
+
+#include "cm_setup.h"
+#include "cm_error_handler.h"
+
+/* Number of events sent per cycle */
+#define NUM_SEND  128
+/* Every NORMAL_EVERY:th event sent is a normal event */
+#define NORMAL_EVERY  4
+/* Number of cycles */
+#define NUM_CYCLES  3
+
+/* Immediate event payload: cycle in the high bits, sequence number below */
+#define IMM_CYCLE_SHIFT  40
+#define IMM_DATA(cycle, seq)  (((uint64_t)(cycle) << IMM_CYCLE_SHIFT) | (seq))
+
+/**
+ * Normal event
+ */
+typedef struct {
+	int seq;
+} normal_event_t;
+
+/**
+ * Immediate event example shared memory
+ */
+typedef struct {
+	/* Event pool used by this application */
+	em_pool_t pool;
+	/* The EO and its local queue */
+	em_eo_t eo;
+	em_queue_t queue;
+	/* Current cycle and next expected sequence number, EM-core 0 only */
+	int cycle;
+	int seq;
+	/* Received events in this cycle */
+	int imm;
+	int normal;
+	/* Pad to cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} imm_shm_t;
+
+COMPILE_TIME_ASSERT((sizeof(imm_shm_t) % ENV_CACHE_LINE_SIZE) == 0,
+		    IMM_SHM_T__SIZE_ERROR);
+COMPILE_TIME_ASSERT(IMM_DATA(NUM_CYCLES, NUM_SEND) <= EM_EVENT_IMM_DATA_MAX,
+		    IMM_DATA__SIZE_ERROR);
+
+/* EM-core local pointer to shared memory */
+static ENV_LOCAL imm_shm_t *imm_shm;
+
+/*
+ * Local function prototypes
+ */
+static em_status_t
+imm_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf);
+
+static em_status_t
+imm_stop(void *eo_ctx, em_eo_t eo);
+
+static void
+imm_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	    em_queue_t queue, void *q_ctx);
+
+static void
+run_cycle(int cycle);
+
+/**
+ * Main function
+ *
+ * Call cm_setup() to perform test & EM setup common for all the
+ * test applications.
+ *
+ * cm_setup() will call test_init() and test_start() and launch
+ * the EM dispatch loop on every EM-core.
+ */
+int main(int argc, char *argv[])
+{
+	return cm_setup(argc, argv);
+}
+
+/**
+ * Init of the immediate event example.
+ *
+ * @attention Run on all cores.
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_init(void)
+{
+	int core = em_core_id();
+
+	if (core == 0) {
+		imm_shm = env_shared_reserve("EventImmSharedMem",
+					     sizeof(imm_shm_t));
+		em_register_error_handler(test_error_handler);
+	} else {
+		imm_shm = env_shared_lookup("EventImmSharedMem");
+	}
+
+	if (imm_shm == NULL) {
+		test_error(EM_ERROR_SET_FATAL(0xec0de), 0xdead,
+			   "Event imm init failed on EM-core: %u",
+			   em_core_id());
+	} else if (core == 0) {
+		memset(imm_shm, 0, sizeof(imm_shm_t));
+	}
+}
+
+/**
+ * Startup of the immediate event example.
+ *
+ * @attention Run only on EM core 0.
+ *
+ * @param appl_conf Application configuration
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_start(appl_conf_t *const appl_conf)
+{
+	em_eo_t eo;
+	em_status_t ret, start_ret = EM_ERROR;
+
+	if (appl_conf->num_pools >= 1)
+		imm_shm->pool = appl_conf->pools[0];
+	else
+		imm_shm->pool = EM_POOL_DEFAULT;
+
+	APPL_PRINT("\n"
+		   "***********************************************************\n"
+		   "EM APPLICATION: '%s' initializing:\n"
+		   "  %s: %s() - EM-core:%i\n"
+		   "  Application running on %d EM-cores (procs:%d, threads:%d)\n"
+		   "  using event pool:%" PRI_POOL "\n"
+		   "***********************************************************\n"
+		   "\n",
+		   appl_conf->name, NO_PATH(__FILE__), __func__, em_core_id(),
+		   em_core_count(),
+		   appl_conf->num_procs, appl_conf->num_threads,
+		   imm_shm->pool);
+
+	test_fatal_if(imm_shm->pool == EM_POOL_UNDEF,
+		      "Undefined application event pool!");
+
+	eo = em_eo_create("event-imm-eo", imm_start, NULL,
+			  imm_stop, NULL, imm_receive, NULL);
+	test_fatal_if(eo == EM_EO_UNDEF, "EO creation failed!");
+	imm_shm->eo = eo;
+
+	ret = em_eo_start_sync(eo, &start_ret, NULL);
+	test_fatal_if(ret != EM_OK || start_ret != EM_OK,
+		      "EO start:%" PRI_STAT " %" PRI_STAT "",
+		      ret, start_ret);
+
+	/* Dispatch on this core only, before entering the main dispatch loop */
+	for (int i = 0; i < NUM_CYCLES; i++)
+		run_cycle(i);
+}
+
+void
+test_stop(appl_conf_t *const appl_conf)
+{
+	const int core = em_core_id();
+	em_status_t stat;
+
+	(void)appl_conf;
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	stat = em_eo_stop_sync(imm_shm->eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO stop failed!");
+}
+
+void
+test_term(void)
+{
+	int core = em_core_id();
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	if (core == 0) {
+		env_shared_free(imm_shm);
+		em_unregister_error_handler();
+	}
+}
+
+/**
+ * @private
+ *
+ * EO start function.
+ *
+ * Creates the local queue, immediate events cannot be sent from here.
+ */
+static em_status_t
+imm_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf)
+{
+	em_queue_t queue;
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)conf;
+
+	queue = em_queue_create("event-imm-local", EM_QUEUE_TYPE_LOCAL,
+				EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_UNDEF, NULL);
+	test_fatal_if(queue == EM_QUEUE_UNDEF, "Queue creation failed!");
+	imm_shm->queue = queue;
+
+	status = em_eo_add_queue_sync(eo, queue);
+	test_fatal_if(status != EM_OK, "EO add queue:%" PRI_STAT "", status);
+
+	return EM_OK;
+}
+
+/**
+ * @private
+ *
+ * EO stop function.
+ */
+static em_status_t
+imm_stop(void *eo_ctx, em_eo_t eo)
+{
+	em_status_t stat;
+
+	(void)eo_ctx;
+
+	APPL_PRINT("Event imm example stop on EM-core %d\n", em_core_id());
+
+	stat = em_eo_remove_queue_all_sync(eo, EM_TRUE);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO remove queues failed!");
+
+	stat = em_eo_delete(eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO delete failed!");
+
+	return stat;
+}
+
+/**
+ * @private
+ *
+ * Payload of the immediate event 'seq' in 'cycle', the last one is the max.
+ */
+static uint64_t
+imm_data(int cycle, int seq)
+{
+	if (seq == NUM_SEND - 1)
+		return EM_EVENT_IMM_DATA_MAX;
+
+	return IMM_DATA(cycle, seq);
+}
+
+/**
+ * @private
+ *
+ * Send NUM_SEND immediate and normal events to the local queue and dispatch
+ * them.
+ */
+static void
+run_cycle(int cycle)
+{
+	em_dispatch_duration_t duration;
+	em_status_t status;
+
+	imm_shm->cycle = cycle;
+	imm_shm->seq = 0;
+	imm_shm->imm = 0;
+	imm_shm->normal = 0;
+
+	for (int i = 0; i < NUM_SEND; i++) {
+		if (i % NORMAL_EVERY != NORMAL_EVERY - 1) {
+			status = em_send_imm(imm_data(cycle, i), imm_shm->queue);
+			test_fatal_if(status != EM_OK, "em_send_imm():%" PRI_STAT "",
+				      status);
+			continue;
+		}
+
+		em_event_t event = em_alloc(sizeof(normal_event_t),
+					    EM_EVENT_TYPE_SW, imm_shm->pool);
+		normal_event_t *normal;
+
+		test_fatal_if(event == EM_EVENT_UNDEF,
+			      "Event allocation failed!");
+		normal = em_event_pointer(event);
+		normal->seq = i;
+
+		status = em_send(event, imm_shm->queue);
+		test_fatal_if(status != EM_OK, "em_send():%" PRI_STAT "", status);
+	}
+
+	memset(&duration, 0, sizeof(duration));
+	duration.select = EM_DISPATCH_DURATION_NO_EVENTS_ROUNDS;
+	duration.no_events.rounds = 100;
+
+	status = em_dispatch_duration(&duration, NULL, NULL);
+	test_fatal_if(status != EM_OK, "em_dispatch_duration():%" PRI_STAT "",
+		      status);
+
+	test_fatal_if(imm_shm->seq != NUM_SEND,
+		      "Cycle %d: received %d events, expected %d",
+		      cycle, imm_shm->seq, NUM_SEND);
+
+	APPL_PRINT("Cycle %d done: imm:%d normal:%d, max payload:0x%" PRIx64 "\n",
+		   cycle, imm_shm->imm, imm_shm->normal, EM_EVENT_IMM_DATA_MAX);
+}
+
+/**
+ * @private
+ *
+ * EO receive function.
+ *
+ * Checks the payload and the order of the immediate and normal events.
+ * Immediate events have nothing to free.
+ */
+static void
+imm_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	    em_queue_t queue, void *q_ctx)
+{
+	const int seq = imm_shm->seq++;
+
+	(void)eo_ctx;
+	(void)queue;
+	(void)q_ctx;
+
+	if (em_event_type_major(type) == EM_EVENT_TYPE_IMMEDIATE) {
+		const uint64_t data = em_event_imm_data(event);
+		const uint64_t expected = imm_data(imm_shm->cycle, seq);
+
+		test_fatal_if(data != expected,
+			      "Immediate event %d: data:0x%" PRIx64 ", expected:0x%" PRIx64 "",
+			      seq, data, expected);
+		imm_shm->imm++;
+		return;
+	}
+
+	const normal_event_t *normal = em_event_pointer(event);
+
+	test_fatal_if(normal->seq != seq, "Normal event: seq:%d, expected:%d",
+		      normal->seq, seq);
+	imm_shm->normal++;
+	em_free(event);
+}
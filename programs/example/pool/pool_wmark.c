@@ -0,0 +1,456 @@
+/*
+ *   Copyright (c) 2023, Nokia Solutions and Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Event Machine pool watermark example.
+ *
+ * Creates an event pool with occupancy watermarks set by em_pool_wmark_set().
+ * An EO alternately allocates events from the pool and holds on to them until
+ * the watermark callback reports that the number of free events dropped below
+ * the low watermark, then frees the held events until the callback reports
+ * that the pool has recovered to the high watermark.
+ *
+ * The pool has the 'available' ODP pool statistic enabled, which the
+ * watermarks need, via em_pool_cfg_t::stats_opt.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <event_machine.h>
+#include <event_machine/platform/env/environment.h>
+
+#include "cm_setup.h"
+#include "cm_error_handler.h"
+
+/*
+ * Number of events in the watermark pool. The watermarks are checked every
+ * few operations on a core: leave room for the operations before the check.
+ */
+#define POOL_EVENTS  8192
+/* Watermarks: number of free events */
+#define WMARK_LOW  2048
+#define WMARK_HIGH  6144
+/* Events allocated or freed per step */
+#define STEP_EVENTS  64
+/* Min time between the steps (ns) */
+#define STEP_NS  (5 * 1000000ULL)
+
+/**
+ * Pool watermark example shared memory
+ */
+typedef struct {
+	/* Event pool for the tick event */
+	em_pool_t pool;
+	/* Pool with watermarks */
+	em_pool_t wmark_pool;
+	/* The EO and its atomic queue */
+	em_eo_t eo;
+	em_queue_t queue;
+	/*
+	 * Updated only in the atomic context of 'queue', the watermark
+	 * callback is called from the em_alloc/free() calls of the EO.
+	 */
+	em_pool_wmark_t wmark;
+	uint32_t wmark_free;
+	int filling;
+	int cycles;
+	env_time_t next_step;
+	int num_held;
+	em_event_t held[POOL_EVENTS];
+	/* Pad to cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} wmark_shm_t;
+
+COMPILE_TIME_ASSERT((sizeof(wmark_shm_t) % ENV_CACHE_LINE_SIZE) == 0,
+		    WMARK_SHM_T__SIZE_ERROR);
+
+/* EM-core local pointer to shared memory */
+static ENV_LOCAL wmark_shm_t *wmark_shm;
+
+/*
+ * Local function prototypes
+ */
+static em_status_t
+wmark_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf);
+
+static em_status_t
+wmark_stop(void *eo_ctx, em_eo_t eo);
+
+static void
+wmark_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	      em_queue_t queue, void *q_ctx);
+
+static void
+wmark_cb(em_pool_t pool, em_pool_wmark_t wmark, uint32_t num_free, void *arg);
+
+/**
+ * Main function
+ *
+ * Call cm_setup() to perform test & EM setup common for all the
+ * test applications.
+ *
+ * cm_setup() will call test_init() and test_start() and launch
+ * the EM dispatch loop on every EM-core.
+ */
+int main(int argc, char *argv[])
+{
+	return cm_setup(argc, argv);
+}
+
+/**
+ * Init of the pool watermark example.
+ *
+ * @attention Run on all cores.
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_init(void)
+{
+	int core = em_core_id();
+
+	if (core == 0) {
+		wmark_shm = env_shared_reserve("PoolWmarkSharedMem",
+					       sizeof(wmark_shm_t));
+		em_register_error_handler(test_error_handler);
+	} else {
+		wmark_shm = env_shared_lookup("PoolWmarkSharedMem");
+	}
+
+	if (wmark_shm == NULL) {
+		test_error(EM_ERROR_SET_FATAL(0xec0de), 0xdead,
+			   "Pool wmark init failed on EM-core: %u",
+			   em_core_id());
+	} else if (core == 0) {
+		memset(wmark_shm, 0, sizeof(wmark_shm_t));
+	}
+}
+
+/**
+ * Startup of the pool watermark example.
+ *
+ * @attention Run only on EM core 0.
+ *
+ * @param appl_conf Application configuration
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_start(appl_conf_t *const appl_conf)
+{
+	em_pool_wmark_param_t wmark_param;
+	em_pool_cfg_t pool_cfg;
+	em_eo_t eo;
+	em_status_t ret, start_ret = EM_ERROR;
+
+	if (appl_conf->num_pools >= 1)
+		wmark_shm->pool = appl_conf->pools[0];
+	else
+		wmark_shm->pool = EM_POOL_DEFAULT;
+
+	APPL_PRINT("\n"
+		   "***********************************************************\n"
+		   "EM APPLICATION: '%s' initializing:\n"
+		   "  %s: %s() - EM-core:%i\n"
+		   "  Application running on %d EM-cores (procs:%d, threads:%d)\n"
+		   "  using event pool:%" PRI_POOL "\n"
+		   "***********************************************************\n"
+		   "\n",
+		   appl_conf->name, NO_PATH(__FILE__), __func__, em_core_id(),
+		   em_core_count(),
+		   appl_conf->num_procs, appl_conf->num_threads,
+		   wmark_shm->pool);
+
+	test_fatal_if(wmark_shm->pool == EM_POOL_UNDEF,
+		      "Undefined application event pool!");
+
+	/*
+	 * Pool with watermarks: the watermarks need the 'available' statistic.
+	 * No core-local cache, all free events are counted as 'available'.
+	 */
+	em_pool_cfg_init(&pool_cfg);
+	pool_cfg.event_type = EM_EVENT_TYPE_SW;
+	pool_cfg.num_subpools = 1;
+	pool_cfg.subpool[0].size = 256;
+	pool_cfg.subpool[0].num = POOL_EVENTS;
+	pool_cfg.subpool[0].cache_size = 0;
+	pool_cfg.stats_opt.in_use = true;
+	pool_cfg.stats_opt.opt.available = 1;
+
+	wmark_shm->wmark_pool = em_pool_create("pool:wmark", EM_POOL_UNDEF,
+					       &pool_cfg);
+	test_fatal_if(wmark_shm->wmark_pool == EM_POOL_UNDEF,
+		      "pool create failed");
+
+	wmark_param.low = WMARK_LOW;
+	wmark_param.high = WMARK_HIGH;
+	wmark_param.func = wmark_cb;
+	wmark_param.arg = wmark_shm;
+
+	ret = em_pool_wmark_set(wmark_shm->wmark_pool, &wmark_param);
+	test_fatal_if(ret != EM_OK, "em_pool_wmark_set():%" PRI_STAT "", ret);
+
+	wmark_shm->filling = 1;
+
+	eo = em_eo_create("pool-wmark-eo", wmark_start, NULL,
+			  wmark_stop, NULL, wmark_receive, NULL);
+	test_fatal_if(eo == EM_EO_UNDEF, "EO creation failed!");
+	wmark_shm->eo = eo;
+
+	ret = em_eo_start_sync(eo, &start_ret, NULL);
+	test_fatal_if(ret != EM_OK || start_ret != EM_OK,
+		      "EO start:%" PRI_STAT " %" PRI_STAT "",
+		      ret, start_ret);
+}
+
+void
+test_stop(appl_conf_t *const appl_conf)
+{
+	const int core = em_core_id();
+	em_status_t stat;
+
+	(void)appl_conf;
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	stat = em_eo_stop_sync(wmark_shm->eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO stop failed!");
+}
+
+void
+test_term(void)
+{
+	int core = em_core_id();
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	if (core == 0) {
+		em_status_t ret = em_pool_delete(wmark_shm->wmark_pool);
+
+		test_fatal_if(ret != EM_OK,
+			      "em_pool_delete(%" PRI_POOL "):%" PRI_STAT "",
+			      wmark_shm->wmark_pool, ret);
+
+		env_shared_free(wmark_shm);
+		em_unregister_error_handler();
+	}
+}
+
+/**
+ * @private
+ *
+ * EO start function.
+ *
+ * Creates the atomic queue and sends the tick event into it.
+ */
+static em_status_t
+wmark_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf)
+{
+	em_queue_t queue;
+	em_event_t event;
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)conf;
+
+	queue = em_queue_create("pool-wmark", EM_QUEUE_TYPE_ATOMIC,
+				EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_DEFAULT,
+				NULL);
+	test_fatal_if(queue == EM_QUEUE_UNDEF, "Queue creation failed!");
+	wmark_shm->queue = queue;
+
+	status = em_eo_add_queue_sync(eo, queue);
+	test_fatal_if(status != EM_OK, "EO add queue:%" PRI_STAT "\n"
+		      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "", status, eo, queue);
+
+	event = em_alloc(sizeof(uint64_t), EM_EVENT_TYPE_SW, wmark_shm->pool);
+	test_fatal_if(event == EM_EVENT_UNDEF, "Event allocation failed!");
+
+	status = em_send(event, queue);
+	test_fatal_if(status != EM_OK, "em_send():%" PRI_STAT "\n"
+		      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "",
+		      status, eo, queue);
+
+	APPL_PRINT("Pool watermark example started: %d events, low:%d high:%d\n",
+		   POOL_EVENTS, WMARK_LOW, WMARK_HIGH);
+
+	return EM_OK;
+}
+
+/**
+ * @private
+ *
+ * EO stop function.
+ */
+static em_status_t
+wmark_stop(void *eo_ctx, em_eo_t eo)
+{
+	em_status_t stat;
+
+	(void)eo_ctx;
+
+	APPL_PRINT("Pool watermark example stop on EM-core %d\n", em_core_id());
+
+	stat = em_eo_remove_queue_sync(eo, wmark_shm->queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO remove queue failed!");
+
+	/* The queue is removed, no receive calls: free the held events */
+	if (wmark_shm->num_held > 0)
+		em_free_multi(wmark_shm->held, wmark_shm->num_held);
+	wmark_shm->num_held = 0;
+
+	stat = em_pool_wmark_clear(wmark_shm->wmark_pool);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("Pool watermark clear failed!");
+
+	stat = em_queue_delete(wmark_shm->queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("Queue delete failed!");
+
+	stat = em_eo_delete(eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO delete failed!");
+
+	return stat;
+}
+
+/**
+ * @private
+ *
+ * Pool watermark callback.
+ *
+ * Called from em_alloc() or em_free() on the fast path, only records the
+ * crossing for the EO to act on.
+ */
+static void
+wmark_cb(em_pool_t pool, em_pool_wmark_t wmark, uint32_t num_free, void *arg)
+{
+	wmark_shm_t *const shm = arg;
+
+	(void)pool;
+
+	shm->wmark = wmark;
+	shm->wmark_free = num_free;
+}
+
+/**
+ * @private
+ *
+ * One step: allocate STEP_EVENTS events until the low watermark is reported,
+ * then free STEP_EVENTS events until the high watermark is reported.
+ */
+static void
+wmark_step(void)
+{
+	wmark_shm_t *const shm = wmark_shm;
+
+	if (shm->filling) {
+		if (shm->wmark == EM_POOL_WMARK_LOW) {
+			APPL_PRINT("Pool watermark LOW: free:%" PRIu32 " held:%d\n",
+				   shm->wmark_free, shm->num_held);
+			shm->filling = 0;
+			return;
+		}
+
+		test_fatal_if(shm->num_held + STEP_EVENTS > POOL_EVENTS,
+			      "No low watermark callback, %d events held",
+			      shm->num_held);
+
+		for (int i = 0; i < STEP_EVENTS; i++) {
+			em_event_t event = em_alloc(64, EM_EVENT_TYPE_SW,
+						    shm->wmark_pool);
+
+			test_fatal_if(event == EM_EVENT_UNDEF,
+				      "Event allocation failed!");
+			shm->held[shm->num_held++] = event;
+		}
+	} else {
+		if (shm->wmark == EM_POOL_WMARK_HIGH) {
+			APPL_PRINT("Pool watermark HIGH: free:%" PRIu32 " held:%d\n",
+				   shm->wmark_free, shm->num_held);
+			APPL_PRINT("Cycle %d done\n", ++shm->cycles);
+			shm->filling = 1;
+			return;
+		}
+
+		test_fatal_if(shm->num_held < STEP_EVENTS,
+			      "No high watermark callback, %d events held",
+			      shm->num_held);
+
+		shm->num_held -= STEP_EVENTS;
+		em_free_multi(&shm->held[shm->num_held], STEP_EVENTS);
+	}
+}
+
+/**
+ * @private
+ *
+ * EO receive function.
+ *
+ * The tick event circulates through the atomic queue, a step is taken every
+ * STEP_NS.
+ */
+static void
+wmark_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	      em_queue_t queue, void *q_ctx)
+{
+	env_time_t now;
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)type;
+	(void)q_ctx;
+
+	if (unlikely(appl_shm->exit_flag)) {
+		em_free(event);
+		return;
+	}
+
+	now = env_time_global();
+	if (env_time_cmp(now, wmark_shm->next_step) >= 0) {
+		wmark_step();
+		wmark_shm->next_step = env_time_sum(now, env_time_global_from_ns(STEP_NS));
+	}
+
+	status = em_send(event, queue);
+	if (unlikely(status != EM_OK)) {
+		em_free(event);
+		test_fatal_if(!appl_shm->exit_flag,
+			      "em_send():%" PRI_STAT " Queue:%" PRI_QUEUE "",
+			      status, queue);
+	}
+}
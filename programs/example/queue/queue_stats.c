@@ -0,0 +1,352 @@
+/*
+ *   Copyright (c) 2023, Nokia Solutions and Networks
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ *
+ * Event Machine queue statistics example.
+ *
+ * One EO circulates a batch of events through its atomic queue, i.e. the
+ * queue always holds about NUM_EVENTS events. The queue depth and sojourn time
+ * are read with em_queue_stats() and printed with em_queue_stats_print() every
+ * PRINT_EVENTS events, then reset with em_queue_stats_reset().
+ *
+ * Needs 'queue.statistics = true' in the EM config file.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <event_machine.h>
+#include <event_machine/platform/env/environment.h>
+
+#include "cm_setup.h"
+#include "cm_error_handler.h"
+
+/* Number of events circulating through the queue */
+#define NUM_EVENTS  64
+/* Print the queue statistics every PRINT_EVENTS received events */
+#define PRINT_EVENTS  (1024 * 1024)
+
+/**
+ * Queue statistics example shared memory
+ */
+typedef struct {
+	/* Event pool used by this application */
+	em_pool_t pool;
+	/* The EO and its atomic queue */
+	em_eo_t eo;
+	em_queue_t queue;
+	/* Events received, only updated in the atomic context of 'queue' */
+	uint64_t count;
+	/* Pad to cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} qstats_shm_t;
+
+COMPILE_TIME_ASSERT((sizeof(qstats_shm_t) % ENV_CACHE_LINE_SIZE) == 0,
+		    QSTATS_SHM_T__SIZE_ERROR);
+
+/* EM-core local pointer to shared memory */
+static ENV_LOCAL qstats_shm_t *qstats_shm;
+
+/*
+ * Local function prototypes
+ */
+static em_status_t
+qstats_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf);
+
+static em_status_t
+qstats_stop(void *eo_ctx, em_eo_t eo);
+
+static void
+qstats_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	       em_queue_t queue, void *q_ctx);
+
+/**
+ * Main function
+ *
+ * Call cm_setup() to perform test & EM setup common for all the
+ * test applications.
+ *
+ * cm_setup() will call test_init() and test_start() and launch
+ * the EM dispatch loop on every EM-core.
+ */
+int main(int argc, char *argv[])
+{
+	return cm_setup(argc, argv);
+}
+
+/**
+ * Init of the queue statistics example.
+ *
+ * @attention Run on all cores.
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_init(void)
+{
+	int core = em_core_id();
+
+	if (core == 0) {
+		qstats_shm = env_shared_reserve("QueueStatsSharedMem",
+						sizeof(qstats_shm_t));
+		em_register_error_handler(test_error_handler);
+	} else {
+		qstats_shm = env_shared_lookup("QueueStatsSharedMem");
+	}
+
+	if (qstats_shm == NULL) {
+		test_error(EM_ERROR_SET_FATAL(0xec0de), 0xdead,
+			   "Queue stats init failed on EM-core: %u",
+			   em_core_id());
+	} else if (core == 0) {
+		memset(qstats_shm, 0, sizeof(qstats_shm_t));
+	}
+}
+
+/**
+ * Startup of the queue statistics example.
+ *
+ * @attention Run only on EM core 0.
+ *
+ * @param appl_conf Application configuration
+ *
+ * @see cm_setup() for setup and dispatch.
+ */
+void
+test_start(appl_conf_t *const appl_conf)
+{
+	em_eo_t eo;
+	em_status_t ret, start_ret = EM_ERROR;
+
+	if (appl_conf->num_pools >= 1)
+		qstats_shm->pool = appl_conf->pools[0];
+	else
+		qstats_shm->pool = EM_POOL_DEFAULT;
+
+	APPL_PRINT("\n"
+		   "***********************************************************\n"
+		   "EM APPLICATION: '%s' initializing:\n"
+		   "  %s: %s() - EM-core:%i\n"
+		   "  Application running on %d EM-cores (procs:%d, threads:%d)\n"
+		   "  using event pool:%" PRI_POOL "\n"
+		   "***********************************************************\n"
+		   "\n",
+		   appl_conf->name, NO_PATH(__FILE__), __func__, em_core_id(),
+		   em_core_count(),
+		   appl_conf->num_procs, appl_conf->num_threads,
+		   qstats_shm->pool);
+
+	test_fatal_if(qstats_shm->pool == EM_POOL_UNDEF,
+		      "Undefined application event pool!");
+
+	eo = em_eo_create("queue-stats-eo", qstats_start, NULL,
+			  qstats_stop, NULL, qstats_receive, NULL);
+	test_fatal_if(eo == EM_EO_UNDEF, "EO creation failed!");
+	qstats_shm->eo = eo;
+
+	ret = em_eo_start_sync(eo, &start_ret, NULL);
+	test_fatal_if(ret != EM_OK || start_ret != EM_OK,
+		      "EO start:%" PRI_STAT " %" PRI_STAT "",
+		      ret, start_ret);
+}
+
+void
+test_stop(appl_conf_t *const appl_conf)
+{
+	const int core = em_core_id();
+	em_status_t stat;
+
+	(void)appl_conf;
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	stat = em_eo_stop_sync(qstats_shm->eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO stop failed!");
+}
+
+void
+test_term(void)
+{
+	int core = em_core_id();
+
+	APPL_PRINT("%s() on EM-core %d\n", __func__, core);
+
+	if (core == 0) {
+		env_shared_free(qstats_shm);
+		em_unregister_error_handler();
+	}
+}
+
+/**
+ * @private
+ *
+ * EO start function.
+ *
+ * Creates the atomic queue and sends NUM_EVENTS events into it.
+ */
+static em_status_t
+qstats_start(void *eo_ctx, em_eo_t eo, const em_eo_conf_t *conf)
+{
+	em_queue_stats_t stats;
+	em_queue_t queue;
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)conf;
+
+	queue = em_queue_create("queue-stats", EM_QUEUE_TYPE_ATOMIC,
+				EM_QUEUE_PRIO_NORMAL, EM_QUEUE_GROUP_DEFAULT,
+				NULL);
+	test_fatal_if(queue == EM_QUEUE_UNDEF, "Queue creation failed!");
+	qstats_shm->queue = queue;
+
+	status = em_eo_add_queue_sync(eo, queue);
+	test_fatal_if(status != EM_OK, "EO add queue:%" PRI_STAT "\n"
+		      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "", status, eo, queue);
+
+	status = em_queue_stats(queue, &stats);
+	test_fatal_if(status != EM_OK,
+		      "em_queue_stats():%" PRI_STAT "\n"
+		      "Set 'queue.statistics = true' in the EM config file",
+		      status);
+
+	for (int i = 0; i < NUM_EVENTS; i++) {
+		em_event_t event = em_alloc(sizeof(uint64_t), EM_EVENT_TYPE_SW,
+					    qstats_shm->pool);
+
+		test_fatal_if(event == EM_EVENT_UNDEF,
+			      "Event allocation failed!");
+
+		status = em_send(event, queue);
+		test_fatal_if(status != EM_OK, "em_send():%" PRI_STAT "\n"
+			      "EO:%" PRI_EO " Queue:%" PRI_QUEUE "",
+			      status, eo, queue);
+	}
+
+	APPL_PRINT("Queue statistics example started, %d events in queue %" PRI_QUEUE "\n",
+		   NUM_EVENTS, queue);
+
+	return EM_OK;
+}
+
+/**
+ * @private
+ *
+ * EO stop function.
+ */
+static em_status_t
+qstats_stop(void *eo_ctx, em_eo_t eo)
+{
+	em_status_t stat;
+
+	(void)eo_ctx;
+
+	APPL_PRINT("Queue statistics example stop on EM-core %d\n", em_core_id());
+
+	stat = em_eo_remove_queue_sync(eo, qstats_shm->queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO remove queue failed!");
+
+	stat = em_queue_delete(qstats_shm->queue);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("Queue delete failed!");
+
+	stat = em_eo_delete(eo);
+	if (stat != EM_OK)
+		APPL_EXIT_FAILURE("EO delete failed!");
+
+	return stat;
+}
+
+/**
+ * @private
+ *
+ * Print the statistics of 'queue' and start a new measurement period.
+ */
+static void
+print_stats(em_queue_t queue)
+{
+	em_queue_stats_t stats;
+	em_status_t stat;
+
+	stat = em_queue_stats(queue, &stats);
+	test_fatal_if(stat != EM_OK, "em_queue_stats():%" PRI_STAT "", stat);
+
+	APPL_PRINT("\nQueue stats: enqueued:%" PRIu64 " dequeued:%" PRIu64 " depth:%" PRIu64 ""
+		   " sojourn avg:%" PRIu64 "ns max:%" PRIu64 "ns\n",
+		   stats.enqueued, stats.dequeued, stats.depth,
+		   stats.sojourn_avg_ns, stats.sojourn_max_ns);
+
+	em_queue_stats_print(queue);
+
+	stat = em_queue_stats_reset(queue);
+	test_fatal_if(stat != EM_OK, "em_queue_stats_reset():%" PRI_STAT "", stat);
+}
+
+/**
+ * @private
+ *
+ * EO receive function.
+ *
+ * Sends the event back into the same queue, prints the queue statistics
+ * every PRINT_EVENTS events.
+ */
+static void
+qstats_receive(void *eo_ctx, em_event_t event, em_event_type_t type,
+	       em_queue_t queue, void *q_ctx)
+{
+	em_status_t status;
+
+	(void)eo_ctx;
+	(void)type;
+	(void)q_ctx;
+
+	if (unlikely(appl_shm->exit_flag)) {
+		em_free(event);
+		return;
+	}
+
+	/* Atomic queue: one core at a time updates the count */
+	if (++qstats_shm->count % PRINT_EVENTS == 0)
+		print_stats(queue);
+
+	status = em_send(event, queue);
+	if (unlikely(status != EM_OK)) {
+		em_free(event);
+		test_fatal_if(!appl_shm->exit_flag,
+			      "em_send():%" PRI_STAT " Queue:%" PRI_QUEUE "",
+			      status, queue);
+	}
+}
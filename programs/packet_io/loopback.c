@@ -58,6 +58,8 @@
  *
  * Try also with EM_QUEUE_TYPE_PARALLEL or EM_QUEUE_TYPE_PARALLEL_ORDERED.
  * Alt. set QUEUE_TYPE_MIX to '1' to use all queue types simultaneously.
+ * With ordered queues, compare the default output ordering (shared tx-burst
+ * buffers) with ordered locks using the '--pktout-order-lock' option.
  */
 #define QUEUE_TYPE  EM_QUEUE_TYPE_ATOMIC
 /* #define QUEUE_TYPE  EM_QUEUE_TYPE_PARALLEL */
@@ -476,8 +478,10 @@ start_eo(void *eo_context, em_eo_t eo, const em_eo_conf_t *conf)
 	 * Default queue for all packets not mathing any
 	 * specific input queue criteria
 	 */
+	memset(&queue_conf, 0, sizeof(queue_conf));
+	queue_conf.flags = pktio_queue_flags(QUEUE_TYPE);
 	def_queue = em_queue_create("default", QUEUE_TYPE, EM_QUEUE_PRIO_NORMAL,
-				    EM_QUEUE_GROUP_DEFAULT, NULL);
+				    EM_QUEUE_GROUP_DEFAULT, &queue_conf);
 	test_fatal_if(def_queue == EM_QUEUE_UNDEF,
 		      "Default Queue creation failed");
 
@@ -518,6 +522,7 @@ create_queue_per_flow(const em_eo_t eo, eo_context_t *const eo_ctx)
 	uint16_t port_offset = (uint16_t)-1;
 	uint32_t q_ctx_idx = 0;
 	queue_context_t *q_ctx;
+	em_queue_conf_t queue_conf;
 	em_queue_type_t qtype;
 	em_queue_t queue;
 	em_status_t ret;
@@ -557,9 +562,11 @@ create_queue_per_flow(const em_eo_t eo, eo_context_t *const eo_ctx)
 			}
 
 			/* Create a queue */
+			memset(&queue_conf, 0, sizeof(queue_conf));
+			queue_conf.flags = pktio_queue_flags(qtype);
 			queue = em_queue_create("udp-flow", qtype,
 						EM_QUEUE_PRIO_NORMAL,
-						EM_QUEUE_GROUP_DEFAULT, NULL);
+						EM_QUEUE_GROUP_DEFAULT, &queue_conf);
 			test_fatal_if(queue == EM_QUEUE_UNDEF,
 				      "Queue create failed: UDP-port %d",
 				      udp_port);
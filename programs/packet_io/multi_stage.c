@@ -102,6 +102,13 @@
  */
 #define QUEUE_TYPE_PERMUTATIONS  (3 * 3 * 3)
 
+/**
+ * Create the parallel 2nd and 3rd stage queues with EM_QUEUE_FLAG_INLINE:
+ * the events sent to them are dispatched on the sending core without a
+ * scheduler round-trip
+ */
+#define QUEUE_INLINE_SEND  0 /* 0=False or 1=True */
+
 /**
  * Select whether the UDP ports should be unique over all IP-interfaces
  * (set to 1) or reused per IP-interface (thus each UDP port is configured once
@@ -248,6 +255,9 @@ fill_q_type_permutations(void);
 static em_queue_type_t
 queue_types(int cnt);
 
+static const em_queue_conf_t *
+stage_queue_conf(em_queue_type_t queue_type, em_queue_conf_t *conf /*out*/);
+
 static void
 set_pktout_queues(int q_idx, em_queue_t pktout_queue[/*out*/]);
 
@@ -514,7 +524,8 @@ test_start(appl_conf_t *const appl_conf)
 			 */
 			queue_type = q_type_tuple->queue_type_2nd;
 			queue_2nd = em_queue_create("udp_port", queue_type,
-						    prio, queue_group, NULL);
+						    prio, queue_group,
+						    stage_queue_conf(queue_type, &queue_conf));
 			test_fatal_if(queue_2nd == EM_QUEUE_UNDEF,
 				      "2.Queue create fail: UDP-port %d",
 				      udp_port);
@@ -542,7 +553,8 @@ test_start(appl_conf_t *const appl_conf)
 			 */
 			queue_type = q_type_tuple->queue_type_3rd;
 			queue_3rd = em_queue_create("udp_port", queue_type,
-						    prio, queue_group, NULL);
+						    prio, queue_group,
+						    stage_queue_conf(queue_type, &queue_conf));
 			test_fatal_if(queue_3rd == EM_QUEUE_UNDEF,
 				      "3.Queue create fail: UDP-port %d",
 				      udp_port);
@@ -738,6 +750,7 @@ receive_packet_eo_1st(void *eo_context, em_event_t event, em_event_type_t type,
 {
 	eo_context_t *const eo_ctx = eo_context;
 	queue_context_1st_t *const q_ctx = queue_context;
+	em_event_t *pkt_tbl;
 	em_status_t status;
 
 	(void)type;
@@ -747,6 +760,9 @@ receive_packet_eo_1st(void *eo_context, em_event_t event, em_event_type_t type,
 		return;
 	}
 
+	/* A vector of same-flow pkts with '--pktin-coalesce' */
+	const uint32_t num = pktio_pkt_tbl(&event, &pkt_tbl /*out*/);
+
 	/* Drop everything from the default queue */
 	if (unlikely(queue == eo_ctx->default_queue)) {
 		static ENV_LOCAL uint64_t drop_cnt = 1;
@@ -755,13 +771,13 @@ receive_packet_eo_1st(void *eo_context, em_event_t event, em_event_type_t type,
 		 * Print notice about pkt drop for the first pkt only to avoid
 		 * flooding the terminal with prints.
 		 */
-		if (drop_cnt == 1) {
+		if (drop_cnt == 1 && num > 0) {
 			uint8_t proto;
 			uint32_t ipv4_dst;
 			uint16_t port_dst;
 			char ip_str[sizeof("255.255.255.255")];
 
-			pktio_get_dst(event, &proto, &ipv4_dst, &port_dst);
+			pktio_get_dst(pkt_tbl[0], &proto, &ipv4_dst, &port_dst);
 			ipaddr_tostr(ipv4_dst, ip_str, sizeof(ip_str));
 			APPL_PRINT("Drop: pkt received from %s:%u, core%d\n",
 				   ip_str, port_dst, em_core_id());
@@ -772,20 +788,23 @@ receive_packet_eo_1st(void *eo_context, em_event_t event, em_event_type_t type,
 	}
 
 	if (ENABLE_ERROR_CHECKS) { /* Check IP address and port */
-		uint8_t proto;
-		uint32_t ipv4_dst;
-		uint16_t port_dst;
-		flow_params_t *const fp = &q_ctx->flow_params;
-
-		pktio_get_dst(event, &proto, &ipv4_dst, &port_dst);
-
-		test_fatal_if(fp->ipv4 != ipv4_dst ||
-			      fp->port != port_dst || fp->proto != proto,
-			      "Q:%" PRI_QUEUE " received illegal packet!\n"
-			      "rcv: IP:0x%" PRIx32 ":%" PRIu16 ".%" PRIu8 "\n"
-			      "cfg: IP:0x%" PRIx32 ":%" PRIu16 ".%" PRIu8 "\n"
-			      "Abort!", queue, ipv4_dst, port_dst, proto,
-			      fp->ipv4, fp->port, fp->proto);
+		const flow_params_t *const fp = &q_ctx->flow_params;
+
+		for (uint32_t i = 0; i < num; i++) {
+			uint8_t proto;
+			uint32_t ipv4_dst;
+			uint16_t port_dst;
+
+			pktio_get_dst(pkt_tbl[i], &proto, &ipv4_dst, &port_dst);
+
+			test_fatal_if(fp->ipv4 != ipv4_dst ||
+				      fp->port != port_dst || fp->proto != proto,
+				      "Q:%" PRI_QUEUE " received illegal packet!\n"
+				      "rcv: IP:0x%" PRIx32 ":%" PRIu16 ".%" PRIu8 "\n"
+				      "cfg: IP:0x%" PRIx32 ":%" PRIu16 ".%" PRIu8 "\n"
+				      "Abort!", queue, ipv4_dst, port_dst, proto,
+				      fp->ipv4, fp->port, fp->proto);
+		}
 	}
 
 	/* Send to the next stage for further processing. */
@@ -829,6 +848,7 @@ receive_packet_eo_3rd(void *eo_context, em_event_t event, em_event_type_t type,
 		      em_queue_t queue, void *queue_context)
 {
 	queue_context_3rd_t *const q_ctx = queue_context;
+	em_event_t *pkt_tbl;
 	int in_port;
 	int out_port;
 	em_queue_t pktout_queue;
@@ -843,7 +863,15 @@ receive_packet_eo_3rd(void *eo_context, em_event_t event, em_event_type_t type,
 		return;
 	}
 
-	in_port = pktio_input_port(event);
+	/* A vector of same-flow pkts, all from the same port */
+	const uint32_t num = pktio_pkt_tbl(&event, &pkt_tbl /*out*/);
+
+	if (unlikely(num == 0)) {
+		em_free(event);
+		return;
+	}
+
+	in_port = pktio_input_port(pkt_tbl[0]);
 
 	if (X_CONNECT_PORTS)
 		out_port = IS_EVEN(in_port) ? in_port + 1 : in_port - 1;
@@ -852,11 +880,13 @@ receive_packet_eo_3rd(void *eo_context, em_event_t event, em_event_type_t type,
 
 	pktout_queue = q_ctx->pktout_queue[out_port];
 
-	/* Touch packet. Swap MAC, IP-addrs and UDP-ports: scr<->dst */
-	pktio_swap_addrs(event);
+	for (uint32_t i = 0; i < num; i++) {
+		/* Touch packet. Swap MAC, IP-addrs and UDP-ports: scr<->dst */
+		pktio_swap_addrs(pkt_tbl[i]);
 
-	if (ALLOC_COPY_FREE)
-		event = alloc_copy_free(event);
+		if (ALLOC_COPY_FREE)
+			pkt_tbl[i] = alloc_copy_free(pkt_tbl[i]);
+	}
 
 	/*
 	 * Send the packet buffer back out via the pktout queue through
@@ -955,6 +985,22 @@ queue_types(int cnt)
 	}
 }
 
+/**
+ * Helper func, returns the queue conf for a 2nd or 3rd stage queue,
+ * NULL for the defaults
+ */
+static const em_queue_conf_t *
+stage_queue_conf(em_queue_type_t queue_type, em_queue_conf_t *conf /*out*/)
+{
+	if (!QUEUE_INLINE_SEND || queue_type != EM_QUEUE_TYPE_PARALLEL)
+		return NULL;
+
+	memset(conf, 0, sizeof(*conf));
+	conf->flags = EM_QUEUE_FLAG_INLINE;
+
+	return conf;
+}
+
 /**
  * Helper func to store the packet output queues for a specific input queue
  */
@@ -52,6 +52,7 @@
 
 #include "cm_setup.h"
 #include "cm_error_handler.h"
+#include "cm_loadgen.h"
 
 /*
  * Test configuration
@@ -114,6 +115,8 @@ typedef struct {
 	em_eo_t eo_tbl[NUM_EO];
 	/* Event pool used by this application */
 	em_pool_t pool;
+	/* Events are sent by the open-loop load generator (-l) */
+	bool loadgen;
 } perf_shm_t;
 
 /** EM-core local pointer to shared memory */
@@ -221,11 +224,15 @@ test_start(appl_conf_t *const appl_conf)
 	test_fatal_if(perf_shm->pool == EM_POOL_UNDEF,
 		      "Undefined application event pool!");
 
+	perf_shm->loadgen = loadgen_enabled();
+
 	/*
 	 * Create and start application EOs
 	 * Send initial test events to the EOs' queues
 	 */
 	em_queue_t queues[NUM_EO];
+	/* all cores, except the load generator core if in use */
+	em_queue_group_t queue_group = loadgen_queue_group();
 
 	for (int i = 0; i < NUM_EO; i++) {
 		em_queue_t queue;
@@ -235,7 +242,7 @@ test_start(appl_conf_t *const appl_conf)
 		/* Create the EO's loop queue */
 		queue = em_queue_create("queue A", QUEUE_TYPE,
 					EM_QUEUE_PRIO_NORMAL,
-					EM_QUEUE_GROUP_DEFAULT, NULL);
+					queue_group, NULL);
 		test_fatal_if(queue == EM_QUEUE_UNDEF,
 			      "Queue creation failed, round:%d", i);
 		queues[i] = queue;
@@ -259,6 +266,14 @@ test_start(appl_conf_t *const appl_conf)
 			      ret, start_ret);
 	}
 
+	if (perf_shm->loadgen) {
+		/* Open-loop: latency over one loop, i.e. two receives */
+		loadgen_start(queues, NUM_EO, perf_shm->pool,
+			      sizeof(perf_event_t), 2);
+		env_sync_mem();
+		return;
+	}
+
 	for (int i = 0; i < NUM_EO; i++) {
 		em_queue_t queue = queues[i];
 		em_event_t events[NUM_EVENT_PER_QUEUE];
@@ -396,6 +411,10 @@ perf_receive(void *eo_context, em_event_t event, em_event_type_t type,
 		return;
 	}
 
+	/* Load generator events are freed after the last hop */
+	if (perf_shm->loadgen && loadgen_receive(event))
+		return;
+
 	if (unlikely(events == 0)) {
 		/* Start the measurement */
 		core_stat.begin_cycles = env_get_cycle();
@@ -409,7 +428,7 @@ perf_receive(void *eo_context, em_event_t event, em_event_type_t type,
 		events = -1; /* +1 below => 0 */
 	}
 
-	if (ALLOC_FREE_PER_EVENT) {
+	if (ALLOC_FREE_PER_EVENT && !perf_shm->loadgen) {
 		em_free(event);
 		event = em_alloc(sizeof(perf_event_t), EM_EVENT_TYPE_SW,
 				 perf_shm->pool);
@@ -52,6 +52,7 @@
 
 #include "cm_setup.h"
 #include "cm_error_handler.h"
+#include "cm_loadgen.h"
 
 /*
  * Test configuration
@@ -127,6 +128,8 @@ typedef struct {
 	em_eo_t eo_tbl[NUM_EO];
 	/* Event pool used by this application */
 	em_pool_t pool;
+	/* Events are sent by the open-loop load generator (-l) */
+	bool loadgen;
 } perf_shm_t;
 
 /** EM-core local pointer to shared memory */
@@ -237,12 +240,16 @@ test_start(appl_conf_t *const appl_conf)
 	test_fatal_if(perf_shm->pool == EM_POOL_UNDEF,
 		      "Undefined application event pool!");
 
+	perf_shm->loadgen = loadgen_enabled();
+
 	/*
 	 * Create and start application pairs.
 	 * Send initial test events to the queues.
 	 */
 	em_queue_t queues_a[NUM_EO / 2];
 	em_queue_t queues_b[NUM_EO / 2];
+	/* all cores, except the load generator core if in use */
+	em_queue_group_t queue_group = loadgen_queue_group();
 
 	for (int i = 0; i < NUM_EO / 2; i++) {
 		em_queue_t queue_a, queue_b;
@@ -253,10 +260,10 @@ test_start(appl_conf_t *const appl_conf)
 		/* Create both queues for the pair */
 		queue_a = em_queue_create("queue-A", QUEUE_TYPE,
 					  get_queue_priority(i),
-					  EM_QUEUE_GROUP_DEFAULT, NULL);
+					  queue_group, NULL);
 		queue_b = em_queue_create("queue-B", QUEUE_TYPE,
 					  get_queue_priority(i),
-					  EM_QUEUE_GROUP_DEFAULT, NULL);
+					  queue_group, NULL);
 		test_fatal_if(queue_a == EM_QUEUE_UNDEF ||
 			      queue_b == EM_QUEUE_UNDEF,
 			      "Queue creation failed, round:%d", i);
@@ -306,6 +313,14 @@ test_start(appl_conf_t *const appl_conf)
 			      ret, start_ret);
 	}
 
+	if (perf_shm->loadgen) {
+		/* Open-loop: events enter at the A-queues, latency over A -> B */
+		loadgen_start(queues_a, NUM_EO / 2, perf_shm->pool,
+			      sizeof(perf_event_t), 2);
+		env_sync_mem();
+		return;
+	}
+
 	for (int i = 0; i < NUM_EO / 2; i++) {
 		em_queue_t queue_a = queues_a[i];
 		em_queue_t queue_b = queues_b[i];
@@ -465,6 +480,10 @@ perf_receive(void *eo_context, em_event_t event, em_event_type_t type,
 		return;
 	}
 
+	/* Load generator events are freed after the last hop */
+	if (perf_shm->loadgen && loadgen_receive(event))
+		return;
+
 	if (unlikely(events == 0)) {
 		/* Start the measurement */
 		core_stat.begin_cycles = env_get_cycle();
@@ -478,7 +497,7 @@ perf_receive(void *eo_context, em_event_t event, em_event_type_t type,
 		events = -1; /* +1 below => 0 */
 	}
 
-	if (ALLOC_FREE_PER_EVENT) {
+	if (ALLOC_FREE_PER_EVENT && !perf_shm->loadgen) {
 		em_free(event);
 		event = em_alloc(sizeof(perf_event_t), EM_EVENT_TYPE_SW,
 				 perf_shm->pool);
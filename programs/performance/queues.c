@@ -53,6 +53,7 @@
 
 #include "cm_setup.h"
 #include "cm_error_handler.h"
+#include "cm_loadgen.h"
 
 /*
  * Test options:
@@ -232,6 +233,8 @@ typedef struct {
 typedef struct {
 	/* Event pool used by this application */
 	em_pool_t pool;
+	/* Events are sent by the open-loop load generator (-l) */
+	bool loadgen;
 
 	test_status_t test_status ENV_CACHE_LINE_ALIGNED;
 
@@ -272,6 +275,9 @@ receive_func(void *eo_context, em_event_t event, em_event_type_t type,
 static int
 update_test_state(em_event_t event);
 
+static void
+loadgen_forward(em_event_t event, const queue_context_t *q_ctx);
+
 static void
 create_and_link_queues(int start_queue, int num_queues);
 
@@ -415,6 +421,8 @@ test_start(appl_conf_t *const appl_conf)
 	env_atomic64_init(&perf_shm->test_status.ready_count);
 	env_atomic64_init(&perf_shm->test_status.freed_count);
 
+	perf_shm->loadgen = loadgen_enabled();
+
 	/* Create EOs */
 	for (i = 0; i < NUM_EOS; i++) {
 		eo_ctx = &perf_shm->eo_context_tbl[i];
@@ -443,6 +451,24 @@ test_start(appl_conf_t *const appl_conf)
 			      i, ret, start_ret);
 	}
 
+	if (perf_shm->loadgen) {
+		/*
+		 * Open-loop: no queue steps, events enter at the first queue of
+		 * each ring and the latency is measured over the whole ring.
+		 */
+		const int num_queues = CREATE_ALL_QUEUES_AT_STARTUP ?
+				       NUM_QUEUES : queue_steps[0];
+		const int num_rings = MIN(num_queues / NUM_EOS, LOADGEN_MAX_QUEUES);
+		em_queue_t ring_queues[LOADGEN_MAX_QUEUES];
+
+		for (i = 0; i < num_rings; i++)
+			ring_queues[i] = perf_shm->queue_context_tbl[i * NUM_EOS].this_queue;
+
+		loadgen_start(ring_queues, num_rings, perf_shm->pool,
+			      sizeof(perf_event_t), NUM_EOS);
+		return;
+	}
+
 	queue_step();
 }
 
@@ -629,6 +655,13 @@ receive_func(void *eo_context, em_event_t event, em_event_type_t type,
 		return;
 	}
 
+	/* Load generator events are freed after the last hop */
+	if (perf_shm->loadgen) {
+		if (!loadgen_receive(event))
+			loadgen_forward(event, q_context);
+		return;
+	}
+
 	if (MEASURE_LATENCY) {
 		recv_time = env_time_global();
 		perf_event = em_event_pointer(event);
@@ -672,6 +705,25 @@ receive_func(void *eo_context, em_event_t event, em_event_type_t type,
 	}
 }
 
+/**
+ * Receive function helper: Forward a load generator event to the next queue
+ *
+ * The queue steps and the latency measurement of the test are not used in
+ * open-loop mode, the load generator reports the results.
+ */
+static void
+loadgen_forward(em_event_t event, const queue_context_t *q_ctx)
+{
+	em_status_t ret = em_send(event, q_ctx->next_queue);
+
+	if (unlikely(ret != EM_OK)) {
+		em_free(event);
+		test_fatal_if(!appl_shm->exit_flag,
+			      "EM send:%" PRI_STAT " Queue:%" PRI_QUEUE "",
+			      ret, q_ctx->next_queue);
+	}
+}
+
 /**
  * Receive function helper: Update the test state
  *
@@ -846,7 +898,7 @@ create_and_link_queues(int start_queue, int num_queues)
 
 			type = QUEUE_TYPE;
 			queue = em_queue_create("queue", type, prio,
-						EM_QUEUE_GROUP_DEFAULT, NULL);
+						loadgen_queue_group(), NULL);
 			if (queue == EM_QUEUE_UNDEF) {
 				APPL_PRINT("Max nbr of supported queues: %d\n",
 					   i);
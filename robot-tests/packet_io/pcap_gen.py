@@ -0,0 +1,49 @@
+#
+# Copyright (c) 2023, Nokia
+# All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Robot keyword library: write pcap files for the packet-io replay tests
+# ('-R, --pktio-replay'), so that the tests need no capture files or NICs.
+#
+
+import struct
+
+PCAP_MAGIC = 0xa1b2c3d4
+LINKTYPE_ETHERNET = 1
+PKT_LEN = 60
+
+
+def _ip_checksum(hdr):
+    total = sum(struct.unpack('!%dH' % (len(hdr) // 2), hdr))
+    while total >> 16:
+        total = (total & 0xffff) + (total >> 16)
+    return ~total & 0xffff
+
+
+def _udp_pkt(src_ip, dst_ip, dst_port):
+    payload = bytes(PKT_LEN - 14 - 20 - 8)
+    udp = struct.pack('!HHHH', 1024, dst_port, 8 + len(payload), 0)
+    ip = struct.pack('!BBHHHBBH4s4s', 0x45, 0, 20 + len(udp) + len(payload),
+                     0, 0, 64, 17, 0, src_ip, dst_ip)
+    ip = ip[:10] + struct.pack('!H', _ip_checksum(ip)) + ip[12:]
+    eth = bytes.fromhex('020000000001' '020000000002' '0800')
+    return eth + ip + udp + payload
+
+
+def write_udp_pcap(path, num_pkts=64, dst_ip='192.168.1.16', base_port=1024):
+    """Write ``num_pkts`` IPv4/UDP packets to ``dst_ip``, one per UDP port
+    starting from ``base_port``, into the classic pcap file ``path``."""
+    num_pkts = int(num_pkts)
+    base_port = int(base_port)
+    src = bytes([10, 0, 0, 1])
+    dst = bytes(int(b) for b in dst_ip.split('.'))
+
+    with open(path, 'wb') as f:
+        f.write(struct.pack('<IHHiIII', PCAP_MAGIC, 2, 4, 0, 0, 65535,
+                            LINKTYPE_ETHERNET))
+        for i in range(num_pkts):
+            pkt = _udp_pkt(src, dst, base_port + i)
+            f.write(struct.pack('<IIII', i, 0, len(pkt), len(pkt)))
+            f.write(pkt)
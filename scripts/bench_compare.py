@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023, Nokia
+# All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Compare programs/bench results against a stored baseline.
+#
+# The bench programs write their results with '-o <file>' (JSON format). This
+# script checks the selected metric (average cost per API call by default) of
+# each test case listed in the baseline file and fails if it has grown more
+# than the tolerance of the test case, e.g. 10% for em_alloc + em_free.
+#
+# Baseline file format:
+# {
+#   "metric": "avg",            # avg, p50, p99 or max
+#   "tolerance": 10,            # default allowed growth in percent
+#   "programs": {
+#     "bench_event": {
+#       "unit": "cycles",       # must match the results
+#       "workers": 1,           # must match the results
+#       "results": {
+#         "event_alloc_free(sw)": {"baseline": 95.5, "tolerance": 10},
+#         ...
+#       }
+#     }
+#   }
+# }
+#
+# A test case with "baseline": null has no recorded value yet and cannot be
+# checked, nor can a program missing from the baseline. Record the values of
+# the local machine with --update:
+#   scripts/bench_compare.py -b <baseline> --update bench_event.json ...
+#
+# Exit status: 0 = no regressions, 1 = regressions or missing results, 2 = error,
+# 3 = no regressions but some test cases were not checked (no baseline value).
+
+import argparse
+import json
+import sys
+
+METRICS = ('avg', 'p50', 'p99', 'max')
+DEFAULT_TOLERANCE = 10.0
+
+
+def error(msg):
+    print('Error: ' + msg, file=sys.stderr)
+    sys.exit(2)
+
+
+def load_json(path):
+    try:
+        with open(path) as f:
+            return json.load(f)
+    except (OSError, ValueError) as e:
+        error('reading %s failed: %s' % (path, e))
+
+
+def load_results(paths):
+    """Return {program: results file content} of the given result files"""
+    programs = {}
+
+    for path in paths:
+        res = load_json(path)
+        if 'program' not in res or 'results' not in res:
+            error('%s is not a bench result file' % path)
+        if res['program'] in programs:
+            error('%s: duplicate results for %s' % (path, res['program']))
+        programs[res['program']] = res
+
+    return programs
+
+
+def check_program(name, base_prog, res, metric, def_tol):
+    """Compare the results of one program, return (failures, unchecked)"""
+    regressions = 0
+    unchecked = 0
+
+    for key in ('unit', 'workers'):
+        if key in base_prog and base_prog[key] != res.get(key):
+            error('%s: %s %s does not match the baseline (%s)' %
+                  (name, key, res.get(key), base_prog[key]))
+
+    values = {r['name']: r[metric] for r in res['results']}
+
+    for test, base in sorted(base_prog.get('results', {}).items()):
+        tol = base.get('tolerance', def_tol)
+        ref = base.get('baseline')
+        label = '%s: %s' % (name, test)
+
+        if test not in values:
+            print('%-60s %12s %12s  MISSING' % (label, '-', '-'))
+            regressions += 1
+            continue
+
+        value = values[test]
+        if ref is None:
+            print('%-60s %12s %12.2f  NO BASELINE' % (label, '-', value))
+            unchecked += 1
+            continue
+
+        diff = (value - ref) * 100.0 / ref if ref else 0.0
+        status = 'OK'
+        if diff > tol:
+            status = 'REGRESSION'
+            regressions += 1
+        elif diff < -tol:
+            status = 'IMPROVED'
+
+        print('%-60s %12.2f %12.2f %+8.1f%% (max %+.1f%%)  %s' %
+              (label, ref, value, diff, tol, status))
+
+    return regressions, unchecked
+
+
+def compare(baseline, programs):
+    metric = baseline.get('metric', 'avg')
+    def_tol = baseline.get('tolerance', DEFAULT_TOLERANCE)
+    regressions = 0
+    unchecked = 0
+
+    if metric not in METRICS:
+        error('unknown metric "%s"' % metric)
+
+    print('%-60s %12s %12s %9s' % ('Test case (' + metric + ')', 'Baseline',
+                                   'Result', 'Change'))
+
+    for name, res in sorted(programs.items()):
+        base_prog = baseline.get('programs', {}).get(name)
+        if base_prog is None:
+            print('%s: NOT IN THE BASELINE, not checked' % name)
+            unchecked += 1
+            continue
+        failed, skipped = check_program(name, base_prog, res, metric, def_tol)
+        regressions += failed
+        unchecked += skipped
+
+    if regressions:
+        print('\n%d regression(s) or missing result(s) found' % regressions)
+        return 1
+
+    if unchecked:
+        print('\nNo regressions, but %d test case(s) or program(s) have no '
+              'baseline value and were NOT checked, record them with --update'
+              % unchecked)
+        return 3
+
+    print('\nNo regressions')
+    return 0
+
+
+def update(baseline, programs, path, add_all):
+    """Record the results as the new baseline values, keep the tolerances"""
+    metric = baseline.setdefault('metric', 'avg')
+    baseline.setdefault('tolerance', DEFAULT_TOLERANCE)
+    base_progs = baseline.setdefault('programs', {})
+
+    for name, res in programs.items():
+        if name not in base_progs and not add_all:
+            continue
+
+        base_prog = base_progs.setdefault(name, {})
+        base_prog['unit'] = res['unit']
+        base_prog['workers'] = res['workers']
+        tests = base_prog.setdefault('results', {})
+
+        for r in res['results']:
+            if r['name'] in tests:
+                tests[r['name']]['baseline'] = r[metric]
+            elif add_all:
+                tests[r['name']] = {'baseline': r[metric]}
+
+    with open(path, 'w') as f:
+        json.dump(baseline, f, indent=2)
+        f.write('\n')
+
+    print('Baseline %s updated' % path)
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Check bench results (JSON, written with -o) against a '
+                    'stored baseline')
+    parser.add_argument('-b', '--baseline', required=True,
+                        help='baseline file')
+    parser.add_argument('-u', '--update', action='store_true',
+                        help='store the results as the new baseline values '
+                             'instead of comparing')
+    parser.add_argument('-a', '--all', action='store_true',
+                        help='with --update: add all test cases of the results '
+                             'to the baseline, not only the listed ones')
+    parser.add_argument('results', nargs='+', help='bench result files')
+    args = parser.parse_args()
+
+    baseline = load_json(args.baseline)
+    programs = load_results(args.results)
+
+    if args.update:
+        return update(baseline, programs, args.baseline, args.all)
+
+    return compare(baseline, programs)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023, Nokia
+# All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Convert an EM event trace dump into the Chrome trace event JSON format.
+#
+# The trace is written by the EM CLI command 'em_trace -w <file>', see the
+# 'trace' section in config/em-odp.conf. Open the resulting JSON file in
+# https://ui.perfetto.dev or chrome://tracing:
+#   - one track per EM-core
+#   - EO receive calls as slices named after the EO
+#   - em_send/alloc/free and timeout events as instant events
+#   - consecutive empty schedule rounds as "idle" slices
+#
+# Usage: scripts/em_trace2json.py <trace file> [-o <json file>]
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b'EMTRACE\0'
+VERSION = 1
+
+HDR = struct.Struct('=8sIIIIQ')
+CORE_HDR = struct.Struct('=II')
+REC = struct.Struct('=QBBHIQQ')
+U32 = struct.Struct('=I')
+U64 = struct.Struct('=Q')
+
+(T_NONE, T_DISPATCH_ENTER, T_DISPATCH_EXIT, T_SEND, T_ALLOC, T_FREE,
+ T_TIMER_FIRE, T_SCHED_EMPTY) = range(8)
+
+TMO_TYPES = {1: 'oneshot', 2: 'periodic'}
+
+
+def error(msg):
+    print('Error: ' + msg, file=sys.stderr)
+    sys.exit(2)
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def unpack(self, st):
+        if self.pos + st.size > len(self.data):
+            error('truncated trace file')
+        val = st.unpack_from(self.data, self.pos)
+        self.pos += st.size
+        return val
+
+    def names(self, name_len):
+        (num,) = self.unpack(U32)
+        names = {}
+        for _ in range(num):
+            (hdl,) = self.unpack(U64)
+            raw = self.data[self.pos:self.pos + name_len]
+            self.pos += name_len
+            names[hdl] = raw.split(b'\0', 1)[0].decode(errors='replace')
+        return names
+
+
+def read_trace(path):
+    """Return (cores {core: [records]}, eo names, queue names)"""
+    try:
+        with open(path, 'rb') as f:
+            data = f.read()
+    except OSError as e:
+        error('reading %s failed: %s' % (path, e))
+
+    rd = Reader(data)
+    magic, version, rec_size, num_cores, name_len, _ = rd.unpack(HDR)
+    if magic != MAGIC:
+        error('%s is not an EM trace file' % path)
+    if version != VERSION or rec_size != REC.size:
+        error('unsupported trace file version %u (record size %u)' %
+              (version, rec_size))
+
+    cores = {}
+    for _ in range(num_cores):
+        core, num = rd.unpack(CORE_HDR)
+        cores[core] = [rd.unpack(REC) for _ in range(num)]
+
+    eos = rd.names(name_len)
+    queues = rd.names(name_len)
+
+    return cores, eos, queues
+
+
+def hdl_name(names, hdl, kind):
+    name = names.get(hdl)
+    return name if name else '%s-0x%x' % (kind, hdl)
+
+
+def convert(cores, eos, queues):
+    events = [{'name': 'process_name', 'ph': 'M', 'pid': 0,
+               'args': {'name': 'EM'}}]
+
+    start = min((recs[0][0] for recs in cores.values() if recs), default=0)
+
+    def us(ts_ns):
+        return (ts_ns - start) / 1000.0
+
+    for core, recs in sorted(cores.items()):
+        events.append({'name': 'thread_name', 'ph': 'M', 'pid': 0,
+                       'tid': core, 'args': {'name': 'EM-core%02d' % core}})
+        in_dispatch = False
+        last_ts = start
+
+        for ts, typ, _, num, aux, a, b in recs:
+            ev = {'pid': 0, 'tid': core, 'ts': us(ts)}
+            last_ts = ts
+
+            if typ == T_DISPATCH_ENTER:
+                ev.update(name=hdl_name(eos, a, 'eo'), ph='B', cat='dispatch',
+                          args={'queue': hdl_name(queues, b, 'queue'),
+                                'events': num, 'event_type': '0x%x' % aux})
+                in_dispatch = True
+            elif typ == T_DISPATCH_EXIT:
+                # The matching enter record may have been overwritten
+                if not in_dispatch:
+                    continue
+                ev.update(ph='E', cat='dispatch')
+                in_dispatch = False
+            elif typ == T_SEND:
+                ev.update(name='send', ph='i', s='t', cat='event',
+                          args={'queue': hdl_name(queues, a, 'queue'),
+                                'event': '0x%x' % b, 'events': num})
+            elif typ == T_ALLOC:
+                ev.update(name='alloc', ph='i', s='t', cat='event',
+                          args={'pool': '0x%x' % a, 'event': '0x%x' % b,
+                                'events': num, 'size': aux})
+            elif typ == T_FREE:
+                ev.update(name='free', ph='i', s='t', cat='event',
+                          args={'event': '0x%x' % b, 'events': num})
+            elif typ == T_TIMER_FIRE:
+                ev.update(name='timeout', ph='i', s='t', cat='timer',
+                          args={'eo': hdl_name(eos, a, 'eo'),
+                                'event': '0x%x' % b,
+                                'tmo_type': TMO_TYPES.get(aux, aux)})
+            elif typ == T_SCHED_EMPTY:
+                ev.update(name='idle', ph='X', cat='sched', dur=aux / 1000.0,
+                          args={'rounds': num})
+            else:
+                continue
+            events.append(ev)
+
+        if in_dispatch:
+            events.append({'pid': 0, 'tid': core, 'ts': us(last_ts),
+                           'ph': 'E', 'cat': 'dispatch'})
+
+    return {'traceEvents': events, 'displayTimeUnit': 'ns'}
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Convert an EM event trace dump into Chrome trace JSON')
+    parser.add_argument('trace', help='trace file written by em_trace -w')
+    parser.add_argument('-o', '--output', help='output JSON file '
+                        '(default: stdout)')
+    args = parser.parse_args()
+
+    cores, eos, queues = read_trace(args.trace)
+    out = convert(cores, eos, queues)
+
+    if args.output:
+        try:
+            with open(args.output, 'w') as f:
+                json.dump(out, f)
+        except OSError as e:
+            error('writing %s failed: %s' % (args.output, e))
+        num = sum(len(recs) for recs in cores.values())
+        print('%d records from %d cores written into %s' %
+              (num, len(cores), args.output))
+    else:
+        json.dump(out, sys.stdout)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -16,18 +16,26 @@ declare -A apps
 # Example Apps
 apps["api_hooks"]=programs/example/api-hooks/api_hooks
 apps["dispatcher_callback"]=programs/example/dispatcher/dispatcher_callback
+apps["dispatch_prio"]=programs/example/dispatcher/dispatch_prio
+apps["dispatch_defer"]=programs/example/dispatcher/dispatch_defer
+apps["core_util"]=programs/example/dispatcher/core_util
+apps["coro_yield"]=programs/example/dispatcher/coro_yield
 # emcli runs hello program with em-odp.conf cli.enable=true and checks extra regex"
 apps["emcli"]=programs/example/hello/hello
 apps["error"]=programs/example/error/error
+apps["event_headroom"]=programs/example/event/event_headroom
+apps["event_imm"]=programs/example/event/event_imm
 apps["event_group_abort"]=programs/example/event_group/event_group_abort
 apps["event_group_assign_end"]=programs/example/event_group/event_group_assign_end
 apps["event_group_chaining"]=programs/example/event_group/event_group_chaining
 apps["event_group"]=programs/example/event_group/event_group
 apps["fractal"]=programs/example/fractal/fractal
+apps["pool_wmark"]=programs/example/pool/pool_wmark
 apps["hello"]=programs/example/hello/hello
 apps["ordered"]=programs/example/queue/ordered
 apps["queue_types_ag"]=programs/example/queue/queue_types_ag
 apps["queue_types_local"]=programs/example/queue/queue_types_local
+apps["queue_stats"]=programs/example/queue/queue_stats
 apps["queue_group"]=programs/example/queue_group/queue_group
 apps["timer_hello"]=programs/example/add-ons/timer_hello
 apps["timer_test"]=programs/example/add-ons/timer_test
@@ -48,6 +56,9 @@ apps["pool_perf"]=programs/performance/pool_perf
 apps["scheduling_latency"]=programs/performance/scheduling_latency
 apps["timer_test_ring"]=programs/performance/timer_test_ring
 
+# Packet-io Apps, pcap replay (-R) instead of NICs
+apps["loopback_replay"]=programs/packet_io/loopback
+
 # Set up conf files for robot tests
 odp_conf="odp/config/odp-linux-generic.conf"
 # - set system.cpu_mhz = 2800
@@ -73,6 +84,8 @@ sed -i 's/prealloc_pools.*/prealloc_pools = false/' "${em_conf}"
 for app in "${!apps[@]}"; do
   if [[ "${apps[${app}]}" == *"example"* ]]; then
     robot_file_path="robot-tests/example"
+  elif [[ "${apps[${app}]}" == *"packet_io"* ]]; then
+    robot_file_path="robot-tests/packet_io"
   else
     robot_file_path="robot-tests/performance"
   fi
@@ -89,6 +102,12 @@ for app in "${!apps[@]}"; do
     sed -i '/^cli:\s{/,/^\t#\sIP\saddress/s/\tenable\s*=.*/\tenable = true/' "${em_conf}"
   fi
 
+  # Enable queue statistics for queue_stats test
+  #  - set queue.statistics = true
+  if [[ "${app}" == "queue_stats" ]]; then
+    sed -i '/^queue:\s{/,/^}/s/^\tstatistics\s*=.*/\tstatistics = true/' "${em_conf}"
+  fi
+
   for ((i = 0; i < ${#core_masks[@]}; i++)); do
     for ((j = 0; j < ${#modes[@]}; j++)); do
         ODP_CONFIG_FILE="${odp_conf}" \
@@ -1075,6 +1075,275 @@ static void cmd_em_egrp_print(int argc, char *argv[])
 	}
 }
 
+static void print_em_queue_stats_help(void)
+{
+	const char *usage = "Usage: em_queue_stats [OPTION]\n"
+			    "Print EM queue statistics (config: queue.statistics = true)\n"
+			    "\n"
+			    "Options:\n"
+			    "  -a, --all\t\t\tPrint the statistics of all active queues\n"
+			    "  -i, --id <queue id>\t\tPrint the statistics and sojourn time\n"
+			    "\t\t\t\thistogram of <queue id>\n"
+			    "  -n, --name <queue name>\tPrint the statistics and sojourn time\n"
+			    "\t\t\t\thistogram of <queue name>\n"
+			    "  -r, --reset\t\t\tReset the statistics of all queues\n"
+			    "  -h, --help\t\t\tDisplay this help\n";
+	odph_cli_log(usage);
+}
+
+static void print_em_queue_stats_all(void)
+{
+	core_log_fn_set(cli_log);
+	core_vlog_fn_set(cli_vlog);
+	queue_stats_print_all();
+	core_log_fn_set(NULL);
+	core_vlog_fn_set(NULL);
+}
+
+static void print_em_queue_stats(em_queue_t queue, const char *name)
+{
+	if (queue == EM_QUEUE_UNDEF) {
+		if (name)
+			odph_cli_log("Error: can't find queue %s\n", name);
+		else
+			odph_cli_log("Error: can't find queue %" PRI_QUEUE "\n", queue);
+		return;
+	}
+
+	core_log_fn_set(cli_log);
+	core_vlog_fn_set(cli_vlog);
+	em_queue_stats_print(queue);
+	core_log_fn_set(NULL);
+	core_vlog_fn_set(NULL);
+}
+
+static void cmd_em_queue_stats(int argc, char *argv[])
+{
+	/* em_queue_stats takes maximum 2 arguments */
+	const int max_args = 2;
+
+	/* When no argument is given, print the stats of all queues */
+	if (argc == 0) {
+		print_em_queue_stats_all();
+		return;
+	} else if (argc > max_args) {
+		odph_cli_log("Error: extra parameter given to command!\n");
+		return;
+	}
+
+	/* Construct argv_new with the command name, see cmd_em_eo_print() */
+	argc += 1/*Cmd str "em_queue_stats"*/ + 1/*Terminating NULL pointer*/;
+	char *argv_new[argc];
+	char cmd[MAX_CMD_LEN] = "em_queue_stats";
+
+	argv_new[0] = cmd;
+	for (int i = 1; i < argc - 1; i++)
+		argv_new[i] = argv[i - 1];
+	argv_new[argc - 1] = NULL; /*Terminating NULL pointer*/
+
+	em_queue_t queue;
+	int option;
+	struct optparse_long longopts[] = {
+		{"all", 'a', OPTPARSE_NONE},
+		{"id", 'i', OPTPARSE_REQUIRED},
+		{"name", 'n', OPTPARSE_REQUIRED},
+		{"reset", 'r', OPTPARSE_NONE},
+		{"help", 'h', OPTPARSE_NONE},
+		{0}
+	};
+	struct optparse options;
+
+	optparse_init(&options, argv_new);
+	options.permute = 0;
+	while (1) {
+		option = optparse_long(&options, longopts, NULL);
+		if (option == -1) /* No more options */
+			break;
+
+		switch (option) {
+		case 'a':
+			print_em_queue_stats_all();
+			break;
+		case 'i':
+			queue = (em_queue_t)(uintptr_t)(int)strtol(options.optarg, NULL, 0);
+			print_em_queue_stats(queue, NULL);
+			break;
+		case 'n':
+			queue = em_queue_find(options.optarg);
+			print_em_queue_stats(queue, options.optarg);
+			break;
+		case 'r':
+			queue_stats_reset_all();
+			odph_cli_log("EM queue statistics reset\n");
+			break;
+		case 'h':
+			print_em_queue_stats_help();
+			break;
+		case '?':
+			odph_cli_log("Error: %s\n", options.errmsg);
+			return;
+		default:
+			odph_cli_log("Unknown Error\n");
+			return;
+		}
+	}
+}
+
+static void cmd_em_core_util(int argc, char *argv[])
+{
+	(void)argv;
+
+	if (argc != 0) {
+		odph_cli_log("Error: extra parameter given to command!\n");
+		return;
+	}
+
+	core_log_fn_set(cli_log);
+	core_vlog_fn_set(cli_vlog);
+	em_core_util_print();
+	core_log_fn_set(NULL);
+	core_vlog_fn_set(NULL);
+}
+
+static void cmd_em_metrics(int argc, char *argv[])
+{
+	(void)argv;
+
+	if (argc != 0) {
+		odph_cli_log("Error: extra parameter given to command!\n");
+		return;
+	}
+
+	char *metrics = metrics_snapshot(NULL);
+
+	if (!metrics) {
+		odph_cli_log("Error: metrics snapshot failed\n");
+		return;
+	}
+
+	/* Log line by line, odph_cli_log() uses a limited size buffer */
+	for (char *line = metrics, *end; *line != '\0'; line = end + 1) {
+		end = strchr(line, '\n');
+		if (!end) {
+			odph_cli_log("%s\n", line);
+			break;
+		}
+		odph_cli_log("%.*s\n", (int)(end - line), line);
+	}
+
+	free(metrics);
+}
+
+static void print_em_trace_help(void)
+{
+	const char *usage = "Usage: em_trace [OPTION]\n"
+			    "Control the EM event trace\n"
+			    "\n"
+			    "Options:\n"
+			    "  -e, --enable\t\tStart tracing on all EM-cores\n"
+			    "  -d, --disable\t\tStop tracing on all EM-cores\n"
+			    "  -c, --clear\t\tDrop all recorded trace records\n"
+			    "  -w, --write <file>\tWrite the trace records into <file>,\n"
+			    "\t\t\tconvert with scripts/em_trace2json.py\n"
+			    "  -s, --status\t\tPrint the trace status\n"
+			    "  -h, --help\t\tDisplay this help\n";
+	odph_cli_log(usage);
+}
+
+static void print_em_trace_status(void)
+{
+	core_log_fn_set(cli_log);
+	core_vlog_fn_set(cli_vlog);
+	trace_info_print();
+	core_log_fn_set(NULL);
+	core_vlog_fn_set(NULL);
+}
+
+static void cmd_em_trace(int argc, char *argv[])
+{
+	/* Command em_trace takes maximum 2 arguments */
+	const int max_args = 2;
+
+	if (argc == 0) {
+		print_em_trace_status();
+		return;
+	} else if (argc > max_args) {
+		odph_cli_log("Error: extra parameter given to command!\n");
+		return;
+	}
+
+	/* Construct argv_new with the command name, see cmd_em_pool_stats() */
+	argc += 1/*Cmd str "em_trace"*/ + 1/*Terminating NULL pointer*/;
+	char *argv_new[argc];
+	char cmd[MAX_CMD_LEN] = "em_trace";
+
+	argv_new[0] = cmd;
+	for (int i = 1; i < argc - 1; i++)
+		argv_new[i] = argv[i - 1];
+	argv_new[argc - 1] = NULL; /*Terminating NULL pointer*/
+
+	int option;
+	int64_t num;
+	struct optparse_long longopts[] = {
+		{"enable", 'e', OPTPARSE_NONE},
+		{"disable", 'd', OPTPARSE_NONE},
+		{"clear", 'c', OPTPARSE_NONE},
+		{"write", 'w', OPTPARSE_REQUIRED},
+		{"status", 's', OPTPARSE_NONE},
+		{"help", 'h', OPTPARSE_NONE},
+		{0}
+	};
+	struct optparse options;
+
+	if (!EM_TRACE_ENABLE) {
+		odph_cli_log("EM trace not compiled in (EM_TRACE_ENABLE=0)\n");
+		return;
+	}
+
+	optparse_init(&options, argv_new);
+	options.permute = 0;
+	while (1) {
+		option = optparse_long(&options, longopts, NULL);
+		if (option == -1) /* No more options */
+			break;
+
+		switch (option) {
+		case 'e':
+			trace_enable(true);
+			odph_cli_log("EM trace enabled\n");
+			break;
+		case 'd':
+			trace_enable(false);
+			odph_cli_log("EM trace disabled\n");
+			break;
+		case 'c':
+			trace_clear();
+			odph_cli_log("EM trace cleared\n");
+			break;
+		case 'w':
+			num = trace_dump(options.optarg);
+			if (num < 0)
+				odph_cli_log("Writing %s failed\n", options.optarg);
+			else
+				odph_cli_log("%" PRId64 " trace records written into %s\n",
+					     num, options.optarg);
+			break;
+		case 's':
+			print_em_trace_status();
+			break;
+		case 'h':
+			print_em_trace_help();
+			break;
+		case '?':
+			odph_cli_log("Error: %s\n", options.errmsg);
+			return;
+		default:
+			odph_cli_log("Unknown Error\n");
+			return;
+		}
+	}
+}
+
 static int cli_register_em_commands(void)
 {
 	/* Register em commands */
@@ -1130,6 +1399,28 @@ static int cli_register_em_commands(void)
 		return -1;
 	}
 
+	if (odph_cli_register_command("em_queue_stats", cmd_em_queue_stats,
+				      "[a|i <queue id>|n <queue name>|r|h]")) {
+		EM_LOG(EM_LOG_ERR, "Registering EM command em_queue_stats failed.\n");
+		return -1;
+	}
+
+	if (odph_cli_register_command("em_core_util", cmd_em_core_util, "")) {
+		EM_LOG(EM_LOG_ERR, "Registering EM command em_core_util failed.\n");
+		return -1;
+	}
+
+	if (odph_cli_register_command("em_metrics", cmd_em_metrics, "")) {
+		EM_LOG(EM_LOG_ERR, "Registering EM command em_metrics failed.\n");
+		return -1;
+	}
+
+	if (odph_cli_register_command("em_trace", cmd_em_trace,
+				      "[e|d|c|w <file>|s|h]")) {
+		EM_LOG(EM_LOG_ERR, "Registering EM command em_trace failed.\n");
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -141,6 +141,36 @@ void mask_em2odp(const em_core_mask_t *const em_core_mask,
 	}
 }
 
+void core_util_init_local(core_util_t *const util)
+{
+	/* The counters are cumulative over em_init_core() calls, only reset the state */
+	odp_atomic_store_u64(&util->state_ts, odp_time_global_ns());
+	odp_atomic_store_u32(&util->idle, 0);
+}
+
+void core_util_print(void)
+{
+	const int core_count = em_core_count();
+	em_core_util_t util;
+
+	EM_PRINT("EM Core Utilization\n"
+		 "-------------------\n"
+		 "Core  Busy(%%)  Busy(ms)      Idle(ms)      Rounds        Empty rounds  Events        Avg burst\n");
+
+	for (int i = 0; i < core_count; i++) {
+		if (em_core_util(i, &util) != EM_OK)
+			continue;
+
+		const uint64_t total_ns = util.busy_ns + util.idle_ns;
+
+		EM_PRINT("%-5d %-8.1f %-13" PRIu64 " %-13" PRIu64 " %-13" PRIu64 " %-13" PRIu64 " %-13" PRIu64 " %.1f\n",
+			 i, total_ns ? 100.0 * (double)util.busy_ns / (double)total_ns : 0.0,
+			 util.busy_ns / 1000000, util.idle_ns / 1000000,
+			 util.rounds, util.empty_rounds, util.events,
+			 util.rounds ? (double)util.events / (double)util.rounds : 0.0);
+	}
+}
+
 void mask_em2phys(const em_core_mask_t *const em_core_mask,
 		  odp_cpumask_t *const odp_cpumask /*out*/)
 {
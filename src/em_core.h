@@ -76,6 +76,43 @@ void mask_em2odp(const em_core_mask_t *const em_core_mask,
 void mask_em2phys(const em_core_mask_t *const em_core_mask,
 		  odp_cpumask_t *const odp_cpumask /*out*/);
 
+void core_util_init_local(core_util_t *const util);
+void core_util_print(void);
+
+/*
+ * Only the owning core writes its utilization counters: a load + store is
+ * enough, no need for an atomic read-modify-write.
+ */
+static inline void
+core_util_add(odp_atomic_u64_t *const cnt, uint64_t val)
+{
+	odp_atomic_store_u64(cnt, odp_atomic_load_u64(cnt) + val);
+}
+
+/* Account the time since the previous state change as busy (to_idle=true) or idle */
+static inline void
+core_util_state_change(core_util_t *const util, bool to_idle)
+{
+	const uint64_t now = odp_time_global_ns();
+	const uint64_t prev = odp_atomic_load_u64(&util->state_ts);
+	const uint64_t ns = now > prev ? now - prev : 0;
+
+	core_util_add(to_idle ? &util->busy_ns : &util->idle_ns, ns);
+	odp_atomic_store_u64(&util->state_ts, now);
+	odp_atomic_store_u32(&util->idle, to_idle);
+}
+
+static inline void
+core_util_round(core_util_t *const util, int num_events)
+{
+	if (num_events > 0) {
+		core_util_add(&util->rounds, 1);
+		core_util_add(&util->events, num_events);
+	} else {
+		core_util_add(&util->empty_rounds, 1);
+	}
+}
+
 #ifdef __cplusplus
 }
 #endif
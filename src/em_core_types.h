@@ -78,6 +78,33 @@ COMPILE_TIME_ASSERT(EM_MAX_CORES - 1 <= UINT8_MAX,
 COMPILE_TIME_ASSERT(ODP_THREAD_COUNT_MAX - 1 <= UINT16_MAX,
 		    CORE_MAP_T__TYPE_ERROR2);
 
+/**
+ * EM-core utilization counters
+ *
+ * Written only by the owning EM-core, read by any thread, see em_core_util().
+ */
+typedef struct {
+	/** Time (ns, global time) of the latest idle <-> active state change */
+	odp_atomic_u64_t state_ts;
+	/** Time (ns) spent active up to 'state_ts' */
+	odp_atomic_u64_t busy_ns;
+	/** Time (ns) spent idle up to 'state_ts' */
+	odp_atomic_u64_t idle_ns;
+	/** Dispatch rounds that got events from the scheduler */
+	odp_atomic_u64_t rounds;
+	/** Dispatch rounds that got no events */
+	odp_atomic_u64_t empty_rounds;
+	/** Events received from the scheduler */
+	odp_atomic_u64_t events;
+	/** Current state: 1=idle, 0=active */
+	odp_atomic_u32_t idle;
+	/* Pad size to a multiple of cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} core_util_t ENV_CACHE_LINE_ALIGNED;
+
+COMPILE_TIME_ASSERT((sizeof(core_util_t) % ENV_CACHE_LINE_SIZE) == 0,
+		    CORE_UTIL_T__SIZE_ERROR);
+
 /**
  * EM spinlock - Cache line sized & aligned
  */
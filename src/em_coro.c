@@ -0,0 +1,430 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2023, Nokia Solutions and Networks
+ */
+
+#include "em_include.h"
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#if CORO_CTX_ASM
+/*
+ * Save the callee-saved registers on the current stack, store the stack
+ * pointer into '*save_sp', switch to 'sp' and restore the registers saved
+ * there. The frame layout must match coro_ctx_init().
+ */
+void em_coro_ctx_switch(void **save_sp, void *sp);
+
+#if defined(__x86_64__)
+/* Frame: mxcsr + x87 control word, r15, r14, r13, r12, rbx, rbp, return address */
+#define CORO_CTX_FRAME_WORDS 7
+
+__asm__(
+"	.text\n"
+"	.globl	em_coro_ctx_switch\n"
+"	.hidden	em_coro_ctx_switch\n"
+"	.type	em_coro_ctx_switch, @function\n"
+"	.p2align 4\n"
+"em_coro_ctx_switch:\n"
+"	pushq	%rbp\n"
+"	pushq	%rbx\n"
+"	pushq	%r12\n"
+"	pushq	%r13\n"
+"	pushq	%r14\n"
+"	pushq	%r15\n"
+"	subq	$8, %rsp\n"
+"	stmxcsr	(%rsp)\n"
+"	fnstcw	4(%rsp)\n"
+"	movq	%rsp, (%rdi)\n"
+"	movq	%rsi, %rsp\n"
+"	ldmxcsr	(%rsp)\n"
+"	fldcw	4(%rsp)\n"
+"	addq	$8, %rsp\n"
+"	popq	%r15\n"
+"	popq	%r14\n"
+"	popq	%r13\n"
+"	popq	%r12\n"
+"	popq	%rbx\n"
+"	popq	%rbp\n"
+"	ret\n"
+"	.size	em_coro_ctx_switch, .-em_coro_ctx_switch\n"
+);
+#elif defined(__aarch64__)
+/* Frame: x19-x28, x29 (fp), x30 (lr), d8-d15, padding to 16 bytes */
+#define CORO_CTX_FRAME_WORDS 22
+
+__asm__(
+"	.text\n"
+"	.globl	em_coro_ctx_switch\n"
+"	.hidden	em_coro_ctx_switch\n"
+"	.type	em_coro_ctx_switch, %function\n"
+"	.p2align 4\n"
+"em_coro_ctx_switch:\n"
+"	sub	sp, sp, #176\n"
+"	stp	x19, x20, [sp, #0]\n"
+"	stp	x21, x22, [sp, #16]\n"
+"	stp	x23, x24, [sp, #32]\n"
+"	stp	x25, x26, [sp, #48]\n"
+"	stp	x27, x28, [sp, #64]\n"
+"	stp	x29, x30, [sp, #80]\n"
+"	stp	d8, d9, [sp, #96]\n"
+"	stp	d10, d11, [sp, #112]\n"
+"	stp	d12, d13, [sp, #128]\n"
+"	stp	d14, d15, [sp, #144]\n"
+"	mov	x2, sp\n"
+"	str	x2, [x0]\n"
+"	mov	sp, x1\n"
+"	ldp	x19, x20, [sp, #0]\n"
+"	ldp	x21, x22, [sp, #16]\n"
+"	ldp	x23, x24, [sp, #32]\n"
+"	ldp	x25, x26, [sp, #48]\n"
+"	ldp	x27, x28, [sp, #64]\n"
+"	ldp	x29, x30, [sp, #80]\n"
+"	ldp	d8, d9, [sp, #96]\n"
+"	ldp	d10, d11, [sp, #112]\n"
+"	ldp	d12, d13, [sp, #128]\n"
+"	ldp	d14, d15, [sp, #144]\n"
+"	add	sp, sp, #176\n"
+"	ret\n"
+"	.size	em_coro_ctx_switch, .-em_coro_ctx_switch\n"
+);
+#endif
+
+static inline void coro_ctx_swap(coro_ctx_t *save, const coro_ctx_t *to)
+{
+	em_coro_ctx_switch(&save->sp, to->sp);
+}
+
+/*
+ * Build the initial frame on the top of the stack: the first switch to the
+ * coroutine "returns" into 'entry' with the stack aligned as after a call.
+ */
+static int coro_ctx_init(coro_ctx_t *ctx, void *stack, size_t size, void (*entry)(void))
+{
+	const uintptr_t top = ((uintptr_t)stack + size) & ~(uintptr_t)15;
+	uint64_t *frame;
+
+#if defined(__x86_64__)
+	/* return address of 'entry' (never used) keeps rsp % 16 == 8 at entry */
+	frame = (uint64_t *)(top - (CORO_CTX_FRAME_WORDS + 2) * sizeof(uint64_t));
+	memset(frame, 0, (CORO_CTX_FRAME_WORDS + 2) * sizeof(uint64_t));
+	/* default mxcsr and x87 control word */
+	frame[0] = 0x1F80 | (UINT64_C(0x037F) << 32);
+	frame[CORO_CTX_FRAME_WORDS] = (uintptr_t)entry;
+#else
+	frame = (uint64_t *)(top - CORO_CTX_FRAME_WORDS * sizeof(uint64_t));
+	memset(frame, 0, CORO_CTX_FRAME_WORDS * sizeof(uint64_t));
+	/* x30 (lr) */
+	frame[11] = (uintptr_t)entry;
+#endif
+	ctx->sp = frame;
+
+	return 0;
+}
+#else /* !CORO_CTX_ASM */
+static inline void coro_ctx_swap(coro_ctx_t *save, const coro_ctx_t *to)
+{
+	swapcontext(save, to);
+}
+
+static int coro_ctx_init(coro_ctx_t *ctx, void *stack, size_t size, void (*entry)(void))
+{
+	if (unlikely(getcontext(ctx) != 0))
+		return -1;
+	ctx->uc_stack.ss_sp = stack;
+	ctx->uc_stack.ss_size = size;
+	ctx->uc_link = NULL;
+	makecontext(ctx, entry, 0);
+
+	return 0;
+}
+#endif /* CORO_CTX_ASM */
+
+/*
+ * Coroutine entry: run receive calls until the coroutine pool is freed.
+ * Each receive is handed over in 'em_locm.coro->current', the coroutine
+ * switches back to the dispatcher after each call so that makecontext() is
+ * only needed once per coroutine.
+ */
+static void coro_main(void)
+{
+	coro_locm_t *const cl = em_locm.coro;
+
+	for (;;) {
+		coro_t *const coro = cl->current;
+
+		coro->receive_func(coro->eo_ctx, coro->event, coro->event_type,
+				   coro->queue, coro->q_ctx);
+		coro->state = CORO_STATE_DONE;
+		coro_ctx_swap(&coro->ctx, &cl->main_ctx);
+	}
+}
+
+static coro_locm_t *coro_locm_alloc(void)
+{
+	coro_locm_t *const cl = calloc(1, sizeof(coro_locm_t));
+
+	if (unlikely(cl == NULL))
+		return NULL;
+
+	for (int i = EM_CORO_MAX_PER_CORE - 1; i >= 0; i--)
+		cl->free[cl->num_free++] = &cl->coro[i];
+	cl->deadline_ns = UINT64_MAX;
+
+	em_locm.coro = cl;
+	return cl;
+}
+
+/*
+ * Map the stack with a PROT_NONE guard page below it: a stack overflow
+ * faults instead of silently corrupting other memory.
+ */
+static int coro_stack_init(coro_t *const coro)
+{
+	const size_t page = (size_t)odp_sys_page_size();
+	const size_t stack_size = ROUND_UP(EM_CORO_STACK_SIZE, page);
+	const size_t map_size = page + stack_size;
+	uint8_t *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+			    MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+
+	if (unlikely(map == MAP_FAILED))
+		return -1;
+
+	if (unlikely(mprotect(map, page, PROT_NONE) != 0 ||
+		     coro_ctx_init(&coro->ctx, map + page, stack_size, coro_main) != 0)) {
+		munmap(map, map_size);
+		return -1;
+	}
+	coro->stack = map;
+	coro->stack_map_size = map_size;
+
+	return 0;
+}
+
+/*
+ * Switch from the dispatcher to a coroutine and, when it returns or parks,
+ * back into the free or parked list.
+ */
+static void coro_switch(coro_locm_t *const cl, coro_t *const coro)
+{
+	cl->current = coro;
+	coro->state = CORO_STATE_RUNNING;
+	coro_ctx_swap(&cl->main_ctx, &coro->ctx);
+	cl->current = NULL;
+
+	if (coro->state == CORO_STATE_PARKED) {
+		cl->parked[cl->num_parked++] = coro;
+	} else {
+		coro->state = CORO_STATE_FREE;
+		cl->free[cl->num_free++] = coro;
+	}
+}
+
+void coro_receive(em_receive_func_t receive_func, void *eo_ctx,
+		  em_event_t event, em_event_type_t event_type,
+		  em_queue_t queue, void *q_ctx, queue_elem_t *q_elem)
+{
+	coro_locm_t *cl = em_locm.coro;
+
+	if (unlikely(cl == NULL))
+		cl = coro_locm_alloc();
+
+	/*
+	 * Run on the dispatcher stack if no coroutine is available,
+	 * em_yield_until() then reports an error.
+	 */
+	if (unlikely(cl == NULL || cl->current != NULL || cl->num_free == 0)) {
+		receive_func(eo_ctx, event, event_type, queue, q_ctx);
+		return;
+	}
+
+	coro_t *const coro = cl->free[cl->num_free - 1];
+
+	if (unlikely(coro->stack == NULL && coro_stack_init(coro) != 0)) {
+		receive_func(eo_ctx, event, event_type, queue, q_ctx);
+		return;
+	}
+	cl->num_free--;
+
+	coro->receive_func = receive_func;
+	coro->eo_ctx = eo_ctx;
+	coro->event = event;
+	coro->event_type = event_type;
+	coro->queue = queue;
+	coro->q_ctx = q_ctx;
+	coro->q_elem = q_elem;
+
+	coro_switch(cl, coro);
+}
+
+/*
+ * Resume a parked coroutine outside of any scheduling context, the context
+ * was released when the coroutine parked.
+ */
+static void coro_resume(coro_locm_t *const cl, coro_t *const coro)
+{
+	em_locm_t *const locm = &em_locm;
+	const em_locm_current_t saved = locm->current;
+
+	locm->current.sched_context_type = EM_SCHED_CONTEXT_TYPE_NONE;
+	locm->current.rcv_multi_cnt = 1;
+	locm->current.q_elem = coro->q_elem;
+	locm->current.sched_q_elem = NULL;
+	locm->current.egrp = EM_EVENT_GROUP_UNDEF;
+	locm->current.egrp_elem = NULL;
+	locm->current.egrp_gen = 0;
+
+	coro_switch(cl, coro);
+
+	locm->current = saved;
+}
+
+void coro_poll(void)
+{
+	coro_locm_t *const cl = em_locm.coro;
+	const int num = cl->num_parked;
+	coro_t *ready[EM_CORO_MAX_PER_CORE];
+	int num_ready = 0;
+	int num_keep = 0;
+	uint64_t now = 0;
+	uint64_t deadline_ns = UINT64_MAX;
+
+	/* Collect first, the resumed coroutines might park again */
+	for (int i = 0; i < num; i++) {
+		coro_t *const coro = cl->parked[i];
+		em_event_t event = EM_EVENT_UNDEF;
+
+		/* Resume without an event if the EO's queue is no longer ready */
+		if (likely(coro->q_elem->state == EM_QUEUE_STATE_READY)) {
+			if (coro->wait_queue != EM_QUEUE_UNDEF)
+				event = em_queue_dequeue(coro->wait_queue);
+
+			if (event == EM_EVENT_UNDEF) {
+				if (coro->deadline_ns != UINT64_MAX && now == 0)
+					now = odp_time_global_ns();
+				if (coro->deadline_ns == UINT64_MAX ||
+				    now < coro->deadline_ns) {
+					cl->parked[num_keep++] = coro;
+					if (coro->deadline_ns < deadline_ns)
+						deadline_ns = coro->deadline_ns;
+					continue;
+				}
+			}
+		}
+
+		coro->result = event;
+		ready[num_ready++] = coro;
+	}
+	cl->num_parked = num_keep;
+	/* The resumed coroutines that park again update the deadline */
+	cl->deadline_ns = deadline_ns;
+
+	for (int i = 0; i < num_ready; i++)
+		coro_resume(cl, ready[i]);
+}
+
+em_status_t coro_term_local(void)
+{
+	coro_locm_t *const cl = em_locm.coro;
+	em_status_t stat = EM_OK;
+
+	if (cl == NULL)
+		return EM_OK;
+
+	if (unlikely(cl->num_parked > 0)) {
+		EM_LOG(EM_LOG_ERR, "EM-core%02d: %d coroutine(s) still parked\n",
+		       em_core_id(), cl->num_parked);
+		stat = EM_ERR_BAD_STATE;
+	}
+
+	for (int i = 0; i < EM_CORO_MAX_PER_CORE; i++) {
+		if (cl->coro[i].stack)
+			munmap(cl->coro[i].stack, cl->coro[i].stack_map_size);
+	}
+	free(cl);
+	em_locm.coro = NULL;
+
+	return stat;
+}
+
+em_status_t em_eo_coro_enable(em_eo_t eo)
+{
+	eo_elem_t *const eo_elem = eo_elem_get(eo);
+
+	RETURN_ERROR_IF(eo_elem == NULL, EM_ERR_BAD_ARG, EM_ESCOPE_EO_CORO_ENABLE,
+			"Invalid EO:%" PRI_EO "", eo);
+	RETURN_ERROR_IF(!eo_allocated(eo_elem), EM_ERR_NOT_CREATED,
+			EM_ESCOPE_EO_CORO_ENABLE, "EO:%" PRI_EO " not created", eo);
+	RETURN_ERROR_IF(eo_elem->use_multi_rcv, EM_ERR_NOT_SUPPORTED,
+			EM_ESCOPE_EO_CORO_ENABLE,
+			"EO:%" PRI_EO " uses a multi-event receive function", eo);
+
+	env_spinlock_lock(&eo_elem->lock);
+	const int num_queues = env_atomic32_get(&eo_elem->num_queues);
+
+	if (eo_elem->state == EM_EO_STATE_CREATED && num_queues == 0)
+		eo_elem->coro = true;
+	env_spinlock_unlock(&eo_elem->lock);
+
+	RETURN_ERROR_IF(!eo_elem->coro, EM_ERR_BAD_STATE, EM_ESCOPE_EO_CORO_ENABLE,
+			"EO:%" PRI_EO " already started or has queues (%d)",
+			eo, num_queues);
+
+	return EM_OK;
+}
+
+em_event_t em_yield_until(em_queue_t queue, uint64_t timeout_ns)
+{
+	em_locm_t *const locm = &em_locm;
+	coro_locm_t *const cl = locm->coro;
+	coro_t *const coro = cl ? cl->current : NULL;
+
+	if (unlikely(coro == NULL)) {
+		INTERNAL_ERROR(EM_ERR_BAD_CONTEXT, EM_ESCOPE_YIELD_UNTIL,
+			       "Not called from the receive function of a coroutine EO");
+		return EM_EVENT_UNDEF;
+	}
+
+	if (queue != EM_QUEUE_UNDEF) {
+		const queue_elem_t *q_elem = queue_elem_get(queue);
+
+		if (unlikely(!q_elem || !queue_allocated(q_elem) ||
+			     q_elem->type != EM_QUEUE_TYPE_UNSCHEDULED)) {
+			INTERNAL_ERROR(EM_ERR_BAD_ARG, EM_ESCOPE_YIELD_UNTIL,
+				       "Q:%" PRI_QUEUE " not an unscheduled queue",
+				       queue);
+			return EM_EVENT_UNDEF;
+		}
+
+		/* No need to park if the event is already there */
+		em_event_t event = em_queue_dequeue(queue);
+
+		if (event != EM_EVENT_UNDEF || timeout_ns == 0)
+			return event;
+	} else if (timeout_ns == 0) {
+		return EM_EVENT_UNDEF;
+	}
+
+	/*
+	 * Release the scheduling context, the dispatcher continues with other
+	 * events (also from the same queue) while the coroutine is parked.
+	 * Within a dispatch burst the context is released after the last event.
+	 */
+	if (locm->current.sched_context_type == EM_SCHED_CONTEXT_TYPE_ATOMIC)
+		em_atomic_processing_end();
+	else if (locm->current.sched_context_type == EM_SCHED_CONTEXT_TYPE_ORDERED)
+		em_ordered_processing_end();
+
+	coro->wait_queue = queue;
+	coro->deadline_ns = timeout_ns == EM_YIELD_FOREVER ?
+			    UINT64_MAX : odp_time_global_ns() + timeout_ns;
+	if (coro->deadline_ns < cl->deadline_ns)
+		cl->deadline_ns = coro->deadline_ns;
+	coro->result = EM_EVENT_UNDEF;
+	coro->state = CORO_STATE_PARKED;
+
+	coro_ctx_swap(&coro->ctx, &cl->main_ctx);
+
+	/* Resumed by coro_poll() on this core */
+	return coro->result;
+}
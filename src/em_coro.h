@@ -0,0 +1,83 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2023, Nokia Solutions and Networks
+ */
+
+/**
+ * @file
+ * EM internal coroutine EO functions
+ *
+ * The receive function of an EO enabled with em_eo_coro_enable() runs on a
+ * coroutine from a core-local pool. em_yield_until() parks the coroutine and
+ * returns to the dispatcher, which resumes the parked coroutines on the same
+ * core once the awaited event has arrived or the timeout has expired.
+ */
+
+#ifndef EM_CORO_H_
+#define EM_CORO_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Free the core-local coroutine pool, called from em_term_core() */
+em_status_t coro_term_local(void);
+
+/** Run an EO receive function on a coroutine */
+void coro_receive(em_receive_func_t receive_func, void *eo_ctx,
+		  em_event_t event, em_event_type_t event_type,
+		  em_queue_t queue, void *q_ctx, queue_elem_t *q_elem);
+
+/** Resume the parked coroutines that are ready to continue */
+void coro_poll(void);
+
+/**
+ * Check for parked coroutines on this core, called every dispatch round
+ */
+static inline void
+coro_poll_parked(void)
+{
+	const coro_locm_t *const cl = em_locm.coro;
+
+	if (unlikely(cl != NULL && cl->num_parked > 0))
+		coro_poll();
+}
+
+/**
+ * Limit the scheduler wait to the nearest deadline of the parked coroutines
+ * on this core, a parked coroutine must not oversleep its em_yield_until()
+ * timeout while the core waits for scheduled events.
+ *
+ * @param sched_wait     Scheduler wait time, odp_schedule_wait_time(wait_ns)
+ * @param sched_wait_ns  The same in ns, UINT64_MAX: ODP_SCHED_WAIT
+ *
+ * @return The scheduler wait time to use
+ */
+static inline uint64_t
+coro_sched_wait(uint64_t sched_wait, uint64_t sched_wait_ns)
+{
+	const coro_locm_t *const cl = em_locm.coro;
+
+	if (likely(cl == NULL || cl->num_parked == 0 ||
+		   cl->deadline_ns == UINT64_MAX ||
+		   sched_wait == ODP_SCHED_NO_WAIT || sched_wait_ns == 0))
+		return sched_wait;
+
+	const uint64_t now = odp_time_global_ns();
+
+	if (cl->deadline_ns <= now)
+		return ODP_SCHED_NO_WAIT;
+
+	const uint64_t park_wait_ns = cl->deadline_ns - now;
+
+	if (park_wait_ns >= sched_wait_ns)
+		return sched_wait;
+
+	return odp_schedule_wait_time(park_wait_ns);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EM_CORO_H_ */
@@ -0,0 +1,106 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2023, Nokia Solutions and Networks
+ */
+
+/**
+ * @file
+ * EM internal coroutine EO types & definitions
+ */
+
+#ifndef EM_CORO_TYPES_H_
+#define EM_CORO_TYPES_H_
+
+/*
+ * Switch only the callee-saved registers and the stack pointer, in assembly,
+ * on x86-64 and AArch64. swapcontext() also saves and restores the signal mask
+ * with a system call on every switch. Other architectures use ucontext.
+ */
+#if defined(__x86_64__) || defined(__aarch64__)
+#define CORO_CTX_ASM 1
+#else
+#define CORO_CTX_ASM 0
+#include <ucontext.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Saved execution context: the stack pointer, the registers are on the stack
+ */
+#if CORO_CTX_ASM
+typedef struct {
+	void *sp;
+} coro_ctx_t;
+#else
+typedef ucontext_t coro_ctx_t;
+#endif
+
+typedef enum {
+	CORO_STATE_FREE = 0,
+	/** Running the EO receive function */
+	CORO_STATE_RUNNING,
+	/** Parked in em_yield_until(), resumed by the dispatcher */
+	CORO_STATE_PARKED,
+	/** The EO receive function returned, the coroutine can be reused */
+	CORO_STATE_DONE
+} coro_state_t;
+
+/**
+ * Coroutine running an EO receive function on its own stack
+ */
+typedef struct {
+	/** Saved context of the coroutine while not running */
+	coro_ctx_t ctx;
+	/**
+	 * Coroutine stack mapping, allocated on first use: a PROT_NONE guard
+	 * page below EM_CORO_STACK_SIZE bytes of stack
+	 */
+	void *stack;
+	size_t stack_map_size;
+	coro_state_t state;
+
+	/** The receive call to run */
+	em_receive_func_t receive_func;
+	void *eo_ctx;
+	em_event_t event;
+	em_event_type_t event_type;
+	em_queue_t queue;
+	void *q_ctx;
+	queue_elem_t *q_elem;
+
+	/** em_yield_until(): unscheduled queue to wait on, or EM_QUEUE_UNDEF */
+	em_queue_t wait_queue;
+	/** em_yield_until(): resume at this time (ns), UINT64_MAX: no timeout */
+	uint64_t deadline_ns;
+	/** em_yield_until(): return value set by the dispatcher on resume */
+	em_event_t result;
+} coro_t;
+
+/**
+ * EM-core local coroutine pool, allocated on the first coroutine EO receive
+ * on the core
+ */
+typedef struct {
+	/** Dispatcher context saved while a coroutine runs */
+	coro_ctx_t main_ctx;
+	/** The running coroutine, NULL when on the dispatcher stack */
+	coro_t *current;
+
+	int num_free;
+	int num_parked;
+	/** Nearest deadline (ns) of the parked coroutines, UINT64_MAX: none */
+	uint64_t deadline_ns;
+	coro_t *free[EM_CORO_MAX_PER_CORE];
+	coro_t *parked[EM_CORO_MAX_PER_CORE];
+
+	coro_t coro[EM_CORO_MAX_PER_CORE];
+} coro_locm_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EM_CORO_TYPES_H_ */
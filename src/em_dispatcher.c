@@ -29,6 +29,10 @@
  */
 
 #include "em_include.h"
+#include "em_dispatcher_inline.h"
+
+/* Max passes over the deferred calls at core term, see dispatch_term_local() */
+#define DEFER_TERM_PASSES  8
 
 static int read_config_file(void)
 {
@@ -213,6 +217,37 @@ em_status_t dispatch_init_local(void)
 	locm->poll_drain_dispatch_last_run = now;
 
 	locm->idle_state = IDLE_STATE_ACTIVE;
+	locm->core_util = &em_shm->core_util[locm->core_id];
+	core_util_init_local(locm->core_util);
 
 	return EM_OK;
 }
+
+em_status_t dispatch_term_local(void)
+{
+	defer_ring_t *const defer = &em_locm.defer;
+
+	if (defer->num == 0)
+		return EM_OK;
+
+	/*
+	 * Run, not drop, the pending deferred calls: they might own events or
+	 * other resources passed via their argument. Calls deferred by the
+	 * deferred functions run in the next pass, a bounded number of passes.
+	 */
+	EM_LOG(EM_LOG_PRINT, "EM-core%02d: running %d pending deferred call(s)\n",
+	       em_core_id(), defer->num);
+	for (int i = 0; i < DEFER_TERM_PASSES && defer->num > 0; i++)
+		dispatch_deferred();
+
+	if (likely(defer->num == 0))
+		return EM_OK;
+
+	EM_LOG(EM_LOG_ERR, "EM-core%02d: drop %d deferred call(s) still pending after %d passes\n",
+	       em_core_id(), defer->num, DEFER_TERM_PASSES);
+	for (int prio = 0; prio < EM_QUEUE_PRIO_NUM; prio++)
+		defer->prio[prio].head = defer->prio[prio].tail;
+	defer->num = 0;
+
+	return EM_ERR_BAD_STATE;
+}
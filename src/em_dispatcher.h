@@ -42,6 +42,57 @@ extern "C" {
 
 em_status_t dispatch_init(void);
 em_status_t dispatch_init_local(void);
+/** Run, or drop after bounded passes, the deferred calls pending on this core */
+em_status_t dispatch_term_local(void);
+
+/**
+ * Check whether events sent to a queue with EM_QUEUE_FLAG_INLINE can be
+ * dispatched on this core via the core-local queues
+ */
+static inline bool
+send_inline_ok(const queue_elem_t *q_elem)
+{
+	const em_locm_t *const locm = &em_locm;
+
+	/* Only from an EO receive function, the dispatcher checks the local queues next */
+	if (locm->current.q_elem == NULL)
+		return false;
+	/* Events sent from an ordered context are put back in order by the scheduler */
+	if (locm->current.sched_context_type == EM_SCHED_CONTEXT_TYPE_ORDERED)
+		return false;
+
+	const queue_group_elem_t *qgrp_elem = queue_group_elem_get(q_elem->queue_group);
+
+	return qgrp_elem && em_core_mask_isset(locm->core_id, &qgrp_elem->core_mask);
+}
+
+/**
+ * Send an event to a queue with EM_QUEUE_FLAG_INLINE, via the core-local
+ * queues if possible and otherwise via the scheduler
+ */
+static inline em_status_t
+send_inline(em_event_t event, const queue_elem_t *q_elem)
+{
+	if (send_inline_ok(q_elem) && send_local(event, q_elem) == EM_OK)
+		return EM_OK;
+
+	return send_event(event, q_elem);
+}
+
+static inline int
+send_inline_multi(const em_event_t events[], const int num,
+		  const queue_elem_t *q_elem)
+{
+	int num_local = 0;
+
+	if (send_inline_ok(q_elem)) {
+		num_local = send_local_multi(events, num, q_elem);
+		if (likely(num_local == num))
+			return num;
+	}
+
+	return num_local + send_event_multi(&events[num_local], num - num_local, q_elem);
+}
 
 #ifdef __cplusplus
 }
@@ -144,8 +144,16 @@ call_eo_receive_fn(const em_eo_t eo, const em_receive_func_t eo_receive_func,
 		 * Call the EO receive function
 		 * (only if the dispatch callback(s) did not free the event)
 		 */
-		eo_receive_func(eo_ctx, event, event_type,
-				queue, queue_ctx);
+		if (EM_TRACE_ENABLE)
+			trace_dispatch_enter(eo, queue, event, 1);
+		if (unlikely(q_elem->flags.coro))
+			coro_receive(eo_receive_func, eo_ctx, event, event_type,
+				     queue, queue_ctx, q_elem);
+		else
+			eo_receive_func(eo_ctx, event, event_type,
+					queue, queue_ctx);
+		if (EM_TRACE_ENABLE)
+			trace_dispatch_exit(eo);
 	}
 
 	if (EM_DISPATCH_CALLBACKS_ENABLE)
@@ -195,7 +203,11 @@ call_eo_receive_multi_fn(const em_eo_t eo,
 		 * Call the EO multi-event receive function
 		 * (only if the dispatch callback(s) did not free all events)
 		 */
+		if (EM_TRACE_ENABLE)
+			trace_dispatch_enter(eo, queue, ev_tbl[0], num);
 		eo_receive_multi_func(eo_ctx, ev_tbl, num, queue, queue_ctx);
+		if (EM_TRACE_ENABLE)
+			trace_dispatch_exit(eo);
 	}
 
 	if (EM_DISPATCH_CALLBACKS_ENABLE)
@@ -215,6 +227,37 @@ call_eo_receive_multi_fn(const em_eo_t eo,
 	locm->current.egrp = EM_EVENT_GROUP_UNDEF;
 }
 
+/**
+ * @brief Helper to dispatch_local_queues() for immediate events (em_send_imm())
+ *
+ * No event header: no event group, dispatch callbacks or queue statistics.
+ * Never sent to queues of EOs with a multi-event receive function.
+ * The handle given to the EO is the stash entry 'evptr', nothing to free.
+ */
+static inline void
+dispatch_local_imm(const stash_entry_t entry_tbl[], const int num,
+		   queue_elem_t *const q_elem)
+{
+	em_locm_t *const locm = &em_locm;
+	const em_queue_t queue = (em_queue_t)(uintptr_t)q_elem->queue;
+	void *const q_ctx = q_elem->context;
+	void *const eo_ctx = q_elem->eo_ctx;
+
+	locm->current.rcv_multi_cnt = 1;
+	/* here: locm->current.egrp == EM_EVENT_GROUP_UNDEF */
+
+	for (int i = 0; i < num; i++) {
+		em_event_t event = (em_event_t)(uintptr_t)entry_tbl[i].evptr;
+
+		if (unlikely(q_elem->flags.coro))
+			coro_receive(q_elem->receive_func, eo_ctx, event,
+				     EM_EVENT_TYPE_IMMEDIATE, queue, q_ctx, q_elem);
+		else
+			q_elem->receive_func(eo_ctx, event, EM_EVENT_TYPE_IMMEDIATE,
+					     queue, q_ctx);
+	}
+}
+
 /**
  * @brief Helper to dispatch_local_queues() for a single event
  */
@@ -233,6 +276,12 @@ _dispatch_local(stash_entry_t entry)
 
 	locm->current.q_elem = q_elem; /* before event_init_... for ESV error prints */
 
+	if (stash_entry_is_imm(entry)) {
+		if (likely(q_elem != NULL && q_elem->state == EM_QUEUE_STATE_READY))
+			dispatch_local_imm(&entry, 1, q_elem);
+		return;
+	}
+
 	odp_event = (odp_event_t)(uintptr_t)entry.evptr;
 	/* Event might originate from outside (via polled pktio) of EM and need init */
 	event = event_init_odp(odp_event, true/*is_extev*/, &ev_hdr/*out*/);
@@ -276,19 +325,29 @@ _dispatch_local_multi(const stash_entry_t entry_tbl[], const int num)
 		const int qidx = entry_tbl[idx].qidx;
 		const em_queue_t queue = queue_idx2hdl(qidx);
 		queue_elem_t *const q_elem = queue_elem_get(queue);
+		const bool is_imm = stash_entry_is_imm(entry_tbl[idx]);
 		int i;
 
 		locm->current.q_elem = q_elem; /* before event_init_... for ESV error prints */
 
 		/*
-		 * Count events sent to the same local queue,
+		 * Count events sent to the same local queue, immediate events
+		 * in separate batches,
 		 * i < num <= EM_QUEUE_LOCAL_MULTI_MAX_BURST
 		 */
-		for (i = idx + 1; i < num && entry_tbl[i].qidx == qidx; i++)
+		for (i = idx + 1; i < num && entry_tbl[i].qidx == qidx &&
+		     stash_entry_is_imm(entry_tbl[i]) == is_imm; i++)
 			;
 
 		ev_cnt = i - idx; /* '1 to num' events */
 
+		if (is_imm) {
+			if (likely(q_elem != NULL && q_elem->state == EM_QUEUE_STATE_READY))
+				dispatch_local_imm(&entry_tbl[idx], ev_cnt, q_elem);
+			idx += ev_cnt;
+			continue;
+		}
+
 		/* Events might originate from outside (via polled pktio) of EM and need init */
 		event_init_odp_multi(&odp_evtbl[idx], ev_tbl/*out*/, evhdr_tbl/*out*/,
 				     ev_cnt, true/*is_extev*/);
@@ -323,11 +382,43 @@ dispatch_local_queues(const stash_entry_t entry_tbl[], const int num)
 		_dispatch_local_multi(entry_tbl, num);
 }
 
+/**
+ * Run the deferred calls of this core (em_defer()) that are pending when
+ * called, highest priority first. Calls deferred meanwhile, also by the
+ * deferred functions, are left for the next call: a deferred function that
+ * defers itself again cannot keep the dispatcher here.
+ */
+static inline void
+dispatch_deferred(void)
+{
+	defer_ring_t *const defer = &em_locm.defer;
+	uint32_t tail[EM_QUEUE_PRIO_NUM];
+
+	for (int prio = 0; prio < EM_QUEUE_PRIO_NUM; prio++)
+		tail[prio] = defer->prio[prio].tail;
+
+	for (int prio = EM_QUEUE_PRIO_NUM - 1; prio >= 0; prio--) {
+		while (defer->prio[prio].head != tail[prio]) {
+			const uint32_t idx = defer->prio[prio].head & (EM_DEFER_RING_SIZE - 1);
+			const defer_call_t call = defer->prio[prio].call[idx];
+
+			defer->prio[prio].head++;
+			defer->num--;
+			em_locm.round_local.num++;
+			em_locm.round_local.prio_num[prio]++;
+			call.fn(call.arg);
+		}
+	}
+}
+
 static inline void
 check_local_queues(void)
 {
 	em_locm_t *const locm = &em_locm;
 
+	if (unlikely(locm->defer.num > 0))
+		dispatch_deferred();
+
 	if (locm->local_queues.empty)
 		return;
 
@@ -339,18 +430,26 @@ check_local_queues(void)
 	stash_entry_t entry_tbl[EM_QUEUE_LOCAL_MULTI_MAX_BURST];
 
 	for (;;) {
+		em_queue_prio_t prio;
+
 		if (EM_DEBUG_TIMESTAMP_ENABLE)
 			locm->debug_ts[EM_DEBUG_TSP_SCHED_ENTRY] = debug_timestamp();
 
 		int num = next_local_queue_events(entry_tbl /*[out]*/,
-						  EM_QUEUE_LOCAL_MULTI_MAX_BURST);
+						  EM_QUEUE_LOCAL_MULTI_MAX_BURST,
+						  &prio /*out*/);
 		if (EM_DEBUG_TIMESTAMP_ENABLE)
 			locm->debug_ts[EM_DEBUG_TSP_SCHED_RETURN] = debug_timestamp();
 
 		if (num <= 0)
 			break;
 
+		locm->round_local.num += num;
+		locm->round_local.prio_num[prio] += num;
 		dispatch_local_queues(entry_tbl, num);
+
+		if (unlikely(locm->defer.num > 0))
+			dispatch_deferred();
 	}
 
 	/* Restore */
@@ -398,6 +497,9 @@ dispatch_multi_receive(em_event_t ev_tbl[], event_hdr_t *ev_hdr_tbl[],
 	int i;
 	int j;
 
+	if (queue_stats_enabled())
+		queue_stats_dequeued(q_elem, ev_hdr_tbl, num_events);
+
 	do {
 		/* count same event groups: 1 to num_events */
 		const int egrp_cnt = count_same_evgroup(&ev_hdr_tbl[idx],
@@ -457,6 +559,9 @@ dispatch_single_receive(em_event_t ev_tbl[], event_hdr_t *ev_hdr_tbl[],
 	const em_receive_func_t eo_rcv_fn = q_elem->receive_func;
 	int i;
 
+	if (queue_stats_enabled())
+		queue_stats_dequeued(q_elem, ev_hdr_tbl, num_events);
+
 	if (check_local_qs) {
 		for (i = 0; i < num_events; i++) {
 			locm->event_burst_cnt--;
@@ -523,6 +628,12 @@ dispatch_events(odp_event_t odp_evtbl[], const int num_events,
 	    sched_ctx_type == EM_SCHED_CONTEXT_TYPE_ORDERED &&
 	    locm->output_queue_track.idx_cnt > 0)
 		output_queue_buffering_drain();
+	/*
+	 * Output the events buffered in an ordered context with an ordered
+	 * lock, unless already done by 'em_ordered_processing_end()'.
+	 */
+	if (locm->output_queue_ordered.num > 0)
+		output_queue_ordered_flush();
 
 	locm->current.q_elem = NULL;
 	locm->current.sched_q_elem = NULL;
@@ -560,16 +671,19 @@ dispatch_poll_ctrl_queue(void)
 }
 
 /*
- * Change the core state to idle and call idle hooks. If the core state changes,
- * call to_idle hooks. If the core state is already idle, call while_idle hooks.
+ * Change the core state to idle, account the busy time and call idle hooks.
+ * If the core state changes, call to_idle hooks. If the core state is already
+ * idle, call while_idle hooks.
  */
 static inline void
 to_idle(const em_dispatch_opt_t *opt)
 {
-	if (EM_IDLE_HOOKS_ENABLE) {
-		em_locm_t *const locm = &em_locm;
+	em_locm_t *const locm = &em_locm;
+
+	if (locm->idle_state == IDLE_STATE_ACTIVE) {
+		core_util_state_change(locm->core_util, true/*to_idle*/);
 
-		if (locm->idle_state == IDLE_STATE_ACTIVE) {
+		if (EM_IDLE_HOOKS_ENABLE) {
 			uint64_t to_idle_delay_ns = 0;
 
 			if (EM_DEBUG_TIMESTAMP_ENABLE) {
@@ -583,28 +697,29 @@ to_idle(const em_dispatch_opt_t *opt)
 			}
 
 			call_idle_hooks_to_idle(to_idle_delay_ns);
-			locm->idle_state = IDLE_STATE_IDLE;
-		} else if (locm->idle_state == IDLE_STATE_IDLE) {
-			call_idle_hooks_while_idle();
 		}
+		locm->idle_state = IDLE_STATE_IDLE;
+	} else if (EM_IDLE_HOOKS_ENABLE && locm->idle_state == IDLE_STATE_IDLE) {
+		call_idle_hooks_while_idle();
 	}
 }
 
 /*
- * Change the core state to active and call idle hooks. If the core state
- * changes call to_active hooks. If the core state is already active no idle
- * hooks will be called.
+ * Change the core state to active, account the idle time and call idle hooks.
+ * If the core state changes call to_active hooks. If the core state is already
+ * active no idle hooks will be called.
  */
 static inline void
 to_active(void)
 {
-	if (EM_IDLE_HOOKS_ENABLE) {
-		em_locm_t *const locm = &em_locm;
+	em_locm_t *const locm = &em_locm;
+
+	if (locm->idle_state == IDLE_STATE_IDLE) {
+		core_util_state_change(locm->core_util, false/*to_idle*/);
 
-		if (locm->idle_state == IDLE_STATE_IDLE) {
+		if (EM_IDLE_HOOKS_ENABLE)
 			call_idle_hooks_to_active();
-			locm->idle_state = IDLE_STATE_ACTIVE;
-		}
+		locm->idle_state = IDLE_STATE_ACTIVE;
 	}
 }
 
@@ -661,19 +776,38 @@ free_invalid_events(odp_event_t odp_evtbl[], int num)
 
 /*
  * Run a dispatch round - query the scheduler for events and dispatch
+ *
+ * Returns the number of events dispatched: the scheduled events plus the
+ * local queue events and deferred calls run in this round, the latter are
+ * counted per priority in em_locm.round_local.
+ * '*prio' is the priority of the scheduled events, EM_QUEUE_PRIO_UNDEF if the
+ * round got no events from the scheduler.
  */
 static inline int
 dispatch_round(uint64_t sched_wait, uint16_t burst_size,
-	       const em_dispatch_opt_t *opt /*optional, can be NULL*/)
+	       const em_dispatch_opt_t *opt /*optional, can be NULL*/,
+	       em_queue_prio_t *prio /*out, optional*/)
 {
+	em_locm_t *const locm = &em_locm;
 	odp_queue_t odp_queue;
 	odp_event_t odp_evtbl[burst_size];
 	int num;
 
+	if (prio)
+		*prio = EM_QUEUE_PRIO_UNDEF;
+	if (unlikely(locm->round_local.num > 0))
+		memset(&locm->round_local, 0, sizeof(locm->round_local));
+
 	dispatch_poll_ctrl_queue();
+	coro_poll_parked();
+
+	/* Wake up for the nearest em_yield_until() timeout on this core */
+	sched_wait = coro_sched_wait(sched_wait, opt ? opt->wait_ns :
+				     em_shm->opt.dispatch.sched_wait_ns);
 
 	num = dispatch_schedule(&odp_queue/*out*/, sched_wait,
 				odp_evtbl/*out[]*/, burst_size);
+	core_util_round(em_locm.core_util, num);
 	if (unlikely(num <= 0)) {
 		/*
 		 * No scheduled events available, check if the local queues
@@ -682,13 +816,15 @@ dispatch_round(uint64_t sched_wait, uint16_t burst_size,
 		 * Update the EM_IDLE_STATE and call idle hooks if they are
 		 * enabled
 		 */
-		if (em_locm.local_queues.empty) {
+		if (EM_TRACE_ENABLE)
+			trace_sched_empty();
+		if (locm->local_queues.empty && locm->defer.num == 0) {
 			to_idle(opt);
 		} else {
 			to_active();
 			check_local_queues();
 		}
-		return 0;
+		return locm->round_local.num;
 	}
 
 	queue_elem_t *const q_elem = odp_queue_context(odp_queue);
@@ -699,6 +835,9 @@ dispatch_round(uint64_t sched_wait, uint16_t burst_size,
 		return 0;
 	}
 
+	if (prio)
+		*prio = q_elem->priority;
+
 	/*
 	 * If scheduled events are available, update the EM_IDLE_STATE and
 	 * call idle hooks if they are enabled.
@@ -708,11 +847,31 @@ dispatch_round(uint64_t sched_wait, uint16_t burst_size,
 	if (q_elem->flags.in_atomic_group) {
 		atomic_group_dispatch(odp_evtbl, num, q_elem);
 	} else {
-		em_locm.event_burst_cnt = num;
+		locm->event_burst_cnt = num;
 		dispatch_events(odp_evtbl, num, q_elem);
 	}
 
-	return num;
+	return num + locm->round_local.num;
+}
+
+/*
+ * em_dispatch_duration() helper: count the events of a dispatch round per
+ * priority, the scheduled events by 'round_prio' and the local queue events
+ * and deferred calls by their own priority
+ */
+static inline void
+dispatch_prio_events(uint64_t prio_events[/*in,out*/], int round_events,
+		     em_queue_prio_t round_prio)
+{
+	const dispatch_local_cnt_t *const round_local = &em_locm.round_local;
+
+	if (round_prio != EM_QUEUE_PRIO_UNDEF)
+		prio_events[round_prio] += round_events - round_local->num;
+
+	if (round_local->num > 0) {
+		for (int i = 0; i < EM_QUEUE_PRIO_NUM; i++)
+			prio_events[i] += round_local->prio_num[i];
+	}
 }
 
 /*
@@ -774,7 +933,7 @@ dispatch_with_userfn(uint64_t rounds, bool do_input_poll, bool do_output_drain)
 			rx_events = input_poll();
 
 		do {
-			round_events = dispatch_round(sched_wait, EM_SCHED_MULTI_MAX_BURST, NULL);
+			round_events = dispatch_round(sched_wait, EM_SCHED_MULTI_MAX_BURST, NULL, NULL);
 			dispatched_events += round_events;
 			i++; /* inc rounds */
 		} while (dispatched_events < rx_events &&
@@ -801,15 +960,58 @@ dispatch_no_userfn(uint64_t rounds)
 
 	if (do_forever) {
 		for (;/*ever*/;)
-			dispatch_round(sched_wait, EM_SCHED_MULTI_MAX_BURST, NULL);
+			dispatch_round(sched_wait, EM_SCHED_MULTI_MAX_BURST, NULL, NULL);
 	} else {
 		for (uint64_t i = 0; i < rounds; i++)
-			events += dispatch_round(sched_wait, EM_SCHED_MULTI_MAX_BURST, NULL);
+			events += dispatch_round(sched_wait, EM_SCHED_MULTI_MAX_BURST, NULL, NULL);
 	}
 
 	return events;
 }
 
+/*
+ * em_dispatch_duration() helper: are the per priority options in use
+ */
+static inline bool
+dispatch_prio_stop_enabled(const em_dispatch_opt_t *opt)
+{
+	if (opt->stop_prio != EM_QUEUE_PRIO_UNDEF)
+		return true;
+
+	for (int i = 0; i < EM_QUEUE_PRIO_NUM; i++) {
+		if (opt->prio_budget[i] > 0)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * em_dispatch_duration() helper: check the per priority event budgets and the
+ * stop priority after a dispatch round.
+ * A round that only ran local queue events or deferred calls did work but
+ * tells nothing about the scheduled priorities, it does not stop dispatch
+ * unless a budget is reached.
+ */
+static inline bool
+dispatch_prio_stop(const em_dispatch_opt_t *opt, int round_events,
+		   em_queue_prio_t round_prio, const uint64_t prio_events[])
+{
+	if (round_events <= 0)
+		return opt->stop_prio != EM_QUEUE_PRIO_UNDEF;
+
+	if (opt->stop_prio != EM_QUEUE_PRIO_UNDEF &&
+	    round_prio != EM_QUEUE_PRIO_UNDEF && round_prio < opt->stop_prio)
+		return true;
+
+	for (int i = 0; i < EM_QUEUE_PRIO_NUM; i++) {
+		if (opt->prio_budget[i] > 0 && prio_events[i] >= opt->prio_budget[i])
+			return true;
+	}
+
+	return false;
+}
+
 /*
  * em_dispatch() helper: dispatch and call the user provided callback functions
  *                       'input_poll' and 'output_drain'
@@ -840,8 +1042,9 @@ dispatch_duration_with_userfn(const em_dispatch_duration_t *duration,
 		duration->select & EM_DISPATCH_DURATION_NO_EVENTS_ROUNDS ? true : false;
 	const bool duration_noev_ns =
 		duration->select & EM_DISPATCH_DURATION_NO_EVENTS_NS ? true : false;
+	const bool prio_stop = dispatch_prio_stop_enabled(opt);
 
-	if (unlikely(duration_forever)) {
+	if (unlikely(duration_forever && !prio_stop)) {
 		for (;/*ever*/;) {
 			/* check if callback functions should be called */
 			do_poll_drain_round = check_poll_drain_round(poll_interval, poll_period);
@@ -850,7 +1053,7 @@ dispatch_duration_with_userfn(const em_dispatch_duration_t *duration,
 				(void)input_poll();
 
 			/* dispatch one round */
-			(void)dispatch_round(sched_wait, burst_size, opt);
+			(void)dispatch_round(sched_wait, burst_size, opt, NULL);
 
 			if (do_output_drain && do_poll_drain_round)
 				(void)output_drain();
@@ -861,6 +1064,8 @@ dispatch_duration_with_userfn(const em_dispatch_duration_t *duration,
 	uint64_t events = 0;
 	uint64_t rounds = 0;
 	uint64_t noev_rounds = 0;
+	uint64_t prio_events[EM_QUEUE_PRIO_NUM] = {0};
+	em_queue_prio_t round_prio = EM_QUEUE_PRIO_UNDEF;
 
 	uint64_t start_ns = 0;
 	uint64_t stop_ns = 0;
@@ -886,10 +1091,13 @@ dispatch_duration_with_userfn(const em_dispatch_duration_t *duration,
 			(void)input_poll();
 
 		/* dispatch one round */
-		int round_events = dispatch_round(sched_wait, burst_size, opt);
+		int round_events = dispatch_round(sched_wait, burst_size,
+						  opt, &round_prio);
 
 		events += round_events;
 		rounds++;
+		if (round_events > 0)
+			dispatch_prio_events(prio_events, round_events, round_prio);
 
 		if (do_output_drain && do_poll_drain_round)
 			(void)output_drain();
@@ -907,6 +1115,10 @@ dispatch_duration_with_userfn(const em_dispatch_duration_t *duration,
 			if (duration_noev_ns && round_events > 0)
 				noev_stop_ns = time_ns + duration->no_events.ns;
 		}
+
+		if (prio_stop &&
+		    dispatch_prio_stop(opt, round_events, round_prio, prio_events))
+			break;
 	}
 
 	if (results) {
@@ -916,6 +1128,7 @@ dispatch_duration_with_userfn(const em_dispatch_duration_t *duration,
 		else
 			results->ns = 0;
 		results->events = events;
+		memcpy(results->prio_events, prio_events, sizeof(prio_events));
 	}
 
 	return events;
@@ -941,16 +1154,19 @@ dispatch_duration_no_userfn(const em_dispatch_duration_t *duration,
 		duration->select & EM_DISPATCH_DURATION_NO_EVENTS_ROUNDS ? true : false;
 	const bool duration_noev_ns =
 		duration->select & EM_DISPATCH_DURATION_NO_EVENTS_NS ? true : false;
+	const bool prio_stop = dispatch_prio_stop_enabled(opt);
 
-	if (unlikely(duration_forever)) {
+	if (unlikely(duration_forever && !prio_stop)) {
 		for (;/*ever*/;)
-			(void)dispatch_round(sched_wait, burst_size, opt);
+			(void)dispatch_round(sched_wait, burst_size, opt, NULL);
 		/* never return */
 	}
 
 	uint64_t events = 0;
 	uint64_t rounds = 0;
 	uint64_t noev_rounds = 0;
+	uint64_t prio_events[EM_QUEUE_PRIO_NUM] = {0};
+	em_queue_prio_t round_prio = EM_QUEUE_PRIO_UNDEF;
 
 	uint64_t start_ns = 0;
 	uint64_t stop_ns = 0;
@@ -970,10 +1186,13 @@ dispatch_duration_no_userfn(const em_dispatch_duration_t *duration,
 	       (!duration_noev_rounds || noev_rounds < duration->no_events.rounds) &&
 	       (!duration_noev_ns || time_ns < noev_stop_ns)) {
 		/* dispatch one round */
-		int round_events = dispatch_round(sched_wait, burst_size, opt);
+		int round_events = dispatch_round(sched_wait, burst_size,
+						  opt, &round_prio);
 
 		events += round_events;
 		rounds++;
+		if (round_events > 0)
+			dispatch_prio_events(prio_events, round_events, round_prio);
 
 		if (duration_noev_rounds) {
 			if (round_events == 0)
@@ -987,6 +1206,10 @@ dispatch_duration_no_userfn(const em_dispatch_duration_t *duration,
 			if (duration_noev_ns && round_events > 0)
 				noev_stop_ns = time_ns + duration->no_events.ns;
 		}
+
+		if (prio_stop &&
+		    dispatch_prio_stop(opt, round_events, round_prio, prio_events))
+			break;
 	}
 
 	if (results) {
@@ -996,6 +1219,7 @@ dispatch_duration_no_userfn(const em_dispatch_duration_t *duration,
 		else
 			results->ns = 0;
 		results->events = events;
+		memcpy(results->prio_events, prio_events, sizeof(prio_events));
 	}
 
 	return events;
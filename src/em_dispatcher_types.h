@@ -53,6 +53,44 @@ typedef enum {
 	IDLE_STATE_ACTIVE = 2
 } idle_state_t;
 
+/**
+ * Deferred call, see em_defer()
+ */
+typedef struct {
+	em_defer_func_t fn;
+	void *arg;
+} defer_call_t;
+
+/**
+ * Core-local deferred calls, a ring per queue priority
+ */
+typedef struct {
+	/** Number of pending calls over all priorities */
+	int num;
+
+	struct {
+		/** Next call to run, free running */
+		uint32_t head;
+		/** Next free slot, free running */
+		uint32_t tail;
+		defer_call_t call[EM_DEFER_RING_SIZE];
+	} prio[EM_QUEUE_PRIO_NUM];
+} defer_ring_t;
+
+COMPILE_TIME_ASSERT(POWEROF2(EM_DEFER_RING_SIZE),
+		    EM_DEFER_RING_SIZE__NOT_POWER_OF_TWO);
+
+/**
+ * Local queue events and deferred calls run during the current dispatch
+ * round, counted into the dispatch round events and results
+ */
+typedef struct {
+	/** Number of local queue events and deferred calls */
+	int num;
+	/** The same per priority: of the local queue or the deferred call */
+	int prio_num[EM_QUEUE_PRIO_NUM];
+} dispatch_local_cnt_t;
+
 #ifdef __cplusplus
 }
 #endif
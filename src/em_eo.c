@@ -174,6 +174,7 @@ eo_add_queue(eo_elem_t *const eo_elem, queue_elem_t *const q_elem)
 	q_elem->max_events = (uint16_t)eo_elem->max_events;
 
 	q_elem->flags.use_multi_rcv = eo_elem->use_multi_rcv ? true : false;
+	q_elem->flags.coro = eo_elem->coro ? true : false;
 	if (eo_elem->use_multi_rcv)
 		q_elem->receive_multi_func = eo_elem->receive_multi_func;
 	else
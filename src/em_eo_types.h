@@ -60,6 +60,8 @@ typedef struct {
 
 	int use_multi_rcv; /* true:receive_multi_func(), false:receive_func() */
 	int max_events;
+	/** true: receive_func() runs as a coroutine, see em_eo_coro_enable() */
+	int coro;
 	/** EO event receive function */
 	em_receive_func_t receive_func;
 	/** EO multi-event receive function */
@@ -46,8 +46,57 @@ COMPILE_TIME_ASSERT(sizeof(_ev_hdr__size_check__arr_t) ==
 COMPILE_TIME_ASSERT(EM_CHECK_LEVEL >= 0 && EM_CHECK_LEVEL <= 3,
 		    EM_CHECK_LEVEL__BAD_VALUE);
 
+/**
+ * Check that an ODP event handle of the default pool leaves the immediate
+ * event tag bit clear, see STASH_ENTRY_IMM and em_send_imm().
+ */
+static em_status_t check_event_hdl_imm_bit(void)
+{
+	const mpool_elem_t *const pool_elem = pool_elem_get(EM_POOL_DEFAULT);
+	odp_event_t odp_event;
+
+	if (unlikely(!pool_elem))
+		return EM_ERR_BAD_STATE;
+
+	if (pool_elem->event_type == EM_EVENT_TYPE_PACKET) {
+		odp_packet_t odp_pkt = odp_packet_alloc(pool_elem->odp_pool[0], 1);
+
+		if (unlikely(odp_pkt == ODP_PACKET_INVALID))
+			return EM_ERR_ALLOC_FAILED;
+		odp_event = odp_packet_to_event(odp_pkt);
+	} else if (pool_elem->event_type == EM_EVENT_TYPE_VECTOR) {
+		odp_packet_vector_t odp_pktvec = odp_packet_vector_alloc(pool_elem->odp_pool[0]);
+
+		if (unlikely(odp_pktvec == ODP_PACKET_VECTOR_INVALID))
+			return EM_ERR_ALLOC_FAILED;
+		odp_event = odp_packet_vector_to_event(odp_pktvec);
+	} else {
+		odp_buffer_t odp_buf = odp_buffer_alloc(pool_elem->odp_pool[0]);
+
+		if (unlikely(odp_buf == ODP_BUFFER_INVALID))
+			return EM_ERR_ALLOC_FAILED;
+		odp_event = odp_buffer_to_event(odp_buf);
+	}
+
+	const evhdl_t evhdl = {.event = event_odp2em(odp_event)};
+	const bool imm_bit = evhdl.evptr & STASH_ENTRY_IMM;
+
+	odp_event_free(odp_event);
+
+	return imm_bit ? EM_ERR_NOT_SUPPORTED : EM_OK;
+}
+
 em_status_t event_init(void)
 {
+	em_status_t stat = check_event_hdl_imm_bit();
+
+	if (unlikely(stat != EM_OK)) {
+		EM_LOG(EM_LOG_ERR,
+		       "ODP event handles use the immediate event tag bit:%" PRI_STAT "\n",
+		       stat);
+		return stat;
+	}
+
 	return EM_OK;
 }
 
@@ -224,6 +273,46 @@ output_queue_buffering_drain(void)
 	track->idx_cnt = 0;
 }
 
+/**
+ * Pass the events buffered during an ordered context with an ordered lock to
+ * the output functions, in the order of the source queue:
+ * the ordered lock is acquired in the order of the events in the source queue.
+ * Each run of events to the same output queue is passed in one call.
+ * Called at the end of the ordered context, see EM_QUEUE_FLAG_ORDER_LOCK.
+ */
+void
+output_queue_ordered_flush(void)
+{
+	output_queue_ordered_t *const ord = &em_locm.output_queue_ordered;
+	const unsigned int num = ord->num;
+	unsigned int i = 0;
+
+	if (num == 0)
+		return;
+
+	odp_schedule_order_lock(0);
+
+	while (i < num) {
+		const queue_elem_t *const output_q_elem = ord->q_elems[i];
+		const em_queue_t output_queue = (em_queue_t)(uintptr_t)output_q_elem->queue;
+		const em_output_func_t output_fn = output_q_elem->output.output_conf.output_fn;
+		void *const output_fn_args = output_q_elem->output.output_conf.output_fn_args;
+		unsigned int run = 1;
+		int ret;
+
+		while (i + run < num && ord->q_elems[i + run] == output_q_elem)
+			run++;
+
+		ret = output_fn(&ord->events[i], run, output_queue, output_fn_args);
+		if (unlikely((unsigned int)ret != run))
+			em_free_multi(&ord->events[i + ret], run - ret);
+		i += run;
+	}
+
+	odp_schedule_order_unlock(0);
+	ord->num = 0;
+}
+
 uint32_t event_vector_tbl(em_event_t vector_event,
 			  em_event_t **event_tbl /*out*/)
 {
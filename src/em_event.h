@@ -55,6 +55,7 @@ em_event_t pkt_clone_odp(odp_packet_t pkt, odp_pool_t pkt_pool,
 void output_queue_track(queue_elem_t *const output_q_elem);
 void output_queue_drain(const queue_elem_t *output_q_elem);
 void output_queue_buffering_drain(void);
+void output_queue_ordered_flush(void);
 
 uint32_t event_vector_tbl(em_event_t vector_event, em_event_t **event_tbl/*out*/);
 em_status_t event_vector_max_size(em_event_t vector_event, uint32_t *max_size /*out*/,
@@ -85,6 +86,7 @@ evhdr_init_pkt(event_hdr_t *ev_hdr, em_event_t event,
 	 * ODP pkt from outside of EM - not allocated by EM & needs init
 	 */
 	odp_packet_user_flag_set(odp_pkt, USER_FLAG_SET);
+	pool_wmark_pkt(odp_pkt);
 	ev_hdr->event_type = EM_EVENT_TYPE_PACKET;
 	ev_hdr->egrp = EM_EVENT_GROUP_UNDEF;
 	ev_hdr->user_area.all = 0; /* uarea fields init when used */
@@ -148,6 +150,7 @@ evhdr_init_pkt_multi(event_hdr_t *const ev_hdrs[],
 			/* else events[i] = events[i] */
 		} else {
 			odp_packet_user_flag_set(odp_pkts[i], USER_FLAG_SET);
+			pool_wmark_pkt(odp_pkts[i]);
 			needs_init_idx[needs_init_num] = i;
 			needs_init_num++;
 		}
@@ -1223,6 +1226,12 @@ send_event(em_event_t event, const queue_elem_t *q_elem)
 	if (esv_ena && odp_event_type(odp_event) == ODP_EVENT_PACKET_VECTOR)
 		vector_tbl2odp(odp_event);
 
+	const bool stats_ena = queue_stats_enabled();
+	int stamped = 0;
+
+	if (stats_ena)
+		stamped = queue_stats_stamp(&event, 1);
+
 	/* Enqueue event for scheduling */
 	ret = odp_queue_enq(odp_queue, odp_event);
 
@@ -1230,10 +1239,15 @@ send_event(em_event_t event, const queue_elem_t *q_elem)
 		/* Restore EM vector event-table before returning vector to user */
 		if (esv_ena && odp_event_type(odp_event) == ODP_EVENT_PACKET_VECTOR)
 			vector_tbl2em(odp_event);
+		if (stats_ena)
+			queue_stats_unstamp(&event, 1);
 
 		return EM_ERR_LIB_FAILED;
 	}
 
+	if (stats_ena)
+		queue_stats_enqueued(q_elem, stamped);
+
 	return EM_OK;
 }
 
@@ -1266,17 +1280,31 @@ send_event_multi(const em_event_t events[], const int num,
 		}
 	}
 
+	const bool stats_ena = queue_stats_enabled();
+	int stamped = 0;
+
+	if (stats_ena)
+		stamped = queue_stats_stamp(events, num);
+
 	/* Enqueue events for scheduling */
 	int ret = odp_queue_enq_multi(odp_queue, odp_events, num);
 
-	if (likely(ret == num))
+	if (likely(ret == num)) {
+		if (stats_ena)
+			queue_stats_enqueued(q_elem, stamped);
 		return num; /* Success! */
+	}
 
 	/*
 	 * Fail: could not enqueue all events (ret != num)
 	 */
 	int enq = ret < 0 ? 0 : ret;
 
+	if (stats_ena) {
+		stamped -= queue_stats_unstamp(&events[enq], num - enq);
+		queue_stats_enqueued(q_elem, stamped);
+	}
+
 	/* Restore EM vector event-table before returning vector to user */
 	if (esv_ena) {
 		for (int i = enq; i < num; i++) {
@@ -1303,15 +1331,25 @@ send_local(em_event_t event, const queue_elem_t *q_elem)
 	em_queue_t queue = (em_queue_t)(uintptr_t)q_elem->queue;
 	stash_entry_t entry = {.qidx = queue_hdl2idx(queue),
 			       .evptr = evhdl.evptr};
+	const bool stats_ena = queue_stats_enabled();
+	int stamped = 0;
+
+	if (stats_ena)
+		stamped = queue_stats_stamp(&event, 1);
 
 	ret = odp_stash_put_u64(locm->local_queues.prio[prio].stash,
 				&entry.u64, 1);
 	if (likely(ret == 1)) {
 		locm->local_queues.empty = 0;
 		locm->local_queues.prio[prio].empty_prio = 0;
+		if (stats_ena)
+			queue_stats_enqueued(q_elem, stamped);
 		return EM_OK;
 	}
 
+	if (stats_ena)
+		queue_stats_unstamp(&event, 1);
+
 	return EM_ERR_LIB_FAILED;
 }
 
@@ -1336,8 +1374,22 @@ send_local_multi(const em_event_t events[], const int num,
 		entry_tbl[i].evptr = evhdl_tbl[i].evptr;
 	}
 
+	const bool stats_ena = queue_stats_enabled();
+	int stamped = 0;
+
+	if (stats_ena)
+		stamped = queue_stats_stamp(events, num);
+
 	int ret = odp_stash_put_u64(locm->local_queues.prio[prio].stash,
 				    &entry_tbl[0].u64, num);
+	const int enq = ret < 0 ? 0 : ret;
+
+	if (stats_ena) {
+		if (enq < num)
+			stamped -= queue_stats_unstamp(&events[enq], num - enq);
+		queue_stats_enqueued(q_elem, stamped);
+	}
+
 	if (likely(ret > 0)) {
 		locm->local_queues.empty = 0;
 		locm->local_queues.prio[prio].empty_prio = 0;
@@ -1347,6 +1399,40 @@ send_local_multi(const em_event_t events[], const int num,
 	return 0;
 }
 
+/**
+ * Send an immediate event (em_send_imm()) to a local queue: the payload is
+ * stored in the stash entry, see STASH_ENTRY_IMM.
+ */
+static inline em_status_t
+send_local_imm(uint64_t data, const queue_elem_t *q_elem)
+{
+	em_locm_t *const locm = &em_locm;
+	const em_queue_prio_t prio = q_elem->priority;
+	em_queue_t queue = (em_queue_t)(uintptr_t)q_elem->queue;
+	stash_entry_t entry = {.qidx = queue_hdl2idx(queue),
+			       .evptr = (data << 1) | STASH_ENTRY_IMM};
+
+	if (unlikely(EM_CHECK_LEVEL > 0 &&
+		     q_elem->state != EM_QUEUE_STATE_READY))
+		return EM_ERR_BAD_STATE;
+
+	int ret = odp_stash_put_u64(locm->local_queues.prio[prio].stash,
+				    &entry.u64, 1);
+	if (unlikely(ret != 1))
+		return EM_ERR_LIB_FAILED;
+
+	locm->local_queues.empty = 0;
+	locm->local_queues.prio[prio].empty_prio = 0;
+
+	return EM_OK;
+}
+
+static inline bool
+stash_entry_is_imm(stash_entry_t entry)
+{
+	return entry.evptr & STASH_ENTRY_IMM;
+}
+
 /**
  * Send one event to a queue of type EM_QUEUE_TYPE_OUTPUT
  */
@@ -1366,6 +1452,19 @@ send_output(em_event_t event, queue_elem_t *const output_q_elem)
 	 * Order is maintained by enqueuing and dequeuing into an odp-queue
 	 * that takes care of order.
 	 */
+	if (sched_ctx_type == EM_SCHED_CONTEXT_TYPE_ORDERED &&
+	    em_locm.current.sched_q_elem->flags.order_lock) {
+		/* Buffer, output in order at the end of the ordered context */
+		output_queue_ordered_t *const ord = &em_locm.output_queue_ordered;
+
+		if (unlikely(ord->num >= EM_OUTPUT_ORDER_LOCK_BUF))
+			return EM_ERR_ALLOC_FAILED;
+		ord->events[ord->num] = event;
+		ord->q_elems[ord->num] = output_q_elem;
+		ord->num++;
+		return EM_OK;
+	}
+
 	if (sched_ctx_type == EM_SCHED_CONTEXT_TYPE_ORDERED) {
 		const odp_queue_t odp_queue = output_q_elem->odp_queue;
 		odp_event_t odp_event = event_em2odp(event);
@@ -1437,6 +1536,21 @@ send_output_multi(const em_event_t events[], const unsigned int num,
 	 * Order is maintained by enqueuing and dequeuing into an odp-queue
 	 * that takes care of order.
 	 */
+	if (sched_ctx_type == EM_SCHED_CONTEXT_TYPE_ORDERED &&
+	    em_locm.current.sched_q_elem->flags.order_lock) {
+		/* Buffer, output in order at the end of the ordered context */
+		output_queue_ordered_t *const ord = &em_locm.output_queue_ordered;
+
+		if (unlikely(ord->num + num > EM_OUTPUT_ORDER_LOCK_BUF))
+			return 0;
+		for (unsigned int i = 0; i < num; i++) {
+			ord->events[ord->num + i] = events[i];
+			ord->q_elems[ord->num + i] = output_q_elem;
+		}
+		ord->num += num;
+		return num;
+	}
+
 	if (sched_ctx_type == EM_SCHED_CONTEXT_TYPE_ORDERED) {
 		const odp_queue_t odp_queue = output_q_elem->odp_queue;
 		odp_event_t odp_events[num];
@@ -99,6 +99,18 @@ typedef union {
 COMPILE_TIME_ASSERT(sizeof(stash_entry_t) == sizeof(uint64_t),
 		    STASH_ENTRY_T_SIZE_ERROR);
 
+/**
+ * Immediate event (em_send_imm()) tag in the lowest bit of
+ * 'stash_entry_t::evptr', the 47-bit payload is in the bits above it.
+ * ODP event handles are aligned pointers, the bit is never set for them,
+ * checked at init by event_init().
+ * The em_event_t handle given to the EO is 'evptr' as is.
+ */
+#define STASH_ENTRY_IMM  1
+
+COMPILE_TIME_ASSERT(EM_EVENT_IMM_DATA_MAX == (UINT64_C(1) << (48 - 1)) - 1,
+		    EM_EVENT_IMM_DATA_MAX__SIZE_ERROR);
+
 /**
  * Event-state counters: 'evgen', 'ref_cnt' and 'send_cnt'.
  *
@@ -203,8 +215,13 @@ typedef struct event_hdr {
 			 * See em_tmo_type_t. Initially 0 = EM_TMO_TYPE_NONE
 			 */
 			uint16_t tmo_type  : 2;
+			/**
+			 * Indicate that 'enq_ns' holds the enqueue time for the
+			 * queue statistics. Set on send, cleared on dequeue.
+			 */
+			uint16_t enq_ts    : 1;
 			/** reserved bits */
-			uint16_t rsvd      : 13;
+			uint16_t rsvd      : 12;
 		};
 	} flags;
 
@@ -255,12 +272,20 @@ typedef struct event_hdr {
 	 */
 	uint16_t align_offset;
 
-	/**
-	 * Holds the tmo handle in case event is used as timeout indication.
-	 * Only valid if flags.tmo_type is not EM_TMO_TYPE_NONE (0).
-	 * Initialized only when used as timeout indication by timer code.
-	 */
-	em_tmo_t tmo;
+	union {
+		/**
+		 * Holds the tmo handle in case event is used as timeout indication.
+		 * Only valid if flags.tmo_type is not EM_TMO_TYPE_NONE (0).
+		 * Initialized only when used as timeout indication by timer code.
+		 */
+		em_tmo_t tmo;
+		/**
+		 * Enqueue time (ns) used by the queue statistics.
+		 * Only valid if flags.enq_ts is set, never set for timeout
+		 * indications (flags.tmo_type != EM_TMO_TYPE_NONE).
+		 */
+		uint64_t enq_ns;
+	};
 
 	/**
 	 * End of event header data,
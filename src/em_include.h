@@ -53,6 +53,7 @@ extern "C" {
 #include <event_machine/helper/event_machine_helper.h>
 #include <event_machine/platform/env/environment.h>
 #include <event_machine/platform/add-ons/event_machine_timer_hw_specific.h>
+#include <event_machine/platform/event_machine_odp_ext.h>
 
 /* ODP API */
 #include <odp_api.h>
@@ -90,14 +91,17 @@ extern "C" {
 #include "em_sync_api_types.h"
 #include "em_hook_types.h"
 #include "em_libconfig_types.h"
+#include "em_trace_types.h"
 #include "add-ons/event_timer/em_timer_types.h"
 #include "em_cli_types.h"
+#include "em_coro_types.h"
 
 #include "em_mem.h"
 
 #include "em_error.h"
 #include "em_event_state.h"
 #include "em_event_inline.h"
+#include "em_queue_stats.h"
 #include "em_queue_inline.h"
 
 #include "em_core.h"
@@ -110,11 +114,14 @@ extern "C" {
 #include "em_queue_group.h"
 #include "em_event_group.h"
 #include "em_atomic_group.h"
+#include "em_trace.h"
 #include "em_hooks.h"
 #include "em_dispatcher.h"
 #include "em_libconfig.h"
 #include "em_chaining.h"
 #include "em_cli.h"
+#include "em_metrics.h"
+#include "em_coro.h"
 
 #ifdef __cplusplus
 }
@@ -337,6 +337,7 @@ static void print_mem_info(void)
 	       "\t\t\t\t ------\t   ----\n"
 	       "current:\t\t\t%5zu B\t%5zu B\n"
 	       "idle_state:\t\t\t%5zu B\t%5zu B\n"
+	       "core_util:\t\t\t%5zu B\t%5zu B\n"
 	       "core_id:\t\t\t%5zu B\t%5zu B\n"
 	       "event_burst_cnt:\t\t%5zu B\t%5zu B\n"
 	       "atomic_group_released:\t\t%5zu B\t%5zu B\n"
@@ -360,6 +361,8 @@ static void print_mem_info(void)
 	       sizeof_field(em_locm_t, current),
 	       offsetof(em_locm_t, idle_state),
 	       sizeof_field(em_locm_t, idle_state),
+	       offsetof(em_locm_t, core_util),
+	       sizeof_field(em_locm_t, core_util),
 	       offsetof(em_locm_t, core_id),
 	       sizeof_field(em_locm_t, core_id),
 	       offsetof(em_locm_t, event_burst_cnt),
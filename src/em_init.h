@@ -81,6 +81,7 @@ typedef struct {
 
 	struct {
 		unsigned int min_events_default; /* default min nbr of events */
+		bool statistics;
 		struct {
 		int map_mode;
 		int custom_map[EM_QUEUE_PRIO_NUM];
@@ -105,6 +106,12 @@ typedef struct {
 		int port;
 	} cli;
 
+	struct {
+		bool enable;
+		const char *ip_addr;
+		int port;
+	} metrics;
+
 	struct {
 		unsigned int poll_ctrl_interval;
 		uint64_t poll_ctrl_interval_ns;
@@ -134,6 +141,11 @@ typedef struct {
 		uint32_t num;
 		startup_pool_conf_t conf[EM_CONFIG_POOLS];
 	} startup_pools;
+
+	struct {
+		bool enable;
+		unsigned int num_records; /* per core, power of two */
+	} trace;
 } opt_t;
 
 em_status_t
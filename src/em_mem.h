@@ -65,6 +65,8 @@ typedef struct {
 	opt_t opt ENV_CACHE_LINE_ALIGNED;
 	/** Mapping between physical core id <-> EM core id */
 	core_map_t core_map ENV_CACHE_LINE_ALIGNED;
+	/** EM-core utilization counters, indexed by EM core id */
+	core_util_t core_util[EM_MAX_CORES] ENV_CACHE_LINE_ALIGNED;
 	/** Table of buffer/packet/event pools used by EM */
 	mpool_tbl_t mpool_tbl ENV_CACHE_LINE_ALIGNED;
 	/** Pool of free event/mempools */
@@ -134,6 +136,8 @@ typedef struct {
 	env_atomic32_t eo_count ENV_CACHE_LINE_ALIGNED;
 	/** Timer resources */
 	timer_storage_t timers ENV_CACHE_LINE_ALIGNED;
+	/** Event trace state */
+	trace_t trace ENV_CACHE_LINE_ALIGNED;
 	/** Current number of allocated queues */
 	env_atomic32_t queue_count ENV_CACHE_LINE_ALIGNED;
 	/** Current number of allocated queue groups */
@@ -191,8 +195,10 @@ typedef struct {
 	/** EM core/local current state */
 	em_locm_current_t current;
 
-	/** Idle state of the core, used when calling idle hooks */
+	/** Idle state of the core, used for utilization and idle hooks */
 	idle_state_t idle_state;
+	/** Utilization counters of this core in em_shm->core_util[] */
+	core_util_t *core_util;
 
 	/** EM core id for this core */
 	int core_id;
@@ -223,6 +229,11 @@ typedef struct {
 	/** Local queues, i.e. storage for events to local queues */
 	local_queues_t local_queues;
 
+	/** Deferred calls of this core, see em_defer() */
+	defer_ring_t defer;
+	/** Local queue events and deferred calls run in this dispatch round */
+	dispatch_local_cnt_t round_local;
+
 	/** EO start-function ongoing, buffer all events and send after start */
 	eo_elem_t *start_eo_elem;
 	/** The number of errors on a core */
@@ -243,6 +254,15 @@ typedef struct {
 	/** Track output-queues used during this dispatch round (burst) */
 	output_queue_track_t output_queue_track;
 
+	/** Output events buffered in an ordered context with an ordered lock */
+	output_queue_ordered_t output_queue_ordered;
+
+	/** Event trace ring of this core, NULL if not tracing */
+	trace_ring_t *trace_ring;
+
+	/** Coroutine pool of this core, NULL until a coroutine EO receives */
+	coro_locm_t *coro;
+
 	/** Guarantee that size is a multiple of cache line size */
 	void *end[0] ENV_CACHE_LINE_ALIGNED;
 } em_locm_t;
@@ -0,0 +1,718 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2023, Nokia Solutions and Networks
+ */
+
+#include "em_include.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/* Check for a stop request at least this often (ms) */
+#define METRICS_POLL_TMO_MS 200
+/* Max time to wait for the client request (ms) */
+#define METRICS_RECV_TMO_MS 1000
+/* Initial size of the snapshot buffer, grown as needed */
+#define METRICS_BUF_INIT_SIZE (16 * 1024)
+
+/* Growing string buffer for building the snapshot */
+typedef struct {
+	char *str;
+	size_t len;
+	size_t size;
+	bool failed;
+} metrics_buf_t;
+
+/* Metrics server state, only used by the process calling em_init/term() */
+static struct {
+	int listen_fd;
+	odp_atomic_u32_t stop;
+	odph_thread_t thread;
+	bool running;
+} metrics_srv = {.listen_fd = -1};
+
+__attribute__((format(printf, 2, 3)))
+static void buf_printf(metrics_buf_t *buf, const char *fmt, ...)
+{
+	va_list args;
+	int len;
+
+	if (buf->failed)
+		return;
+
+	while (1) {
+		const size_t avail = buf->size - buf->len;
+
+		va_start(args, fmt);
+		len = vsnprintf(&buf->str[buf->len], avail, fmt, args);
+		va_end(args);
+
+		if (unlikely(len < 0)) {
+			buf->failed = true;
+			return;
+		}
+		if ((size_t)len < avail)
+			break;
+
+		/* Too small, grow and retry */
+		size_t size = buf->size * 2;
+
+		while (size - buf->len <= (size_t)len)
+			size *= 2;
+
+		char *str = realloc(buf->str, size);
+
+		if (unlikely(!str)) {
+			buf->failed = true;
+			return;
+		}
+		buf->str = str;
+		buf->size = size;
+	}
+
+	buf->len += len;
+}
+
+/* Copy 'name' into 'label' escaping the chars not allowed in a label value */
+static const char *label_str(const char *name, char label[], size_t size)
+{
+	size_t n = 0;
+
+	for (; *name != '\0' && n + 2 < size; name++) {
+		if (*name == '"' || *name == '\\') {
+			label[n++] = '\\';
+			label[n++] = *name;
+		} else if (*name == '\n') {
+			label[n++] = '\\';
+			label[n++] = 'n';
+		} else {
+			label[n++] = *name;
+		}
+	}
+	label[n] = '\0';
+
+	return label;
+}
+
+static void metric_header(metrics_buf_t *buf, const char *name,
+			  const char *type, const char *help)
+{
+	buf_printf(buf, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+static void metrics_em(metrics_buf_t *buf)
+{
+	metric_header(buf, "em_cores", "gauge", "Number of EM-cores");
+	buf_printf(buf, "em_cores %d\n", em_core_count());
+
+	metric_header(buf, "em_objects", "gauge", "Number of created EM objects");
+	buf_printf(buf, "em_objects{type=\"eo\"} %u\n",
+		   env_atomic32_get(&em_shm->eo_count));
+	buf_printf(buf, "em_objects{type=\"queue\"} %u\n",
+		   env_atomic32_get(&em_shm->queue_count));
+	buf_printf(buf, "em_objects{type=\"queue_group\"} %u\n",
+		   env_atomic32_get(&em_shm->queue_group_count));
+	buf_printf(buf, "em_objects{type=\"event_group\"} %u\n",
+		   env_atomic32_get(&em_shm->event_group_count));
+	buf_printf(buf, "em_objects{type=\"atomic_group\"} %u\n",
+		   env_atomic32_get(&em_shm->atomic_group_count));
+	buf_printf(buf, "em_objects{type=\"pool\"} %u\n",
+		   env_atomic32_get(&em_shm->pool_count));
+}
+
+/*
+ * Metric family with one sample per object, the value is the uint64_t at
+ * 'offset' in the sampled struct. In the text format all the lines of a
+ * family must form one group: header first, then the samples of all objects.
+ */
+typedef struct {
+	const char *name;
+	const char *type;
+	const char *help;
+	size_t offset;
+	/* Value in ns, printed in seconds */
+	bool ns;
+} metric_family_t;
+
+static uint64_t metric_value(const void *sample, const metric_family_t *family)
+{
+	return *(const uint64_t *)(const void *)((const uint8_t *)sample + family->offset);
+}
+
+static void metric_sample(metrics_buf_t *buf, const metric_family_t *family,
+			  const char *labels, uint64_t value)
+{
+	if (family->ns)
+		buf_printf(buf, "%s{%s} %.9f\n", family->name, labels, (double)value / 1e9);
+	else
+		buf_printf(buf, "%s{%s} %" PRIu64 "\n", family->name, labels, value);
+}
+
+static const metric_family_t core_families[] = {
+	{"em_core_busy_seconds_total", "counter",
+	 "Time the EM-core has been busy dispatching events",
+	 offsetof(em_core_util_t, busy_ns), true},
+	{"em_core_idle_seconds_total", "counter",
+	 "Time the EM-core has been idle",
+	 offsetof(em_core_util_t, idle_ns), true},
+	{"em_core_dispatch_rounds_total", "counter",
+	 "Dispatch rounds that got events from the scheduler",
+	 offsetof(em_core_util_t, rounds), false},
+	{"em_core_empty_rounds_total", "counter",
+	 "Dispatch rounds that got no events from the scheduler",
+	 offsetof(em_core_util_t, empty_rounds), false},
+	{"em_core_events_total", "counter",
+	 "Events received from the scheduler",
+	 offsetof(em_core_util_t, events), false},
+};
+
+static void metrics_cores(metrics_buf_t *buf)
+{
+	const int core_count = em_core_count();
+	em_core_util_t util[EM_MAX_CORES];
+	bool valid[EM_MAX_CORES];
+	char lbl[32];
+
+	/* Sample once, all families show the same values */
+	for (int i = 0; i < core_count; i++)
+		valid[i] = em_core_util(i, &util[i]) == EM_OK;
+
+	for (size_t f = 0; f < sizeof(core_families) / sizeof(core_families[0]); f++) {
+		const metric_family_t *family = &core_families[f];
+
+		metric_header(buf, family->name, family->type, family->help);
+		for (int i = 0; i < core_count; i++) {
+			if (!valid[i])
+				continue;
+			snprintf(lbl, sizeof(lbl), "core=\"%d\"", i);
+			metric_sample(buf, family, lbl, metric_value(&util[i], family));
+		}
+	}
+}
+
+/* Sampled pool, see metrics_pools() */
+typedef struct {
+	em_pool_info_t info;
+	em_pool_stats_t stats;
+	odp_pool_stats_opt_t opt;
+	bool has_stats;
+	char label[2 * EM_POOL_NAME_LEN];
+} pool_sample_t;
+
+enum {
+	POOL_EVENTS,
+	POOL_EVENTS_USED,
+	POOL_EVENTS_FREE,
+	POOL_ALLOC_OPS,
+	POOL_ALLOC_FAILS,
+	POOL_FREE_OPS,
+	POOL_FAMILIES
+};
+
+static const metric_family_t pool_families[POOL_FAMILIES] = {
+	[POOL_EVENTS] = {"em_pool_events", "gauge",
+			 "Number of events in the subpool"},
+	[POOL_EVENTS_USED] = {"em_pool_events_used", "gauge",
+			      "Number of allocated events in the subpool (needs pool statistics)"},
+	[POOL_EVENTS_FREE] = {"em_pool_events_free", "gauge",
+			      "Number of free events in the subpool (needs pool statistics)"},
+	[POOL_ALLOC_OPS] = {"em_pool_alloc_ops_total", "counter",
+			    "Successful alloc operations (needs pool statistics)"},
+	[POOL_ALLOC_FAILS] = {"em_pool_alloc_fails_total", "counter",
+			      "Failed alloc operations (needs pool statistics)"},
+	[POOL_FREE_OPS] = {"em_pool_free_ops_total", "counter",
+			   "Free operations (needs pool statistics)"},
+};
+
+/* Value of pool family 'f' for subpool 'j', false if not collected */
+static bool pool_value(const pool_sample_t *p, int j, int f, uint64_t *value /*out*/)
+{
+	const em_pool_subpool_stats_t *sp = &p->stats.subpool_stats[j];
+	const bool avail = p->opt.bit.available || p->opt.bit.cache_available;
+
+	switch (f) {
+	case POOL_EVENTS:
+		*value = p->info.subpool[j].num;
+		return true;
+	case POOL_EVENTS_USED:
+		*value = p->info.subpool[j].used;
+		return avail;
+	case POOL_EVENTS_FREE:
+		*value = p->info.subpool[j].free;
+		return avail;
+	case POOL_ALLOC_OPS:
+		*value = sp->alloc_ops;
+		return p->has_stats && p->opt.bit.alloc_ops;
+	case POOL_ALLOC_FAILS:
+		*value = sp->alloc_fails;
+		return p->has_stats && p->opt.bit.alloc_fails;
+	case POOL_FREE_OPS:
+		*value = sp->free_ops;
+		return p->has_stats && p->opt.bit.free_ops;
+	default:
+		return false;
+	}
+}
+
+static void metrics_pools(metrics_buf_t *buf)
+{
+	const mpool_tbl_t *const mpool_tbl = &em_shm->mpool_tbl;
+	pool_sample_t *const pools = calloc(EM_CONFIG_POOLS, sizeof(pool_sample_t));
+	int num = 0;
+
+	if (unlikely(!pools)) {
+		buf->failed = true;
+		return;
+	}
+
+	/* Sample once, all families show the same values */
+	for (int i = 0; i < EM_CONFIG_POOLS; i++) {
+		const mpool_elem_t *pool_elem = &mpool_tbl->pool[i];
+		pool_sample_t *p = &pools[num];
+
+		if (!pool_allocated(pool_elem) ||
+		    em_pool_info(pool_elem->em_pool, &p->info) != EM_OK)
+			continue;
+
+		p->opt = pool_elem->stats_opt;
+		p->has_stats = pool_elem->stats_opt.all != 0 &&
+			       em_pool_stats(pool_elem->em_pool, &p->stats) == EM_OK;
+		label_str(pool_elem->name, p->label, sizeof(p->label));
+		num++;
+	}
+
+	for (int f = 0; f < POOL_FAMILIES; f++) {
+		const metric_family_t *family = &pool_families[f];
+
+		metric_header(buf, family->name, family->type, family->help);
+		for (int i = 0; i < num; i++) {
+			const pool_sample_t *p = &pools[i];
+
+			for (int j = 0; j < p->info.num_subpools; j++) {
+				char lbl[sizeof(p->label) + 64];
+				uint64_t value;
+
+				if (!pool_value(p, j, f, &value))
+					continue;
+				snprintf(lbl, sizeof(lbl), "pool=\"%s\",subpool=\"%d\",size=\"%u\"",
+					 p->label, j, p->info.subpool[j].size);
+				metric_sample(buf, family, lbl, value);
+			}
+		}
+	}
+
+	free(pools);
+}
+
+/* Sampled queue, see metrics_queues() */
+typedef struct {
+	em_queue_stats_t stats;
+	uint64_t sojourn_sum_ns;
+	char lbl[2 * EM_QUEUE_NAME_LEN + 64];
+} queue_sample_t;
+
+static const metric_family_t queue_families[] = {
+	{"em_queue_enqueued_total", "counter",
+	 "Events sent into the queue",
+	 offsetof(em_queue_stats_t, enqueued), false},
+	{"em_queue_dequeued_total", "counter",
+	 "Sent events dispatched or dequeued from the queue",
+	 offsetof(em_queue_stats_t, dequeued), false},
+	{"em_queue_dequeued_ext_total", "counter",
+	 "Events dispatched or dequeued that were not sent with em_send (pktin, timer)",
+	 offsetof(em_queue_stats_t, dequeued_ext), false},
+	{"em_queue_depth", "gauge",
+	 "Estimated number of sent events in the queue",
+	 offsetof(em_queue_stats_t, depth), false},
+};
+
+static void metrics_queues(metrics_buf_t *buf)
+{
+	const queue_tbl_t *const queue_tbl = &em_shm->queue_tbl;
+	char qname[EM_QUEUE_NAME_LEN];
+	char label[2 * EM_QUEUE_NAME_LEN];
+	queue_sample_t *queues;
+	int num = 0;
+
+	if (!queue_stats_enabled())
+		return;
+
+	queues = malloc(EM_MAX_QUEUES * sizeof(queue_sample_t));
+	if (unlikely(!queues)) {
+		buf->failed = true;
+		return;
+	}
+
+	/* Sample once, all families show the same values */
+	for (int i = 0; i < EM_MAX_QUEUES; i++) {
+		const queue_elem_t *q_elem = &queue_tbl->queue_elem[i];
+		const em_queue_t queue = (em_queue_t)(uintptr_t)q_elem->queue;
+		queue_sample_t *q = &queues[num];
+
+		if (!queue_allocated(q_elem) || em_queue_stats(queue, &q->stats) != EM_OK)
+			continue;
+		if (q->stats.enqueued == 0 && q->stats.dequeued_ext == 0)
+			continue;
+
+		q->sojourn_sum_ns = env_atomic64_get(&queue_stats_get(q_elem)->sojourn_sum_ns);
+		queue_get_name(q_elem, qname, sizeof(qname));
+		snprintf(q->lbl, sizeof(q->lbl), "queue=\"%" PRI_QUEUE "\",name=\"%s\",type=\"%s\"",
+			 queue, label_str(qname, label, sizeof(label)),
+			 queue_get_type_str(q_elem->type));
+		num++;
+	}
+
+	for (size_t f = 0; f < sizeof(queue_families) / sizeof(queue_families[0]); f++) {
+		const metric_family_t *family = &queue_families[f];
+
+		metric_header(buf, family->name, family->type, family->help);
+		for (int i = 0; i < num; i++)
+			metric_sample(buf, family, queues[i].lbl,
+				      metric_value(&queues[i].stats, family));
+	}
+
+	metric_header(buf, "em_queue_sojourn_seconds", "histogram",
+		      "Time sent events waited in the queue");
+	for (int i = 0; i < num; i++) {
+		const queue_sample_t *q = &queues[i];
+		/* Cumulative buckets, bucket 'j' upper limit is 2^(10+j) ns */
+		uint64_t cum = 0;
+
+		for (int j = 0; j < EM_QUEUE_STATS_HIST_BUCKETS - 1; j++) {
+			cum += q->stats.sojourn_hist[j];
+			buf_printf(buf, "em_queue_sojourn_seconds_bucket{%s,le=\"%.9g\"} %" PRIu64 "\n",
+				   q->lbl, (double)(UINT64_C(1) << (10 + j)) / 1e9, cum);
+		}
+		buf_printf(buf, "em_queue_sojourn_seconds_bucket{%s,le=\"+Inf\"} %" PRIu64 "\n",
+			   q->lbl, q->stats.dequeued);
+		buf_printf(buf, "em_queue_sojourn_seconds_sum{%s} %.9f\n", q->lbl,
+			   (double)q->sojourn_sum_ns / 1e9);
+		buf_printf(buf, "em_queue_sojourn_seconds_count{%s} %" PRIu64 "\n",
+			   q->lbl, q->stats.dequeued);
+	}
+
+	free(queues);
+}
+
+static void metrics_eos(metrics_buf_t *buf)
+{
+	const eo_tbl_t *const eo_tbl = &em_shm->eo_tbl;
+	char label[2 * EM_EO_NAME_LEN];
+
+	metric_header(buf, "em_eo_queues", "gauge", "Number of queues added to the EO");
+	for (int i = 0; i < EM_MAX_EOS; i++) {
+		const eo_elem_t *eo_elem = &eo_tbl->eo_elem[i];
+
+		if (!eo_allocated(eo_elem))
+			continue;
+
+		label_str(eo_elem->name, label, sizeof(label));
+		buf_printf(buf, "em_eo_queues{eo=\"%" PRI_EO "\",name=\"%s\"} %u\n",
+			   eo_elem->eo, label, env_atomic32_get(&eo_elem->num_queues));
+	}
+
+	metric_header(buf, "em_eo_running", "gauge", "EO is running (started)");
+	for (int i = 0; i < EM_MAX_EOS; i++) {
+		const eo_elem_t *eo_elem = &eo_tbl->eo_elem[i];
+
+		if (!eo_allocated(eo_elem))
+			continue;
+
+		label_str(eo_elem->name, label, sizeof(label));
+		buf_printf(buf, "em_eo_running{eo=\"%" PRI_EO "\",name=\"%s\"} %d\n",
+			   eo_elem->eo, label, eo_elem->state == EM_EO_STATE_RUNNING);
+	}
+}
+
+static void metrics_timers(metrics_buf_t *buf)
+{
+	const timer_storage_t *const tmrs = &em_shm->timers;
+	odp_timer_pool_info_t info[EM_ODP_MAX_TIMERS];
+	bool valid[EM_ODP_MAX_TIMERS];
+	char label[2 * ODP_TIMER_POOL_NAME_LEN];
+
+	if (!em_shm->conf.event_timer)
+		return;
+
+	/* Sample once, both families show the same values */
+	for (int i = 0; i < EM_ODP_MAX_TIMERS; i++) {
+		const event_timer_t *timer = &tmrs->timer[i];
+
+		valid[i] = timer->odp_tmr_pool != ODP_TIMER_POOL_INVALID &&
+			   odp_timer_pool_info(timer->odp_tmr_pool, &info[i]) == 0;
+	}
+
+	metric_header(buf, "em_timer_timeouts", "gauge",
+		      "Number of allocated timeouts in the timer");
+	for (int i = 0; i < EM_ODP_MAX_TIMERS; i++) {
+		if (!valid[i])
+			continue;
+		label_str(info[i].name ? info[i].name : "", label, sizeof(label));
+		buf_printf(buf, "em_timer_timeouts{timer=\"%d\",name=\"%s\"} %u\n",
+			   i, label, info[i].cur_timers);
+	}
+
+	metric_header(buf, "em_timer_timeouts_max", "gauge",
+		      "High watermark of allocated timeouts in the timer");
+	for (int i = 0; i < EM_ODP_MAX_TIMERS; i++) {
+		if (!valid[i])
+			continue;
+		label_str(info[i].name ? info[i].name : "", label, sizeof(label));
+		buf_printf(buf, "em_timer_timeouts_max{timer=\"%d\",name=\"%s\"} %u\n",
+			   i, label, info[i].hwm_timers);
+	}
+}
+
+char *metrics_snapshot(size_t *len)
+{
+	metrics_buf_t buf = {.str = malloc(METRICS_BUF_INIT_SIZE),
+			     .size = METRICS_BUF_INIT_SIZE};
+
+	if (unlikely(!buf.str))
+		return NULL;
+	buf.str[0] = '\0';
+
+	metrics_em(&buf);
+	metrics_cores(&buf);
+	metrics_pools(&buf);
+	metrics_queues(&buf);
+	metrics_eos(&buf);
+	metrics_timers(&buf);
+
+	if (unlikely(buf.failed)) {
+		free(buf.str);
+		return NULL;
+	}
+
+	if (len)
+		*len = buf.len;
+	return buf.str;
+}
+
+static int send_all(int fd, const char *data, size_t len)
+{
+	while (len > 0) {
+		ssize_t ret = send(fd, data, len, MSG_NOSIGNAL);
+
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		data += ret;
+		len -= (size_t)ret;
+	}
+
+	return 0;
+}
+
+/* Answer one HTTP request (any path) with a snapshot */
+static void metrics_serve(int fd)
+{
+	const struct timeval tmo = {.tv_sec = METRICS_RECV_TMO_MS / 1000,
+				    .tv_usec = (METRICS_RECV_TMO_MS % 1000) * 1000};
+	char req[1024];
+	char hdr[256];
+	size_t len = 0;
+
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tmo, sizeof(tmo));
+	/* The request content does not matter, wait for it to avoid a RST */
+	if (recv(fd, req, sizeof(req), 0) <= 0)
+		return;
+
+	char *body = metrics_snapshot(&len);
+
+	if (unlikely(!body)) {
+		const char *err = "HTTP/1.0 500 Internal Server Error\r\n"
+				  "Content-Length: 0\r\n\r\n";
+
+		send_all(fd, err, strlen(err));
+		return;
+	}
+
+	int n = snprintf(hdr, sizeof(hdr), "HTTP/1.0 200 OK\r\n"
+			 "Content-Type: text/plain; version=0.0.4\r\n"
+			 "Content-Length: %zu\r\n\r\n", len);
+
+	if (send_all(fd, hdr, n) == 0)
+		send_all(fd, body, len);
+
+	free(body);
+}
+
+static int metrics_thr_fn(__attribute__((__unused__)) void *arg)
+{
+	init_ext_thread();
+
+	while (!odp_atomic_load_u32(&metrics_srv.stop)) {
+		struct pollfd pfd = {.fd = metrics_srv.listen_fd, .events = POLLIN};
+
+		if (poll(&pfd, 1, METRICS_POLL_TMO_MS) <= 0)
+			continue;
+
+		int fd = accept(metrics_srv.listen_fd, NULL, NULL);
+
+		if (fd < 0)
+			continue;
+		metrics_serve(fd);
+		close(fd);
+	}
+
+	return 0;
+}
+
+static int read_config_file(void)
+{
+	const char *conf_str;
+	bool val_bool = false;
+	int val = 0;
+	int ret;
+
+	EM_PRINT("EM metrics config:\n");
+
+	conf_str = "metrics.enable";
+	ret = em_libconfig_lookup_bool(&em_shm->libconfig, conf_str, &val_bool);
+	if (unlikely(!ret)) {
+		EM_LOG(EM_LOG_ERR, "Config option '%s' not found\n", conf_str);
+		return -1;
+	}
+	em_shm->opt.metrics.enable = val_bool;
+	EM_PRINT("  %s: %s(%d)\n", conf_str, val_bool ? "true" : "false", val_bool);
+
+	conf_str = "metrics.ip_addr";
+	ret = em_libconfig_lookup_string(&em_shm->libconfig, conf_str,
+					 &em_shm->opt.metrics.ip_addr);
+	if (unlikely(!ret)) {
+		EM_LOG(EM_LOG_ERR, "Config option '%s' not found\n", conf_str);
+		return -1;
+	}
+	EM_PRINT("  %s: %s\n", conf_str, em_shm->opt.metrics.ip_addr);
+
+	conf_str = "metrics.port";
+	ret = em_libconfig_lookup_int(&em_shm->libconfig, conf_str, &val);
+	if (unlikely(!ret)) {
+		EM_LOG(EM_LOG_ERR, "Config option '%s' not found\n", conf_str);
+		return -1;
+	}
+	if (val <= 0 || val > UINT16_MAX) {
+		EM_LOG(EM_LOG_ERR, "Bad config value '%s = %d'\n", conf_str, val);
+		return -1;
+	}
+	em_shm->opt.metrics.port = val;
+	EM_PRINT("  %s: %d\n", conf_str, val);
+
+	return 0;
+}
+
+static int metrics_socket_open(void)
+{
+	struct sockaddr_in addr = {.sin_family = AF_INET,
+				   .sin_port = htons((uint16_t)em_shm->opt.metrics.port)};
+	const int one = 1;
+
+	if (inet_pton(AF_INET, em_shm->opt.metrics.ip_addr, &addr.sin_addr) != 1) {
+		EM_LOG(EM_LOG_ERR, "Invalid metrics.ip_addr:%s\n",
+		       em_shm->opt.metrics.ip_addr);
+		return -1;
+	}
+
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+	if (fd < 0) {
+		EM_LOG(EM_LOG_ERR, "Metrics socket() failed:%s\n", strerror(errno));
+		return -1;
+	}
+
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+	    listen(fd, 4)) {
+		EM_LOG(EM_LOG_ERR, "Metrics socket bind/listen %s:%d failed:%s\n",
+		       em_shm->opt.metrics.ip_addr, em_shm->opt.metrics.port,
+		       strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+em_status_t metrics_init(void)
+{
+	if (read_config_file())
+		return EM_ERR_LIB_FAILED;
+
+	if (!em_shm->opt.metrics.enable)
+		return EM_OK;
+
+	metrics_srv.listen_fd = metrics_socket_open();
+	if (metrics_srv.listen_fd < 0)
+		return EM_ERR_LIB_FAILED;
+	odp_atomic_init_u32(&metrics_srv.stop, 0);
+
+	/* Run the server on a control thread, like the EM CLI */
+	odp_cpumask_t cpumask;
+	odph_thread_common_param_t thr_common;
+	odph_thread_param_t thr_param;
+	odp_instance_t instance;
+
+	if (odp_cpumask_default_control(&cpumask, 1) != 1 ||
+	    odp_instance(&instance)) {
+		EM_LOG(EM_LOG_ERR, "Metrics thread setup failed\n");
+		goto error;
+	}
+
+	odph_thread_common_param_init(&thr_common);
+	thr_common.instance = instance;
+	thr_common.cpumask = &cpumask;
+	thr_common.thread_model = 0; /* 0: Use pthread */
+
+	odph_thread_param_init(&thr_param);
+	thr_param.thr_type = ODP_THREAD_CONTROL;
+	thr_param.start = metrics_thr_fn;
+	thr_param.arg = NULL;
+
+	if (odph_thread_create(&metrics_srv.thread, &thr_common, &thr_param, 1) != 1) {
+		EM_LOG(EM_LOG_ERR, "Failed to create metrics server thread\n");
+		goto error;
+	}
+	metrics_srv.running = true;
+
+	EM_PRINT("Serving EM metrics on http://%s:%d/metrics\n",
+		 em_shm->opt.metrics.ip_addr, em_shm->opt.metrics.port);
+
+	return EM_OK;
+
+error:
+	close(metrics_srv.listen_fd);
+	metrics_srv.listen_fd = -1;
+	return EM_ERR_LIB_FAILED;
+}
+
+em_status_t metrics_term(void)
+{
+	em_status_t stat = EM_OK;
+
+	if (metrics_srv.running) {
+		odp_atomic_store_u32(&metrics_srv.stop, 1);
+		if (odph_thread_join(&metrics_srv.thread, 1) != 1) {
+			EM_LOG(EM_LOG_ERR, "Failed to join metrics server thread\n");
+			stat = EM_ERR_LIB_FAILED;
+		}
+		metrics_srv.running = false;
+	}
+
+	if (metrics_srv.listen_fd >= 0) {
+		close(metrics_srv.listen_fd);
+		metrics_srv.listen_fd = -1;
+	}
+
+	return stat;
+}
@@ -0,0 +1,40 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2023, Nokia Solutions and Networks
+ */
+
+/**
+ * @file
+ * EM internal metrics exporter
+ *
+ * Serves a snapshot of the EM pool, queue, EO, core and timer statistics in
+ * the Prometheus text exposition format over a local TCP socket, see the
+ * 'metrics' section in config/em-odp.conf. The snapshot is built on a
+ * control thread from the shared counters, the EM-cores are not involved.
+ */
+
+#ifndef EM_METRICS_H_
+#define EM_METRICS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+em_status_t metrics_init(void);
+em_status_t metrics_term(void);
+
+/**
+ * Build a snapshot of the EM metrics in the Prometheus text format
+ *
+ * @param[out] len  Length of the returned string (optional, can be NULL)
+ *
+ * @return Null-terminated string allocated with malloc(), free with free().
+ *         NULL on allocation failure.
+ */
+char *metrics_snapshot(size_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EM_METRICS_H_ */
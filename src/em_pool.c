@@ -1227,6 +1227,8 @@ pool_init(mpool_tbl_t *const mpool_tbl, mpool_pool_t *const mpool_pool,
 			mpool_elem->odp_pool[j] = ODP_POOL_INVALID;
 			mpool_elem->size[j] = 0;
 		}
+		odp_atomic_init_u32(&mpool_elem->wmark.enabled, 0);
+		odp_atomic_init_u32(&mpool_elem->wmark.is_low, 0);
 
 		objpool_add(&mpool_pool->objpool, i % cores,
 			    &mpool_elem->objpool_elem);
@@ -1238,6 +1240,13 @@ pool_init(mpool_tbl_t *const mpool_tbl, mpool_pool_t *const mpool_pool,
 	for (int i = 0; i < POOL_ODP2EM_TBL_LEN; i++)
 		mpool_tbl->pool_odp2em[i] = EM_POOL_UNDEF;
 
+	odp_atomic_init_u32(&mpool_tbl->wmark_pools, 0);
+	for (int i = 0; i <= EM_MAX_CORES; i++) {
+		for (int j = 0; j < EM_CONFIG_POOLS; j++) {
+			odp_atomic_init_u64(&mpool_tbl->wmark_cnt[i].ops[j], 0);
+		}
+	}
+
 	/* Store common ODP pool capabilities in the mpool_tbl for easy access*/
 	if (odp_pool_capability(&mpool_tbl->odp_pool_capability) != 0)
 		return EM_ERR_LIB_FAILED;
@@ -1981,9 +1990,55 @@ pool_delete(em_pool_t pool)
 	mpool_elem->event_type = EM_EVENT_TYPE_UNDEF;
 	mpool_elem->num_subpools = 0;
 
+	if (odp_atomic_load_u32(&mpool_elem->wmark.enabled)) {
+		odp_atomic_store_u32(&mpool_elem->wmark.enabled, 0);
+		odp_atomic_dec_u32(&mpool_tbl->wmark_pools);
+	}
+
 	return pool_free(pool);
 }
 
+/**
+ * Check the pool watermarks and call the user callback if one was crossed
+ *
+ * The number of free events is read from the ODP pool statistics, so also
+ * events allocated and freed outside of EM (pktio) are seen. Only the counters
+ * selected in em_pool_wmark_set() are read, not all enabled pool statistics.
+ */
+void pool_wmark_check(mpool_elem_t *const pool_elem)
+{
+	uint64_t free_sum = 0;
+
+	for (int i = 0; i < pool_elem->num_subpools; i++) {
+		odp_pool_stats_selected_t odp_stats;
+
+		if (unlikely(odp_pool_stats_selected(pool_elem->odp_pool[i], &odp_stats,
+						     &pool_elem->wmark.opt) != 0))
+			return;
+		/* Only the selected counters are valid */
+		if (pool_elem->wmark.opt.bit.available)
+			free_sum += odp_stats.available;
+		if (pool_elem->wmark.opt.bit.cache_available)
+			free_sum += odp_stats.cache_available;
+	}
+
+	const uint32_t num_free = free_sum > pool_elem->wmark.num ?
+				  pool_elem->wmark.num : (uint32_t)free_sum;
+
+	/* Only the core that flips 'is_low' calls the callback */
+	uint32_t is_low = num_free < pool_elem->wmark.low ? 0 : 1;
+
+	if (is_low == 0) {
+		if (odp_atomic_cas_u32(&pool_elem->wmark.is_low, &is_low, 1))
+			pool_elem->wmark.func(pool_elem->em_pool, EM_POOL_WMARK_LOW,
+					      num_free, pool_elem->wmark.arg);
+	} else if (num_free >= pool_elem->wmark.high) {
+		if (odp_atomic_cas_u32(&pool_elem->wmark.is_low, &is_low, 0))
+			pool_elem->wmark.func(pool_elem->em_pool, EM_POOL_WMARK_HIGH,
+					      num_free, pool_elem->wmark.arg);
+	}
+}
+
 em_pool_t
 pool_find(const char *name)
 {
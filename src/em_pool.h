@@ -154,6 +154,121 @@ pool_odp2em(odp_pool_t odp_pool)
 	return em_shm->mpool_tbl.pool_odp2em[idx];
 }
 
+void pool_wmark_check(mpool_elem_t *const pool_elem);
+
+static inline pool_wmark_cnt_t *
+pool_wmark_cnt_get(void)
+{
+	const em_locm_t *const locm = &em_locm;
+	const int idx = locm->is_external_thr ? EM_MAX_CORES : locm->core_id;
+
+	return &em_shm->mpool_tbl.wmark_cnt[idx];
+}
+
+/* Add to a per core counter: load + store for an EM-core, atomic add when shared */
+static inline uint64_t
+pool_wmark_cnt_add(odp_atomic_u64_t *const cnt, uint64_t num)
+{
+	if (em_locm.is_external_thr)
+		return odp_atomic_fetch_add_u64(cnt, num) + num;
+
+	const uint64_t val = odp_atomic_load_u64(cnt) + num;
+
+	odp_atomic_store_u64(cnt, val);
+	return val;
+}
+
+/* Check the watermarks when the counter crosses a multiple of the interval */
+static inline bool
+pool_wmark_check_due(uint64_t cnt, uint64_t num)
+{
+	return cnt / POOL_WMARK_CHECK_INTERVAL !=
+	       (cnt - num) / POOL_WMARK_CHECK_INTERVAL;
+}
+
+/**
+ * Count operations on a pool with watermarks, sample the pool occupancy from
+ * the ODP pool statistics every POOL_WMARK_CHECK_INTERVAL operations on a core
+ */
+static inline void
+pool_wmark_ops(mpool_elem_t *const pool_elem, int num)
+{
+	const int pool_idx = pool_hdl2idx(pool_elem->em_pool);
+	pool_wmark_cnt_t *const wcnt = pool_wmark_cnt_get();
+	const uint64_t cnt = pool_wmark_cnt_add(&wcnt->ops[pool_idx], num);
+
+	if (pool_wmark_check_due(cnt, num))
+		pool_wmark_check(pool_elem);
+}
+
+/* EM pool of an ODP pool if it has watermarks set, otherwise NULL */
+static inline mpool_elem_t *
+pool_wmark_elem(odp_pool_t odp_pool)
+{
+	mpool_elem_t *const pool_elem = pool_elem_get(pool_odp2em(odp_pool));
+
+	if (!pool_elem || !odp_atomic_load_u32(&pool_elem->wmark.enabled))
+		return NULL;
+
+	return pool_elem;
+}
+
+/**
+ * Events allocated from a pool via the EM API
+ */
+static inline void
+pool_wmark_alloc(const mpool_elem_t *const pool_elem, int num)
+{
+	if (likely(!odp_atomic_load_u32(&pool_elem->wmark.enabled)) || num <= 0)
+		return;
+
+	pool_wmark_ops((mpool_elem_t *)(uintptr_t)pool_elem, num);
+}
+
+/**
+ * Events freed via the EM API
+ */
+static inline void
+pool_wmark_free(const odp_event_t odp_events[], int num)
+{
+	if (likely(odp_atomic_load_u32(&em_shm->mpool_tbl.wmark_pools) == 0))
+		return;
+
+	for (int i = 0; i < num; i++) {
+		const odp_event_type_t type = odp_event_type(odp_events[i]);
+		odp_pool_t odp_pool;
+
+		if (type == ODP_EVENT_PACKET)
+			odp_pool = odp_packet_pool(odp_packet_from_event(odp_events[i]));
+		else if (type == ODP_EVENT_BUFFER)
+			odp_pool = odp_buffer_pool(odp_buffer_from_event(odp_events[i]));
+		else if (type == ODP_EVENT_PACKET_VECTOR)
+			odp_pool = odp_packet_vector_pool(odp_packet_vector_from_event(odp_events[i]));
+		else
+			continue;
+
+		mpool_elem_t *const pool_elem = pool_wmark_elem(odp_pool);
+
+		if (pool_elem)
+			pool_wmark_ops(pool_elem, 1);
+	}
+}
+
+/**
+ * Packet entering EM from outside, e.g. received by pktin into an EM pool
+ */
+static inline void
+pool_wmark_pkt(odp_packet_t odp_pkt)
+{
+	if (likely(odp_atomic_load_u32(&em_shm->mpool_tbl.wmark_pools) == 0))
+		return;
+
+	mpool_elem_t *const pool_elem = pool_wmark_elem(odp_packet_pool(odp_pkt));
+
+	if (pool_elem)
+		pool_wmark_ops(pool_elem, 1);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -77,8 +77,43 @@ typedef struct {
 	em_pool_cfg_t pool_cfg;
 	/* Pool name */
 	char name[EM_POOL_NAME_LEN];
+	/** Occupancy watermarks, see em_pool_wmark_set() */
+	struct {
+		/** Watermarks set: 1, not set: 0 */
+		odp_atomic_u32_t enabled;
+		/** Free events are below 'low': 1, else 0 */
+		odp_atomic_u32_t is_low;
+		uint32_t low;
+		uint32_t high;
+		/** Total number of events in all subpools */
+		uint32_t num;
+		/** ODP pool statistics read to get the number of free events */
+		odp_pool_stats_opt_t opt;
+		em_pool_wmark_func_t func;
+		void *arg;
+	} wmark;
 } mpool_elem_t;
 
+/**
+ * Sample the ODP pool statistics of a pool with watermarks every
+ * POOL_WMARK_CHECK_INTERVAL alloc/free/pktin operations on a core, i.e. the
+ * cost of reading the statistics is spread over the operations
+ */
+#define POOL_WMARK_CHECK_INTERVAL  64
+
+/**
+ * Operation counters of pools with watermarks, per core
+ *
+ * Only decide when to sample the pool occupancy. Written only by the owning
+ * EM-core. The entry after the EM-cores is shared by all external (non
+ * EM-core) threads.
+ */
+typedef struct {
+	odp_atomic_u64_t ops[EM_CONFIG_POOLS];
+	/* Pad size to a multiple of cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} pool_wmark_cnt_t ENV_CACHE_LINE_ALIGNED;
+
 /**
  * @def POOL_ODP2EM_TBL_LEN
  * Length of the mpool_tbl_t::pool_odp2em[] array
@@ -107,6 +142,11 @@ typedef struct {
 
 	/** ODP pool capabilities common for all pools */
 	odp_pool_capability_t odp_pool_capability ENV_CACHE_LINE_ALIGNED;
+
+	/** Number of pools with watermarks set */
+	odp_atomic_u32_t wmark_pools ENV_CACHE_LINE_ALIGNED;
+	/** Per core operation counters for the pool watermarks */
+	pool_wmark_cnt_t wmark_cnt[EM_MAX_CORES + 1];
 } mpool_tbl_t;
 
 /**
@@ -84,6 +84,7 @@ static int
 read_config_file(void)
 {
 	const char *conf_str;
+	bool val_bool = false;
 	int val = 0;
 	int ret;
 
@@ -107,6 +108,18 @@ read_config_file(void)
 	em_shm->opt.queue.min_events_default = val;
 	EM_PRINT("  %s: %d\n", conf_str, val);
 
+	/*
+	 * Option: queue.statistics
+	 */
+	conf_str = "queue.statistics";
+	ret = em_libconfig_lookup_bool(&em_shm->libconfig, conf_str, &val_bool);
+	if (unlikely(!ret)) {
+		EM_LOG(EM_LOG_ERR, "Config option '%s' not found\n", conf_str);
+		return -1;
+	}
+	em_shm->opt.queue.statistics = val_bool;
+	EM_PRINT("  %s: %s(%d)\n", conf_str, val_bool ? "true" : "false", val_bool);
+
 	/*
 	 * Option: queue.prio_map_mode
 	 */
@@ -237,6 +250,12 @@ queue_init(queue_tbl_t *const queue_tbl,
 	ret = queue_init_prio_map(min, max, em_shm->queue_prio.num_runtime);
 	RETURN_ERROR_IF(ret != 0, EM_ERR_LIB_FAILED, EM_ESCOPE_INIT,
 			"mapping odp priorities failed: %d", ret);
+
+	/* Reserve the queue statistics if enabled in the config file */
+	em_status_t stat = queue_stats_init();
+
+	RETURN_ERROR_IF(stat != EM_OK, stat, EM_ESCOPE_INIT,
+			"queue_stats_init() failed:%" PRI_STAT "", stat);
 	return EM_OK;
 }
 
@@ -300,6 +319,7 @@ queue_init_local(void)
 
 	memset(&locm->output_queue_track, 0,
 	       sizeof(locm->output_queue_track));
+	locm->output_queue_ordered.num = 0;
 
 	return EM_OK;
 }
@@ -315,23 +335,32 @@ queue_term_local(void)
 	stash_entry_t entry_tbl[EM_QUEUE_LOCAL_MULTI_MAX_BURST];
 	em_event_t ev_tbl[EM_QUEUE_LOCAL_MULTI_MAX_BURST];
 	event_hdr_t *ev_hdr_tbl[EM_QUEUE_LOCAL_MULTI_MAX_BURST];
+	em_queue_prio_t prio;
 	em_status_t stat = EM_OK;
 
 	for (;;) {
 		int num = next_local_queue_events(entry_tbl /*[out]*/,
-						  EM_QUEUE_LOCAL_MULTI_MAX_BURST);
+						  EM_QUEUE_LOCAL_MULTI_MAX_BURST,
+						  &prio /*out*/);
 		if (num <= 0)
 			break;
 
-		for (int i = 0; i < num; i++)
-			ev_tbl[i] = (em_event_t)(uintptr_t)entry_tbl[i].evptr;
+		int num_ev = 0;
+
+		/* Immediate events (em_send_imm()) have nothing to free */
+		for (int i = 0; i < num; i++) {
+			if (!stash_entry_is_imm(entry_tbl[i]))
+				ev_tbl[num_ev++] = (em_event_t)(uintptr_t)entry_tbl[i].evptr;
+		}
+		if (num_ev == 0)
+			continue;
 
-		event_to_hdr_multi(ev_tbl, ev_hdr_tbl, num);
+		event_to_hdr_multi(ev_tbl, ev_hdr_tbl, num_ev);
 
 		if (esv_enabled())
-			evstate_em2usr_multi(ev_tbl, ev_hdr_tbl, num,
+			evstate_em2usr_multi(ev_tbl, ev_hdr_tbl, num_ev,
 					     EVSTATE__TERM_CORE__QUEUE_LOCAL);
-		em_free_multi(ev_tbl, num);
+		em_free_multi(ev_tbl, num_ev);
 	}
 
 	for (int prio = 0; prio < EM_QUEUE_PRIO_NUM; prio++) {
@@ -732,6 +761,9 @@ void queue_setup_common(queue_elem_t *q_elem /*out*/,
 			 "%s%" PRI_QUEUE "", EM_Q_BASENAME, queue);
 	qname[EM_QUEUE_NAME_LEN - 1] = '\0';
 
+	if (queue_stats_enabled())
+		queue_stats_reset(q_elem);
+
 	q_elem->flags.all = 0;
 	/* Init q_elem fields based on setup params and clear the rest */
 	q_elem->type = (uint8_t)setup->type;
@@ -909,6 +941,27 @@ queue_setup_scheduled(queue_elem_t *q_elem /*in,out*/,
 		return -6;
 	}
 
+	if (setup->conf->flags & EM_QUEUE_FLAG_ORDER_LOCK) {
+		if (setup->type != EM_QUEUE_TYPE_PARALLEL_ORDERED) {
+			*err_str = "Q-setup-sched: order lock only for ordered queues";
+			return -7;
+		}
+		if (odp_sched_capa->max_ordered_locks < 1) {
+			*err_str = "Q-setup-sched: ordered locks unavailable";
+			return -8;
+		}
+		odp_queue_param.sched.lock_count = 1;
+		q_elem->flags.order_lock = true;
+	}
+
+	if (setup->conf->flags & EM_QUEUE_FLAG_INLINE) {
+		if (setup->type != EM_QUEUE_TYPE_PARALLEL) {
+			*err_str = "Q-setup-sched: inline send only for parallel queues";
+			return -9;
+		}
+		q_elem->flags.inline_send = true;
+	}
+
 	/*
 	 * Note: The ODP queue context points to the EM queue elem.
 	 * The EM queue context set by the user using the API function
@@ -927,7 +980,7 @@ queue_setup_scheduled(queue_elem_t *q_elem /*in,out*/,
 	err = create_odp_queue(q_elem, &odp_queue_param);
 	if (unlikely(err)) {
 		*err_str = "Q-setup-sched: scheduled odp queue creation failed!";
-		return -7;
+		return -10;
 	}
 
 	/*
@@ -122,7 +122,20 @@ queue_unsched_enqueue_multi(const em_event_t events[], int num,
 
 	events_em2odp(events, odp_events, num);
 
+	const bool stats_ena = queue_stats_enabled();
+	int stamped = 0;
+
+	if (stats_ena)
+		stamped = queue_stats_stamp(events, num);
+
 	ret = odp_queue_enq_multi(odp_queue, odp_events, num);
+	if (stats_ena) {
+		const int enq = ret < 0 ? 0 : ret;
+
+		if (enq < num)
+			stamped -= queue_stats_unstamp(&events[enq], num - enq);
+		queue_stats_enqueued(q_elem, stamped);
+	}
 	if (unlikely(ret < 0))
 		return 0;
 
@@ -149,15 +162,28 @@ queue_unsched_enqueue(em_event_t event, const queue_elem_t *const q_elem)
 		     q_elem->state != EM_QUEUE_STATE_UNSCHEDULED))
 		return EM_ERR_BAD_STATE;
 
+	const bool stats_ena = queue_stats_enabled();
+	int stamped = 0;
+
+	if (stats_ena)
+		stamped = queue_stats_stamp(&event, 1);
+
 	ret = odp_queue_enq(odp_queue, odp_event);
-	if (unlikely(EM_CHECK_LEVEL > 0 && ret != 0))
+	if (unlikely(EM_CHECK_LEVEL > 0 && ret != 0)) {
+		if (stats_ena)
+			queue_stats_unstamp(&event, 1);
 		return EM_ERR_LIB_FAILED;
+	}
+
+	if (stats_ena)
+		queue_stats_enqueued(q_elem, stamped);
 
 	return EM_OK;
 }
 
 static inline int
-next_local_queue_events(stash_entry_t entry_tbl[/*out*/], int num_events)
+next_local_queue_events(stash_entry_t entry_tbl[/*out*/], int num_events,
+			em_queue_prio_t *prio_out /*out, set if events*/)
 {
 	em_locm_t *const locm = &em_locm;
 
@@ -176,8 +202,10 @@ next_local_queue_events(stash_entry_t entry_tbl[/*out*/], int num_events)
 		odp_stash_t stash = locm->local_queues.prio[prio].stash;
 		int num = odp_stash_get_u64(stash, &entry_tbl[0].u64 /*[out]*/,
 					    num_events);
-		if (num > 0)
+		if (num > 0) {
+			*prio_out = prio;
 			return num;
+		}
 
 		locm->local_queues.prio[prio].empty_prio = 1;
 		prio--;
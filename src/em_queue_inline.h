@@ -215,6 +215,9 @@ queue_dequeue(const queue_elem_t *q_elem)
 
 	em_event = event_odp2em(odp_event);
 
+	if (queue_stats_enabled())
+		queue_stats_dequeued_events(q_elem, &em_event, 1);
+
 	if (esv_enabled()) {
 		event_hdr_t *ev_hdr = event_to_hdr(em_event);
 
@@ -239,6 +242,9 @@ queue_dequeue_multi(const queue_elem_t *q_elem,
 	if (ret <= 0)
 		return ret;
 
+	if (queue_stats_enabled())
+		queue_stats_dequeued_events(q_elem, events, ret);
+
 	/* now events[] = odp_events[], events[].evgen missing, set below: */
 	if (esv_enabled()) {
 		event_hdr_t *ev_hdrs[ret];
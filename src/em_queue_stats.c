@@ -0,0 +1,255 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2023, Nokia Solutions and Networks
+ */
+
+#include "em_include.h"
+
+em_status_t queue_stats_init(void)
+{
+	queue_tbl_t *const queue_tbl = &em_shm->queue_tbl;
+	const size_t size = sizeof(queue_stats_t) * EM_MAX_QUEUES;
+	uint32_t flags = 0;
+
+	queue_tbl->stats = NULL;
+	queue_tbl->stats_shm = ODP_SHM_INVALID;
+
+	if (!em_shm->opt.queue.statistics)
+		return EM_OK;
+
+#if ODP_VERSION_API_NUM(1, 33, 0) > ODP_VERSION_API
+	flags |= ODP_SHM_SINGLE_VA;
+#else
+	odp_shm_capability_t shm_capa;
+	int ret = odp_shm_capability(&shm_capa);
+
+	if (unlikely(ret)) {
+		EM_LOG(EM_LOG_ERR, "shm capability error:%d\n", ret);
+		return EM_ERR_LIB_FAILED;
+	}
+
+	if (shm_capa.flags & ODP_SHM_SINGLE_VA)
+		flags |= ODP_SHM_SINGLE_VA;
+#endif
+	/*
+	 * Reserved during em_init() like the EM shm itself, the address is thus
+	 * valid in all EM-cores also in process-per-core mode.
+	 */
+	odp_shm_t shm = odp_shm_reserve("em_queue_stats_shm", size,
+					ODP_CACHE_LINE_SIZE, flags);
+	if (unlikely(shm == ODP_SHM_INVALID)) {
+		EM_LOG(EM_LOG_ERR, "Queue stats shm reserve failed, size:%zu\n", size);
+		return EM_ERR_ALLOC_FAILED;
+	}
+
+	queue_stats_t *stats = odp_shm_addr(shm);
+
+	if (unlikely(stats == NULL))
+		return EM_ERR_BAD_POINTER;
+
+	memset(stats, 0, size);
+	queue_tbl->stats_shm = shm;
+	queue_tbl->stats = stats;
+
+	return EM_OK;
+}
+
+em_status_t queue_stats_term(void)
+{
+	queue_tbl_t *const queue_tbl = &em_shm->queue_tbl;
+
+	if (queue_tbl->stats_shm == ODP_SHM_INVALID)
+		return EM_OK;
+
+	queue_tbl->stats = NULL;
+	if (unlikely(odp_shm_free(queue_tbl->stats_shm) != 0))
+		return EM_ERR_LIB_FAILED;
+	queue_tbl->stats_shm = ODP_SHM_INVALID;
+
+	return EM_OK;
+}
+
+void queue_stats_reset(const queue_elem_t *q_elem)
+{
+	queue_stats_t *const stats = queue_stats_get(q_elem);
+
+	env_atomic64_set(&stats->enqueued, 0);
+	env_atomic64_set(&stats->dequeued, 0);
+	env_atomic64_set(&stats->dequeued_ext, 0);
+	env_atomic64_set(&stats->sojourn_sum_ns, 0);
+	env_atomic64_set(&stats->sojourn_max_ns, 0);
+	for (int i = 0; i < EM_QUEUE_STATS_HIST_BUCKETS; i++)
+		env_atomic64_set(&stats->sojourn_hist[i], 0);
+}
+
+void queue_stats_reset_all(void)
+{
+	const queue_tbl_t *queue_tbl = &em_shm->queue_tbl;
+
+	if (!queue_stats_enabled())
+		return;
+
+	for (int i = 0; i < EM_MAX_QUEUES; i++) {
+		if (queue_allocated(&queue_tbl->queue_elem[i]))
+			queue_stats_reset(&queue_tbl->queue_elem[i]);
+	}
+}
+
+static void queue_stats_read(const queue_elem_t *q_elem, em_queue_stats_t *stats /*out*/)
+{
+	const queue_stats_t *qs = queue_stats_get(q_elem);
+
+	/* Read 'dequeued' first: the depth estimate must not underflow */
+	stats->dequeued = env_atomic64_get(&qs->dequeued);
+	stats->enqueued = env_atomic64_get(&qs->enqueued);
+	stats->dequeued_ext = env_atomic64_get(&qs->dequeued_ext);
+	stats->depth = stats->enqueued > stats->dequeued ?
+		       stats->enqueued - stats->dequeued : 0;
+	stats->sojourn_avg_ns = stats->dequeued ?
+				env_atomic64_get(&qs->sojourn_sum_ns) / stats->dequeued : 0;
+	stats->sojourn_max_ns = env_atomic64_get(&qs->sojourn_max_ns);
+	for (int i = 0; i < EM_QUEUE_STATS_HIST_BUCKETS; i++)
+		stats->sojourn_hist[i] = env_atomic64_get(&qs->sojourn_hist[i]);
+}
+
+em_status_t em_queue_stats(em_queue_t queue, em_queue_stats_t *stats /*out*/)
+{
+	const queue_elem_t *q_elem = queue_elem_get(queue);
+
+	if (EM_CHECK_LEVEL > 0)
+		RETURN_ERROR_IF(!q_elem || !stats, EM_ERR_BAD_ARG,
+				EM_ESCOPE_QUEUE_STATS,
+				"Inv.args: Q:%" PRI_QUEUE " stats:%p", queue, stats);
+
+	if (EM_CHECK_LEVEL > 1)
+		RETURN_ERROR_IF(!queue_allocated(q_elem), EM_ERR_NOT_CREATED,
+				EM_ESCOPE_QUEUE_STATS,
+				"Queue:%" PRI_QUEUE " not created", queue);
+
+	RETURN_ERROR_IF(!queue_stats_enabled(), EM_ERR_NOT_IMPLEMENTED,
+			EM_ESCOPE_QUEUE_STATS,
+			"Queue statistics not enabled (config: queue.statistics)");
+
+	queue_stats_read(q_elem, stats);
+
+	return EM_OK;
+}
+
+em_status_t em_queue_stats_reset(em_queue_t queue)
+{
+	const queue_elem_t *q_elem = queue_elem_get(queue);
+
+	if (EM_CHECK_LEVEL > 0)
+		RETURN_ERROR_IF(!q_elem, EM_ERR_BAD_ARG, EM_ESCOPE_QUEUE_STATS_RESET,
+				"Invalid EM queue:%" PRI_QUEUE "", queue);
+
+	if (EM_CHECK_LEVEL > 1)
+		RETURN_ERROR_IF(!queue_allocated(q_elem), EM_ERR_NOT_CREATED,
+				EM_ESCOPE_QUEUE_STATS_RESET,
+				"Queue:%" PRI_QUEUE " not created", queue);
+
+	RETURN_ERROR_IF(!queue_stats_enabled(), EM_ERR_NOT_IMPLEMENTED,
+			EM_ESCOPE_QUEUE_STATS_RESET,
+			"Queue statistics not enabled (config: queue.statistics)");
+
+	queue_stats_reset(q_elem);
+
+	return EM_OK;
+}
+
+/* Upper limit of histogram bucket 'i' as a string, e.g. "<2us" */
+static const char *hist_bucket_str(int i, char buf[], size_t len)
+{
+	if (i == EM_QUEUE_STATS_HIST_BUCKETS - 1) {
+		snprintf(buf, len, ">=%" PRIu64 "ms", (UINT64_C(1) << (9 + i)) / 1000000);
+		return buf;
+	}
+
+	const uint64_t ns = UINT64_C(1) << (10 + i);
+
+	if (ns < 1000000)
+		snprintf(buf, len, "<%" PRIu64 "us", ns / 1000);
+	else
+		snprintf(buf, len, "<%" PRIu64 "ms", ns / 1000000);
+
+	return buf;
+}
+
+static void queue_stats_print_elem(const queue_elem_t *q_elem)
+{
+	em_queue_t queue = (em_queue_t)(uintptr_t)q_elem->queue;
+	char qname[EM_QUEUE_NAME_LEN];
+	em_queue_stats_t stats;
+	char buf[16];
+
+	queue_get_name(q_elem, qname, sizeof(qname));
+	queue_stats_read(q_elem, &stats);
+
+	EM_PRINT("Queue %" PRI_QUEUE " \"%s\":\n"
+		 "  enqueued:%" PRIu64 " dequeued:%" PRIu64 " ext:%" PRIu64 " depth:%" PRIu64 "\n"
+		 "  sojourn avg:%" PRIu64 "ns max:%" PRIu64 "ns\n",
+		 queue, qname, stats.enqueued, stats.dequeued, stats.dequeued_ext,
+		 stats.depth, stats.sojourn_avg_ns, stats.sojourn_max_ns);
+
+	if (stats.dequeued == 0)
+		return;
+
+	EM_PRINT("  sojourn histogram:\n");
+	for (int i = 0; i < EM_QUEUE_STATS_HIST_BUCKETS; i++) {
+		if (stats.sojourn_hist[i] == 0)
+			continue;
+		EM_PRINT("    %-8s %" PRIu64 " (%.1f%%)\n", hist_bucket_str(i, buf, sizeof(buf)),
+			 stats.sojourn_hist[i],
+			 100.0 * (double)stats.sojourn_hist[i] / (double)stats.dequeued);
+	}
+}
+
+void em_queue_stats_print(em_queue_t queue)
+{
+	const queue_elem_t *q_elem = queue_elem_get(queue);
+
+	if (!queue_stats_enabled()) {
+		EM_PRINT("Queue statistics not enabled (config: queue.statistics)\n");
+		return;
+	}
+
+	if (!q_elem || !queue_allocated(q_elem)) {
+		EM_PRINT("Queue %" PRI_QUEUE " not created\n", queue);
+		return;
+	}
+
+	queue_stats_print_elem(q_elem);
+}
+
+void queue_stats_print_all(void)
+{
+	const queue_tbl_t *queue_tbl = &em_shm->queue_tbl;
+	em_queue_stats_t stats;
+	char qname[EM_QUEUE_NAME_LEN];
+
+	if (!queue_stats_enabled()) {
+		EM_PRINT("Queue statistics not enabled (config: queue.statistics)\n");
+		return;
+	}
+
+	EM_PRINT("EM Queue Statistics\n"
+		 "-------------------\n"
+		 "Queue      Name                            Enqueued     Dequeued     Ext          Depth      Avg(ns)    Max(ns)\n");
+
+	for (int i = 0; i < EM_MAX_QUEUES; i++) {
+		const queue_elem_t *q_elem = &queue_tbl->queue_elem[i];
+
+		if (!queue_allocated(q_elem))
+			continue;
+
+		queue_stats_read(q_elem, &stats);
+		if (stats.enqueued == 0 && stats.dequeued_ext == 0)
+			continue;
+
+		queue_get_name(q_elem, qname, sizeof(qname));
+		EM_PRINT("%-10" PRI_QUEUE " %-31s %-12" PRIu64 " %-12" PRIu64 " %-12" PRIu64 " %-10" PRIu64 " %-10" PRIu64 " %" PRIu64 "\n",
+			 (em_queue_t)(uintptr_t)q_elem->queue, qname,
+			 stats.enqueued, stats.dequeued, stats.dequeued_ext, stats.depth,
+			 stats.sojourn_avg_ns, stats.sojourn_max_ns);
+	}
+}
@@ -0,0 +1,166 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2023, Nokia Solutions and Networks
+ */
+
+/**
+ * @file
+ * EM internal queue statistics functions
+ *
+ * Enabled with the config file option 'queue.statistics'. The send functions
+ * store the enqueue time into the event header and count the enqueued events,
+ * the dispatcher and em_queue_dequeue...() count the dequeued events and
+ * collect the sojourn time histogram. See em_queue_stats_t.
+ */
+
+#ifndef EM_QUEUE_STATS_H_
+#define EM_QUEUE_STATS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+em_status_t queue_stats_init(void);
+em_status_t queue_stats_term(void);
+
+/** Reset the statistics of a queue, called on queue create */
+void queue_stats_reset(const queue_elem_t *q_elem);
+
+/** Reset the statistics of all queues */
+void queue_stats_reset_all(void);
+
+/** Print the statistics of all queues */
+void queue_stats_print_all(void);
+
+static inline bool queue_stats_enabled(void)
+{
+	return unlikely(em_shm->queue_tbl.stats != NULL);
+}
+
+static inline queue_stats_t *queue_stats_get(const queue_elem_t *q_elem)
+{
+	const queue_tbl_t *queue_tbl = &em_shm->queue_tbl;
+
+	return &queue_tbl->stats[q_elem - &queue_tbl->queue_elem[0]];
+}
+
+/**
+ * Store the enqueue time into the event headers before the enqueue
+ *
+ * @return The number of timestamped events, timeout indications excluded
+ */
+static inline int queue_stats_stamp(const em_event_t events[], int num)
+{
+	const uint64_t now = odp_time_global_ns();
+	int stamped = 0;
+
+	for (int i = 0; i < num; i++) {
+		event_hdr_t *ev_hdr = event_to_hdr(events[i]);
+
+		/* 'enq_ns' shares storage with 'tmo' */
+		if (ev_hdr->flags.tmo_type != EM_TMO_TYPE_NONE)
+			continue;
+		ev_hdr->enq_ns = now;
+		ev_hdr->flags.enq_ts = 1;
+		stamped++;
+	}
+
+	return stamped;
+}
+
+/**
+ * Clear the enqueue time of events that could not be enqueued
+ *
+ * @return The number of events that had been timestamped
+ */
+static inline int queue_stats_unstamp(const em_event_t events[], int num)
+{
+	int unstamped = 0;
+
+	for (int i = 0; i < num; i++) {
+		event_hdr_t *ev_hdr = event_to_hdr(events[i]);
+
+		if (ev_hdr->flags.enq_ts) {
+			ev_hdr->flags.enq_ts = 0;
+			unstamped++;
+		}
+	}
+
+	return unstamped;
+}
+
+/**
+ * Count timestamped events successfully enqueued into the queue
+ */
+static inline void queue_stats_enqueued(const queue_elem_t *q_elem, int num)
+{
+	if (num > 0)
+		env_atomic64_add(&queue_stats_get(q_elem)->enqueued, num);
+}
+
+static inline int queue_stats_hist_idx(uint64_t ns)
+{
+	if (ns < 1024)
+		return 0;
+
+	/* [2^(9+i), 2^(10+i)) ns -> i */
+	const int idx = 63 - __builtin_clzll(ns) - 9;
+
+	return MIN(idx, EM_QUEUE_STATS_HIST_BUCKETS - 1);
+}
+
+/**
+ * Count dequeued events and collect their sojourn times
+ */
+static inline void
+queue_stats_dequeued(const queue_elem_t *q_elem, event_hdr_t *const ev_hdrs[], int num)
+{
+	queue_stats_t *const stats = queue_stats_get(q_elem);
+	const uint64_t now = odp_time_global_ns();
+	uint64_t sum = 0;
+	uint64_t max = 0;
+	int stamped = 0;
+
+	for (int i = 0; i < num; i++) {
+		event_hdr_t *const ev_hdr = ev_hdrs[i];
+
+		if (!ev_hdr->flags.enq_ts)
+			continue;
+		ev_hdr->flags.enq_ts = 0;
+
+		const uint64_t ns = now > ev_hdr->enq_ns ? now - ev_hdr->enq_ns : 0;
+
+		env_atomic64_inc(&stats->sojourn_hist[queue_stats_hist_idx(ns)]);
+		sum += ns;
+		max = MAX(max, ns);
+		stamped++;
+	}
+
+	if (stamped) {
+		env_atomic64_add(&stats->dequeued, stamped);
+		env_atomic64_add(&stats->sojourn_sum_ns, sum);
+
+		uint64_t old_max = env_atomic64_get(&stats->sojourn_max_ns);
+
+		while (max > old_max &&
+		       !env_atomic64_cmpset(&stats->sojourn_max_ns, old_max, max))
+			old_max = env_atomic64_get(&stats->sojourn_max_ns);
+	}
+	if (stamped < num)
+		env_atomic64_add(&stats->dequeued_ext, num - stamped);
+}
+
+static inline void
+queue_stats_dequeued_events(const queue_elem_t *q_elem, const em_event_t events[], int num)
+{
+	event_hdr_t *ev_hdrs[num];
+
+	event_to_hdr_multi(events, ev_hdrs, num);
+	queue_stats_dequeued(q_elem, ev_hdrs, num);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EM_QUEUE_STATS_H_ */
@@ -208,8 +208,14 @@ typedef struct queue_elem_t {
 			uint8_t in_atomic_group : 1;
 			/** Is this an ODP pktin event queue (true/false)? */
 			uint8_t is_pktin        : 1;
+			/** Ordered queue with an ODP ordered lock (EM_QUEUE_FLAG_ORDER_LOCK) */
+			uint8_t order_lock      : 1;
+			/** The EO receive function runs as a coroutine */
+			uint8_t coro            : 1;
+			/** Parallel queue dispatched on the sending core (EM_QUEUE_FLAG_INLINE) */
+			uint8_t inline_send     : 1;
 			/** reserved bits */
-			uint8_t rsvd            : 4;
+			uint8_t rsvd            : 1;
 		};
 	} flags;
 
@@ -272,6 +278,29 @@ typedef struct queue_elem_t {
 COMPILE_TIME_ASSERT(sizeof(queue_elem_t) % ENV_CACHE_LINE_SIZE == 0,
 		    QUEUE_ELEM_T__SIZE_ERROR);
 
+/**
+ * Queue statistics counters, see em_queue_stats_t
+ *
+ * Updated by all cores sending to or receiving from the queue.
+ */
+typedef struct {
+	/** Events sent into the queue with an enqueue timestamp */
+	env_atomic64_t enqueued;
+	/** Timestamped events dequeued from the queue */
+	env_atomic64_t dequeued;
+	/** Events dequeued without a timestamp (pktin, timeouts) */
+	env_atomic64_t dequeued_ext;
+	/** Sum of the sojourn times (ns) */
+	env_atomic64_t sojourn_sum_ns;
+	/** Max sojourn time (ns) */
+	env_atomic64_t sojourn_max_ns;
+	/** Sojourn time histogram */
+	env_atomic64_t sojourn_hist[EM_QUEUE_STATS_HIST_BUCKETS];
+
+	/** Guarantee that size is a multiple of cache line size */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+} queue_stats_t;
+
 /**
  * EM queue element table
  */
@@ -284,6 +313,13 @@ typedef struct queue_tbl_t {
 	odp_schedule_capability_t odp_schedule_capability;
 	/** Queue name table */
 	char name[EM_MAX_QUEUES][EM_QUEUE_NAME_LEN] ENV_CACHE_LINE_ALIGNED;
+	/**
+	 * Queue statistics, indexed as 'queue_elem[]', NULL if disabled
+	 * (config option 'queue.statistics').
+	 */
+	queue_stats_t *stats;
+	/** Shared memory of 'stats[]' */
+	odp_shm_t stats_shm;
 } queue_tbl_t;
 
 /**
@@ -313,6 +349,16 @@ typedef struct output_queue_track_t {
 	queue_elem_t *used_queues[EM_MAX_QUEUES];
 } output_queue_track_t;
 
+/**
+ * Events sent to output queues from an ordered context with an ordered lock,
+ * see EM_QUEUE_FLAG_ORDER_LOCK. Flushed at the end of the ordered context.
+ */
+typedef struct output_queue_ordered_t {
+	unsigned int num;
+	em_event_t events[EM_OUTPUT_ORDER_LOCK_BUF];
+	queue_elem_t *q_elems[EM_OUTPUT_ORDER_LOCK_BUF];
+} output_queue_ordered_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,364 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2023, Nokia Solutions and Networks
+ */
+
+#include "em_include.h"
+
+/** Smallest accepted value for config option 'trace.num_records' */
+#define TRACE_MIN_RECORDS  64
+
+/**
+ * Trace dump file header
+ *
+ * Followed by, for each EM-core:
+ *   uint32_t core, uint32_t num + 'num' trace_rec_t records, oldest first
+ * and then the names of the EOs and queues:
+ *   uint32_t num + 'num' x {uint64_t handle, char name[name_len]} (EOs)
+ *   uint32_t num + 'num' x {uint64_t handle, char name[name_len]} (queues)
+ * All values in host byte order.
+ */
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t rec_size;
+	uint32_t num_cores;
+	uint32_t name_len;
+	uint64_t rsvd;
+} trace_file_hdr_t;
+
+/** Name length in the dump file, also fits queue names */
+#define TRACE_NAME_LEN  EM_EO_NAME_LEN
+COMPILE_TIME_ASSERT(EM_QUEUE_NAME_LEN <= TRACE_NAME_LEN, TRACE_NAME_LEN_ERROR);
+
+static int read_config_file(void)
+{
+	const char *conf_str;
+	bool val_bool = false;
+	int val = 0;
+	int ret;
+
+	EM_PRINT("EM trace config:%s\n",
+		 EM_TRACE_ENABLE ? "" : " (not compiled in, EM_TRACE_ENABLE=0)");
+
+	/*
+	 * Option: trace.enable
+	 */
+	conf_str = "trace.enable";
+	ret = em_libconfig_lookup_bool(&em_shm->libconfig, conf_str, &val_bool);
+	if (unlikely(!ret)) {
+		EM_LOG(EM_LOG_ERR, "Config option '%s' not found\n", conf_str);
+		return -1;
+	}
+	/* store & print the value */
+	em_shm->opt.trace.enable = val_bool;
+	EM_PRINT("  %s: %s(%d)\n", conf_str, val_bool ? "true" : "false",
+		 val_bool);
+
+	/*
+	 * Option: trace.num_records
+	 */
+	conf_str = "trace.num_records";
+	ret = em_libconfig_lookup_int(&em_shm->libconfig, conf_str, &val);
+	if (unlikely(!ret)) {
+		EM_LOG(EM_LOG_ERR, "Config option '%s' not found\n", conf_str);
+		return -1;
+	}
+	if (val < TRACE_MIN_RECORDS || val > (1 << 24)) {
+		EM_LOG(EM_LOG_ERR, "Bad config value '%s = %d' (min:%d max:%d)\n",
+		       conf_str, val, TRACE_MIN_RECORDS, 1 << 24);
+		return -1;
+	}
+	/* store & print the value, rounded up to a power of two */
+	em_shm->opt.trace.num_records = 1U << (32 - __builtin_clz((unsigned int)val - 1));
+	EM_PRINT("  %s: %d (used:%u)\n", conf_str, val,
+		 em_shm->opt.trace.num_records);
+
+	return 0;
+}
+
+static inline trace_ring_t *trace_ring_get(uint8_t *base, int core)
+{
+	return (trace_ring_t *)(uintptr_t)(base + (size_t)core * em_shm->trace.ring_size);
+}
+
+em_status_t trace_init(void)
+{
+	trace_t *const trace = &em_shm->trace;
+	const int num_cores = em_core_count();
+	uint32_t flags = 0;
+
+	trace->enabled = 0;
+	trace->shm = ODP_SHM_INVALID;
+
+	if (read_config_file())
+		return EM_ERR_LIB_FAILED;
+
+	if (!EM_TRACE_ENABLE)
+		return EM_OK;
+
+	trace->num_records = em_shm->opt.trace.num_records;
+	trace->mask = trace->num_records - 1;
+	trace->ring_size = ROUND_UP(sizeof(trace_ring_t) +
+				    trace->num_records * sizeof(trace_rec_t),
+				    ENV_CACHE_LINE_SIZE);
+
+#if ODP_VERSION_API_NUM(1, 33, 0) > ODP_VERSION_API
+	flags |= ODP_SHM_SINGLE_VA;
+#else
+	odp_shm_capability_t shm_capa;
+	int ret = odp_shm_capability(&shm_capa);
+
+	if (unlikely(ret)) {
+		EM_LOG(EM_LOG_ERR, "shm capability error:%d\n", ret);
+		return EM_ERR_LIB_FAILED;
+	}
+
+	if (shm_capa.flags & ODP_SHM_SINGLE_VA)
+		flags |= ODP_SHM_SINGLE_VA;
+#endif
+	trace->shm = odp_shm_reserve("em_trace_shm", trace->ring_size * num_cores,
+				     ODP_CACHE_LINE_SIZE, flags);
+	if (unlikely(trace->shm == ODP_SHM_INVALID)) {
+		EM_LOG(EM_LOG_ERR, "Trace shm reserve failed, size:%zu\n",
+		       trace->ring_size * num_cores);
+		return EM_ERR_ALLOC_FAILED;
+	}
+
+	uint8_t *base = odp_shm_addr(trace->shm);
+
+	if (unlikely(base == NULL))
+		return EM_ERR_BAD_POINTER;
+
+	for (int i = 0; i < num_cores; i++)
+		trace_ring_get(base, i)->head = 0;
+
+	trace->enabled = em_shm->opt.trace.enable ? 1 : 0;
+
+	return EM_OK;
+}
+
+em_status_t trace_init_local(void)
+{
+	em_locm_t *const locm = &em_locm;
+
+	locm->trace_ring = NULL;
+
+	if (!EM_TRACE_ENABLE)
+		return EM_OK;
+
+	uint8_t *base = odp_shm_addr(em_shm->trace.shm);
+
+	if (unlikely(base == NULL))
+		return EM_ERR_BAD_POINTER;
+
+	locm->trace_ring = trace_ring_get(base, em_core_id());
+
+	return EM_OK;
+}
+
+em_status_t trace_term(void)
+{
+	trace_t *const trace = &em_shm->trace;
+
+	trace->enabled = 0;
+
+	if (trace->shm == ODP_SHM_INVALID)
+		return EM_OK;
+
+	if (unlikely(odp_shm_free(trace->shm) != 0))
+		return EM_ERR_LIB_FAILED;
+	trace->shm = ODP_SHM_INVALID;
+
+	return EM_OK;
+}
+
+void trace_enable(bool enable)
+{
+	em_shm->trace.enabled = enable ? 1 : 0;
+	env_sync_mem();
+}
+
+void trace_clear(void)
+{
+	uint8_t *base;
+
+	if (!EM_TRACE_ENABLE)
+		return;
+
+	base = odp_shm_addr(em_shm->trace.shm);
+	if (unlikely(base == NULL))
+		return;
+
+	for (int i = 0; i < em_core_count(); i++)
+		trace_ring_get(base, i)->head = 0;
+	env_sync_mem();
+}
+
+/* Write the handle + name entries with a leading count, return count or -1 */
+static int64_t dump_eo_names(FILE *file)
+{
+	const eo_tbl_t *eo_tbl = &em_shm->eo_tbl;
+	uint32_t num = 0;
+	long pos = ftell(file);
+
+	if (fwrite(&num, sizeof(num), 1, file) != 1)
+		return -1;
+
+	for (int i = 0; i < EM_MAX_EOS; i++) {
+		const eo_elem_t *eo_elem = &eo_tbl->eo_elem[i];
+		uint64_t hdl = (uint64_t)(uintptr_t)eo_elem->eo;
+		char name[TRACE_NAME_LEN] = {0};
+
+		if (eo_elem->state == EM_EO_STATE_UNDEF)
+			continue;
+
+		strncpy(name, eo_elem->name, sizeof(name) - 1);
+		if (fwrite(&hdl, sizeof(hdl), 1, file) != 1 ||
+		    fwrite(name, sizeof(name), 1, file) != 1)
+			return -1;
+		num++;
+	}
+
+	if (fseek(file, pos, SEEK_SET) || fwrite(&num, sizeof(num), 1, file) != 1 ||
+	    fseek(file, 0, SEEK_END))
+		return -1;
+
+	return num;
+}
+
+static int64_t dump_queue_names(FILE *file)
+{
+	const queue_tbl_t *queue_tbl = &em_shm->queue_tbl;
+	uint32_t num = 0;
+	long pos = ftell(file);
+
+	if (fwrite(&num, sizeof(num), 1, file) != 1)
+		return -1;
+
+	for (int i = 0; i < EM_MAX_QUEUES; i++) {
+		const queue_elem_t *q_elem = &queue_tbl->queue_elem[i];
+		char name[TRACE_NAME_LEN] = {0};
+
+		if (!queue_allocated(q_elem))
+			continue;
+
+		em_queue_t queue = (em_queue_t)(uintptr_t)q_elem->queue;
+		uint64_t hdl = (uint64_t)(uintptr_t)queue;
+
+		queue_get_name(q_elem, name, sizeof(name));
+		if (fwrite(&hdl, sizeof(hdl), 1, file) != 1 ||
+		    fwrite(name, sizeof(name), 1, file) != 1)
+			return -1;
+		num++;
+	}
+
+	if (fseek(file, pos, SEEK_SET) || fwrite(&num, sizeof(num), 1, file) != 1 ||
+	    fseek(file, 0, SEEK_END))
+		return -1;
+
+	return num;
+}
+
+static int64_t dump_rings(FILE *file, uint8_t *base, int num_cores)
+{
+	const uint32_t num_records = em_shm->trace.num_records;
+	const uint32_t mask = em_shm->trace.mask;
+	int64_t total = 0;
+
+	for (int core = 0; core < num_cores; core++) {
+		const trace_ring_t *ring = trace_ring_get(base, core);
+		const uint64_t head = ring->head;
+		const uint32_t num = head < num_records ? (uint32_t)head : num_records;
+		const uint64_t first = head - num;
+		const uint32_t core_u32 = core;
+
+		if (fwrite(&core_u32, sizeof(core_u32), 1, file) != 1 ||
+		    fwrite(&num, sizeof(num), 1, file) != 1)
+			return -1;
+
+		/* The ring may wrap: write the oldest part first */
+		const uint32_t idx = first & mask;
+		const uint32_t num1 = MIN(num, num_records - idx);
+
+		if (fwrite(&ring->rec[idx], sizeof(trace_rec_t), num1, file) != num1 ||
+		    fwrite(&ring->rec[0], sizeof(trace_rec_t), num - num1, file) != num - num1)
+			return -1;
+
+		total += num;
+	}
+
+	return total;
+}
+
+int64_t trace_dump(const char *path)
+{
+	const int num_cores = em_core_count();
+	trace_file_hdr_t hdr;
+	uint8_t *base;
+	int64_t total;
+	FILE *file;
+
+	if (!EM_TRACE_ENABLE)
+		return -1;
+
+	base = odp_shm_addr(em_shm->trace.shm);
+	if (unlikely(base == NULL))
+		return -1;
+
+	file = fopen(path, "wb");
+	if (file == NULL) {
+		EM_LOG(EM_LOG_ERR, "Trace dump: cannot open %s\n", path);
+		return -1;
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, TRACE_FILE_MAGIC, sizeof(TRACE_FILE_MAGIC));
+	hdr.version = TRACE_FILE_VERSION;
+	hdr.rec_size = sizeof(trace_rec_t);
+	hdr.num_cores = num_cores;
+	hdr.name_len = TRACE_NAME_LEN;
+
+	if (fwrite(&hdr, sizeof(hdr), 1, file) != 1) {
+		total = -1;
+		goto dump_end;
+	}
+
+	total = dump_rings(file, base, num_cores);
+	if (total < 0)
+		goto dump_end;
+
+	if (dump_eo_names(file) < 0 || dump_queue_names(file) < 0)
+		total = -1;
+
+dump_end:
+	if (fclose(file) != 0)
+		total = -1;
+	if (total < 0)
+		EM_LOG(EM_LOG_ERR, "Trace dump: writing %s failed\n", path);
+
+	return total;
+}
+
+void trace_info_print(void)
+{
+	const trace_t *trace = &em_shm->trace;
+
+	if (!EM_TRACE_ENABLE) {
+		EM_PRINT("EM trace not compiled in (EM_TRACE_ENABLE=0)\n");
+		return;
+	}
+
+	uint8_t *base = odp_shm_addr(trace->shm);
+
+	EM_PRINT("EM trace: %s, %u records/core (%zu bytes)\n"
+		 "  core  written\n",
+		 trace->enabled ? "enabled" : "disabled",
+		 trace->num_records, trace->ring_size);
+
+	if (base == NULL)
+		return;
+
+	for (int i = 0; i < em_core_count(); i++)
+		EM_PRINT("  %-4d  %" PRIu64 "\n", i, trace_ring_get(base, i)->head);
+}
@@ -0,0 +1,169 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2023, Nokia Solutions and Networks
+ */
+
+/**
+ * @file
+ * EM internal event trace functions
+ *
+ * Each EM-core writes trace records into its own ring in shared memory,
+ * the oldest records are overwritten when the ring is full. Tracing is
+ * compiled in with EM_TRACE_ENABLE and switched on/off at runtime via the
+ * config file option 'trace.enable' or the EM CLI command 'em_trace'.
+ * The rings are dumped into a binary file that scripts/em_trace2json.py
+ * converts into the Chrome trace / Perfetto JSON format.
+ */
+
+#ifndef EM_TRACE_H_
+#define EM_TRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+em_status_t trace_init(void);
+em_status_t trace_init_local(void);
+em_status_t trace_term(void);
+
+/**
+ * Switch tracing on/off on all EM-cores
+ */
+void trace_enable(bool enable);
+
+/**
+ * Drop all recorded trace records, only call when tracing is disabled
+ */
+void trace_clear(void);
+
+/**
+ * Write the trace records of all EM-cores into the binary file 'path'
+ *
+ * Tracing should be disabled during the dump, records written meanwhile
+ * might be inconsistent.
+ *
+ * @return Number of records written, -1 on error
+ */
+int64_t trace_dump(const char *path);
+
+/**
+ * Print the trace configuration and status
+ */
+void trace_info_print(void);
+
+static inline bool trace_enabled(void)
+{
+	return EM_TRACE_ENABLE && unlikely(em_shm->trace.enabled);
+}
+
+static inline void
+trace_write(trace_type_t type, int num, uint32_t aux, uint64_t a, uint64_t b)
+{
+	trace_ring_t *const ring = em_locm.trace_ring;
+
+	/* Not an EM-core, e.g. the EM CLI or a thread external to EM */
+	if (unlikely(ring == NULL))
+		return;
+
+	trace_rec_t *const rec = &ring->rec[ring->head & em_shm->trace.mask];
+
+	rec->ts_ns = odp_time_global_ns();
+	rec->type = type;
+	rec->num = num > UINT16_MAX ? UINT16_MAX : (uint16_t)num;
+	rec->aux = aux;
+	rec->a = a;
+	rec->b = b;
+	ring->head++;
+}
+
+static inline void
+trace_dispatch_enter(em_eo_t eo, em_queue_t queue, em_event_t event, int num)
+{
+	if (!trace_enabled())
+		return;
+
+	const event_hdr_t *ev_hdr = event_to_hdr(event);
+
+	trace_write(TRACE_TYPE_DISPATCH_ENTER, num, ev_hdr->event_type,
+		    (uint64_t)(uintptr_t)eo, (uint64_t)(uintptr_t)queue);
+
+	/* Timeout events are also traced separately */
+	if (unlikely(ev_hdr->flags.tmo_type != EM_TMO_TYPE_NONE))
+		trace_write(TRACE_TYPE_TIMER_FIRE, 1, ev_hdr->flags.tmo_type,
+			    (uint64_t)(uintptr_t)eo, (uint64_t)(uintptr_t)ev_hdr->event);
+}
+
+static inline void
+trace_dispatch_exit(em_eo_t eo)
+{
+	if (!trace_enabled())
+		return;
+
+	trace_write(TRACE_TYPE_DISPATCH_EXIT, 0, 0, (uint64_t)(uintptr_t)eo, 0);
+}
+
+static inline void
+trace_send(const em_event_t events[], int num, em_queue_t queue)
+{
+	if (!trace_enabled())
+		return;
+
+	trace_write(TRACE_TYPE_SEND, num, 0, (uint64_t)(uintptr_t)queue,
+		    (uint64_t)(uintptr_t)events[0]);
+}
+
+static inline void
+trace_alloc(const em_event_t events[], int num, uint32_t size, em_pool_t pool)
+{
+	if (!trace_enabled())
+		return;
+
+	trace_write(TRACE_TYPE_ALLOC, num, size, (uint64_t)(uintptr_t)pool,
+		    (uint64_t)(uintptr_t)events[0]);
+}
+
+static inline void
+trace_free(const em_event_t events[], int num)
+{
+	if (!trace_enabled())
+		return;
+
+	trace_write(TRACE_TYPE_FREE, num, 0, 0, (uint64_t)(uintptr_t)events[0]);
+}
+
+/**
+ * Consecutive empty schedule rounds update the count of the previous record
+ * instead of filling the ring.
+ */
+static inline void
+trace_sched_empty(void)
+{
+	if (!trace_enabled())
+		return;
+
+	trace_ring_t *const ring = em_locm.trace_ring;
+
+	if (unlikely(ring == NULL))
+		return;
+
+	if (ring->head > 0) {
+		trace_rec_t *const prev = &ring->rec[(ring->head - 1) & em_shm->trace.mask];
+
+		if (prev->type == TRACE_TYPE_SCHED_EMPTY) {
+			if (prev->num < UINT16_MAX)
+				prev->num++;
+			/* aux: time since the first empty round (ns) */
+			prev->aux = (uint32_t)MIN(odp_time_global_ns() - prev->ts_ns,
+						  (uint64_t)UINT32_MAX);
+			return;
+		}
+	}
+
+	trace_write(TRACE_TYPE_SCHED_EMPTY, 1, 0, 0, 0);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EM_TRACE_H_ */
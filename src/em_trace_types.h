@@ -0,0 +1,107 @@
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2023, Nokia Solutions and Networks
+ */
+
+/**
+ * @file
+ * EM internal event trace types & definitions
+ */
+
+#ifndef EM_TRACE_TYPES_H_
+#define EM_TRACE_TYPES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Trace dump file magic, the file starts with these 8 bytes */
+#define TRACE_FILE_MAGIC    "EMTRACE"
+/** Trace dump file format version */
+#define TRACE_FILE_VERSION  1
+
+/**
+ * Trace record types
+ *
+ * The values are part of the trace dump file format, only append new types.
+ */
+typedef enum {
+	TRACE_TYPE_NONE = 0,
+	/** EO receive called: a=EO, b=queue, num=events, aux=first event type */
+	TRACE_TYPE_DISPATCH_ENTER = 1,
+	/** EO receive returned: a=EO */
+	TRACE_TYPE_DISPATCH_EXIT = 2,
+	/** em_send...(): a=queue, b=first event, num=events */
+	TRACE_TYPE_SEND = 3,
+	/** em_alloc...(): a=pool, b=first event, num=events, aux=size */
+	TRACE_TYPE_ALLOC = 4,
+	/** em_free...(): b=first event, num=events */
+	TRACE_TYPE_FREE = 5,
+	/** Timeout event dispatched: a=EO, b=event, aux=em_tmo_type_t */
+	TRACE_TYPE_TIMER_FIRE = 6,
+	/** Scheduler returned no events: num=consecutive empty rounds, aux=ns */
+	TRACE_TYPE_SCHED_EMPTY = 7,
+	TRACE_TYPE_LAST
+} trace_type_t;
+
+/**
+ * Trace record, 32 bytes
+ */
+typedef struct {
+	/** Global time in ns, comparable between cores */
+	uint64_t ts_ns;
+	/** trace_type_t */
+	uint8_t type;
+	uint8_t rsvd;
+	/** Number of events (saturates at UINT16_MAX) */
+	uint16_t num;
+	/** Type specific extra data */
+	uint32_t aux;
+	/** Type specific handle, see trace_type_t */
+	uint64_t a;
+	/** Type specific handle, see trace_type_t */
+	uint64_t b;
+} trace_rec_t;
+
+COMPILE_TIME_ASSERT(sizeof(trace_rec_t) == 32, TRACE_REC_SIZE_ERROR);
+
+/**
+ * Per core trace ring, written only by the owning core
+ */
+typedef struct {
+	/** Number of records written since start, head & mask = next index */
+	uint64_t head;
+	/** Pad the header to a cache line */
+	void *end[0] ENV_CACHE_LINE_ALIGNED;
+	/** Trace records, 'trace_t::num_records' entries */
+	trace_rec_t rec[];
+} trace_ring_t;
+
+COMPILE_TIME_ASSERT(sizeof(trace_ring_t) == ENV_CACHE_LINE_SIZE,
+		    TRACE_RING_SIZE_ERROR);
+
+/**
+ * EM event trace state (in em_shm)
+ */
+typedef struct {
+	/** Tracing on/off at runtime, checked at each trace point */
+	int enabled;
+	/** Records per core, power of two */
+	uint32_t num_records;
+	/** num_records - 1 */
+	uint32_t mask;
+	/** Size of one core's ring incl. the header, multiple of cache lines */
+	size_t ring_size;
+	/**
+	 * Shared memory for the rings of all cores, core 'n' ring at offset
+	 * 'n * ring_size'. Map with odp_shm_addr(), not via a stored pointer,
+	 * to also work in process-per-core mode.
+	 */
+	odp_shm_t shm;
+} trace_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EM_TRACE_TYPES_H_ */
@@ -41,3 +41,38 @@ em_core_count(void)
 {
 	return em_shm->core_map.count;
 }
+
+em_status_t
+em_core_util(int core, em_core_util_t *util /*out*/)
+{
+	RETURN_ERROR_IF(core < 0 || core >= em_core_count() || !util,
+			EM_ERR_BAD_ARG, EM_ESCOPE_CORE_UTIL,
+			"Inv.args: core:%d util:%p", core, util);
+
+	const core_util_t *const cu = &em_shm->core_util[core];
+	const uint64_t now = odp_time_global_ns();
+	const uint64_t state_ts = odp_atomic_load_u64(&cu->state_ts);
+	const uint64_t cur_ns = now > state_ts ? now - state_ts : 0;
+
+	util->busy_ns = odp_atomic_load_u64(&cu->busy_ns);
+	util->idle_ns = odp_atomic_load_u64(&cu->idle_ns);
+	util->rounds = odp_atomic_load_u64(&cu->rounds);
+	util->empty_rounds = odp_atomic_load_u64(&cu->empty_rounds);
+	util->events = odp_atomic_load_u64(&cu->events);
+
+	/* Include the time spent in the current state */
+	if (state_ts != 0) {
+		if (odp_atomic_load_u32(&cu->idle))
+			util->idle_ns += cur_ns;
+		else
+			util->busy_ns += cur_ns;
+	}
+
+	return EM_OK;
+}
+
+void
+em_core_util_print(void)
+{
+	core_util_print();
+}
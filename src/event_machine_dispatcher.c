@@ -33,6 +33,7 @@
 
 static const em_dispatch_opt_t dispatch_opt_default = {
 	.burst_size = EM_SCHED_MULTI_MAX_BURST,
+	.stop_prio = EM_QUEUE_PRIO_UNDEF,
 	.__internal_check = EM_CHECK_INIT_CALLED
 	/* other members initialized to 0 or NULL as per C standard */
 };
@@ -66,7 +67,8 @@ uint64_t em_dispatch(uint64_t rounds /* 0 = forever */)
 		/* empty the locally pre-scheduled events (if any) */
 		do {
 			round_events = dispatch_round(ODP_SCHED_NO_WAIT,
-						      EM_SCHED_MULTI_MAX_BURST, NULL);
+						      EM_SCHED_MULTI_MAX_BURST, NULL,
+						      NULL);
 			events += round_events;
 		} while (round_events > 0);
 	}
@@ -113,15 +115,19 @@ dispatch_duration(const em_dispatch_duration_t *duration,
 		locm->is_sched_paused = true;
 
 		int round_events;
+		em_queue_prio_t round_prio;
 		uint64_t rounds = 0;
 		uint16_t burst_size = opt->burst_size;
 
 		/* empty the locally pre-scheduled events (if any) */
 		do {
 			round_events = dispatch_round(ODP_SCHED_NO_WAIT,
-						      burst_size, opt);
+						      burst_size, opt, &round_prio);
 			events += round_events;
 			rounds++;
+			if (results && round_events > 0)
+				dispatch_prio_events(results->prio_events,
+						     round_events, round_prio);
 		} while (round_events > 0);
 
 		if (results) {
@@ -153,6 +159,11 @@ em_status_t em_dispatch_duration(const em_dispatch_duration_t *duration,
 				EM_ERR_BAD_ARG, EM_ESCOPE_DISPATCH_DURATION,
 				"Bad option: 0 < opt.burst_size (%" PRIu64 ") <= %u (max)",
 				opt->burst_size, EM_SCHED_MULTI_MAX_BURST);
+		RETURN_ERROR_IF(opt->stop_prio >= EM_QUEUE_PRIO_NUM &&
+				opt->stop_prio != EM_QUEUE_PRIO_UNDEF,
+				EM_ERR_BAD_ARG, EM_ESCOPE_DISPATCH_DURATION,
+				"Bad option: opt.stop_prio (%" PRIu32 ") invalid",
+				opt->stop_prio);
 	}
 
 	if (EM_CHECK_LEVEL > 1) {
@@ -200,6 +211,11 @@ em_status_t em_dispatch_ns(uint64_t ns,
 				EM_ERR_BAD_ARG, EM_ESCOPE_DISPATCH_NS,
 				"Bad option: 0 < opt.burst_size (%" PRIu64 ") <= %u (max)",
 				opt->burst_size, EM_SCHED_MULTI_MAX_BURST);
+		RETURN_ERROR_IF(opt->stop_prio >= EM_QUEUE_PRIO_NUM &&
+				opt->stop_prio != EM_QUEUE_PRIO_UNDEF,
+				EM_ERR_BAD_ARG, EM_ESCOPE_DISPATCH_NS,
+				"Bad option: opt.stop_prio (%" PRIu32 ") invalid",
+				opt->stop_prio);
 	}
 
 	const em_dispatch_duration_t duration = {
@@ -230,6 +246,11 @@ em_status_t em_dispatch_events(uint64_t events,
 				EM_ERR_BAD_ARG, EM_ESCOPE_DISPATCH_EVENTS,
 				"Bad option: 0 < opt.burst_size (%" PRIu64 ") <= %u (max)",
 				opt->burst_size, EM_SCHED_MULTI_MAX_BURST);
+		RETURN_ERROR_IF(opt->stop_prio >= EM_QUEUE_PRIO_NUM &&
+				opt->stop_prio != EM_QUEUE_PRIO_UNDEF,
+				EM_ERR_BAD_ARG, EM_ESCOPE_DISPATCH_EVENTS,
+				"Bad option: opt.stop_prio (%" PRIu32 ") invalid",
+				opt->stop_prio);
 	}
 
 	const em_dispatch_duration_t duration = {
@@ -260,6 +281,11 @@ em_status_t em_dispatch_rounds(uint64_t rounds,
 				EM_ERR_BAD_ARG, EM_ESCOPE_DISPATCH_ROUNDS,
 				"Bad option: 0 < opt.burst_size (%" PRIu64 ") <= %u (max)",
 				opt->burst_size, EM_SCHED_MULTI_MAX_BURST);
+		RETURN_ERROR_IF(opt->stop_prio >= EM_QUEUE_PRIO_NUM &&
+				opt->stop_prio != EM_QUEUE_PRIO_UNDEF,
+				EM_ERR_BAD_ARG, EM_ESCOPE_DISPATCH_ROUNDS,
+				"Bad option: opt.stop_prio (%" PRIu32 ") invalid",
+				opt->stop_prio);
 	}
 
 	const em_dispatch_duration_t duration = {
@@ -343,3 +369,36 @@ em_dispatch_unregister_exit_cb(em_dispatch_exit_func_t func)
 			"Dispatch callback unregister failed");
 	return EM_OK;
 }
+
+em_status_t em_defer_prio(em_defer_func_t fn, void *arg, em_queue_prio_t prio)
+{
+	em_locm_t *const locm = &em_locm;
+
+	RETURN_ERROR_IF(EM_CHECK_LEVEL > 0 && (!fn || prio >= EM_QUEUE_PRIO_NUM),
+			EM_ERR_BAD_ARG, EM_ESCOPE_DEFER,
+			"Inv.args: fn:%p prio:%" PRIu32 "", fn, prio);
+	RETURN_ERROR_IF(locm->is_external_thr, EM_ERR_BAD_CONTEXT, EM_ESCOPE_DEFER,
+			"Not called on an EM-core");
+
+	defer_ring_t *const defer = &locm->defer;
+	const uint32_t tail = defer->prio[prio].tail;
+
+	RETURN_ERROR_IF(tail - defer->prio[prio].head >= EM_DEFER_RING_SIZE,
+			EM_ERR_TOO_LARGE, EM_ESCOPE_DEFER,
+			"Deferred calls of prio:%" PRIu32 " full (%d)",
+			prio, EM_DEFER_RING_SIZE);
+
+	defer_call_t *const call = &defer->prio[prio].call[tail & (EM_DEFER_RING_SIZE - 1)];
+
+	call->fn = fn;
+	call->arg = arg;
+	defer->prio[prio].tail = tail + 1;
+	defer->num++;
+
+	return EM_OK;
+}
+
+em_status_t em_defer(em_defer_func_t fn, void *arg)
+{
+	return em_defer_prio(fn, arg, EM_QUEUE_PRIO_NORMAL);
+}
@@ -37,7 +37,8 @@ em_event_t em_alloc(uint32_t size, em_event_type_t type, em_pool_t pool)
 
 	if (EM_CHECK_LEVEL > 0 &&
 	    unlikely(size == 0 || !pool_elem ||
-		     em_event_type_major(type) == EM_EVENT_TYPE_TIMER_IND)) {
+		     major_type == EM_EVENT_TYPE_TIMER_IND ||
+		     major_type == EM_EVENT_TYPE_IMMEDIATE)) {
 		INTERNAL_ERROR(EM_ERR_BAD_ARG, EM_ESCOPE_ALLOC,
 			       "Invalid args: size:%u type:%u pool:%" PRI_POOL "",
 			       size, type, pool);
@@ -84,8 +85,13 @@ em_event_t em_alloc(uint32_t size, em_event_type_t type, em_pool_t pool)
 		return EM_EVENT_UNDEF;
 	}
 
+	if (event != EM_EVENT_UNDEF)
+		pool_wmark_alloc(pool_elem, 1);
+
 	if (EM_API_HOOKS_ENABLE && event != EM_EVENT_UNDEF)
 		call_api_hooks_alloc(&event, 1, 1, size, type, pool);
+	if (EM_TRACE_ENABLE && event != EM_EVENT_UNDEF)
+		trace_alloc(&event, 1, size, pool);
 
 	return event;
 }
@@ -97,11 +103,13 @@ int em_alloc_multi(em_event_t events[/*out*/], int num,
 		return 0;
 
 	const mpool_elem_t *const pool_elem = pool_elem_get(pool);
+	const em_event_type_t major_type = em_event_type_major(type);
 	int ret = 0;
 
 	if (EM_CHECK_LEVEL > 0 &&
 	    unlikely(!events || num < 0 || size == 0 || !pool_elem ||
-		     em_event_type_major(type) == EM_EVENT_TYPE_TIMER_IND)) {
+		     major_type == EM_EVENT_TYPE_TIMER_IND ||
+		     major_type == EM_EVENT_TYPE_IMMEDIATE)) {
 		INTERNAL_ERROR(EM_ERR_BAD_ARG, EM_ESCOPE_ALLOC_MULTI,
 			       "Invalid args: events:%p num:%d size:%u type:%u pool:%" PRI_POOL "",
 			       events, num, size, type, pool);
@@ -123,7 +131,7 @@ int em_alloc_multi(em_event_t events[/*out*/], int num,
 		 * pkt events.
 		 */
 		if (EM_CHECK_LEVEL >= 1 &&
-		    unlikely(em_event_type_major(type) == EM_EVENT_TYPE_PACKET)) {
+		    unlikely(major_type == EM_EVENT_TYPE_PACKET)) {
 			INTERNAL_ERROR(EM_ERR_NOT_IMPLEMENTED, EM_ESCOPE_ALLOC_MULTI,
 				       "EM-pool:%s(%" PRI_POOL "): Invalid event type:0x%x for buf",
 				       pool_elem->name, pool, type);
@@ -132,7 +140,7 @@ int em_alloc_multi(em_event_t events[/*out*/], int num,
 		ret = event_alloc_buf_multi(events, num, pool_elem, size, type);
 	} else if (pool_elem->event_type == EM_EVENT_TYPE_VECTOR) {
 		if (EM_CHECK_LEVEL >= 1 &&
-		    unlikely(em_event_type_major(type) != EM_EVENT_TYPE_VECTOR)) {
+		    unlikely(major_type != EM_EVENT_TYPE_VECTOR)) {
 			INTERNAL_ERROR(EM_ERR_NOT_IMPLEMENTED, EM_ESCOPE_ALLOC,
 				       "EM-pool:%s(%" PRI_POOL "): Inv. event type:0x%x for vector",
 				       pool_elem->name, pool, type);
@@ -155,8 +163,12 @@ int em_alloc_multi(em_event_t events[/*out*/], int num,
 		}
 	}
 
+	pool_wmark_alloc(pool_elem, ret);
+
 	if (EM_API_HOOKS_ENABLE && ret > 0)
 		call_api_hooks_alloc(events, ret, num, size, type, pool);
+	if (EM_TRACE_ENABLE && ret > 0)
+		trace_alloc(events, ret, size, pool);
 
 	return ret;
 }
@@ -277,7 +289,10 @@ void em_free(em_event_t event)
 
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_free(&event, 1);
+	if (EM_TRACE_ENABLE)
+		trace_free(&event, 1);
 
+	pool_wmark_free(&odp_event, 1);
 	odp_event_free(odp_event);
 }
 
@@ -355,7 +370,10 @@ void em_free_multi(em_event_t events[], int num)
 
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_free(events, num_free);
+	if (EM_TRACE_ENABLE)
+		trace_free(events, num_free);
 
+	pool_wmark_free(odp_events, num_free);
 	odp_event_free_multi(odp_events, num_free);
 }
 
@@ -369,6 +387,8 @@ send_external(em_event_t event, em_queue_t queue)
 {
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_send(&event, 1, queue, EM_EVENT_GROUP_UNDEF);
+	if (EM_TRACE_ENABLE)
+		trace_send(&event, 1, queue);
 
 	em_status_t stat = send_chaining(event, queue);
 
@@ -390,6 +410,8 @@ send_external_multi(const em_event_t events[], int num, em_queue_t queue)
 {
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_send(events, num, queue, EM_EVENT_GROUP_UNDEF);
+	if (EM_TRACE_ENABLE)
+		trace_send(events, num, queue);
 
 	int num_sent = send_chaining_multi(events, num, queue);
 
@@ -441,6 +463,8 @@ send_internal(em_event_t event, event_hdr_t *ev_hdr, em_queue_t queue)
 
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_send(&event, 1, queue, EM_EVENT_GROUP_UNDEF);
+	if (EM_TRACE_ENABLE)
+		trace_send(&event, 1, queue);
 
 	if (q_elem->type == EM_QUEUE_TYPE_OUTPUT) {
 		/*
@@ -462,8 +486,13 @@ send_internal(em_event_t event, event_hdr_t *ev_hdr, em_queue_t queue)
 		evstate_usr2em(event, ev_hdr, EVSTATE__SEND);
 
 	switch (q_elem->type) {
-	case EM_QUEUE_TYPE_ATOMIC:
 	case EM_QUEUE_TYPE_PARALLEL:
+		if (unlikely(q_elem->flags.inline_send)) {
+			stat = send_inline(event, q_elem);
+			break;
+		}
+		/* fallthrough */
+	case EM_QUEUE_TYPE_ATOMIC:
 	case EM_QUEUE_TYPE_PARALLEL_ORDERED:
 		stat = send_event(event, q_elem);
 		break;
@@ -535,6 +564,8 @@ send_internal_multi(const em_event_t events[], event_hdr_t *ev_hdrs[],
 
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_send(events, num, queue, EM_EVENT_GROUP_UNDEF);
+	if (EM_TRACE_ENABLE)
+		trace_send(events, num, queue);
 
 	if (q_elem->type == EM_QUEUE_TYPE_OUTPUT) {
 		/*
@@ -556,8 +587,13 @@ send_internal_multi(const em_event_t events[], event_hdr_t *ev_hdrs[],
 		evstate_usr2em_multi(events, ev_hdrs, num, EVSTATE__SEND_MULTI);
 
 	switch (q_elem->type) {
-	case EM_QUEUE_TYPE_ATOMIC:
 	case EM_QUEUE_TYPE_PARALLEL:
+		if (unlikely(q_elem->flags.inline_send)) {
+			num_sent = send_inline_multi(events, num, q_elem);
+			break;
+		}
+		/* fallthrough */
+	case EM_QUEUE_TYPE_ATOMIC:
 	case EM_QUEUE_TYPE_PARALLEL_ORDERED:
 		num_sent = send_event_multi(events, num, q_elem);
 		break;
@@ -768,9 +804,14 @@ em_pool_t em_event_get_pool(em_event_t event)
 
 em_status_t em_event_set_type(em_event_t event, em_event_type_t newtype)
 {
-	if (EM_CHECK_LEVEL > 0)
+	if (EM_CHECK_LEVEL > 0) {
 		RETURN_ERROR_IF(event == EM_EVENT_UNDEF, EM_ERR_BAD_ARG,
 				EM_ESCOPE_EVENT_SET_TYPE, "event undefined!");
+		RETURN_ERROR_IF(em_event_type_major(newtype) == EM_EVENT_TYPE_TIMER_IND ||
+				em_event_type_major(newtype) == EM_EVENT_TYPE_IMMEDIATE,
+				EM_ERR_BAD_ARG, EM_ESCOPE_EVENT_SET_TYPE,
+				"Invalid new event type:0x%x", newtype);
+	}
 
 	/* similar to 'ev_hdr = event_to_hdr(event)', slightly extended: */
 	odp_event_t odp_event = event_em2odp(event);
@@ -1290,9 +1331,13 @@ static em_event_t event_clone_part(em_event_t event, em_pool_t pool/*or EM_POOL_
 
 	memcpy(dst, src, size);
 
+	pool_wmark_alloc(pool_elem, 1);
+
 	/* Call the 'alloc' API hook function also for event-clone */
 	if (EM_API_HOOKS_ENABLE && clone_event != EM_EVENT_UNDEF)
 		call_api_hooks_alloc(&clone_event, 1, 1, size, type, pool);
+	if (EM_TRACE_ENABLE && clone_event != EM_EVENT_UNDEF)
+		trace_alloc(&clone_event, 1, size, pool);
 
 	return clone_event;
 }
@@ -1606,6 +1651,8 @@ void em_event_vector_free(em_event_t vector_event)
 
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_free(&vector_event, 1);
+	if (EM_TRACE_ENABLE)
+		trace_free(&vector_event, 1);
 
 	if (esv_enabled()) {
 		event_hdr_t *const ev_hdr = eventvec_to_hdr(vector_event);
@@ -1738,3 +1785,173 @@ err_vecinfo:
 	}
 	return status;
 }
+
+/*
+ * Helper to the em_event_..._head() functions: get the odp pkt of an event
+ */
+static inline odp_packet_t event_odp_pkt(em_event_t event, em_escope_t escope)
+{
+	if (EM_CHECK_LEVEL > 0 && unlikely(event == EM_EVENT_UNDEF)) {
+		INTERNAL_ERROR(EM_ERR_BAD_ARG, escope, "event undefined!");
+		return ODP_PACKET_INVALID;
+	}
+
+	const odp_event_t odp_event = event_em2odp(event);
+
+	if (unlikely(odp_event_type(odp_event) != ODP_EVENT_PACKET)) {
+		INTERNAL_ERROR(EM_ERR_BAD_TYPE, escope,
+			       "Event:%" PRI_EVENT " not a packet", event);
+		return ODP_PACKET_INVALID;
+	}
+
+	return odp_packet_from_event(odp_event);
+}
+
+uint32_t em_event_headroom(em_event_t event)
+{
+	if (EM_CHECK_LEVEL > 0 && unlikely(event == EM_EVENT_UNDEF)) {
+		INTERNAL_ERROR(EM_ERR_BAD_ARG, EM_ESCOPE_EVENT_HEADROOM,
+			       "event undefined!");
+		return 0;
+	}
+
+	const odp_event_t odp_event = event_em2odp(event);
+
+	if (odp_event_type(odp_event) != ODP_EVENT_PACKET)
+		return 0;
+
+	return odp_packet_headroom(odp_packet_from_event(odp_event));
+}
+
+void *em_event_push_head(em_event_t event, uint32_t len)
+{
+	const odp_packet_t odp_pkt = event_odp_pkt(event, EM_ESCOPE_EVENT_PUSH_HEAD);
+
+	if (unlikely(odp_pkt == ODP_PACKET_INVALID))
+		return NULL;
+
+	void *ptr = odp_packet_push_head(odp_pkt, len);
+
+	if (unlikely(!ptr))
+		INTERNAL_ERROR(EM_ERR_TOO_LARGE, EM_ESCOPE_EVENT_PUSH_HEAD,
+			       "len:%u > headroom:%u", len,
+			       odp_packet_headroom(odp_pkt));
+	return ptr;
+}
+
+void *em_event_pull_head(em_event_t event, uint32_t len)
+{
+	const odp_packet_t odp_pkt = event_odp_pkt(event, EM_ESCOPE_EVENT_PULL_HEAD);
+
+	if (unlikely(odp_pkt == ODP_PACKET_INVALID))
+		return NULL;
+
+	void *ptr = odp_packet_pull_head(odp_pkt, len);
+
+	if (unlikely(!ptr))
+		INTERNAL_ERROR(EM_ERR_TOO_LARGE, EM_ESCOPE_EVENT_PULL_HEAD,
+			       "len:%u >= size:%u", len,
+			       odp_packet_seg_len(odp_pkt));
+	return ptr;
+}
+
+void *em_event_extend_head(em_event_t *event /*in/out*/, uint32_t len)
+{
+	if (EM_CHECK_LEVEL > 0 && unlikely(!event)) {
+		INTERNAL_ERROR(EM_ERR_BAD_POINTER, EM_ESCOPE_EVENT_EXTEND_HEAD,
+			       "event pointer NULL");
+		return NULL;
+	}
+
+	odp_packet_t odp_pkt = event_odp_pkt(*event, EM_ESCOPE_EVENT_EXTEND_HEAD);
+
+	if (unlikely(odp_pkt == ODP_PACKET_INVALID))
+		return NULL;
+
+	/* Zero-copy within the headroom, the handle stays the same */
+	if (len <= odp_packet_headroom(odp_pkt))
+		return odp_packet_push_head(odp_pkt, len);
+
+	void *data_ptr = NULL;
+	uint32_t seg_len = 0;
+	int ret = odp_packet_extend_head(&odp_pkt /*in,out*/, len,
+					 &data_ptr, &seg_len);
+	if (unlikely(ret < 0)) {
+		INTERNAL_ERROR(EM_ERR_ALLOC_FAILED, EM_ESCOPE_EVENT_EXTEND_HEAD,
+			       "Event:%" PRI_EVENT " extend head by %u failed:%d",
+			       *event, len, ret);
+		return NULL;
+	}
+
+	if (ret > 0) {
+		/*
+		 * Prepended segment(s): new pkt handle, the metadata incl. the
+		 * user area with the EM event header is kept. Update the
+		 * handles, keep the ESV event generation.
+		 */
+		event_hdr_t *const ev_hdr = odp_packet_user_area(odp_pkt);
+		const em_event_t new_event = event_odp2em(odp_packet_to_event(odp_pkt));
+
+		if (esv_enabled()) {
+			evhdl_t hdr_hdl = {.event = ev_hdr->event};
+			evhdl_t usr_hdl = {.event = *event};
+			const evhdl_t new_hdl = {.event = new_event};
+
+			hdr_hdl.evptr = new_hdl.evptr;
+			usr_hdl.evptr = new_hdl.evptr;
+			ev_hdr->event = hdr_hdl.event;
+			*event = usr_hdl.event;
+		} else {
+			ev_hdr->event = new_event;
+			*event = new_event;
+		}
+	}
+
+	return data_ptr;
+}
+
+em_status_t em_send_imm(uint64_t data, em_queue_t queue)
+{
+	const queue_elem_t *const q_elem = queue_elem_get(queue);
+
+	RETURN_ERROR_IF(EM_CHECK_LEVEL > 0 && !q_elem,
+			EM_ERR_BAD_ID, EM_ESCOPE_SEND_IMM,
+			"Invalid queue:%" PRI_QUEUE "", queue);
+	RETURN_ERROR_IF(EM_CHECK_LEVEL >= 2 && !queue_allocated(q_elem),
+			EM_ERR_BAD_STATE, EM_ESCOPE_SEND_IMM,
+			"Invalid queue:%" PRI_QUEUE "", queue);
+	RETURN_ERROR_IF(data > EM_EVENT_IMM_DATA_MAX,
+			EM_ERR_TOO_LARGE, EM_ESCOPE_SEND_IMM,
+			"data:0x%" PRIx64 " > max:0x%" PRIx64 "",
+			data, EM_EVENT_IMM_DATA_MAX);
+	RETURN_ERROR_IF(q_elem->type != EM_QUEUE_TYPE_LOCAL,
+			EM_ERR_NOT_SUPPORTED, EM_ESCOPE_SEND_IMM,
+			"Q:%" PRI_QUEUE " not a local queue", queue);
+	RETURN_ERROR_IF(q_elem->flags.use_multi_rcv,
+			EM_ERR_NOT_SUPPORTED, EM_ESCOPE_SEND_IMM,
+			"Q:%" PRI_QUEUE " EO uses a multi-event receive function", queue);
+	RETURN_ERROR_IF(em_locm.start_eo_elem != NULL || em_locm.is_external_thr,
+			EM_ERR_BAD_CONTEXT, EM_ESCOPE_SEND_IMM,
+			"Not allowed from an EO start function or a non-EM thread");
+
+	em_status_t stat = send_local_imm(data, q_elem);
+
+	RETURN_ERROR_IF(stat != EM_OK, stat, EM_ESCOPE_SEND_IMM,
+			"Q:%" PRI_QUEUE " send failed", queue);
+
+	return EM_OK;
+}
+
+uint64_t em_event_imm_data(em_event_t event)
+{
+	const stash_entry_t entry = {.evptr = (uintptr_t)event};
+
+	if (EM_CHECK_LEVEL > 0 &&
+	    unlikely(event == EM_EVENT_UNDEF || !stash_entry_is_imm(entry))) {
+		INTERNAL_ERROR(EM_ERR_BAD_TYPE, EM_ESCOPE_EVENT_IMM_DATA,
+			       "Event:%" PRI_EVENT " not an immediate event", event);
+		return 0;
+	}
+
+	return entry.evptr >> 1;
+}
@@ -278,6 +278,8 @@ send_external_egrp(em_event_t event, event_hdr_t *const ev_hdr,
 {
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_send(&event, 1, queue, event_group);
+	if (EM_TRACE_ENABLE)
+		trace_send(&event, 1, queue);
 
 	em_status_t stat = send_chaining_egrp(event, ev_hdr, queue, egrp_elem);
 
@@ -301,6 +303,8 @@ send_external_egrp_multi(const em_event_t events[], event_hdr_t *ev_hdrs[], int
 {
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_send(events, num, queue, event_group);
+	if (EM_TRACE_ENABLE)
+		trace_send(events, num, queue);
 
 	int num_sent = send_chaining_egrp_multi(events, ev_hdrs, num,
 						queue, egrp_elem);
@@ -353,6 +357,8 @@ send_internal_egrp(em_event_t event, event_hdr_t *ev_hdr, em_queue_t queue,
 
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_send(&event, 1, queue, event_group);
+	if (EM_TRACE_ENABLE)
+		trace_send(&event, 1, queue);
 
 	/*
 	 * Normal send to a queue on this device
@@ -361,8 +367,13 @@ send_internal_egrp(em_event_t event, event_hdr_t *ev_hdr, em_queue_t queue,
 		evstate_usr2em(event, ev_hdr, EVSTATE__SEND_EGRP);
 
 	switch (q_elem->type) {
-	case EM_QUEUE_TYPE_ATOMIC:
 	case EM_QUEUE_TYPE_PARALLEL:
+		if (unlikely(q_elem->flags.inline_send)) {
+			stat = send_inline(event, q_elem);
+			break;
+		}
+		/* fallthrough */
+	case EM_QUEUE_TYPE_ATOMIC:
 	case EM_QUEUE_TYPE_PARALLEL_ORDERED:
 		stat = send_event(event, q_elem);
 		break;
@@ -434,6 +445,8 @@ send_internal_egrp_multi(const em_event_t events[], event_hdr_t *ev_hdrs[],
 
 	if (EM_API_HOOKS_ENABLE)
 		call_api_hooks_send(events, num, queue, event_group);
+	if (EM_TRACE_ENABLE)
+		trace_send(events, num, queue);
 
 	/*
 	 * Normal send to a queue on this device
@@ -442,8 +455,13 @@ send_internal_egrp_multi(const em_event_t events[], event_hdr_t *ev_hdrs[],
 		evstate_usr2em_multi(events, ev_hdrs, num, EVSTATE__SEND_EGRP_MULTI);
 
 	switch (q_elem->type) {
-	case EM_QUEUE_TYPE_ATOMIC:
 	case EM_QUEUE_TYPE_PARALLEL:
+		if (unlikely(q_elem->flags.inline_send)) {
+			num_sent = send_inline_multi(events, num, q_elem);
+			break;
+		}
+		/* fallthrough */
+	case EM_QUEUE_TYPE_ATOMIC:
 	case EM_QUEUE_TYPE_PARALLEL_ORDERED:
 		num_sent = send_event_multi(events, num, q_elem);
 		break;
@@ -181,6 +181,11 @@ em_init(const em_conf_t *conf)
 	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_INIT,
 			"hooks_init() failed:%" PRI_STAT "", stat);
 
+	/* Initialize the event trace rings (only if compiled in) */
+	stat = trace_init();
+	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_INIT,
+			"trace_init() failed:%" PRI_STAT "", stat);
+
 	/*
 	 * Initialize the EM buffer pools and create the EM_DEFAULT_POOL.
 	 * Create also startup pools if configured in the runtime config
@@ -242,6 +247,11 @@ em_init(const em_conf_t *conf)
 	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_INIT,
 			"emcli_init() failed:%" PRI_STAT "", stat);
 
+	/* Initialize the metrics exporter */
+	stat = metrics_init();
+	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_INIT,
+			"metrics_init() failed:%" PRI_STAT "", stat);
+
 	return EM_OK;
 }
 
@@ -312,6 +322,10 @@ em_init_core(void)
 	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_INIT_CORE,
 			"sync_api_init_local() failed:%" PRI_STAT "", stat);
 
+	stat = trace_init_local();
+	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_INIT_CORE,
+			"trace_init_local() failed:%" PRI_STAT "", stat);
+
 	/* Init the EM CLI locally on this core (only if enabled) */
 	stat = emcli_init_local();
 	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_INIT_CORE,
@@ -354,6 +368,10 @@ em_term(const em_conf_t *conf)
 	if (em_shm->conf.event_timer)
 		timer_term(&em_shm->timers);
 
+	stat = metrics_term();
+	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_TERM,
+			"metrics_term() failed:%" PRI_STAT "", stat);
+
 	stat = emcli_term();
 	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_TERM,
 			"emcli_term() failed:%" PRI_STAT "", stat);
@@ -362,6 +380,14 @@ em_term(const em_conf_t *conf)
 	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_TERM,
 			"chaining_term() failed:%" PRI_STAT "", stat);
 
+	stat = queue_stats_term();
+	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_TERM,
+			"queue_stats_term() failed:%" PRI_STAT "", stat);
+
+	stat = trace_term();
+	RETURN_ERROR_IF(stat != EM_OK, EM_ERR_LIB_FAILED, EM_ESCOPE_TERM,
+			"trace_term() failed:%" PRI_STAT "", stat);
+
 	ret = em_libconfig_term_global(&em_shm->libconfig);
 	RETURN_ERROR_IF(ret != 0, EM_ERR_LIB_FAILED, EM_ESCOPE_TERM,
 			"EM config term failed:%d");
@@ -389,6 +415,14 @@ em_term_core(void)
 	em_status_t ret_stat = EM_OK;
 	em_locm_t *const locm = &em_locm;
 
+	/* Run the deferred calls first, they might still use EM */
+	stat = dispatch_term_local();
+	if (stat != EM_OK) {
+		ret_stat = stat;
+		INTERNAL_ERROR(stat, EM_ESCOPE_TERM_CORE,
+			       "dispatch_term_local() fails: %" PRI_STAT "", stat);
+	}
+
 	if (em_core_id() == 0)
 		delete_ctrl_queues();
 
@@ -408,6 +442,14 @@ em_term_core(void)
 			       "emcli_term_local() fails: %" PRI_STAT "", stat);
 	}
 
+	/* Free the coroutine pool of this core (if used) */
+	stat = coro_term_local();
+	if (stat != EM_OK) {
+		ret_stat = stat;
+		INTERNAL_ERROR(stat, EM_ESCOPE_TERM_CORE,
+			       "coro_term_local() fails: %" PRI_STAT "", stat);
+	}
+
 	/* Delete the local queues */
 	stat = queue_term_local();
 	if (stat != EM_OK) {
@@ -302,140 +302,120 @@ em_pool_t em_odp_pool2em(odp_pool_t odp_pool)
 	return pool_odp2em(odp_pool);
 }
 
-static inline int
-pkt_enqueue_scheduled(const odp_packet_t pkt_tbl[/*num*/], int num,
-		      const queue_elem_t *q_elem)
+/** Destination of a run of consecutive pkts enqueued into the same queue */
+typedef struct {
+	int start;
+	int num;
+	em_queue_t queue;
+	/* NULL: queue not in this EM instance, use event chaining */
+	queue_elem_t *q_elem;
+} pkt_run_t;
+
+/* Do the pkts sent into the queue need their ev-hdrs initialized first */
+static inline bool pkt_run_needs_init(const queue_elem_t *q_elem)
 {
-	odp_event_t odp_event_tbl[num];
-
-	odp_packet_to_event_multi(pkt_tbl, odp_event_tbl/*out*/, num);
-
-	/*
-	 * Enqueue the events into a scheduled em-odp queue.
-	 * No need to init the ev-hdrs - init is done in dispatch.
-	 */
-	int sent = odp_queue_enq_multi(q_elem->odp_queue,
-				       odp_event_tbl, num);
-	if (unlikely(sent < num)) {
-		sent = unlikely(sent < 0) ? 0 : sent;
-		odp_packet_free_multi(&pkt_tbl[sent], num - sent);
-		/*
-		 * Event state checking: No need to adjust the event state
-		 * since the events were never enqueued into EM.
-		 */
-	}
-
-	return sent;
+	/* scheduled & local: init is done in dispatch, other types: dropped */
+	return !q_elem || (!q_elem->flags.scheduled &&
+			   (q_elem->type == EM_QUEUE_TYPE_UNSCHEDULED ||
+			    q_elem->type == EM_QUEUE_TYPE_OUTPUT));
 }
 
 static inline int
-pkt_enqueue_local(const odp_packet_t pkt_tbl[/*num*/], int num,
-		  const queue_elem_t *q_elem)
+pkt_run_enqueue(const pkt_run_t *run, const odp_packet_t pkt_tbl[],
+		odp_event_t odp_event_tbl[], em_event_t event_tbl[])
 {
-	odp_event_t odp_event_tbl[num];
-	em_event_t event_tbl[num];
-
-	odp_packet_to_event_multi(pkt_tbl, odp_event_tbl/*out*/, num);
-
-	events_odp2em(odp_event_tbl, event_tbl/*out*/, num);
+	const int start = run->start;
+	const int num = run->num;
+	queue_elem_t *const q_elem = run->q_elem;
+	int sent = 0;
 
-	/*
-	 * Send into an local em-odp queue.
-	 * No need to init the ev-hdrs - init is done in dispatch.
-	 */
-	int sent = send_local_multi(event_tbl, num, q_elem);
+	if (!q_elem) {
+		if (likely(queue_external(run->queue)))
+			sent = send_chaining_multi(&event_tbl[start], num, run->queue);
+	} else if (q_elem->flags.scheduled) {
+		sent = odp_queue_enq_multi(q_elem->odp_queue, &odp_event_tbl[start], num);
+	} else if (q_elem->type == EM_QUEUE_TYPE_LOCAL) {
+		sent = send_local_multi(&event_tbl[start], num, q_elem);
+	} else if (q_elem->type == EM_QUEUE_TYPE_UNSCHEDULED) {
+		sent = odp_queue_enq_multi(q_elem->odp_queue, &odp_event_tbl[start], num);
+	} else if (q_elem->type == EM_QUEUE_TYPE_OUTPUT) {
+		sent = send_output_multi(&event_tbl[start], num, q_elem);
+	} /* else: no supported queue type, drop all pkts of the run */
 
 	if (unlikely(sent < num)) {
 		sent = unlikely(sent < 0) ? 0 : sent;
-		odp_packet_free_multi(&pkt_tbl[sent], num - sent);
 		/*
-		 * Event state checking: No need to adjust the event state
-		 * since the events were never enqueued into EM.
+		 * Event state checking: pkts with initialized ev-hdrs are
+		 * EM events and freed as such, the rest were never in EM.
 		 */
+		if (pkt_run_needs_init(q_elem))
+			em_free_multi(&event_tbl[start + sent], num - sent);
+		else
+			odp_packet_free_multi(&pkt_tbl[start + sent], num - sent);
 	}
 
 	return sent;
 }
 
+/*
+ * Enqueue 'num' pkts split into 'num_runs' runs of consecutive pkts with the
+ * same destination queue. Common to em_odp_pkt_enqueue() (a single run) and
+ * em_odp_pkt_enqueue_multi().
+ */
 static inline int
-pkt_enqueue_chaining_out(const odp_packet_t pkt_tbl[/*num*/], int num,
-			 em_queue_t queue)
+pkt_runs_enqueue(const odp_packet_t pkt_tbl[/*num*/], int num,
+		 const pkt_run_t runs[/*num_runs*/], int num_runs)
 {
 	odp_event_t odp_event_tbl[num];
 	em_event_t event_tbl[num];
-	event_hdr_t *evhdr_tbl[num];
+	int num_init = 0;
 	int sent = 0;
 
 	odp_packet_to_event_multi(pkt_tbl, odp_event_tbl/*out*/, num);
-
 	events_odp2em(odp_event_tbl, event_tbl/*out*/, num);
 
-	/* Init the event-hdrs for incoming non-scheduled pkts */
-	event_init_pkt_multi(pkt_tbl, event_tbl/*in/out*/,
-			     evhdr_tbl/*out*/, num, true /*is_extev*/);
-
-	/* Send directly out via event chaining */
-	if (likely(queue_external(queue)))
-		sent = send_chaining_multi(event_tbl, num, queue);
-
-	if (unlikely(sent < num)) {
-		sent = unlikely(sent < 0) ? 0 : sent;
-		em_free_multi(&event_tbl[sent], num - sent);
+	for (int r = 0; r < num_runs; r++) {
+		if (pkt_run_needs_init(runs[r].q_elem))
+			num_init += runs[r].num;
 	}
 
-	return sent;
-}
-
-static inline int
-pkt_enqueue_unscheduled(const odp_packet_t pkt_tbl[/*num*/], int num,
-			const queue_elem_t *q_elem)
-{
-	odp_event_t odp_event_tbl[num];
-	em_event_t event_tbl[num];
-	event_hdr_t *evhdr_tbl[num];
-
-	odp_packet_to_event_multi(pkt_tbl, odp_event_tbl/*out*/, num);
-
-	events_odp2em(odp_event_tbl, event_tbl/*out*/, num);
-
-	/* Init the event-hdrs for incoming non-scheduled pkts */
-	event_init_pkt_multi(pkt_tbl, event_tbl/*in/out*/,
-			     evhdr_tbl/*out*/, num, true /*is_extev*/);
+	/* Init the event-hdrs of all incoming non-scheduled pkts in one pass */
+	if (num_init == num) {
+		event_hdr_t *evhdr_tbl[num];
+
+		event_init_pkt_multi(pkt_tbl, event_tbl/*in/out*/,
+				     evhdr_tbl/*out*/, num, true /*is_extev*/);
+	} else if (num_init > 0) {
+		odp_packet_t init_pkts[num_init];
+		em_event_t init_events[num_init];
+		event_hdr_t *init_evhdrs[num_init];
+		int n = 0;
+
+		for (int r = 0; r < num_runs; r++) {
+			if (!pkt_run_needs_init(runs[r].q_elem))
+				continue;
+			for (int i = runs[r].start; i < runs[r].start + runs[r].num; i++) {
+				init_pkts[n] = pkt_tbl[i];
+				init_events[n] = event_tbl[i];
+				n++;
+			}
+		}
 
-	/* Enqueue into an unscheduled em-odp queue */
-	int sent = odp_queue_enq_multi(q_elem->odp_queue, odp_event_tbl, num);
+		event_init_pkt_multi(init_pkts, init_events/*in/out*/,
+				     init_evhdrs/*out*/, num_init, true /*is_extev*/);
 
-	if (unlikely(sent < num)) {
-		sent = unlikely(sent < 0) ? 0 : sent;
-		em_free_multi(&event_tbl[sent], num - sent);
+		/* ESV might have updated the event handles */
+		n = 0;
+		for (int r = 0; r < num_runs; r++) {
+			if (!pkt_run_needs_init(runs[r].q_elem))
+				continue;
+			for (int i = runs[r].start; i < runs[r].start + runs[r].num; i++)
+				event_tbl[i] = init_events[n++];
+		}
 	}
 
-	return sent;
-}
-
-static inline int
-pkt_enqueue_output(const odp_packet_t pkt_tbl[/*num*/], int num,
-		   queue_elem_t *const q_elem)
-{
-	odp_event_t odp_event_tbl[num];
-	em_event_t event_tbl[num];
-	event_hdr_t *evhdr_tbl[num];
-
-	odp_packet_to_event_multi(pkt_tbl, odp_event_tbl/*out*/, num);
-
-	events_odp2em(odp_event_tbl, event_tbl/*out*/, num);
-
-	/* Init the event-hdrs for incoming non-scheduled pkts */
-	event_init_pkt_multi(pkt_tbl, event_tbl/*in/out*/,
-			     evhdr_tbl/*out*/, num, true /*is_extev*/);
-
-	/* Send directly out via an output em-odp queue */
-	int sent = send_output_multi(event_tbl, num, q_elem);
-
-	if (unlikely(sent < num)) {
-		sent = unlikely(sent < 0) ? 0 : sent;
-		em_free_multi(&event_tbl[sent], num - sent);
-	}
+	for (int r = 0; r < num_runs; r++)
+		sent += pkt_run_enqueue(&runs[r], pkt_tbl, odp_event_tbl, event_tbl);
 
 	return sent;
 }
@@ -445,31 +425,35 @@ int em_odp_pkt_enqueue(const odp_packet_t pkt_tbl[/*num*/], int num, em_queue_t
 	if (unlikely(!pkt_tbl || num <= 0))
 		return 0;
 
-	queue_elem_t *const q_elem = queue_elem_get(queue);
+	const pkt_run_t run = {.start = 0, .num = num, .queue = queue,
+			       .q_elem = queue_elem_get(queue)};
 
-	/* Queue not in this EM instance, send directly out via event chaining */
-	if (!q_elem)
-		return pkt_enqueue_chaining_out(pkt_tbl, num, queue);
-
-	if (q_elem->flags.scheduled)
-		return pkt_enqueue_scheduled(pkt_tbl, num, q_elem);
+	return pkt_runs_enqueue(pkt_tbl, num, &run, 1);
+}
 
-	if (q_elem->type == EM_QUEUE_TYPE_LOCAL)
-		return pkt_enqueue_local(pkt_tbl, num, q_elem);
+int em_odp_pkt_enqueue_multi(const odp_packet_t pkt_tbl[/*num*/],
+			     const em_queue_t queue_tbl[/*num*/], int num)
+{
+	if (unlikely(!pkt_tbl || !queue_tbl || num <= 0))
+		return 0;
 
-	if (q_elem->type == EM_QUEUE_TYPE_UNSCHEDULED)
-		return pkt_enqueue_unscheduled(pkt_tbl, num, q_elem);
+	pkt_run_t runs[num];
+	int num_runs = 0;
 
-	if (q_elem->type ==  EM_QUEUE_TYPE_OUTPUT)
-		return pkt_enqueue_output(pkt_tbl, num, q_elem);
+	/* Split into runs of consecutive pkts with the same destination */
+	for (int i = 0; i < num; i++) {
+		if (num_runs > 0 && runs[num_runs - 1].queue == queue_tbl[i]) {
+			runs[num_runs - 1].num++;
+			continue;
+		}
+		runs[num_runs].start = i;
+		runs[num_runs].num = 1;
+		runs[num_runs].queue = queue_tbl[i];
+		runs[num_runs].q_elem = queue_elem_get(queue_tbl[i]);
+		num_runs++;
+	}
 
-	/* No supported queue type, drop all pkts */
-	odp_packet_free_multi(pkt_tbl, num);
-	/*
-	 * Event state checking: No need to adjust the event state
-	 * since the pkts/events were neither initialized nor enqueued into EM.
-	 */
-	return 0;
+	return pkt_runs_enqueue(pkt_tbl, num, runs, num_runs);
 }
 
 odp_schedule_group_t em_odp_qgrp2odp(em_queue_group_t queue_group)
@@ -608,3 +608,55 @@ void em_pool_subpool_stats_selected_print(em_pool_t pool, const int subpools[],
 {
 	subpools_stats_selected_print(pool, subpools, num_subpools, opt);
 }
+
+em_status_t em_pool_wmark_set(em_pool_t pool, const em_pool_wmark_param_t *param)
+{
+	mpool_elem_t *const pool_elem = pool_elem_get(pool);
+
+	RETURN_ERROR_IF(pool_elem == NULL || !pool_allocated(pool_elem) ||
+			!param || !param->func || param->low > param->high,
+			EM_ERR_BAD_ARG, EM_ESCOPE_POOL_WMARK_SET,
+			"Inv.args: pool:%" PRI_POOL " param:%p", pool, param);
+	RETURN_ERROR_IF(!pool_elem->stats_opt.bit.available,
+			EM_ERR_NOT_SUPPORTED, EM_ESCOPE_POOL_WMARK_SET,
+			"EM-pool:%" PRI_POOL " needs 'available' statistics", pool);
+
+	uint32_t num = 0;
+
+	for (int i = 0; i < pool_elem->num_subpools; i++)
+		num += pool_elem->pool_cfg.subpool[i].num;
+
+	/* Disable while updating, cores only check enabled watermarks */
+	const bool was_enabled = odp_atomic_xchg_u32(&pool_elem->wmark.enabled, 0);
+
+	pool_elem->wmark.low = param->low;
+	pool_elem->wmark.high = param->high;
+	pool_elem->wmark.func = param->func;
+	pool_elem->wmark.arg = param->arg;
+	pool_elem->wmark.num = num;
+	/* Read only the free event counters when sampling */
+	pool_elem->wmark.opt.all = 0;
+	pool_elem->wmark.opt.bit.available = pool_elem->stats_opt.bit.available;
+	pool_elem->wmark.opt.bit.cache_available = pool_elem->stats_opt.bit.cache_available;
+	odp_atomic_store_u32(&pool_elem->wmark.is_low, 0);
+
+	odp_atomic_store_rel_u32(&pool_elem->wmark.enabled, 1);
+	if (!was_enabled)
+		odp_atomic_inc_u32(&em_shm->mpool_tbl.wmark_pools);
+
+	return EM_OK;
+}
+
+em_status_t em_pool_wmark_clear(em_pool_t pool)
+{
+	mpool_elem_t *const pool_elem = pool_elem_get(pool);
+
+	RETURN_ERROR_IF(pool_elem == NULL || !pool_allocated(pool_elem),
+			EM_ERR_BAD_ARG, EM_ESCOPE_POOL_WMARK_CLEAR,
+			"Inv.args: pool:%" PRI_POOL "", pool);
+
+	if (odp_atomic_xchg_u32(&pool_elem->wmark.enabled, 0))
+		odp_atomic_dec_u32(&em_shm->mpool_tbl.wmark_pools);
+
+	return EM_OK;
+}
@@ -70,6 +70,10 @@ em_ordered_processing_end(void)
 	if (unlikely(!q_elem || q_elem->type != EM_QUEUE_TYPE_PARALLEL_ORDERED))
 		return;
 
+	/* The ordered lock is only available in the ordered context */
+	if (locm->output_queue_ordered.num > 0)
+		output_queue_ordered_flush();
+
 	odp_schedule_release_ordered();
 	/*
 	 * ODP might not actually release the ordered context here. From an EM